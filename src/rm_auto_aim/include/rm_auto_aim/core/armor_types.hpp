@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include <Eigen/Geometry>
+
+namespace rm_auto_aim {
+
+/**
+ * 算法核心类型（不依赖ROS）
+ *
+ * ArmorDetector / PnPSolver / ArmorTracker / ArmorSolver 之间只传递这里的类型，
+ * ROS消息的转换集中在节点边缘（armor_msg_builder），核心库可脱离ROS单独编译和复用。
+ */
+
+// 颜色枚举
+enum class Color : uint8_t {
+    BLUE = 0,
+    RED = 1,
+};
+
+// 装甲板类型
+enum class ArmorType : uint8_t {
+    SMALL = 0,
+    LARGE = 1,
+};
+
+// 装甲板编号/符号
+enum class ArmorSymbol : uint8_t {
+    UNKNOWN = 0,
+    HERO = 1,       // 1号英雄
+    ENGINEER = 2,   // 2号工程
+    INFANTRY_3 = 3, // 3号步兵
+    INFANTRY_4 = 4, // 4号步兵
+    INFANTRY_5 = 5, // 5号步兵
+    SENTRY = 6,     // 哨兵
+    OUTPOST = 7,    // 前哨站
+    BASE = 8,       // 基地
+};
+
+// 装甲板编号名称（仅用于日志/调试话题，关键路径使用枚举）
+inline const char* armorSymbolName(ArmorSymbol symbol) {
+    switch (symbol) {
+        case ArmorSymbol::HERO: return "hero";
+        case ArmorSymbol::ENGINEER: return "engineer";
+        case ArmorSymbol::INFANTRY_3: return "3";
+        case ArmorSymbol::INFANTRY_4: return "4";
+        case ArmorSymbol::INFANTRY_5: return "5";
+        case ArmorSymbol::SENTRY: return "sentry";
+        case ArmorSymbol::OUTPOST: return "outpost";
+        case ArmorSymbol::BASE: return "base";
+        default: return "unknown";
+    }
+}
+
+// 图像坐标（像素）
+struct ImagePoint {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+/**
+ * @brief 单块装甲板的观测（相机坐标系）
+ */
+struct ArmorObservation {
+    ArmorSymbol symbol = ArmorSymbol::UNKNOWN;
+    ArmorType type = ArmorType::SMALL;
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();                 // m
+    Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+    double yaw = 0.0;                         // 朝向角（跟踪器观测量，2·atan2(qz, qw)）
+    std::array<ImagePoint, 4> corners{};      // 图像角点 (左上, 右上, 右下, 左下)
+    float distance_to_image_center = 0.0f;    // 像素
+
+    /**
+     * @brief 设置姿态并同步计算yaw
+     */
+    void setOrientation(const Eigen::Quaterniond& q) {
+        orientation = q;
+        yaw = yawFromQuaternion(q);
+    }
+
+    static double yawFromQuaternion(const Eigen::Quaterniond& q) {
+        return 2.0 * std::atan2(q.z(), q.w());
+    }
+};
+
+/**
+ * @brief 单帧装甲板观测（定长，无堆分配）
+ */
+struct ArmorObservations {
+    static constexpr uint8_t MAX_ARMORS = 16;
+
+    int64_t stamp_ns = 0;   // 帧采集时间戳（ns），0表示合成帧
+    uint8_t camera = 0;     // 来源相机序号，0为参考相机（多相机时坐标系随之不同）
+    uint8_t count = 0;
+    std::array<ArmorObservation, MAX_ARMORS> armors;
+
+    /**
+     * @brief 追加一块装甲板
+     * @return false 表示数组已满，装甲板被丢弃
+     */
+    bool append(const ArmorObservation& armor) {
+        if (count >= MAX_ARMORS) {
+            return false;
+        }
+        armors[count++] = armor;
+        return true;
+    }
+
+    void clear() { count = 0; }
+    bool empty() const { return count == 0; }
+};
+
+}  // namespace rm_auto_aim
@@ -1,14 +1,28 @@
 #pragma once
 
-#include <image_transport/image_transport.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
 #include <sensor_msgs/msg/image.hpp>
+#include <std_msgs/msg/float64.hpp>
+#include <std_msgs/msg/u_int64.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "rm_auto_aim/detector/detector.hpp"
 #include "rm_auto_aim/detector/pnp_solver.hpp"
+#include "rm_auto_aim/detector/warmup.hpp"
 #include "rm_interfaces/msg/armors.hpp"
+#include "rm_interfaces/msg/compact_armors.hpp"
+#include "rm_interfaces/msg/serial_receive_data.hpp"
+#include "rm_utils/latest_mailbox.hpp"
+#include "rm_utils/rcu_cell.hpp"
+#include "rm_utils/thread_placement.hpp"
 
 namespace rm_auto_aim {
 
@@ -17,46 +31,168 @@ namespace rm_auto_aim {
  *
  * 订阅相机图像，执行灯条检测→装甲板匹配→PnP解算，
  * 发布检测到的装甲板三维位姿信息。
+ *
+ * 支持多路相机（camera_topics，每路 <前缀>/image_raw 与 <前缀>/camera_info），
+ * 每路各自的内参与PnP解算器，发布的观测带相机序号，由解算节点变换到参考相机坐标系。
+ * 图像回调只把帧放入该路的单槽邮箱（未处理的旧帧直接覆盖并计为丢帧），
+ * 检测线程组共享各路邮箱，总是取最早到达的一路最新帧处理：
+ * 同一路串行，不同路并行，排队延迟不超过一帧处理时间。
+ *
+ * 检测参数（二值化/灯条/装甲板/分类器阈值）与目标颜色支持运行时修改：参数回调构造新的
+ * 不可变配置并以RCU指针交换发布，各检测线程每帧无锁取快照，版本变化时在帧间更新检测器。
+ * detect_color_from_serial 开启时目标颜色跟随下位机（/serial/receive 的color）自动切换。
+ *
+ * 生命周期: configure 取得主相机内参（/camera_info、自身参数或标定缓存，均无则失败，
+ * 由管理节点重试；其他相机只取自各自的camera_info）并用合成帧预热检测与PnP，activate 启动检测线程，
+ * deactivate 停止检测，cleanup 释放检测器与通信实体。
+ * 配置后 /camera_info 仅在内参不同时替换解算器并更新缓存。
+ *
+ * 本节点是 /image_raw 在容器内唯一的订阅者（相机以unique_ptr发布，零拷贝到达）。
+ * 原始图像录制不另行订阅 /image_raw，而是由本节点把用完的主相机帧经 /armor_detector/image_tee
+ * 转交录制节点（所有权转移，录制写完后归还缓冲区池）。
  */
-class ArmorDetectorNode : public rclcpp::Node {
+class ArmorDetectorNode : public rclcpp_lifecycle::LifecycleNode {
 public:
+    using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+
     explicit ArmorDetectorNode(const rclcpp::NodeOptions& options);
+    ~ArmorDetectorNode() override;
+
+    CallbackReturn on_configure(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_activate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_deactivate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_cleanup(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_shutdown(const rclcpp_lifecycle::State& state) override;
 
 private:
-    void imageCallback(const sensor_msgs::msg::Image::ConstSharedPtr& msg);
-    void cameraInfoCallback(const sensor_msgs::msg::CameraInfo::ConstSharedPtr& msg);
+    /**
+     * @brief 可热更新的检测配置（发布后不再修改）
+     */
+    struct DetectorConfig {
+        DetectorParams params;
+        Color detect_color = Color::RED;
+    };
+
+    /**
+     * @brief 一路相机输入：订阅、内参与PnP解算器
+     */
+    struct CameraStream {
+        size_t index = 0;
+        std::string topic_prefix;
+        // 当前内参（内参回调与configure可能并发，加锁访问）
+        std::mutex calibration_mutex;
+        CameraCalibration calibration;
+        // 内参回调整体替换，检测线程用atomic_load取快照
+        std::shared_ptr<PnPSolver> pnp_solver;
+        rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr img_sub;
+        rclcpp::Subscription<sensor_msgs::msg::CameraInfo>::SharedPtr cam_info_sub;
+    };
+
+    /**
+     * @brief 一个检测线程：每路相机一个检测器（各路分辨率可能不同，避免内部缓冲区反复重建）
+     */
+    struct DetectWorker {
+        size_t index = 0;
+        std::vector<std::unique_ptr<ArmorDetector>> detectors;
+        // 单帧观测（仅本线程访问，复用避免逐帧构造）
+        ArmorObservations observations;
+        // 本线程的配置读者与检测器当前使用的配置版本
+        std::unique_ptr<RcuCell<DetectorConfig>::Reader> config_reader;
+        uint64_t config_version = 0;
+        std::thread thread;
+    };
+
+    // 停止检测线程（关闭邮箱，残留帧经recycleFrame转交录制或归还）
+    void stopDetecting();
+    // 释放检测器、解算器与通信实体
+    void releaseResources();
+
+    // 图像回调：放入该路邮箱，覆盖未处理的旧帧
+    void imageCallback(CameraStream& stream, sensor_msgs::msg::Image::UniquePtr msg);
+    // 用完（检测完、被覆盖或未激活）的帧：主相机帧有录制订阅者时转交，否则归还缓冲区池
+    void recycleFrame(const CameraStream& stream, sensor_msgs::msg::Image::UniquePtr msg);
+    // 检测线程：从邮箱组取最早到达的一路最新帧处理
+    void detectLoop(DetectWorker& worker);
+    void processImage(
+        DetectWorker& worker, CameraStream& stream, sensor_msgs::msg::Image::UniquePtr msg);
+    void placeCurrentThread(ThreadPlacement placement, const std::string& name);
+    // 定期发布丢帧计数
+    void publishFrameStats();
+    void cameraInfoCallback(
+        CameraStream& stream, const sensor_msgs::msg::CameraInfo::ConstSharedPtr& msg);
+
+    // 取得各路内参并创建PnP解算器，主相机无任何内参来源时返回false
+    bool initCalibration();
+    // 合成帧预热检测 → PnP → 消息组装（每个检测线程、每路已知内参的相机）
+    void warmUp(Color color);
 
     // 声明和初始化ROS参数
     void declareParameters();
-    DetectorParams loadParams();
+    DetectorConfig loadConfig();
+
+    // 参数修改回调：可热更新的参数发布为新配置，其余参数下次configure生效
+    rcl_interfaces::msg::SetParametersResult onParametersSet(
+        const std::vector<rclcpp::Parameter>& params);
+    // 下位机颜色变化时改写detect_color参数（经参数回调生效）
+    void serialCallback(const rm_interfaces::msg::SerialReceiveData::ConstSharedPtr& msg);
 
     // 创建调试发布器
     void createDebugPublishers();
+    void publishDebug(
+        const ArmorDetector& detector, const rm_interfaces::msg::CompactArmors& armors_msg);
     void publishDebugImages(const cv::Mat& binary, const cv::Mat& debug_img);
-    void publishMarkers(const rm_interfaces::msg::Armors& armors_msg);
+    void publishMarkers(const rm_interfaces::msg::CompactArmors& armors_msg);
+
+    // 检测+PnP结果写入核心观测类型（发布前在节点边缘转换为定长消息）
+    void fillArmors(
+        const cv::Mat& image, const std::vector<Armor>& armors, PnPSolver& pnp_solver,
+        ArmorObservations& observations);
+
+    // 各路相机（0号为主相机，构造时按camera_topics创建，之后不增减）
+    std::vector<std::unique_ptr<CameraStream>> streams_;
+    // 主相机标定缓存文件
+    std::string calibration_cache_;
 
-    // 检测器与PnP解算器
-    std::unique_ptr<ArmorDetector> detector_;
-    std::unique_ptr<PnPSolver> pnp_solver_;
+    // 检测配置（参数回调发布，检测线程经各自的读者无锁读取）
+    RcuCell<DetectorConfig> config_;
+    OnSetParametersCallbackHandle::SharedPtr param_callback_;
 
-    // 目标颜色
-    Color detect_color_ = Color::RED;
+    // 检测线程组（configure创建检测器，activate启动线程）。
+    // 须声明在config_之后：各线程持有config_的读者，析构时先于config_注销
+    std::vector<std::unique_ptr<DetectWorker>> workers_;
 
-    // 图像订阅
-    rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr img_sub_;
-    rclcpp::Subscription<sensor_msgs::msg::CameraInfo>::SharedPtr cam_info_sub_;
+    // 目标颜色跟随下位机：最近一次收到的下位机颜色（-1表示尚未收到）
+    rclcpp::Subscription<rm_interfaces::msg::SerialReceiveData>::SharedPtr serial_sub_;
+    std::atomic<int> serial_color_{-1};
 
-    // 检测结果发布
-    rclcpp::Publisher<rm_interfaces::msg::Armors>::SharedPtr armors_pub_;
+    // 各路图像邮箱
+    LatestMailboxGroup<sensor_msgs::msg::Image::UniquePtr> mailboxes_;
+    std::atomic<bool> detecting_{false};  // 激活状态：检测线程运行中
+    ThreadPlacement detect_placement_;  // 检测线程的CPU亲和性与实时优先级
+
+    // 帧统计：收到 / 处理 / 被新帧覆盖丢弃
+    std::atomic<uint64_t> frames_received_{0};
+    std::atomic<uint64_t> frames_processed_{0};
+    std::atomic<uint64_t> frames_dropped_{0};
+    uint64_t foreign_releases_reported_ = 0;  // 已告警的缓冲区池外来归还次数
+    rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::Float64>::SharedPtr frame_age_pub_;
+    rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::UInt64>::SharedPtr dropped_pub_;
+    rclcpp::TimerBase::SharedPtr stats_timer_;
+
+    // 检测结果发布（定长消息，中间件支持时使用借用消息）
+    rclcpp_lifecycle::LifecyclePublisher<rm_interfaces::msg::CompactArmors>::SharedPtr armors_pub_;
+
+    // 用完的主相机帧转交录制节点（/armor_detector/image_tee，仅进程内订阅者时发布，所有权转移不拷贝）
+    rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr image_tee_pub_;
 
     // 调试发布器
     bool debug_ = false;
-    image_transport::Publisher binary_pub_;
-    image_transport::Publisher debug_img_pub_;
-    rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr marker_pub_;
-
-    // 相机内参是否已初始化
-    bool cam_info_received_ = false;
+    // 调试图像（image_transport不支持生命周期节点，直接发布原始图像）
+    rclcpp_lifecycle::LifecyclePublisher<sensor_msgs::msg::Image>::SharedPtr binary_pub_;
+    rclcpp_lifecycle::LifecyclePublisher<sensor_msgs::msg::Image>::SharedPtr debug_img_pub_;
+    rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>::SharedPtr marker_pub_;
+    // 旧版变长消息，仅供调试工具使用
+    rclcpp_lifecycle::LifecyclePublisher<rm_interfaces::msg::Armors>::SharedPtr legacy_armors_pub_;
 };
 
 }  // namespace rm_auto_aim
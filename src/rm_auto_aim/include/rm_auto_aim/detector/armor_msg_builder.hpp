@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+
+#include "rm_auto_aim/core/armor_types.hpp"
+#include "rm_interfaces/msg/armors.hpp"
+#include "rm_interfaces/msg/compact_armors.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * 核心类型 ↔ ROS消息转换（仅在节点边缘使用，算法库不依赖本文件）
+ */
+
+// 检测结果所在坐标系（CompactArmors不携带frame_id）
+constexpr const char* ARMOR_FRAME_ID = "camera_optical_frame";
+
+/**
+ * @brief 单块装甲板观测 → 定长装甲板消息
+ */
+rm_interfaces::msg::CompactArmor toMsg(const ArmorObservation& armor);
+
+/**
+ * @brief 单帧观测 → 定长检测结果（就地填写，可直接写入借用消息）
+ */
+void toMsg(const ArmorObservations& armors, rm_interfaces::msg::CompactArmors& msg);
+
+/**
+ * @brief 定长检测结果 → 单帧观测（yaw由姿态四元数重新计算）
+ */
+void fromMsg(const rm_interfaces::msg::CompactArmors& msg, ArmorObservations& armors);
+
+/**
+ * @brief 定长消息转为旧版变长Armors消息（仅供rviz/录包等工具使用）
+ */
+rm_interfaces::msg::Armors toArmorsMsg(
+    const rm_interfaces::msg::CompactArmors& armors,
+    const std::string& frame_id = ARMOR_FRAME_ID);
+
+}  // namespace rm_auto_aim
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "rm_auto_aim/detector/types.hpp"
+#include "rm_utils/rt_memory.hpp"
 
 namespace rm_auto_aim {
 
@@ -41,6 +42,11 @@ private:
      */
     void preprocess(const cv::Mat& input);
 
+    /**
+     * @brief 按输入尺寸准备中间图像（尺寸不变时逐帧复用，实时内存模式下使用大页）
+     */
+    void ensureScratch(const cv::Size& size);
+
     /**
      * @brief 检测灯条
      * @param detect_color 目标颜色
@@ -78,8 +84,11 @@ private:
         const std::vector<Light>& lights) const;
 
     DetectorParams params_;
+    cv::Mat gray_;
     cv::Mat binary_;
     cv::Mat debug_img_;
+    HugePageBuffer scratch_;           // gray_/binary_的大页后备存储
+    mutable cv::Mat color_mask_;       // 灯条颜色判定掩码（外接矩形大小）
 };
 
 }  // namespace rm_auto_aim
@@ -28,7 +28,25 @@ public:
      * @param yaw [out] 偏航角(弧度)
      * @return 解算是否成功
      */
-    bool solve(const Armor& armor, cv::Mat& rvec, cv::Mat& tvec, double& yaw);
+    bool solve(const Armor& armor, cv::Mat& rvec, cv::Mat& tvec, double& yaw) const;
+
+    /**
+     * @brief 解算装甲板位姿并直接填写核心观测类型
+     * @param armor 检测到的装甲板
+     * @param img_center 图像中心（用于计算到中心距离）
+     * @param observation [out] 相机坐标系下的装甲板观测
+     * @return 解算是否成功
+     */
+    bool solve(const Armor& armor, const cv::Point2f& img_center,
+               ArmorObservation& observation) const;
+
+    /**
+     * @brief 批量解算一帧的全部装甲板（多块时在任务池HOT类别上并行），结果按检测顺序写入
+     * @param observations [out] 解算成功的装甲板观测（stamp_ns保持不变）
+     * @return 因超出定长上限而丢弃的装甲板数
+     */
+    size_t solveAll(const std::vector<Armor>& armors, const cv::Point2f& img_center,
+                    ArmorObservations& observations) const;
 
     /**
      * @brief 从旋转矩阵提取yaw角
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "rm_auto_aim/core/armor_types.hpp"
+
 namespace rm_auto_aim {
 
 // 装甲板尺寸常量 (mm)
@@ -11,31 +13,6 @@ constexpr double SMALL_ARMOR_WIDTH = 133.0;
 constexpr double LARGE_ARMOR_WIDTH = 227.0;
 constexpr double ARMOR_HEIGHT = 56.0;
 
-// 颜色枚举
-enum class Color : uint8_t {
-    BLUE = 0,
-    RED = 1,
-};
-
-// 装甲板类型
-enum class ArmorType : uint8_t {
-    SMALL = 0,
-    LARGE = 1,
-};
-
-// 装甲板编号/符号
-enum class ArmorSymbol : uint8_t {
-    UNKNOWN = 0,
-    HERO = 1,       // 1号英雄
-    ENGINEER = 2,   // 2号工程
-    INFANTRY_3 = 3, // 3号步兵
-    INFANTRY_4 = 4, // 4号步兵
-    INFANTRY_5 = 5, // 5号步兵
-    SENTRY = 6,     // 哨兵
-    OUTPOST = 7,    // 前哨站
-    BASE = 8,       // 基地
-};
-
 // 灯条结构体
 struct Light : public cv::RotatedRect {
     Light() = default;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <string>
+
+#include "rm_auto_aim/detector/detector.hpp"
+#include "rm_auto_aim/detector/pnp_solver.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 相机标定（内参 + 畸变 + 图像尺寸）
+ */
+struct CameraCalibration {
+    cv::Mat camera_matrix;   // 3x3 CV_64F
+    cv::Mat dist_coeffs;     // 1xN CV_64F
+    int width = 0;
+    int height = 0;
+
+    bool valid() const {
+        return camera_matrix.rows == 3 && camera_matrix.cols == 3 &&
+               camera_matrix.at<double>(0, 0) > 0.0 && camera_matrix.at<double>(1, 1) > 0.0;
+    }
+
+    /**
+     * @brief 图像尺寸；未知时由主点位置估计
+     */
+    cv::Size imageSize() const;
+
+    bool sameAs(const CameraCalibration& other) const;
+};
+
+/**
+ * @brief 由参数数组构造标定（fx<=0视为未配置）
+ */
+CameraCalibration calibrationFromArrays(
+    const std::vector<double>& camera_matrix, const std::vector<double>& dist_coeffs,
+    int width, int height);
+
+/**
+ * @brief 读写标定缓存文件（OpenCV FileStorage YAML），路径支持 ~ 展开
+ */
+bool loadCalibrationCache(const std::string& path, CameraCalibration& calibration);
+bool saveCalibrationCache(const std::string& path, const CameraCalibration& calibration);
+
+/**
+ * @brief 生成含一块目标颜色装甲板（两根竖直灯条）的合成图像
+ */
+cv::Mat makeWarmupFrame(const cv::Size& size, Color color);
+
+/**
+ * @brief 用合成帧预热 检测 → PnP → 观测组装
+ *
+ * 触发OpenCV各函数的延迟初始化、中间图像与容器的首次分配，
+ * 让第一帧真实图像以稳态延迟处理。pnp_solver为空时只预热检测。
+ * @return 最后一次预热输出的装甲板（count为0说明合成帧未通过当前检测阈值，
+ *         检测与预处理路径仍已预热）
+ */
+ArmorObservations warmUpDetection(
+    ArmorDetector& detector, PnPSolver* pnp_solver, const cv::Size& size,
+    Color color, int iterations);
+
+}  // namespace rm_auto_aim
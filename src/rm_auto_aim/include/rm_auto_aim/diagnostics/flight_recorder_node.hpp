@@ -0,0 +1,38 @@
+#pragma once
+
+#include <rclcpp/rclcpp.hpp>
+#include <std_srvs/srv/trigger.hpp>
+
+#include "rm_utils/flight_recorder.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 飞行记录器控制节点
+ *
+ * 启动进程内FlightRecorder的后台转储线程，三种触发方式：
+ *   - ~/dump 服务：立即转储并返回文件路径
+ *   - SIGUSR1 信号：kill -USR1 <pid>
+ *   - 跟踪器进入LOST（dump_on_lost，按min_dump_interval_s限频）
+ * 转储文件用 `ros2 run rm_utils flight_recorder_decode <file>` 解码。
+ * 需与被记录的节点位于同一进程。
+ */
+class FlightRecorderNode : public rclcpp::Node {
+public:
+    explicit FlightRecorderNode(const rclcpp::NodeOptions& options);
+    ~FlightRecorderNode() override;
+
+private:
+    void dumpCallback(
+        const std_srvs::srv::Trigger::Request::SharedPtr request,
+        std_srvs::srv::Trigger::Response::SharedPtr response);
+
+    static void signalHandler(int signum);
+
+    double window_s_ = 10.0;
+    bool signal_installed_ = false;
+
+    rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr dump_srv_;
+};
+
+}  // namespace rm_auto_aim
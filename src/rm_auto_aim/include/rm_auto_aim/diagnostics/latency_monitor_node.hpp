@@ -0,0 +1,57 @@
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <std_srvs/srv/trigger.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "rm_utils/alloc_tracker.hpp"
+#include "rm_utils/latency_tracer.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 端到端延迟监视节点
+ *
+ * 定期读取进程内LatencyTracer的直方图，把上一周期窗口内各计时点的
+ * 分位数发布到 /diagnostics；~/dump 服务返回并打印启动以来的累计统计。
+ * 需与被追踪的节点位于同一进程（同一组件容器或融合流水线进程）。
+ * 加载了分配计数钩子（librm_alloc_hooks.so）时同时发布各阶段每帧堆分配次数。
+ */
+class LatencyMonitorNode : public rclcpp::Node {
+public:
+    explicit LatencyMonitorNode(const rclcpp::NodeOptions& options);
+
+private:
+    using Snapshots = std::array<LatencyHistogram::Snapshot, TRACE_STAGE_COUNT>;
+
+    void publishDiagnostics();
+    void dumpCallback(
+        const std_srvs::srv::Trigger::Request::SharedPtr request,
+        std_srvs::srv::Trigger::Response::SharedPtr response);
+
+    /**
+     * @brief 文本表格：每个计时点的累计延迟和阶段耗时分位数（ms）
+     */
+    static std::string formatTable(const Snapshots& since_capture, const Snapshots& stage_delta);
+
+    /**
+     * @brief 各阶段窗口内每帧分配次数/字节数与具名线程分配计数，超出预算时告警
+     */
+    diagnostic_msgs::msg::DiagnosticStatus allocationStatus();
+
+    Snapshots prev_since_capture_;
+    Snapshots prev_stage_delta_;
+    std::array<AllocTracker::FrameStats, ALLOC_TAG_COUNT> prev_alloc_frames_{};
+    std::vector<AllocTracker::ThreadEntry> prev_alloc_threads_;
+    int64_t alloc_budget_per_frame_ = 0;
+
+    rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+    rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr dump_srv_;
+    rclcpp::TimerBase::SharedPtr timer_;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rm_interfaces/msg/target.hpp"
+#include "rm_utils/latency_histogram.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 合成负载发生器（吞吐上限测试）
+ *
+ * 代替相机发布合成 /image_raw（可配分辨率与干扰物数量）和锁存的 /camera_info，
+ * 订阅解算输出 /solver/target（每帧一条，时间戳即本节点发布时刻）统计端到端延迟与丢帧。
+ * 帧率从start_fps起按ramp_factor逐级提升（上限max_fps），每级持续step_duration_s，
+ * 某级p99延迟或丢帧率超过阈值即停止提升，再在最后通过与首次失败之间二分细化，
+ * 得到当前部署方式（config_label：独立进程/同容器/进程内通信）下可持续的帧率。
+ * 结果打印到日志、发布到 /diagnostics（auto_aim/load_generator），
+ * report_path非空时以一行JSON追加写入，便于汇总比较不同部署方式。
+ */
+class LoadGeneratorNode : public rclcpp::Node {
+public:
+    explicit LoadGeneratorNode(const rclcpp::NodeOptions& options);
+    ~LoadGeneratorNode() override;
+
+private:
+    /**
+     * @brief 单级测量结果
+     */
+    struct StepResult {
+        double target_fps = 0.0;
+        double achieved_fps = 0.0;   // 实际发布帧率（发生器自身跟不上时低于目标）
+        uint64_t published = 0;
+        uint64_t received = 0;
+        double drop_rate = 0.0;
+        double p50_ms = 0.0;
+        double p99_ms = 0.0;
+        double max_ms = 0.0;
+        bool passed = false;
+    };
+
+    /**
+     * @brief 预渲染合成帧（目标装甲板水平移动 + 随机干扰灯条/色块），测量期间只做拷贝
+     */
+    void renderFrames();
+
+    void publishCameraInfo();
+
+    /**
+     * @brief 发布线程：等待下游就绪 → 逐级提升帧率 → 二分细化 → 汇报
+     */
+    void generatorLoop();
+
+    /**
+     * @brief 以fps发布duration_s秒后停止发布、等待settle_s收齐结果，返回本级统计
+     */
+    StepResult runStep(double fps, double duration_s);
+
+    /**
+     * @brief 按fps节奏发布直到deadline；返回实际发布帧数
+     */
+    uint64_t publishUntil(double fps, std::chrono::steady_clock::time_point deadline);
+
+    void publishFrame();
+
+    void targetCallback(const rm_interfaces::msg::Target::ConstSharedPtr& msg);
+
+    void report(const std::vector<StepResult>& steps, double sustainable_fps);
+    void publishStatus(const StepResult& step, double sustainable_fps, bool finished);
+
+    // 配置
+    int width_;
+    int height_;
+    int clutter_;
+    int variants_;
+    int target_color_;
+    double start_fps_;
+    double max_fps_;
+    double ramp_factor_;
+    int refine_steps_;
+    double step_duration_s_;
+    double warmup_s_;
+    double settle_s_;
+    double ready_timeout_s_;
+    double latency_threshold_ms_;
+    double drop_threshold_;
+    std::string config_label_;
+    std::string report_path_;
+    bool shutdown_on_finish_;
+
+    std::vector<cv::Mat> frames_;
+    size_t next_frame_ = 0;
+    sensor_msgs::msg::CameraInfo camera_info_msg_;
+
+    // 结果统计：只计入时间戳不早于本级开始时刻的结果
+    std::atomic<int64_t> step_start_ns_{0};
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> total_received_{0};
+    LatencyHistogram latency_;
+
+    std::atomic<bool> running_{false};
+    std::thread generator_thread_;
+
+    // ROS接口
+    rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr image_pub_;
+    rclcpp::Publisher<sensor_msgs::msg::CameraInfo>::SharedPtr camera_info_pub_;
+    rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+    rclcpp::Subscription<rm_interfaces::msg::Target>::SharedPtr target_sub_;
+};
+
+}  // namespace rm_auto_aim
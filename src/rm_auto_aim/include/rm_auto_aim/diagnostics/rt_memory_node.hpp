@@ -0,0 +1,36 @@
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <std_srvs/srv/trigger.hpp>
+
+#include "rm_utils/rt_memory.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 实时内存模式节点
+ *
+ * enable为true时在构造中开启进程级实时内存模式（mlockall、堆/栈预触碰、大页缓冲），
+ * 因此必须最先加载（容器中排在相机节点之前，流水线进程中先于流水线创建）。
+ * 无论是否开启，都定期把常驻/锁定/大页内存与缺页计数发布到 /diagnostics；
+ * 运行期缺页计数仍在增长说明还有未预分配的路径。~/report 服务返回当前报告。
+ */
+class RtMemoryNode : public rclcpp::Node {
+public:
+    explicit RtMemoryNode(const rclcpp::NodeOptions& options);
+
+private:
+    void publishReport();
+    void reportCallback(
+        const std_srvs::srv::Trigger::Request::SharedPtr request,
+        std_srvs::srv::Trigger::Response::SharedPtr response);
+
+    MemoryReport prev_report_;
+
+    rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+    rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr report_srv_;
+    rclcpp::TimerBase::SharedPtr timer_;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include <array>
+
+#include "rm_utils/task_pool.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 进程级任务池配置节点
+ *
+ * 构造时按参数启动全局任务池（各优先级类别的线程数、CPU集合与调度策略），
+ * 须在检测/解算节点之前加载（容器中紧随rt_memory，流水线进程中先于流水线创建），
+ * 之后各模块提交的任务都在这组线程上执行，不再自建线程。
+ * 定期把各类别的提交/执行/窃取/排队计数发布到 /diagnostics（auto_aim/task_pool）。
+ */
+class TaskPoolNode : public rclcpp::Node {
+public:
+    explicit TaskPoolNode(const rclcpp::NodeOptions& options);
+
+private:
+    void publishStats();
+
+    size_t hot_pending_warn_ = 16;
+    std::array<TaskPool::ClassStats, TASK_PRIORITY_COUNT> prev_stats_;
+
+    rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+    rclcpp::TimerBase::SharedPtr timer_;
+};
+
+}  // namespace rm_auto_aim
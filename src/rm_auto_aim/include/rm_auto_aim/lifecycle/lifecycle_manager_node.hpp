@@ -0,0 +1,88 @@
+#pragma once
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <lifecycle_msgs/srv/change_state.hpp>
+#include <lifecycle_msgs/srv/get_state.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include <string>
+#include <vector>
+
+#include "rm_interfaces/msg/gimbal_cmd.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 生命周期管理节点：按就绪情况逐级激活相机/检测/解算/串口
+ *
+ * 所有受管节点同时开始configure（打开设备、加载内参、预热并行进行），
+ * configure成功即视为就绪；失败的节点按retry_period_s重试（设备还在枚举、内参未到）。
+ * 一个节点在自身就绪且depends_on中的节点全部激活后立即activate，
+ * 不再依赖固定的启动延时。默认依赖链使下游先激活：串口 → 解算 → 检测 → 相机，
+ * 相机出第一帧时整条链路已可输出命令。
+ *
+ * 全部激活后继续监督：按supervise_period_s查询各节点状态，节点崩溃重启（回到未配置）
+ * 或被外部停用时重新纳入上述流程。服务请求超过request_timeout_s未返回（节点卡死或
+ * 请求途中崩溃）即放弃该请求并重新查询状态，不会永远等待。
+ *
+ * 统计并报告进程启动到各节点就绪/激活、全部激活、首条云台命令的时间
+ * （日志 + /diagnostics 上的 auto_aim/startup）。
+ */
+class LifecycleManagerNode : public rclcpp::Node {
+public:
+    explicit LifecycleManagerNode(const rclcpp::NodeOptions& options);
+
+private:
+    enum class Phase : uint8_t {
+        UNKNOWN,      // 尚未查询状态
+        UNCONFIGURED,
+        CONFIGURED,   // 就绪（inactive）
+        ACTIVE,
+    };
+
+    struct Stage {
+        std::string name;
+        std::vector<size_t> depends_on;
+        bool required = true;  // false: 配置失败时不阻塞依赖它的节点
+        rclcpp::Client<lifecycle_msgs::srv::GetState>::SharedPtr get_state;
+        rclcpp::Client<lifecycle_msgs::srv::ChangeState>::SharedPtr change_state;
+        Phase phase = Phase::UNKNOWN;
+        bool pending = false;        // 有未返回的服务请求
+        bool pending_get_state = false;  // 未返回的是GetState（否则为ChangeState）
+        int64_t pending_request_id = 0;
+        double pending_since_s = 0.0;
+        double check_at_s = 0.0;     // 激活后下次查询状态的时刻
+        int configure_attempts = 0;
+        bool configure_failed = false;
+        double retry_at_s = 0.0;     // 下次重试时刻（进程启动后秒数）
+        double configured_s = -1.0;
+        double active_s = -1.0;
+    };
+
+    /**
+     * @brief 周期推进各节点的状态机
+     */
+    void step();
+    void queryState(size_t index);
+    void requestTransition(size_t index, uint8_t transition_id);
+    void onTransitionDone(size_t index, uint8_t transition_id, bool success);
+    // 放弃超时未返回的请求，稍后重新查询状态
+    void abandonRequest(size_t index, double now_s);
+    bool dependenciesSatisfied(const Stage& stage) const;
+
+    void firstCommandCallback(const rm_interfaces::msg::GimbalCmd::ConstSharedPtr& msg);
+    void publishReport();
+
+    std::vector<Stage> stages_;
+    double retry_period_s_ = 0.5;
+    double request_timeout_s_ = 10.0;
+    double supervise_period_s_ = 0.5;
+    double all_active_s_ = -1.0;   // 必需节点全部激活的时刻
+    double first_command_s_ = -1.0;
+
+    rclcpp::TimerBase::SharedPtr step_timer_;
+    rclcpp::Subscription<rm_interfaces::msg::GimbalCmd>::SharedPtr first_command_sub_;
+    rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <opencv2/videoio.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include "rm_auto_aim/detector/detector.hpp"
+#include "rm_auto_aim/detector/pnp_solver.hpp"
+#include "rm_auto_aim/solver/armor_solver.hpp"
+#include "rm_hardware_driver/serial_port.hpp"
+#include "rm_interfaces/msg/compact_armors.hpp"
+#include "rm_interfaces/msg/gimbal_cmd.hpp"
+#include "rm_interfaces/msg/target.hpp"
+#include "rm_utils/rt_memory.hpp"
+#include "rm_utils/spsc_queue.hpp"
+#include "rm_utils/thread_placement.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 单进程快速通路自瞄流水线（比赛模式）
+ *
+ * 三个专用线程，通过有界无锁SPSC队列串联，关键路径上不经过ROS执行器：
+ *   采集线程: VideoCapture → 预分配图像
+ *   检测线程: ArmorDetector + PnPSolver
+ *   解算线程: ArmorTracker + TrajectoryCompensator → 串口直接写入
+ *
+ * 检测/解算结果经旁路队列交给ROS定时器发布（/detector/armors、
+ * /solver/target、/solver/gimbal_cmd），仅用于观测和录制。
+ * 队列满时丢弃新数据并计数，不阻塞上游。
+ */
+class AutoAimPipeline : public rclcpp::Node {
+public:
+    /**
+     * @throws std::runtime_error 相机/视频源无法打开（不留下无线程的半初始化节点，
+     *         由进程退出码交给launch重启重试）
+     */
+    explicit AutoAimPipeline(const rclcpp::NodeOptions& options);
+    ~AutoAimPipeline() override;
+
+private:
+    // 采集帧（图像内存在空闲队列和就绪队列之间循环复用）
+    struct Frame {
+        cv::Mat image;
+        int64_t stamp_ns = 0;
+        uint64_t seq = 0;
+    };
+
+    // 检测结果（核心类型，关键路径上不构造ROS消息）
+    struct Detection {
+        ArmorObservations armors;
+        uint64_t seq = 0;
+    };
+
+    // 旁路观测数据（装甲板在ROS执行器线程中才转换为消息）
+    struct Observation {
+        ArmorObservations armors;
+        rm_interfaces::msg::Target target;
+        rm_interfaces::msg::GimbalCmd gimbal_cmd;
+        bool has_cmd = false;
+    };
+
+    void declareParameters();
+    DetectorParams loadDetectorParams();
+    SolverParams loadSolverParams();
+    bool openCamera();
+    void openSerial();
+
+    // 各级线程主循环
+    void captureLoop();
+    void detectLoop();
+    void solveLoop();
+    void placeCurrentThread(ThreadPlacement placement, const std::string& name);
+
+    // ROS旁路发布（执行器线程）
+    void publishObservations();
+
+    // 相机
+    cv::VideoCapture cap_;
+    std::string video_path_;
+    int fps_ = 30;
+    bool use_driver_timestamp_ = true;
+    int64_t timestamp_offset_ns_ = 0;
+
+    // 算法
+    std::unique_ptr<ArmorDetector> detector_;
+    std::unique_ptr<PnPSolver> pnp_solver_;
+    std::unique_ptr<ArmorSolver> solver_;
+    Color detect_color_ = Color::RED;
+
+    // 串口
+    SerialPort serial_;
+
+    // 级间队列
+    std::unique_ptr<SpscQueue<Frame>> free_frames_;     // 检测 → 采集（回收图像内存）
+    std::unique_ptr<SpscQueue<Frame>> ready_frames_;    // 采集 → 检测
+    std::unique_ptr<SpscQueue<Detection>> detections_;  // 检测 → 解算
+    std::unique_ptr<SpscQueue<Observation>> observations_;  // 解算 → ROS发布
+    std::vector<HugePageBuffer> frame_storage_;  // 实时内存模式下图像帧的大页后备存储
+
+    // 线程
+    std::atomic<bool> running_{false};
+    std::thread capture_thread_;
+    std::thread detect_thread_;
+    std::thread solve_thread_;
+
+    // 各级线程的CPU亲和性与实时优先级（解算线程同时负责串口写）
+    ThreadPlacement capture_placement_;
+    ThreadPlacement detect_placement_;
+    ThreadPlacement solve_placement_;
+
+    // 解算遥测（可选，刷写线程按threads.telemetry放置）
+    std::unique_ptr<TelemetryWriter> telemetry_;
+    ThreadPlacement telemetry_placement_;
+
+    // 统计
+    std::atomic<uint64_t> captured_{0};
+    std::atomic<uint64_t> capture_drops_{0};
+    std::atomic<uint64_t> detect_drops_{0};
+    std::atomic<uint64_t> serial_writes_{0};
+
+    // ROS旁路发布
+    bool publish_observations_ = true;
+    rclcpp::Publisher<rm_interfaces::msg::CompactArmors>::SharedPtr armors_pub_;
+    rclcpp::Publisher<rm_interfaces::msg::Target>::SharedPtr target_pub_;
+    rclcpp::Publisher<rm_interfaces::msg::GimbalCmd>::SharedPtr gimbal_cmd_pub_;
+    rclcpp::TimerBase::SharedPtr publish_timer_;
+};
+
+}  // namespace rm_auto_aim
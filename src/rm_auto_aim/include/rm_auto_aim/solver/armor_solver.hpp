@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include "rm_auto_aim/solver/armor_tracker.hpp"
+#include "rm_auto_aim/solver/solver_telemetry.hpp"
+#include "rm_auto_aim/solver/utils/trajectory_compensator.hpp"
+
+namespace rm_auto_aim {
+
+// 解算参数
+struct SolverParams {
+    // 弹道参数
+    double bullet_speed = 30.0;
+    double gravity = 9.82;
+    double resistance = 0.092;
+
+    // 反陀螺参数
+    double max_tracking_v_yaw = 60.0;   // 角速度阈值
+    double side_angle = 15.0;           // 切换角度阈值(度)
+    double coming_angle = 1.222;        // 小陀螺出现角 (70°)
+    double leaving_angle = 0.524;       // 小陀螺消失角 (30°)
+
+    // 跟踪器参数
+    double max_match_distance = 0.5;
+    double max_match_yaw_diff = 0.67;
+    int tracking_thres = 3;
+    double lost_time_thres = 3.05;
+
+    // EKF过程噪声
+    double sigma2_q_x = 0.008;
+    double sigma2_q_y = 0.008;
+    double sigma2_q_z = 0.008;
+    double sigma2_q_yaw = 1.30;
+    double sigma2_q_r = 98.0;
+    // EKF观测噪声
+    double r_x = 0.0005;
+    double r_y = 0.0005;
+    double r_z = 0.0005;
+    double r_yaw = 0.005;
+};
+
+// 单帧解算输出的云台控制量
+struct GimbalCommand {
+    bool valid = false;    // 是否处于跟踪状态（有有效瞄准点）
+    double yaw = 0.0;      // rad
+    double pitch = 0.0;    // rad
+    bool fire = false;
+    Eigen::Vector3d aim_point = Eigen::Vector3d::Zero();
+};
+
+/**
+ * @brief 装甲板解算器
+ *
+ * 单帧解算流程：EKF跟踪 → 瞄准点选择（反陀螺策略）→ 弹道补偿 → 手动补偿。
+ * 只依赖核心类型（core/armor_types.hpp），不持有任何ROS实体，
+ * 解算节点和融合流水线共用同一份实现。
+ */
+class ArmorSolver {
+public:
+    explicit ArmorSolver(const SolverParams& params);
+
+    /**
+     * @brief 更新参数（弹道补偿器、跟踪器与EKF噪声同步更新，跟踪状态保留）
+     */
+    void setParams(const SolverParams& params);
+
+    /**
+     * @brief 执行单帧解算
+     * @param armors 当前帧检测结果
+     * @param dt 距上一帧的时间间隔(秒)
+     * @return 云台控制量，未跟踪时valid为false
+     */
+    GimbalCommand solve(const ArmorObservations& armors, double dt);
+
+    /**
+     * @brief 用合成观测预热 跟踪 → 瞄准点 → 弹道补偿 路径，结束后跟踪器回到LOST
+     *
+     * 合成帧时间戳为0，不计入延迟统计。
+     * @return 预热过程中是否进入过跟踪状态（即补偿路径已执行）
+     */
+    bool warmUp(int iterations);
+
+    /**
+     * @brief 设置遥测写入器，之后每帧真实数据追加一条SolverTelemetryRecord
+     * @param writer 由调用方持有，nullptr关闭遥测；须在解算线程之外切换时先停止解算
+     */
+    void setTelemetry(TelemetryWriter* writer) { telemetry_ = writer; }
+
+    const ArmorTracker& tracker() const { return tracker_; }
+    ManualCompensator& manualCompensator() { return manual_compensator_; }
+
+private:
+    /**
+     * @brief 汇总本帧跟踪器内部状态与输出，追加到遥测写入器（只做拷贝入队）
+     */
+    void recordTelemetry(const ArmorObservations& armors, double dt, const GimbalCommand& cmd);
+
+    /**
+     * @brief 根据EKF状态计算瞄准点
+     * @param state EKF状态向量
+     * @param v_yaw 目标角速度
+     * @return 瞄准点三维坐标
+     */
+    Eigen::Vector3d calcAimPoint(const ArmorEKF::StateVec& state, double v_yaw);
+
+    /**
+     * @brief 判断是否为小陀螺状态
+     */
+    bool isSmallGyro(double v_yaw) const;
+
+    /**
+     * @brief 选择最优装甲板（反陀螺策略）
+     * @param state EKF状态向量
+     * @param armors_num 目标装甲板数量
+     * @return 选中的装甲板三维坐标
+     */
+    Eigen::Vector3d selectBestArmor(
+        const ArmorEKF::StateVec& state, int armors_num);
+
+    SolverParams params_;
+
+    // 跟踪器
+    ArmorTracker tracker_;
+
+    // 弹道补偿器
+    TrajectoryCompensator trajectory_compensator_;
+    ManualCompensator manual_compensator_;
+
+    TelemetryWriter* telemetry_ = nullptr;
+};
+
+}  // namespace rm_auto_aim
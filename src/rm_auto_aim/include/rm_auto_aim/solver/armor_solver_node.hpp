@@ -1,12 +1,18 @@
 #pragma once
 
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
 
-#include "rm_auto_aim/solver/armor_tracker.hpp"
-#include "rm_auto_aim/solver/utils/trajectory_compensator.hpp"
-#include "rm_interfaces/msg/armors.hpp"
+#include <atomic>
+#include <thread>
+
+#include "rm_auto_aim/solver/armor_solver.hpp"
+#include "rm_auto_aim/solver/camera_fusion.hpp"
+#include "rm_interfaces/msg/compact_armors.hpp"
 #include "rm_interfaces/msg/gimbal_cmd.hpp"
 #include "rm_interfaces/msg/target.hpp"
+#include "rm_utils/rcu_cell.hpp"
+#include "rm_utils/thread_placement.hpp"
 
 namespace rm_auto_aim {
 
@@ -18,71 +24,119 @@ namespace rm_auto_aim {
  * 2. 瞄准目标选择（反陀螺策略）
  * 3. 弹道补偿
  * 4. 输出云台控制指令
+ *
+ * 多相机时各相机的检测结果经CameraFusion变换到参考相机坐标系后送入同一个跟踪器，
+ * 外参由camera_extrinsics参数给出（每相机6个数，顺序与检测节点camera_topics一致）。
+ * 每收到一帧检测结果都发布一条 /solver/target（时间戳取该帧）：融合拒收的帧（迟到帧、
+ * 非目标相机的空帧）不更新跟踪器、不发云台命令，但仍以当前跟踪状态发布，
+ * 锁步回放的相机据此确认每一帧，多相机锁步不会因拒收帧而超时。
+ *
+ * 装甲板订阅位于独立回调组，由节点自己的单线程执行器在专用线程中执行，
+ * 解算不与容器线程池中的日志、调试、参数服务回调竞争。
+ *
+ * 跟踪器、EKF噪声、弹道与反陀螺参数（ekf.* / tracker.* / solver.*）支持运行时修改：
+ * 参数回调在当前配置副本上应用修改并校验，整体发布为新的不可变配置（RCU指针交换），
+ * 解算线程每帧无锁读取配置版本，变化时在两帧之间整体替换解算参数，跟踪状态保留。
+ *
+ * 生命周期: configure 创建解算器并预热，activate 启动解算线程，
+ * deactivate 停止解算线程，cleanup 释放解算器与通信实体。
  */
-class ArmorSolverNode : public rclcpp::Node {
+class ArmorSolverNode : public rclcpp_lifecycle::LifecycleNode {
 public:
+    using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+
     explicit ArmorSolverNode(const rclcpp::NodeOptions& options);
+    ~ArmorSolverNode() override;
+
+    CallbackReturn on_configure(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_activate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_deactivate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_cleanup(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_shutdown(const rclcpp_lifecycle::State& state) override;
 
 private:
+    /**
+     * @brief 停止解算线程
+     */
+    void stopSolving();
+
+    /**
+     * @brief 释放解算器、执行器与通信实体
+     */
+    void releaseResources();
+
     /**
      * @brief 装甲板检测结果回调
      */
-    void armorsCallback(const rm_interfaces::msg::Armors::ConstSharedPtr& msg);
+    void armorsCallback(const rm_interfaces::msg::CompactArmors::ConstSharedPtr& msg);
+
+    /**
+     * @brief 以当前跟踪器状态发布Target（tracking为false时只发布时间戳与丢失标志）
+     */
+    void publishTarget(const builtin_interfaces::msg::Time& stamp, bool tracking);
 
     /**
      * @brief 声明并加载参数
      */
     void declareParameters();
-    void loadParams();
+    SolverParams loadParams();
 
     /**
-     * @brief 根据EKF状态计算瞄准点
-     * @param state EKF状态向量
-     * @param v_yaw 目标角速度
-     * @return 瞄准点三维坐标
+     * @brief 参数修改回调：可热更新的参数发布为新配置，其余参数下次configure生效
      */
-    Eigen::Vector3d calcAimPoint(const Eigen::VectorXd& state, double v_yaw);
+    rcl_interfaces::msg::SetParametersResult onParametersSet(
+        const std::vector<rclcpp::Parameter>& params);
 
     /**
-     * @brief 判断是否为小陀螺状态
+     * @brief 读取camera_extrinsics并设置融合外参，格式错误返回false
      */
-    bool isSmallGyro(double v_yaw) const;
+    bool loadExtrinsics();
 
     /**
-     * @brief 选择最优装甲板（反陀螺策略）
-     * @param state EKF状态向量
-     * @param armors_num 目标装甲板数量
-     * @return 选中的装甲板三维坐标
+     * @brief 按telemetry.*参数打开解算遥测文件并挂到解算器上
      */
-    Eigen::Vector3d selectBestArmor(
-        const Eigen::VectorXd& state, int armors_num);
+    void openTelemetry();
 
-    // 跟踪器
-    std::unique_ptr<ArmorTracker> tracker_;
+    /**
+     * @brief 从解算器摘下并关闭遥测文件（解算线程须已停止）
+     */
+    void closeTelemetry();
 
-    // 弹道补偿器
-    TrajectoryCompensator trajectory_compensator_;
-    ManualCompensator manual_compensator_;
+    /**
+     * @brief 对当前线程应用放置配置并记录结果
+     */
+    void placeCurrentThread(ThreadPlacement placement, const std::string& name);
+
+    // 解算器（跟踪+反陀螺+弹道补偿）
+    std::unique_ptr<ArmorSolver> solver_;
+
+    // 可热更新的解算参数：参数回调发布，解算线程通过自己的读者句柄无锁读取
+    RcuCell<SolverParams> config_;
+    std::unique_ptr<RcuCell<SolverParams>::Reader> config_reader_;
+    uint64_t applied_config_version_ = 0;   // 解算器当前使用的配置版本（仅解算线程访问）
+    OnSetParametersCallbackHandle::SharedPtr param_callback_;
+
+    // 解算专用执行器：回调组不加入容器执行器，由solve_thread_独占执行
+    rclcpp::CallbackGroup::SharedPtr solve_group_;
+    rclcpp::executors::SingleThreadedExecutor::SharedPtr solve_executor_;
+    std::thread solve_thread_;
+    std::atomic<bool> solving_{false};
+    ThreadPlacement solve_placement_;
 
     // 订阅与发布
-    rclcpp::Subscription<rm_interfaces::msg::Armors>::SharedPtr armors_sub_;
-    rclcpp::Publisher<rm_interfaces::msg::Target>::SharedPtr target_pub_;
-    rclcpp::Publisher<rm_interfaces::msg::GimbalCmd>::SharedPtr gimbal_cmd_pub_;
-
-    // 时间戳管理
-    rclcpp::Time last_time_;
-    bool first_frame_ = true;
-
-    // 弹道参数
-    double bullet_speed_ = 30.0;
-    double gravity_ = 9.82;
-    double resistance_ = 0.092;
-
-    // 反陀螺参数
-    double max_tracking_v_yaw_ = 60.0;   // 角速度阈值
-    double side_angle_ = 15.0;            // 切换角度阈值(度)
-    double coming_angle_ = 1.222;         // 小陀螺出现角 (70°)
-    double leaving_angle_ = 0.524;        // 小陀螺消失角 (30°)
+    rclcpp::Subscription<rm_interfaces::msg::CompactArmors>::SharedPtr armors_sub_;
+    rclcpp_lifecycle::LifecyclePublisher<rm_interfaces::msg::Target>::SharedPtr target_pub_;
+    rclcpp_lifecycle::LifecyclePublisher<rm_interfaces::msg::GimbalCmd>::SharedPtr gimbal_cmd_pub_;
+
+    // 解算遥测（可选）：每帧跟踪器内部状态写入列式文件
+    std::unique_ptr<TelemetryWriter> telemetry_;
+    ThreadPlacement telemetry_placement_;
+
+    // 多相机融合前处理（坐标变换 + dt + 迟到/无信息帧过滤，仅解算线程访问）
+    CameraFusion fusion_;
+
+    // 节点边缘：定长消息 → 核心观测（仅解算线程访问，逐帧复用）
+    ArmorObservations observations_;
 
     // 调试
     bool debug_ = false;
@@ -1,12 +1,10 @@
 #pragma once
 
 #include <Eigen/Dense>
-#include <memory>
-#include <string>
+#include <cmath>
 
+#include "rm_auto_aim/core/armor_types.hpp"
 #include "rm_auto_aim/solver/utils/extended_kalman_filter.hpp"
-#include "rm_interfaces/msg/armor.hpp"
-#include "rm_interfaces/msg/armors.hpp"
 
 namespace rm_auto_aim {
 
@@ -20,6 +18,54 @@ enum class TrackerState : uint8_t {
     TEMP_LOST = 3,   // 临时丢失（掉帧处理）
 };
 
+/**
+ * @brief 整车运动模型：旋转中心匀速平移 + 匀角速度旋转
+ *
+ * 状态向量: [xc, v_xc, yc, v_yc, zc, v_zc, yaw, v_yaw, r, d_zc]
+ */
+struct ArmorMotionModel {
+    using StateVec = Eigen::Matrix<double, 10, 1>;
+
+    StateVec operator()(const StateVec& x, double dt) const {
+        StateVec x1 = x;
+        x1(0) += x(1) * dt;   // xc += v_xc * dt
+        x1(2) += x(3) * dt;   // yc += v_yc * dt
+        x1(4) += x(5) * dt;   // zc += v_zc * dt
+        x1(6) += x(7) * dt;   // yaw += v_yaw * dt
+        return x1;
+    }
+};
+
+/**
+ * @brief 装甲板观测模型：从旋转中心反推装甲板位置
+ *
+ * 观测向量: [x_armor, y_armor, z_armor, yaw]
+ */
+struct ArmorMeasureModel {
+    using StateVec = Eigen::Matrix<double, 10, 1>;
+
+    Eigen::Vector4d operator()(const StateVec& x) const {
+        Eigen::Vector4d z;
+        z(0) = x(0) - std::cos(x(6)) * x(8);  // x_armor = xc - r*cos(yaw)
+        z(1) = x(2) - std::sin(x(6)) * x(8);  // y_armor = yc - r*sin(yaw)
+        z(2) = x(4) + x(9);                   // z_armor = zc + d_zc
+        z(3) = x(6);                           // yaw
+        return z;
+    }
+
+    /**
+     * @brief 新息，yaw残差归一化到[-pi, pi]
+     */
+    Eigen::Vector4d residual(const Eigen::Vector4d& z, const Eigen::Vector4d& z_pred) const {
+        Eigen::Vector4d y = z - z_pred;
+        while (y(3) > M_PI) y(3) -= 2 * M_PI;
+        while (y(3) < -M_PI) y(3) += 2 * M_PI;
+        return y;
+    }
+};
+
+using ArmorEKF = ExtendedKalmanFilter<10, 4, ArmorMotionModel, ArmorMeasureModel>;
+
 /**
  * @brief 装甲板跟踪器
  *
@@ -53,7 +99,12 @@ public:
      * @param armors 当前帧检测结果
      * @param dt 距上一帧的时间间隔
      */
-    void update(const rm_interfaces::msg::Armors& armors, double dt);
+    void update(const ArmorObservations& armors, double dt);
+
+    /**
+     * @brief 直接回到LOST（不触发状态转移记录与转储，用于启动预热后清场）
+     */
+    void reset();
 
     /**
      * @brief 获取当前跟踪状态
@@ -61,14 +112,29 @@ public:
     TrackerState state() const { return state_; }
 
     /**
-     * @brief 获取跟踪目标ID
+     * @brief 获取跟踪目标编号
      */
-    std::string trackedId() const { return tracked_id_; }
+    ArmorSymbol trackedSymbol() const { return tracked_symbol_; }
 
     /**
      * @brief 获取EKF状态向量
      */
-    Eigen::VectorXd getState() const { return ekf_->state(); }
+    const ArmorEKF::StateVec& getState() const { return ekf_.state(); }
+
+    /**
+     * @brief 获取EKF协方差矩阵
+     */
+    const ArmorEKF::StateMat& covariance() const { return ekf_.covariance(); }
+
+    /**
+     * @brief 最近一次EKF更新的新息（仅当lastMatchIndex() >= 0时属于当前帧）
+     */
+    const Eigen::Vector4d& lastInnovation() const { return ekf_.innovation(); }
+
+    /**
+     * @brief 当前帧关联到的观测索引，-1表示本帧未做关联或未匹配
+     */
+    int lastMatchIndex() const { return last_match_idx_; }
 
     /**
      * @brief 获取目标装甲板数量（用于旋转模型）
@@ -79,32 +145,28 @@ private:
     /**
      * @brief 初始化EKF
      */
-    void initEKF(const rm_interfaces::msg::Armor& armor);
+    void initEKF(const ArmorObservation& armor);
 
     /**
-     * @brief 匹配装甲板（关联检测和跟踪）
-     * @param armors 检测到的装甲板
-     * @return 匹配到的装甲板索引，-1表示未匹配
+     * @brief 用匹配到的装甲板更新EKF（同时记录观测新息）
      */
-    int matchArmor(const rm_interfaces::msg::Armors& armors);
+    void updateEKF(const ArmorObservation& armor);
 
     /**
-     * @brief 状态转移函数 (运动模型)
-     */
-    static Eigen::VectorXd predictFunc(const Eigen::VectorXd& x, double dt);
-
-    /**
-     * @brief 观测函数 (从旋转中心反推装甲板位置)
+     * @brief 匹配装甲板（关联检测和跟踪）
+     * @param armors 检测到的装甲板
+     * @return 匹配到的装甲板索引，-1表示未匹配
      */
-    static Eigen::Vector4d measureFunc(const Eigen::VectorXd& x);
+    int matchArmor(const ArmorObservations& armors);
 
-    // EKF
-    std::unique_ptr<ExtendedKalmanFilter> ekf_;
+    // EKF（定长，随跟踪器一起分配）
+    ArmorEKF ekf_;
 
     // 跟踪状态
     TrackerState state_ = TrackerState::LOST;
-    std::string tracked_id_;
+    ArmorSymbol tracked_symbol_ = ArmorSymbol::UNKNOWN;
     int target_armors_num_ = 4;   // 默认步兵4块甲
+    int last_match_idx_ = -1;
 
     // 状态计数器
     int detect_count_ = 0;
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Eigen/Geometry>
+#include <cstdint>
+#include <vector>
+
+#include "rm_auto_aim/core/armor_types.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 相机外参：某相机光学坐标系 → 参考相机（0号）光学坐标系
+ */
+struct CameraExtrinsic {
+    Eigen::Quaterniond rotation = Eigen::Quaterniond::Identity();
+    Eigen::Vector3d translation = Eigen::Vector3d::Zero();
+
+    /**
+     * @brief 由 [x, y, z, roll, pitch, yaw]（m, rad；绕参考相机x/y/z轴，按z-y-x顺序合成）构造
+     */
+    static CameraExtrinsic fromXyzRpy(const double* values);
+
+    /**
+     * @brief 把观测的位置与姿态变换到参考相机坐标系（同步更新yaw）
+     */
+    void apply(ArmorObservations& armors) const;
+};
+
+/**
+ * @brief 多相机观测融合前处理（位于跟踪器之前）
+ *
+ * 各相机的检测结果按到达顺序逐帧送入同一个跟踪器：
+ * - 非参考相机的观测先变换到参考相机坐标系；
+ * - 来自另一相机且时间戳早于已处理帧的迟到帧丢弃（EKF不能回退时间）；
+ *   同一相机的时间戳回退（视频循环、回放重启）沿用单相机的处理，dt取默认值；
+ * - 空帧只有来自最近一次看到目标的相机时才送入跟踪器计为丢失，
+ *   其他相机视野内没有目标不代表目标消失。
+ * 只有一个相机时与原先的单相机行为完全一致。
+ */
+class CameraFusion {
+public:
+    enum class Verdict : uint8_t {
+        ACCEPT = 0,          // 送入跟踪器
+        STALE = 1,           // 其他相机的迟到帧
+        UNKNOWN_CAMERA = 2,  // 相机序号超出外参表
+        NO_INFORMATION = 3,  // 非当前目标相机的空帧
+    };
+
+    static constexpr double DEFAULT_DT = 0.01;
+
+    CameraFusion();
+
+    /**
+     * @brief 设置外参表（下标即相机序号；空表等价于只有参考相机）
+     */
+    void setExtrinsics(const std::vector<CameraExtrinsic>& extrinsics);
+
+    size_t cameraCount() const { return extrinsics_.size(); }
+
+    /**
+     * @brief 处理一帧：变换坐标并计算距上一帧的dt
+     * @return ACCEPT时armors已变换、dt有效，其余情况本帧不应送入跟踪器
+     */
+    Verdict prepare(ArmorObservations& armors, double& dt);
+
+    /**
+     * @brief 清除时间与目标相机记录（重新激活时调用）
+     */
+    void reset();
+
+    uint64_t count(Verdict verdict) const { return counts_[static_cast<size_t>(verdict)]; }
+
+private:
+    std::vector<CameraExtrinsic> extrinsics_;
+    int64_t last_stamp_ns_ = 0;
+    int last_camera_ = -1;        // 最近一次送入跟踪器的相机
+    int last_seen_camera_ = -1;   // 最近一次看到装甲板的相机
+    uint64_t counts_[4] = {};
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rm_utils/telemetry_log.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 单帧解算遥测记录（定长POD，由TelemetryWriter按列写入.rmtl文件）
+ *
+ * 字段顺序与solverTelemetryColumns()一一对应，增删字段时两处同步修改。
+ */
+struct SolverTelemetryRecord {
+    int64_t stamp_ns;         // 帧时间戳（CLOCK_REALTIME）
+    int64_t solve_ns;         // 解算完成时刻
+    double dt;
+    double state[10];         // [xc, v_xc, yc, v_yc, zc, v_zc, yaw, v_yaw, r, d_zc]
+    double cov_diag[10];      // 协方差对角线
+    double innovation[4];     // [x, y, z, yaw]，本帧未更新EKF时为NaN
+    double aim_point[3];
+    double cmd_yaw;           // 补偿后的云台命令（rad）
+    double cmd_pitch;
+    int32_t matched_index;    // 关联到的观测索引，-1表示未关联
+    int32_t armors_num;       // 目标装甲板数量（旋转模型）
+    uint8_t observations;     // 本帧观测数量
+    uint8_t camera;           // 来源相机序号
+    uint8_t tracker_state;    // TrackerState
+    uint8_t tracked_symbol;   // ArmorSymbol
+    uint8_t valid;            // 有有效瞄准点
+    uint8_t fire;
+    uint8_t small_gyro;       // 反陀螺策略生效
+};
+
+/**
+ * @brief SolverTelemetryRecord的列定义
+ */
+const std::vector<TelemetryColumn>& solverTelemetryColumns();
+
+/**
+ * @brief 在output_dir下新建 solver_<时间>.rmtl 并以解算记录的列定义打开写入器
+ */
+bool openSolverTelemetry(TelemetryWriter& writer, const std::string& output_dir,
+                         const TelemetryWriter::Options& options, std::string* error);
+
+}  // namespace rm_auto_aim
@@ -1,90 +1,154 @@
 #pragma once
 
 #include <Eigen/Dense>
-#include <functional>
 
 namespace rm_auto_aim {
 
 /**
- * @brief 扩展卡尔曼滤波器 (EKF)
+ * @brief 定维扩展卡尔曼滤波器 (EKF)
  *
- * 状态向量 (10维):
- *   [xc, v_xc, yc, v_yc, zc, v_zc, yaw, v_yaw, r, d_zc]
- * 观测向量 (4维):
- *   [x_armor, y_armor, z_armor, yaw]
+ * 状态/观测维度与模型类型均为模板参数：所有矩阵为定长Eigen类型（栈上、无堆分配），
+ * 模型调用在编译期确定并可内联，预测/更新步不产生任何临时分配。
+ * 雅可比由数值微分求得，协方差更新使用Joseph形式。
  *
- * 运动模型：匀速+匀角速度
- * 观测模型：从旋转中心反推装甲板位置
+ * @tparam N 状态维度
+ * @tparam M 观测维度
+ * @tparam MotionModel 状态转移模型，需提供
+ *         Eigen::Matrix<double, N, 1> operator()(const Eigen::Matrix<double, N, 1>& x, double dt) const
+ * @tparam MeasureModel 观测模型，需提供
+ *         Eigen::Matrix<double, M, 1> operator()(const Eigen::Matrix<double, N, 1>& x) const
+ *         以及新息计算（角度类观测在此归一化）
+ *         Eigen::Matrix<double, M, 1> residual(const Eigen::Matrix<double, M, 1>& z,
+ *                                              const Eigen::Matrix<double, M, 1>& z_pred) const
  */
+template <int N, int M, typename MotionModel, typename MeasureModel>
 class ExtendedKalmanFilter {
 public:
-    using VecX = Eigen::VectorXd;
-    using MatXX = Eigen::MatrixXd;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
-    // 函数签名：状态转移 f(x, dt) 和观测模型 h(x)
-    using PredictFunc = std::function<VecX(const VecX&, double)>;
-    using MeasureFunc = std::function<Eigen::Vector4d(const VecX&)>;
+    static constexpr int STATES = N;
+    static constexpr int MEASUREMENTS = M;
 
-    /**
-     * @param n_states 状态维度 (10)
-     * @param n_obs    观测维度 (4)
-     */
-    ExtendedKalmanFilter(int n_states, int n_obs);
+    using StateVec = Eigen::Matrix<double, N, 1>;
+    using StateMat = Eigen::Matrix<double, N, N>;
+    using MeasVec = Eigen::Matrix<double, M, 1>;
+    using MeasMat = Eigen::Matrix<double, M, M>;
+    using MeasJac = Eigen::Matrix<double, M, N>;
+    using Gain = Eigen::Matrix<double, N, M>;
 
-    /**
-     * @brief 设置运动模型和观测模型
-     */
-    void setFunctions(PredictFunc f, MeasureFunc h);
+    explicit ExtendedKalmanFilter(
+        const MotionModel& f = MotionModel(), const MeasureModel& h = MeasureModel())
+        : f_(f), h_(h) {}
 
     /**
      * @brief 设置过程噪声和观测噪声
      */
-    void setNoiseMatrices(const MatXX& Q, const MatXX& R);
+    void setNoiseMatrices(const StateMat& Q, const MeasMat& R) {
+        Q_ = Q;
+        R_ = R;
+    }
 
     /**
-     * @brief 初始化状态
+     * @brief 初始化状态（协方差重置为0.1·I）
      */
-    void init(const VecX& x0);
+    void init(const StateVec& x0) {
+        x_ = x0;
+        P_ = StateMat::Identity() * 0.1;
+        initialized_ = true;
+    }
 
     /**
      * @brief 预测步
      * @param dt 时间间隔(秒)
      * @return 预测后状态
      */
-    VecX predict(double dt);
+    const StateVec& predict(double dt) {
+        if (!initialized_) return x_;
+
+        // 在预测前的状态处求雅可比 F，状态转移结果复用为f(x)
+        const StateVec f0 = f_(x_, dt);
+        computeF(f0, dt);
+
+        x_ = f0;
+        P_ = F_ * P_ * F_.transpose() + Q_;
+        return x_;
+    }
 
     /**
      * @brief 更新步
      * @param z 观测向量
      * @return 更新后状态
      */
-    VecX update(const Eigen::Vector4d& z);
+    const StateVec& update(const MeasVec& z) {
+        if (!initialized_) return x_;
+
+        // 观测雅可比 H 与新息
+        const MeasVec h0 = h_(x_);
+        computeH(h0);
+        y_ = h_.residual(z, h0);
+
+        // 新息协方差与卡尔曼增益
+        const MeasMat S = H_ * P_ * H_.transpose() + R_;
+        const Gain K = P_ * H_.transpose() * S.inverse();
+
+        // 状态更新
+        x_ += K * y_;
+
+        // 协方差更新 (Joseph 形式提高数值稳定性)
+        const StateMat IKH = StateMat::Identity() - K * H_;
+        P_ = IKH * P_ * IKH.transpose() + K * R_ * K.transpose();
+        return x_;
+    }
 
     // 访问器
-    VecX state() const { return x_; }
-    MatXX covariance() const { return P_; }
+    const StateVec& state() const { return x_; }
+    const StateMat& covariance() const { return P_; }
+    const StateMat& processNoise() const { return Q_; }
+    const MeasMat& measurementNoise() const { return R_; }
+    bool initialized() const { return initialized_; }
 
-private:
     /**
-     * @brief 数值计算状态转移雅可比矩阵
+     * @brief 最近一次更新步的新息（观测 - 预测观测，由观测模型归一化）
      */
-    MatXX computeF(const VecX& x, double dt);
+    const MeasVec& innovation() const { return y_; }
+
+private:
+    static constexpr double JACOBIAN_EPS = 1e-5;
 
     /**
-     * @brief 数值计算观测雅可比矩阵
+     * @brief 数值计算状态转移雅可比矩阵（f0 = f(x_, dt)）
      */
-    Eigen::Matrix<double, 4, Eigen::Dynamic> computeH(const VecX& x);
+    void computeF(const StateVec& f0, double dt) {
+        StateVec x_perturbed = x_;
+        for (int i = 0; i < N; i++) {
+            x_perturbed(i) += JACOBIAN_EPS;
+            F_.col(i) = (f_(x_perturbed, dt) - f0) / JACOBIAN_EPS;
+            x_perturbed(i) = x_(i);
+        }
+    }
 
-    int n_states_;
-    int n_obs_;
-
-    VecX x_;      // 状态向量
-    MatXX P_;     // 协方差矩阵
-    MatXX Q_;     // 过程噪声
-    MatXX R_;     // 观测噪声
-
-    PredictFunc f_;   // 状态转移函数
-    MeasureFunc h_;   // 观测函数
+    /**
+     * @brief 数值计算观测雅可比矩阵（h0 = h(x_)）
+     */
+    void computeH(const MeasVec& h0) {
+        StateVec x_perturbed = x_;
+        for (int i = 0; i < N; i++) {
+            x_perturbed(i) += JACOBIAN_EPS;
+            H_.col(i) = (h_(x_perturbed) - h0) / JACOBIAN_EPS;
+            x_perturbed(i) = x_(i);
+        }
+    }
+
+    MotionModel f_;    // 状态转移模型
+    MeasureModel h_;   // 观测模型
+
+    StateVec x_ = StateVec::Zero();                 // 状态向量
+    StateMat P_ = StateMat::Identity();             // 协方差矩阵
+    StateMat Q_ = StateMat::Identity();             // 过程噪声
+    MeasMat R_ = MeasMat::Identity();               // 观测噪声
+    MeasVec y_ = MeasVec::Zero();                   // 最近一次新息
+    StateMat F_ = StateMat::Identity();             // 状态转移雅可比（复用）
+    MeasJac H_ = MeasJac::Zero();                   // 观测雅可比（复用）
 
     bool initialized_ = false;
 };
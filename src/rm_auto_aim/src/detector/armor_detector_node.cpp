@@ -2,46 +2,269 @@
 
 #include <cv_bridge/cv_bridge.h>
 
-#include <geometry_msgs/msg/pose.hpp>
-#include <opencv2/calib3d.hpp>
-#include <tf2/LinearMath/Matrix3x3.h>
-#include <tf2/LinearMath/Quaternion.h>
+#include "rm_auto_aim/detector/armor_msg_builder.hpp"
+#include "rm_utils/alloc_tracker.hpp"
+#include "rm_utils/buffer_pool.hpp"
+#include "rm_utils/flight_recorder.hpp"
+#include "rm_utils/latency_tracer.hpp"
+#include "rm_utils/task_pool.hpp"
 
 namespace rm_auto_aim {
 
+namespace {
+
+// 可热更新的参数（debug涉及调试发布器，只在configure时读取）
+const std::vector<std::string> kReloadableParams = {
+    "binary_threshold",
+    "light.min_ratio", "light.max_ratio", "light.max_angle", "light.color_diff_thresh",
+    "armor.min_small_center_distance", "armor.max_small_center_distance",
+    "armor.min_large_center_distance", "armor.max_large_center_distance", "armor.max_angle",
+    "classifier.confidence",
+    "estimator.optimize_yaw", "estimator.search_range",
+    "detect_color",
+};
+
+// 把单个参数写入配置，不是可热更新参数时返回false
+template <typename Config>
+bool applyParameter(Config& config, const rclcpp::Parameter& param) {
+    auto& p = config.params;
+    const auto& name = param.get_name();
+    if (name == "binary_threshold") p.binary_threshold = static_cast<int>(param.as_int());
+    // 灯条
+    else if (name == "light.min_ratio") p.light_min_ratio = param.as_double();
+    else if (name == "light.max_ratio") p.light_max_ratio = param.as_double();
+    else if (name == "light.max_angle") p.light_max_angle = param.as_double();
+    else if (name == "light.color_diff_thresh") {
+        p.light_color_diff_thresh = static_cast<int>(param.as_int());
+    }
+    // 装甲板
+    else if (name == "armor.min_small_center_distance") {
+        p.armor_min_small_center_distance = param.as_double();
+    } else if (name == "armor.max_small_center_distance") {
+        p.armor_max_small_center_distance = param.as_double();
+    } else if (name == "armor.min_large_center_distance") {
+        p.armor_min_large_center_distance = param.as_double();
+    } else if (name == "armor.max_large_center_distance") {
+        p.armor_max_large_center_distance = param.as_double();
+    } else if (name == "armor.max_angle") {
+        p.armor_max_angle = param.as_double();
+    }
+    // 分类器与PnP
+    else if (name == "classifier.confidence") p.classifier_confidence = param.as_double();
+    else if (name == "estimator.optimize_yaw") p.optimize_yaw = param.as_bool();
+    else if (name == "estimator.search_range") p.search_range = param.as_double();
+    // 目标颜色
+    else if (name == "detect_color") config.detect_color = static_cast<Color>(param.as_int());
+    else return false;
+    return true;
+}
+
+}  // namespace
+
 ArmorDetectorNode::ArmorDetectorNode(const rclcpp::NodeOptions& options)
-    : Node("armor_detector", options)
+    : rclcpp_lifecycle::LifecycleNode("armor_detector", options)
 {
-    RCLCPP_INFO(get_logger(), "ArmorDetectorNode 初始化中...");
-
     // 声明ROS参数
     declareParameters();
 
-    // 创建检测器
-    auto params = loadParams();
-    detector_ = std::make_unique<ArmorDetector>(params);
+    detect_placement_ = declareThreadPlacement(*this, "detection");
+    calibration_cache_ = this->get_parameter("calibration_cache").as_string();
+
+    auto topics = this->get_parameter("camera_topics").as_string_array();
+    if (topics.empty()) {
+        topics.emplace_back();
+    }
+    if (topics.size() > UINT8_MAX) {
+        RCLCPP_WARN(get_logger(), "相机路数 %zu 超出上限，只使用前 %d 路", topics.size(), UINT8_MAX);
+        topics.resize(UINT8_MAX);
+    }
+
+    // 订阅各路相机信息（锁存话题，任何状态下都接收：未配置时作为内参来源，
+    // 配置后内参与当前不同时替换该路PnP解算器）
+    rclcpp::SubscriptionOptions cam_info_options;
+    cam_info_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+    for (size_t i = 0; i < topics.size(); i++) {
+        auto stream = std::make_unique<CameraStream>();
+        stream->index = i;
+        stream->topic_prefix = topics[i];
+        auto* raw = stream.get();
+        stream->cam_info_sub = this->create_subscription<sensor_msgs::msg::CameraInfo>(
+            raw->topic_prefix + "/camera_info", rclcpp::QoS(1).reliable().transient_local(),
+            [this, raw](const sensor_msgs::msg::CameraInfo::ConstSharedPtr& msg) {
+                cameraInfoCallback(*raw, msg);
+            },
+            cam_info_options);
+        streams_.push_back(std::move(stream));
+    }
+    mailboxes_.resize(streams_.size());
+    if (streams_.size() > 1) {
+        RCLCPP_INFO(get_logger(), "多相机输入: %zu 路", streams_.size());
+    }
+
+    param_callback_ = this->add_on_set_parameters_callback(
+        std::bind(&ArmorDetectorNode::onParametersSet, this, std::placeholders::_1));
+}
+
+ArmorDetectorNode::~ArmorDetectorNode() {
+    stopDetecting();
+}
+
+ArmorDetectorNode::CallbackReturn ArmorDetectorNode::on_configure(const rclcpp_lifecycle::State&) {
+    // 内参：/camera_info > 自身参数 > 标定缓存；都没有时配置失败，由管理节点重试
+    if (!initCalibration()) {
+        RCLCPP_WARN(get_logger(), "无内参参数、标定缓存与 /camera_info，暂不能就绪");
+        return CallbackReturn::FAILURE;
+    }
+
+    // 检测配置：发布为当前版本，之后的修改经参数回调热更新
+    const auto config = loadConfig();
+    const auto& params = config.params;
     debug_ = params.debug;
+    const uint64_t config_version = config_.publish(config);
+
+    // 创建检测线程组（0表示每路相机一个线程），每个线程为每路相机各建一个检测器
+    int64_t worker_count = this->get_parameter("detect_workers").as_int();
+    if (worker_count <= 0) {
+        worker_count = static_cast<int64_t>(streams_.size());
+    }
+    workers_.clear();
+    for (int64_t i = 0; i < worker_count; i++) {
+        auto worker = std::make_unique<DetectWorker>();
+        worker->index = static_cast<size_t>(i);
+        worker->config_reader = std::make_unique<RcuCell<DetectorConfig>::Reader>(config_);
+        worker->config_version = config_version;
+        for (size_t j = 0; j < streams_.size(); j++) {
+            worker->detectors.push_back(std::make_unique<ArmorDetector>(params));
+        }
+        workers_.push_back(std::move(worker));
+    }
 
-    // 订阅相机信息（获取内参后创建PnP解算器）
-    cam_info_sub_ = this->create_subscription<sensor_msgs::msg::CameraInfo>(
-        "/camera_info", rclcpp::SensorDataQoS(),
-        std::bind(&ArmorDetectorNode::cameraInfoCallback, this, std::placeholders::_1));
+    // 预热（检测线程启动前，独占检测器）
+    if (this->get_parameter("warmup.enable").as_bool()) {
+        warmUp(config.detect_color);
+    }
 
-    // 订阅图像
-    img_sub_ = this->create_subscription<sensor_msgs::msg::Image>(
-        "/image_raw", rclcpp::SensorDataQoS(),
-        std::bind(&ArmorDetectorNode::imageCallback, this, std::placeholders::_1));
+    // 帧龄（采集→开始检测, ms）与丢帧计数
+    frame_age_pub_ = this->create_publisher<std_msgs::msg::Float64>(
+        "/armor_detector/frame_age", rclcpp::SensorDataQoS());
+    dropped_pub_ = this->create_publisher<std_msgs::msg::UInt64>(
+        "/armor_detector/dropped_frames", 10);
+    stats_timer_ = this->create_wall_timer(
+        std::chrono::seconds(1), std::bind(&ArmorDetectorNode::publishFrameStats, this));
+
+    // 订阅各路图像（回调只做邮箱交换，队列中的帧很快被取走，丢帧统一在邮箱处计数；未激活时直接归还）
+    for (auto& stream : streams_) {
+        auto* raw = stream.get();
+        stream->img_sub = this->create_subscription<sensor_msgs::msg::Image>(
+            raw->topic_prefix + "/image_raw", rclcpp::SensorDataQoS(),
+            [this, raw](sensor_msgs::msg::Image::UniquePtr msg) {
+                imageCallback(*raw, std::move(msg));
+            });
+    }
+
+    // 目标颜色跟随下位机
+    if (this->get_parameter("detect_color_from_serial").as_bool()) {
+        serial_color_ = -1;
+        serial_sub_ = this->create_subscription<rm_interfaces::msg::SerialReceiveData>(
+            "/serial/receive", rclcpp::SensorDataQoS(),
+            std::bind(&ArmorDetectorNode::serialCallback, this, std::placeholders::_1));
+    }
 
     // 发布装甲板检测结果
-    armors_pub_ = this->create_publisher<rm_interfaces::msg::Armors>(
+    armors_pub_ = this->create_publisher<rm_interfaces::msg::CompactArmors>(
         "/detector/armors", rclcpp::SensorDataQoS());
 
+    // 用完的主相机帧转交录制节点（普通发布器：未激活时转交的帧也不能被丢弃）
+    image_tee_pub_ = rclcpp::create_publisher<sensor_msgs::msg::Image>(
+        *this, "/armor_detector/image_tee", rclcpp::SensorDataQoS());
+
     // 调试发布
     if (debug_) {
         createDebugPublishers();
     }
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorDetectorNode::CallbackReturn ArmorDetectorNode::on_activate(const rclcpp_lifecycle::State&) {
+    frame_age_pub_->on_activate();
+    dropped_pub_->on_activate();
+    armors_pub_->on_activate();
+    if (debug_) {
+        binary_pub_->on_activate();
+        debug_img_pub_->on_activate();
+        marker_pub_->on_activate();
+        legacy_armors_pub_->on_activate();
+    }
 
-    RCLCPP_INFO(get_logger(), "ArmorDetectorNode 初始化完成");
+    // 检测线程（所有发布器激活后启动）
+    mailboxes_.reopen();
+    detecting_ = true;
+    for (auto& worker : workers_) {
+        worker->thread = std::thread(&ArmorDetectorNode::detectLoop, this, std::ref(*worker));
+    }
+    RCLCPP_INFO(get_logger(), "检测线程已启动: %zu 个线程, %zu 路相机",
+                workers_.size(), streams_.size());
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorDetectorNode::CallbackReturn ArmorDetectorNode::on_deactivate(const rclcpp_lifecycle::State&) {
+    stopDetecting();
+    frame_age_pub_->on_deactivate();
+    dropped_pub_->on_deactivate();
+    armors_pub_->on_deactivate();
+    if (debug_) {
+        binary_pub_->on_deactivate();
+        debug_img_pub_->on_deactivate();
+        marker_pub_->on_deactivate();
+        legacy_armors_pub_->on_deactivate();
+    }
+    RCLCPP_INFO(get_logger(), "检测线程已停止");
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorDetectorNode::CallbackReturn ArmorDetectorNode::on_cleanup(const rclcpp_lifecycle::State&) {
+    releaseResources();
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorDetectorNode::CallbackReturn ArmorDetectorNode::on_shutdown(const rclcpp_lifecycle::State&) {
+    stopDetecting();
+    releaseResources();
+    return CallbackReturn::SUCCESS;
+}
+
+void ArmorDetectorNode::stopDetecting() {
+    detecting_ = false;
+    // 残留帧与检测完的帧走同一回收路径：主相机帧仍转交录制，停用前的最后几帧不丢
+    auto remaining = mailboxes_.close();
+    for (size_t lane = 0; lane < remaining.size(); lane++) {
+        if (remaining[lane]) {
+            recycleFrame(*streams_[lane], std::move(remaining[lane]));
+        }
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void ArmorDetectorNode::releaseResources() {
+    for (auto& stream : streams_) {
+        stream->img_sub.reset();
+        std::atomic_store(&stream->pnp_solver, std::shared_ptr<PnPSolver>());
+    }
+    serial_sub_.reset();
+    stats_timer_.reset();
+    frame_age_pub_.reset();
+    dropped_pub_.reset();
+    armors_pub_.reset();
+    binary_pub_.reset();
+    debug_img_pub_.reset();
+    marker_pub_.reset();
+    legacy_armors_pub_.reset();
+    image_tee_pub_.reset();
+    workers_.clear();
 }
 
 void ArmorDetectorNode::declareParameters() {
@@ -67,157 +290,405 @@ void ArmorDetectorNode::declareParameters() {
     this->declare_parameter("debug", false);
     // 目标颜色
     this->declare_parameter("detect_color", 1);  // 0=BLUE, 1=RED
+    // 目标颜色跟随下位机发来的颜色（/serial/receive）
+    this->declare_parameter("detect_color_from_serial", true);
+    // 相机内参（fx为0表示未配置，改用标定缓存）
+    this->declare_parameter("camera_matrix", std::vector<double>(9, 0.0));
+    this->declare_parameter("distortion_coefficients", std::vector<double>(5, 0.0));
+    this->declare_parameter("image_width", 0);
+    this->declare_parameter("image_height", 0);
+    this->declare_parameter("calibration_cache", "~/.ros/rm_camera_calibration.yaml");
+    // 多相机：每路话题前缀（订阅 <前缀>/image_raw 与 <前缀>/camera_info，""为主相机），
+    // 序号即发布观测中的相机序号；检测线程数（0为每路一个）
+    this->declare_parameter("camera_topics", std::vector<std::string>{""});
+    this->declare_parameter("detect_workers", 0);
+    // 启动预热
+    this->declare_parameter("warmup.enable", true);
+    this->declare_parameter("warmup.iterations", 20);
 }
 
-DetectorParams ArmorDetectorNode::loadParams() {
-    DetectorParams p;
-    p.binary_threshold = this->get_parameter("binary_threshold").as_int();
-    p.light_min_ratio = this->get_parameter("light.min_ratio").as_double();
-    p.light_max_ratio = this->get_parameter("light.max_ratio").as_double();
-    p.light_max_angle = this->get_parameter("light.max_angle").as_double();
-    p.light_color_diff_thresh = this->get_parameter("light.color_diff_thresh").as_int();
-    p.armor_min_small_center_distance =
-        this->get_parameter("armor.min_small_center_distance").as_double();
-    p.armor_max_small_center_distance =
-        this->get_parameter("armor.max_small_center_distance").as_double();
-    p.armor_min_large_center_distance =
-        this->get_parameter("armor.min_large_center_distance").as_double();
-    p.armor_max_large_center_distance =
-        this->get_parameter("armor.max_large_center_distance").as_double();
-    p.armor_max_angle = this->get_parameter("armor.max_angle").as_double();
-    p.classifier_confidence = this->get_parameter("classifier.confidence").as_double();
-    p.optimize_yaw = this->get_parameter("estimator.optimize_yaw").as_bool();
-    p.search_range = this->get_parameter("estimator.search_range").as_double();
-    p.debug = this->get_parameter("debug").as_bool();
-
-    detect_color_ = static_cast<Color>(this->get_parameter("detect_color").as_int());
-    return p;
+ArmorDetectorNode::DetectorConfig ArmorDetectorNode::loadConfig() {
+    DetectorConfig config;
+    for (const auto& param : this->get_parameters(kReloadableParams)) {
+        applyParameter(config, param);
+    }
+    config.params.debug = this->get_parameter("debug").as_bool();
+    return config;
 }
 
-void ArmorDetectorNode::cameraInfoCallback(
-    const sensor_msgs::msg::CameraInfo::ConstSharedPtr& msg) {
-    if (cam_info_received_) return;
+rcl_interfaces::msg::SetParametersResult ArmorDetectorNode::onParametersSet(
+    const std::vector<rclcpp::Parameter>& params)
+{
+    rcl_interfaces::msg::SetParametersResult result;
+    result.successful = true;
+
+    // 未配置时只接受修改，configure时统一读取
+    const bool configured = !config_.empty();
+    DetectorConfig config = configured ? config_.copy() : DetectorConfig{};
+    bool reloadable = false;
+    for (const auto& param : params) {
+        if (param.get_name() == "detect_color" &&
+            param.get_type() == rclcpp::ParameterType::PARAMETER_INTEGER &&
+            param.as_int() != 0 && param.as_int() != 1) {
+            result.successful = false;
+            result.reason = "detect_color 只能为 0(BLUE) 或 1(RED)";
+            return result;
+        }
+        if (applyParameter(config, param)) {
+            reloadable = true;
+        } else if (configured) {
+            RCLCPP_INFO(get_logger(), "参数 %s 在重新configure后生效", param.get_name().c_str());
+        }
+    }
+    if (!reloadable || !configured) {
+        return result;
+    }
+    const uint64_t version = config_.publish(config);
+    RCLCPP_INFO(get_logger(), "检测参数已更新（版本 %lu，目标颜色 %s），下一帧生效", version,
+                config.detect_color == Color::RED ? "RED" : "BLUE");
+    return result;
+}
 
-    // 提取相机内参矩阵 3x3
-    cv::Mat camera_matrix(3, 3, CV_64F);
-    for (int i = 0; i < 9; i++) {
-        camera_matrix.at<double>(i / 3, i % 3) = msg->k[i];
+void ArmorDetectorNode::serialCallback(
+    const rm_interfaces::msg::SerialReceiveData::ConstSharedPtr& msg) {
+    // 只在下位机颜色变化时改写参数（之后手动设置的颜色保持到下位机颜色再次变化）
+    const int color = msg->color;
+    if (color != 0 && color != 1) {
+        return;
+    }
+    if (serial_color_.exchange(color) == color) {
+        return;
     }
+    const auto result = this->set_parameter(rclcpp::Parameter("detect_color", color));
+    if (!result.successful) {
+        RCLCPP_WARN(get_logger(), "按下位机颜色切换失败: %s", result.reason.c_str());
+    }
+}
 
-    // 提取畸变系数
-    cv::Mat dist_coeffs(1, static_cast<int>(msg->d.size()), CV_64F);
-    for (size_t i = 0; i < msg->d.size(); i++) {
-        dist_coeffs.at<double>(0, static_cast<int>(i)) = msg->d[i];
+bool ArmorDetectorNode::initCalibration() {
+    // 其他相机：内参只取自各自的camera_info，尚未收到时该路帧等待内参
+    for (size_t i = 1; i < streams_.size(); i++) {
+        auto& stream = *streams_[i];
+        std::lock_guard<std::mutex> lock(stream.calibration_mutex);
+        if (stream.calibration.valid()) {
+            std::atomic_store(&stream.pnp_solver, std::make_shared<PnPSolver>(
+                stream.calibration.camera_matrix, stream.calibration.dist_coeffs));
+        } else {
+            RCLCPP_WARN(get_logger(), "相机 %zu 尚未收到 %s/camera_info，收到前该路帧不处理",
+                        i, stream.topic_prefix.c_str());
+        }
     }
 
-    pnp_solver_ = std::make_unique<PnPSolver>(camera_matrix, dist_coeffs);
-    cam_info_received_ = true;
-    RCLCPP_INFO(get_logger(), "已接收相机内参，PnP解算器已初始化");
+    auto& primary = *streams_.front();
+    std::lock_guard<std::mutex> lock(primary.calibration_mutex);
+    auto& calibration = primary.calibration;
+    if (calibration.valid()) {
+        // 配置前已收到/camera_info（相机先完成配置）
+        RCLCPP_INFO(get_logger(), "相机内参取自 /camera_info");
+    } else {
+        calibration = calibrationFromArrays(
+            this->get_parameter("camera_matrix").as_double_array(),
+            this->get_parameter("distortion_coefficients").as_double_array(),
+            static_cast<int>(this->get_parameter("image_width").as_int()),
+            static_cast<int>(this->get_parameter("image_height").as_int()));
+        if (calibration.valid()) {
+            RCLCPP_INFO(get_logger(), "相机内参取自节点参数");
+        } else if (!calibration_cache_.empty() &&
+                   loadCalibrationCache(calibration_cache_, calibration)) {
+            RCLCPP_INFO(get_logger(), "相机内参取自标定缓存: %s", calibration_cache_.c_str());
+        } else {
+            return false;
+        }
+    }
+    std::atomic_store(&primary.pnp_solver, std::make_shared<PnPSolver>(
+        calibration.camera_matrix, calibration.dist_coeffs));
+    return true;
 }
 
-void ArmorDetectorNode::imageCallback(const sensor_msgs::msg::Image::ConstSharedPtr& msg) {
-    // 等待相机内参
-    if (!cam_info_received_) {
-        RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
-                             "等待相机内参...");
+void ArmorDetectorNode::warmUp(Color color) {
+    const int iterations = static_cast<int>(this->get_parameter("warmup.iterations").as_int());
+    const auto start = std::chrono::steady_clock::now();
+    cv::Size size;
+    bool detected = false;
+    for (const auto& stream : streams_) {
+        const auto pnp_solver = std::atomic_load(&stream->pnp_solver);
+        if (!pnp_solver) {
+            continue;  // 该路内参未知，首帧时再分配
+        }
+        cv::Size stream_size;
+        {
+            std::lock_guard<std::mutex> lock(stream->calibration_mutex);
+            stream_size = stream->calibration.imageSize();
+        }
+        if (stream->index == 0) {
+            size = stream_size;
+        }
+        for (auto& worker : workers_) {
+            const auto armors = warmUpDetection(
+                *worker->detectors[stream->index], pnp_solver.get(), stream_size,
+                color, iterations);
+            detected = detected || !armors.empty();
+        }
+    }
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (!detected) {
+        RCLCPP_WARN(get_logger(), "检测预热完成: %.1f ms，合成帧未检出装甲板（仅预热了预处理与灯条检测）",
+                    elapsed_ms);
+    } else {
+        RCLCPP_INFO(get_logger(), "检测预热完成: %dx%d, %.1f ms", size.width, size.height,
+                    elapsed_ms);
+    }
+}
+
+void ArmorDetectorNode::cameraInfoCallback(
+    CameraStream& stream, const sensor_msgs::msg::CameraInfo::ConstSharedPtr& msg) {
+    const auto calibration = calibrationFromArrays(
+        std::vector<double>(msg->k.begin(), msg->k.end()), msg->d,
+        static_cast<int>(msg->width), static_cast<int>(msg->height));
+    {
+        std::lock_guard<std::mutex> lock(stream.calibration_mutex);
+        if (!calibration.valid() || calibration.sameAs(stream.calibration)) {
+            return;
+        }
+        stream.calibration = calibration;
+        // 已配置时整体替换解算器；主相机未配置时留待configure使用，
+        // 其他相机没有别的内参来源，收到即创建
+        if (std::atomic_load(&stream.pnp_solver) || stream.index > 0) {
+            std::atomic_store(&stream.pnp_solver, std::make_shared<PnPSolver>(
+                calibration.camera_matrix, calibration.dist_coeffs));
+            RCLCPP_INFO(get_logger(), "已接收相机 %zu 内参（与当前不同），PnP解算器已更新",
+                        stream.index);
+        }
+    }
+
+    // 主相机写入缓存，下次启动无需等待/camera_info（后台任务写盘，不阻塞回调；不捕获this）
+    if (stream.index == 0 && !calibration_cache_.empty()) {
+        TaskPool::global().submit(
+            TaskPriority::BACKGROUND,
+            [path = calibration_cache_, calibration, logger = get_logger()]() {
+                if (!saveCalibrationCache(path, calibration)) {
+                    RCLCPP_WARN(logger, "标定缓存写入失败: %s", path.c_str());
+                }
+            });
+    }
+}
+
+void ArmorDetectorNode::imageCallback(
+    CameraStream& stream, sensor_msgs::msg::Image::UniquePtr msg) {
+    if (!detecting_) {
+        // 未激活：不检测，直接转交录制或归还缓冲区
+        recycleFrame(stream, std::move(msg));
         return;
     }
+    frames_received_.fetch_add(1, std::memory_order_relaxed);
+    auto displaced = mailboxes_.put(stream.index, std::move(msg));
+    if (displaced) {
+        // 检测线程还没来得及处理的旧帧：丢弃并归还缓冲区
+        const uint64_t dropped = frames_dropped_.fetch_add(1, std::memory_order_relaxed) + 1;
+        RM_FLIGHT_RECORD(FlightEvent::FRAME_DROPPED, static_cast<double>(dropped));
+        recycleFrame(stream, std::move(displaced));
+    }
+}
 
-    // 转换ROS图像到OpenCV
-    auto cv_image = cv_bridge::toCvShare(msg, "bgr8");
-    const auto& image = cv_image->image;
+void ArmorDetectorNode::recycleFrame(
+    const CameraStream& stream, sensor_msgs::msg::Image::UniquePtr msg) {
+    // 有进程内录制订阅者时转移整条消息的所有权（录制节点写完后归还缓冲区），否则直接归还；
+    // 录制不再与检测同时订阅 /image_raw，相机发布时不会为第二个订阅者深拷贝
+    if (stream.index == 0 && image_tee_pub_ &&
+        image_tee_pub_->get_intra_process_subscription_count() > 0) {
+        image_tee_pub_->publish(std::move(msg));
+        return;
+    }
+    BufferPool::global().release(std::move(msg->data));
+}
 
-    // 执行检测
-    auto armors = detector_->detect(image, detect_color_);
+void ArmorDetectorNode::placeCurrentThread(ThreadPlacement placement, const std::string& name) {
+    placement.name = name;
+    std::string message;
+    if (applyThreadPlacement(placement, &message)) {
+        RCLCPP_INFO(get_logger(), "线程 %s: %s", name.c_str(), message.c_str());
+    } else {
+        RCLCPP_WARN(get_logger(), "线程 %s 放置降级: %s", name.c_str(), message.c_str());
+    }
+}
 
-    // 构造发布消息
-    rm_interfaces::msg::Armors armors_msg;
-    armors_msg.header = msg->header;
+void ArmorDetectorNode::detectLoop(DetectWorker& worker) {
+    placeCurrentThread(detect_placement_, worker.index == 0 ?
+        std::string("detection") : "detection_" + std::to_string(worker.index));
 
-    cv::Point2f img_center(image.cols / 2.0f, image.rows / 2.0f);
+    sensor_msgs::msg::Image::UniquePtr msg;
+    size_t lane = 0;
+    while (mailboxes_.take(msg, lane)) {
+        processImage(worker, *streams_[lane], std::move(msg));
+        mailboxes_.done(lane);
+    }
+}
 
-    for (auto& armor : armors) {
-        cv::Mat rvec, tvec;
-        double yaw;
+void ArmorDetectorNode::publishFrameStats() {
+    if (!detecting_) return;
+
+    std_msgs::msg::UInt64 dropped;
+    dropped.data = frames_dropped_.load(std::memory_order_relaxed);
+    dropped_pub_->publish(dropped);
+    RCLCPP_DEBUG(get_logger(), "图像帧: 收到 %lu, 处理 %lu, 覆盖丢弃 %lu",
+                 frames_received_.load(), frames_processed_.load(), dropped.data);
+
+    // 归还的图像缓冲区不是池中取出的：途中被深拷贝过，进程内零拷贝已失效
+    const uint64_t foreign = BufferPool::global().foreignReleases();
+    if (foreign > foreign_releases_reported_) {
+        RCLCPP_WARN(get_logger(), "图像缓冲区外来归还 %lu 次（新增 %lu），进程内零拷贝失效，"
+                    "检查 /image_raw 是否存在非UniquePtr或跨进程订阅",
+                    foreign, foreign - foreign_releases_reported_);
+        foreign_releases_reported_ = foreign;
+    }
+}
 
-        // PnP解算
-        if (!pnp_solver_->solve(armor, rvec, tvec, yaw)) {
-            continue;
+void ArmorDetectorNode::processImage(
+    DetectWorker& worker, CameraStream& stream, sensor_msgs::msg::Image::UniquePtr msg) {
+    // 参数热更新：无锁取本帧配置快照，版本变化时更新本线程的检测器（不计入本帧分配）
+    const auto config = worker.config_reader->read();
+    if (config.version() != worker.config_version) {
+        for (auto& detector : worker.detectors) {
+            detector->setParams(config->params);
         }
+        worker.config_version = config.version();
+    }
 
-        // 构造单个装甲板消息
-        rm_interfaces::msg::Armor armor_msg;
-        armor_msg.number = armor.number;
-        armor_msg.type = armor.type == ArmorType::SMALL ? "small" : "large";
-        armor_msg.distance_to_image_center = armor.distanceToCenter(img_center);
+    // 本帧（检测 + PnP + 发布）的堆分配计入DETECT
+    AllocScope alloc_scope(AllocTag::DETECT, true);
+
+    // 采集→开始检测的帧龄
+    const int64_t stamp_ns = rclcpp::Time(msg->header.stamp).nanoseconds();
+    auto& tracer = LatencyTracer::global();
+    tracer.mark(TraceStage::DETECT_START, stamp_ns);
+    // 时间戳不是真实采集时刻（如视频锁步的合成时间戳）时帧龄无意义，与sinceCapture一同关闭
+    if (tracer.sinceCaptureEnabled() && frame_age_pub_->get_subscription_count() > 0) {
+        std_msgs::msg::Float64 age;
+        age.data = (this->now() - rclcpp::Time(msg->header.stamp)).seconds() * 1e3;
+        frame_age_pub_->publish(age);
+    }
+    frames_processed_.fetch_add(1, std::memory_order_relaxed);
+
+    // 独占图像消息：处理完后转交录制节点，或把数据缓冲区归还相机的缓冲区池
+    struct FrameRecycler {
+        ArmorDetectorNode& node;
+        const CameraStream& stream;
+        sensor_msgs::msg::Image::UniquePtr& msg;
+        ~FrameRecycler() { node.recycleFrame(stream, std::move(msg)); }
+    } recycler{*this, stream, msg};
+
+    // 等待相机内参（取快照：内参回调可能同时替换解算器）
+    const auto pnp_solver = std::atomic_load(&stream.pnp_solver);
+    if (!pnp_solver) {
+        RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
+                             "等待相机 %zu 内参...", stream.index);
+        return;
+    }
 
-        // 平移
-        armor_msg.pose.position.x = tvec.at<double>(0);
-        armor_msg.pose.position.y = tvec.at<double>(1);
-        armor_msg.pose.position.z = tvec.at<double>(2);
+    if (msg->encoding != "bgr8") {
+        RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
+                             "不支持的图像编码: %s", msg->encoding.c_str());
+        return;
+    }
 
-        // 旋转：rvec → 四元数
-        cv::Mat rotation_matrix;
-        cv::Rodrigues(rvec, rotation_matrix);
-        tf2::Matrix3x3 tf2_rotation(
-            rotation_matrix.at<double>(0, 0), rotation_matrix.at<double>(0, 1),
-            rotation_matrix.at<double>(0, 2), rotation_matrix.at<double>(1, 0),
-            rotation_matrix.at<double>(1, 1), rotation_matrix.at<double>(1, 2),
-            rotation_matrix.at<double>(2, 0), rotation_matrix.at<double>(2, 1),
-            rotation_matrix.at<double>(2, 2));
-        tf2::Quaternion q;
-        tf2_rotation.getRotation(q);
-        armor_msg.pose.orientation.x = q.x();
-        armor_msg.pose.orientation.y = q.y();
-        armor_msg.pose.orientation.z = q.z();
-        armor_msg.pose.orientation.w = q.w();
+    // 直接引用消息缓冲区，无需cv_bridge拷贝
+    const cv::Mat image(
+        static_cast<int>(msg->height), static_cast<int>(msg->width), CV_8UC3,
+        msg->data.data(), msg->step);
 
-        armors_msg.armors.push_back(armor_msg);
+    // 执行检测
+    auto& detector = *worker.detectors[stream.index];
+    auto armors = detector.detect(image, config->detect_color);
+    tracer.mark(TraceStage::DETECT_END, stamp_ns);
+
+    // 发布：中间件支持借用消息时直接在其缓冲区中构造，否则unique_ptr发布
+    // （进程内通信时所有权直接转移给解算节点）
+    auto& observations = worker.observations;
+    observations.stamp_ns = stamp_ns;
+    observations.camera = static_cast<uint8_t>(stream.index);
+    fillArmors(image, armors, *pnp_solver, observations);
+    tracer.mark(TraceStage::PNP_DONE, stamp_ns);
+
+    // 节点边缘：核心观测 → 定长消息（调试输出只针对主相机）
+    const bool debug = debug_ && stream.index == 0;
+    if (armors_pub_->can_loan_messages()) {
+        auto loaned_msg = armors_pub_->borrow_loaned_message();
+        auto& armors_msg = loaned_msg.get();
+        toMsg(observations, armors_msg);
+        if (debug) {
+            publishDebug(detector, armors_msg);
+        }
+        armors_pub_->publish(std::move(loaned_msg));
+    } else {
+        auto armors_msg = std::make_unique<rm_interfaces::msg::CompactArmors>();
+        toMsg(observations, *armors_msg);
+        // 调试发布（需在转移消息所有权之前完成）
+        if (debug) {
+            publishDebug(detector, *armors_msg);
+        }
+        armors_pub_->publish(std::move(armors_msg));
     }
+}
 
-    // 发布
-    armors_pub_->publish(armors_msg);
-
-    // 调试发布
-    if (debug_) {
-        publishDebugImages(detector_->getBinaryImage(), detector_->getDebugImage());
-        publishMarkers(armors_msg);
+void ArmorDetectorNode::fillArmors(
+    const cv::Mat& image, const std::vector<Armor>& armors, PnPSolver& pnp_solver,
+    ArmorObservations& observations)
+{
+    // PnP解算（多块装甲板时在任务池上并行），超出定长上限的装甲板丢弃
+    const cv::Point2f img_center(image.cols / 2.0f, image.rows / 2.0f);
+    if (pnp_solver.solveAll(armors, img_center, observations) > 0) {
+        RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
+                             "装甲板数量超过上限 %d，多余结果已丢弃",
+                             ArmorObservations::MAX_ARMORS);
     }
 }
 
 void ArmorDetectorNode::createDebugPublishers() {
-    binary_pub_ = image_transport::create_publisher(this, "/armor_detector/binary");
-    debug_img_pub_ = image_transport::create_publisher(this, "/armor_detector/debug");
+    binary_pub_ = this->create_publisher<sensor_msgs::msg::Image>("/armor_detector/binary", 10);
+    debug_img_pub_ = this->create_publisher<sensor_msgs::msg::Image>("/armor_detector/debug", 10);
     marker_pub_ = this->create_publisher<visualization_msgs::msg::MarkerArray>(
         "/armor_detector/marker", 10);
+    legacy_armors_pub_ = this->create_publisher<rm_interfaces::msg::Armors>(
+        "/armor_detector/armors", 10);
+}
+
+void ArmorDetectorNode::publishDebug(
+    const ArmorDetector& detector, const rm_interfaces::msg::CompactArmors& armors_msg) {
+    publishDebugImages(detector.getBinaryImage(), detector.getDebugImage());
+    publishMarkers(armors_msg);
+    legacy_armors_pub_->publish(toArmorsMsg(armors_msg));
 }
 
 void ArmorDetectorNode::publishDebugImages(const cv::Mat& binary, const cv::Mat& debug_img) {
     if (!binary.empty()) {
         auto binary_msg = cv_bridge::CvImage(std_msgs::msg::Header(), "mono8", binary).toImageMsg();
-        binary_pub_.publish(*binary_msg);
+        binary_pub_->publish(*binary_msg);
     }
     if (!debug_img.empty()) {
         auto debug_msg =
             cv_bridge::CvImage(std_msgs::msg::Header(), "bgr8", debug_img).toImageMsg();
-        debug_img_pub_.publish(*debug_msg);
+        debug_img_pub_->publish(*debug_msg);
     }
 }
 
-void ArmorDetectorNode::publishMarkers(const rm_interfaces::msg::Armors& armors_msg) {
+void ArmorDetectorNode::publishMarkers(const rm_interfaces::msg::CompactArmors& armors_msg) {
     visualization_msgs::msg::MarkerArray marker_array;
 
-    for (size_t i = 0; i < armors_msg.armors.size(); i++) {
+    for (size_t i = 0; i < armors_msg.armors_num; i++) {
         const auto& armor = armors_msg.armors[i];
         visualization_msgs::msg::Marker marker;
-        marker.header = armors_msg.header;
+        marker.header.stamp = armors_msg.stamp;
+        marker.header.frame_id = ARMOR_FRAME_ID;
         marker.ns = "armors";
         marker.id = static_cast<int>(i);
         marker.type = visualization_msgs::msg::Marker::CUBE;
         marker.action = visualization_msgs::msg::Marker::ADD;
         marker.pose = armor.pose;
         marker.scale.x = 0.02;
-        marker.scale.y = armor.type == "small" ? 0.133 : 0.227;
+        marker.scale.y =
+            armor.type == rm_interfaces::msg::CompactArmor::TYPE_SMALL ? 0.133 : 0.227;
         marker.scale.z = 0.056;
         marker.color.a = 0.8;
         marker.color.r = 0.0;
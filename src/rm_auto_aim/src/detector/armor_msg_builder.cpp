@@ -0,0 +1,95 @@
+#include "rm_auto_aim/detector/armor_msg_builder.hpp"
+
+#include <algorithm>
+
+#include <rclcpp/time.hpp>
+
+namespace rm_auto_aim {
+
+using CompactArmorMsg = rm_interfaces::msg::CompactArmor;
+
+// 消息常量必须与内部枚举保持一致（直接static_cast转换）
+static_assert(CompactArmorMsg::SYMBOL_UNKNOWN == static_cast<uint8_t>(ArmorSymbol::UNKNOWN));
+static_assert(CompactArmorMsg::SYMBOL_HERO == static_cast<uint8_t>(ArmorSymbol::HERO));
+static_assert(CompactArmorMsg::SYMBOL_ENGINEER == static_cast<uint8_t>(ArmorSymbol::ENGINEER));
+static_assert(CompactArmorMsg::SYMBOL_INFANTRY_3 == static_cast<uint8_t>(ArmorSymbol::INFANTRY_3));
+static_assert(CompactArmorMsg::SYMBOL_INFANTRY_4 == static_cast<uint8_t>(ArmorSymbol::INFANTRY_4));
+static_assert(CompactArmorMsg::SYMBOL_INFANTRY_5 == static_cast<uint8_t>(ArmorSymbol::INFANTRY_5));
+static_assert(CompactArmorMsg::SYMBOL_SENTRY == static_cast<uint8_t>(ArmorSymbol::SENTRY));
+static_assert(CompactArmorMsg::SYMBOL_OUTPOST == static_cast<uint8_t>(ArmorSymbol::OUTPOST));
+static_assert(CompactArmorMsg::SYMBOL_BASE == static_cast<uint8_t>(ArmorSymbol::BASE));
+static_assert(CompactArmorMsg::TYPE_SMALL == static_cast<uint8_t>(ArmorType::SMALL));
+static_assert(CompactArmorMsg::TYPE_LARGE == static_cast<uint8_t>(ArmorType::LARGE));
+static_assert(rm_interfaces::msg::CompactArmors::MAX_ARMORS == ArmorObservations::MAX_ARMORS);
+
+CompactArmorMsg toMsg(const ArmorObservation& armor) {
+    CompactArmorMsg armor_msg;
+    armor_msg.symbol = static_cast<uint8_t>(armor.symbol);
+    armor_msg.type = static_cast<uint8_t>(armor.type);
+    armor_msg.distance_to_image_center = armor.distance_to_image_center;
+
+    armor_msg.pose.position.x = armor.position.x();
+    armor_msg.pose.position.y = armor.position.y();
+    armor_msg.pose.position.z = armor.position.z();
+    armor_msg.pose.orientation.x = armor.orientation.x();
+    armor_msg.pose.orientation.y = armor.orientation.y();
+    armor_msg.pose.orientation.z = armor.orientation.z();
+    armor_msg.pose.orientation.w = armor.orientation.w();
+
+    for (size_t i = 0; i < armor.corners.size(); i++) {
+        armor_msg.corners[2 * i] = armor.corners[i].x;
+        armor_msg.corners[2 * i + 1] = armor.corners[i].y;
+    }
+    return armor_msg;
+}
+
+void toMsg(const ArmorObservations& armors, rm_interfaces::msg::CompactArmors& msg) {
+    msg.stamp = rclcpp::Time(armors.stamp_ns);
+    msg.camera_id = armors.camera;
+    msg.armors_num = armors.count;
+    for (uint8_t i = 0; i < armors.count; i++) {
+        msg.armors[i] = toMsg(armors.armors[i]);
+    }
+}
+
+void fromMsg(const rm_interfaces::msg::CompactArmors& msg, ArmorObservations& armors) {
+    armors.stamp_ns = rclcpp::Time(msg.stamp).nanoseconds();
+    armors.camera = msg.camera_id;
+    armors.count = std::min<uint8_t>(msg.armors_num, ArmorObservations::MAX_ARMORS);
+    for (uint8_t i = 0; i < armors.count; i++) {
+        const auto& src = msg.armors[i];
+        auto& armor = armors.armors[i];
+        armor.symbol = static_cast<ArmorSymbol>(src.symbol);
+        armor.type = static_cast<ArmorType>(src.type);
+        armor.distance_to_image_center = src.distance_to_image_center;
+        armor.position = Eigen::Vector3d(
+            src.pose.position.x, src.pose.position.y, src.pose.position.z);
+        armor.setOrientation(Eigen::Quaterniond(
+            src.pose.orientation.w, src.pose.orientation.x,
+            src.pose.orientation.y, src.pose.orientation.z));
+        for (size_t j = 0; j < armor.corners.size(); j++) {
+            armor.corners[j] = {src.corners[2 * j], src.corners[2 * j + 1]};
+        }
+    }
+}
+
+rm_interfaces::msg::Armors toArmorsMsg(
+    const rm_interfaces::msg::CompactArmors& armors, const std::string& frame_id)
+{
+    rm_interfaces::msg::Armors out;
+    out.header.stamp = armors.stamp;
+    out.header.frame_id = frame_id;
+    out.armors.reserve(armors.armors_num);
+    for (uint8_t i = 0; i < armors.armors_num; i++) {
+        const auto& src = armors.armors[i];
+        rm_interfaces::msg::Armor armor;
+        armor.number = armorSymbolName(static_cast<ArmorSymbol>(src.symbol));
+        armor.type = src.type == CompactArmorMsg::TYPE_SMALL ? "small" : "large";
+        armor.distance_to_image_center = src.distance_to_image_center;
+        armor.pose = src.pose;
+        out.armors.push_back(std::move(armor));
+    }
+    return out;
+}
+
+}  // namespace rm_auto_aim
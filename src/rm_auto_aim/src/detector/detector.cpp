@@ -55,9 +55,27 @@ std::vector<Armor> ArmorDetector::detect(const cv::Mat& input, Color detect_colo
 }
 
 void ArmorDetector::preprocess(const cv::Mat& input) {
-    cv::Mat gray;
-    cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
-    cv::threshold(gray, binary_, params_.binary_threshold, 255, cv::THRESH_BINARY);
+    ensureScratch(input.size());
+    cv::cvtColor(input, gray_, cv::COLOR_BGR2GRAY);
+    cv::threshold(gray_, binary_, params_.binary_threshold, 255, cv::THRESH_BINARY);
+}
+
+void ArmorDetector::ensureScratch(const cv::Size& size) {
+    if (gray_.size() == size && binary_.size() == size) {
+        return;
+    }
+    if (rtHugePagesEnabled()) {
+        // 两张单通道图共用一块预触碰的大页缓冲区，分辨率变化时才重新分配
+        const size_t bytes = static_cast<size_t>(size.area());
+        scratch_ = HugePageBuffer(bytes * 2);
+        if (scratch_.data()) {
+            gray_ = cv::Mat(size, CV_8UC1, scratch_.data());
+            binary_ = cv::Mat(size, CV_8UC1, scratch_.data() + bytes);
+            return;
+        }
+    }
+    gray_.create(size, CV_8UC1);
+    binary_.create(size, CV_8UC1);
 }
 
 std::vector<Light> ArmorDetector::detectLights(const cv::Mat& input, Color detect_color) {
@@ -108,18 +126,26 @@ bool ArmorDetector::isValidLight(const Light& light) const {
 }
 
 Color ArmorDetector::classifyLightColor(const cv::Mat& input, const cv::RotatedRect& rect) const {
-    // 获取灯条ROI
-    cv::Mat mask = cv::Mat::zeros(input.size(), CV_8UC1);
+    // 获取灯条ROI：掩码只覆盖外接矩形，不再为每个灯条分配整帧掩码
     cv::Point2f pts[4];
     rect.points(pts);
     std::vector<cv::Point> roi_pts;
     for (int i = 0; i < 4; i++) {
         roi_pts.emplace_back(static_cast<int>(pts[i].x), static_cast<int>(pts[i].y));
     }
-    cv::fillConvexPoly(mask, roi_pts, cv::Scalar(255));
+    const cv::Rect bbox = cv::boundingRect(roi_pts) & cv::Rect(0, 0, input.cols, input.rows);
 
     // 计算红蓝通道均值
-    cv::Scalar mean_val = cv::mean(input, mask);
+    cv::Scalar mean_val;
+    if (!bbox.empty()) {
+        color_mask_.create(bbox.size(), CV_8UC1);
+        color_mask_.setTo(0);
+        for (auto& pt : roi_pts) {
+            pt -= bbox.tl();
+        }
+        cv::fillConvexPoly(color_mask_, roi_pts, cv::Scalar(255));
+        mean_val = cv::mean(input(bbox), color_mask_);
+    }
     double b_mean = mean_val[0];
     double r_mean = mean_val[2];
 
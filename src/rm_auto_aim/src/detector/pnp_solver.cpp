@@ -1,8 +1,12 @@
 #include "rm_auto_aim/detector/pnp_solver.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <opencv2/calib3d.hpp>
 
+#include "rm_utils/task_pool.hpp"
+
 namespace rm_auto_aim {
 
 PnPSolver::PnPSolver(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs)
@@ -30,7 +34,7 @@ PnPSolver::PnPSolver(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs)
     };
 }
 
-bool PnPSolver::solve(const Armor& armor, cv::Mat& rvec, cv::Mat& tvec, double& yaw) {
+bool PnPSolver::solve(const Armor& armor, cv::Mat& rvec, cv::Mat& tvec, double& yaw) const {
     auto image_points = armor.corners();
     auto object_points = getObjectPoints(armor.type);
 
@@ -79,6 +83,63 @@ bool PnPSolver::solve(const Armor& armor, cv::Mat& rvec, cv::Mat& tvec, double&
     return true;
 }
 
+bool PnPSolver::solve(
+    const Armor& armor, const cv::Point2f& img_center, ArmorObservation& observation) const
+{
+    cv::Mat rvec, tvec;
+    double pnp_yaw;
+    if (!solve(armor, rvec, tvec, pnp_yaw)) {
+        return false;
+    }
+
+    observation.symbol = armor.symbol;
+    observation.type = armor.type;
+    observation.distance_to_image_center = armor.distanceToCenter(img_center);
+    observation.position = Eigen::Vector3d(
+        tvec.at<double>(0), tvec.at<double>(1), tvec.at<double>(2));
+
+    // 旋转：rvec → 四元数
+    cv::Mat rotation_matrix;
+    cv::Rodrigues(rvec, rotation_matrix);
+    Eigen::Matrix3d rotation;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            rotation(r, c) = rotation_matrix.at<double>(r, c);
+        }
+    }
+    observation.setOrientation(Eigen::Quaterniond(rotation));
+
+    const cv::Point2f corners[4] = {
+        armor.left_light.top, armor.right_light.top,
+        armor.right_light.bottom, armor.left_light.bottom};
+    for (int i = 0; i < 4; i++) {
+        observation.corners[i] = {corners[i].x, corners[i].y};
+    }
+    return true;
+}
+
+size_t PnPSolver::solveAll(
+    const std::vector<Armor>& armors, const cv::Point2f& img_center,
+    ArmorObservations& observations) const
+{
+    observations.clear();
+    const size_t count = std::min<size_t>(armors.size(), ArmorObservations::MAX_ARMORS);
+
+    // 各装甲板的PnP互相独立：先并行解到定长暂存区，再按检测顺序紧凑写入
+    std::array<ArmorObservation, ArmorObservations::MAX_ARMORS> solved;
+    std::array<bool, ArmorObservations::MAX_ARMORS> ok{};
+    parallelFor(0, count, [&](size_t i) {
+        ok[i] = solve(armors[i], img_center, solved[i]);
+    });
+
+    for (size_t i = 0; i < count; i++) {
+        if (ok[i]) {
+            observations.append(solved[i]);
+        }
+    }
+    return armors.size() - count;
+}
+
 double PnPSolver::extractYaw(const cv::Mat& rotation_matrix) {
     // 从旋转矩阵中提取yaw角
     // 使用 atan2(R[2][0], R[0][0]) 提取绕Y轴旋转
@@ -0,0 +1,142 @@
+#include "rm_auto_aim/detector/warmup.hpp"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <opencv2/imgproc.hpp>
+
+namespace rm_auto_aim {
+
+namespace {
+
+std::string expandUser(const std::string& path) {
+    if (!path.empty() && path[0] == '~') {
+        const char* home = std::getenv("HOME");
+        return std::string(home ? home : "") + path.substr(1);
+    }
+    return path;
+}
+
+// 逐级创建父目录
+void makeParentDirs(const std::string& path) {
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+        mkdir(path.substr(0, pos).c_str(), 0755);
+    }
+}
+
+}  // namespace
+
+cv::Size CameraCalibration::imageSize() const {
+    if (width > 0 && height > 0) {
+        return {width, height};
+    }
+    // 主点近似位于图像中心
+    return {static_cast<int>(camera_matrix.at<double>(0, 2) * 2.0 + 0.5),
+            static_cast<int>(camera_matrix.at<double>(1, 2) * 2.0 + 0.5)};
+}
+
+bool CameraCalibration::sameAs(const CameraCalibration& other) const {
+    if (!valid() || !other.valid() || width != other.width || height != other.height ||
+        dist_coeffs.total() != other.dist_coeffs.total()) {
+        return false;
+    }
+    return cv::norm(camera_matrix, other.camera_matrix, cv::NORM_INF) < 1e-9 &&
+           (dist_coeffs.empty() || cv::norm(dist_coeffs, other.dist_coeffs, cv::NORM_INF) < 1e-12);
+}
+
+CameraCalibration calibrationFromArrays(
+    const std::vector<double>& camera_matrix, const std::vector<double>& dist_coeffs,
+    int width, int height)
+{
+    CameraCalibration calibration;
+    if (camera_matrix.size() != 9 || camera_matrix[0] <= 0.0) {
+        return calibration;
+    }
+    calibration.camera_matrix = cv::Mat(3, 3, CV_64F, const_cast<double*>(camera_matrix.data())).clone();
+    calibration.dist_coeffs = dist_coeffs.empty()
+        ? cv::Mat::zeros(1, 5, CV_64F)
+        : cv::Mat(1, static_cast<int>(dist_coeffs.size()), CV_64F,
+                  const_cast<double*>(dist_coeffs.data())).clone();
+    calibration.width = width;
+    calibration.height = height;
+    return calibration;
+}
+
+bool loadCalibrationCache(const std::string& path, CameraCalibration& calibration) {
+    try {
+        cv::FileStorage fs(expandUser(path), cv::FileStorage::READ);
+        if (!fs.isOpened()) {
+            return false;
+        }
+        CameraCalibration loaded;
+        fs["camera_matrix"] >> loaded.camera_matrix;
+        fs["distortion_coefficients"] >> loaded.dist_coeffs;
+        fs["image_width"] >> loaded.width;
+        fs["image_height"] >> loaded.height;
+        if (!loaded.valid() || loaded.camera_matrix.type() != CV_64F) {
+            return false;
+        }
+        if (loaded.dist_coeffs.empty()) {
+            loaded.dist_coeffs = cv::Mat::zeros(1, 5, CV_64F);
+        }
+        calibration = loaded;
+        return true;
+    } catch (const cv::Exception&) {
+        return false;  // 文件损坏按无缓存处理
+    }
+}
+
+bool saveCalibrationCache(const std::string& path, const CameraCalibration& calibration) {
+    const std::string full = expandUser(path);
+    makeParentDirs(full);
+    try {
+        cv::FileStorage fs(full, cv::FileStorage::WRITE);
+        if (!fs.isOpened()) {
+            return false;
+        }
+        fs << "image_width" << calibration.width;
+        fs << "image_height" << calibration.height;
+        fs << "camera_matrix" << calibration.camera_matrix;
+        fs << "distortion_coefficients" << calibration.dist_coeffs;
+        return true;
+    } catch (const cv::Exception&) {
+        return false;
+    }
+}
+
+cv::Mat makeWarmupFrame(const cv::Size& size, Color color) {
+    cv::Mat frame(size, CV_8UC3, cv::Scalar(20, 20, 20));
+    // 灯条中心偏白、带目标颜色，灰度高于常用二值化阈值且红蓝通道差明显
+    const cv::Scalar light_color =
+        color == Color::RED ? cv::Scalar(80, 80, 255) : cv::Scalar(255, 80, 80);
+    const int length = std::max(size.height / 10, 12);
+    const int width = std::max(length / 5, 3);
+    const int gap = length * 23 / 10;  // 灯条中心距约为2.3倍灯条长度（小装甲板）
+    const cv::Point center(size.width / 2, size.height / 2);
+    for (const int dx : {-gap / 2, gap / 2}) {
+        cv::rectangle(frame,
+                      cv::Rect(center.x + dx - width / 2, center.y - length / 2, width, length),
+                      light_color, cv::FILLED);
+    }
+    return frame;
+}
+
+ArmorObservations warmUpDetection(
+    ArmorDetector& detector, PnPSolver* pnp_solver, const cv::Size& size,
+    Color color, int iterations)
+{
+    const cv::Mat frame = makeWarmupFrame(size, color);
+    const cv::Point2f img_center(size.width / 2.0f, size.height / 2.0f);
+    ArmorObservations observations;
+    for (int i = 0; i < iterations; i++) {
+        observations.clear();
+        const auto armors = detector.detect(frame, color);
+        if (pnp_solver) {
+            pnp_solver->solveAll(armors, img_center, observations);
+        }
+    }
+    return observations;
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,77 @@
+#include "rm_auto_aim/diagnostics/flight_recorder_node.hpp"
+
+#include <csignal>
+
+namespace rm_auto_aim {
+
+FlightRecorderNode::FlightRecorderNode(const rclcpp::NodeOptions& options)
+    : Node("flight_recorder", options)
+{
+    RCLCPP_INFO(get_logger(), "FlightRecorderNode 初始化中...");
+
+    this->declare_parameter("output_dir", "/tmp/rm_flight");
+    this->declare_parameter("window_s", 10.0);
+    this->declare_parameter("dump_on_lost", true);
+    this->declare_parameter("min_dump_interval_s", 5.0);
+    this->declare_parameter("dump_on_signal", true);
+
+    FlightRecorder::DumpConfig config;
+    config.output_dir = this->get_parameter("output_dir").as_string();
+    config.window_s = this->get_parameter("window_s").as_double();
+    config.dump_on_tracker_lost = this->get_parameter("dump_on_lost").as_bool();
+    config.min_interval_s = this->get_parameter("min_dump_interval_s").as_double();
+    // 回调在转储线程中执行，只捕获可拷贝的logger
+    config.on_dump = [logger = get_logger()](const std::string& path, long count) {
+        if (count < 0) {
+            RCLCPP_ERROR(logger, "飞行记录转储失败: %s", path.c_str());
+        } else {
+            RCLCPP_WARN(logger, "飞行记录已转储 %ld 条: %s", count, path.c_str());
+        }
+    };
+    window_s_ = config.window_s;
+    FlightRecorder::global().startDumper(config);
+
+    if (this->get_parameter("dump_on_signal").as_bool()) {
+        signal_installed_ = std::signal(SIGUSR1, &FlightRecorderNode::signalHandler) != SIG_ERR;
+    }
+
+    dump_srv_ = this->create_service<std_srvs::srv::Trigger>(
+        "~/dump", std::bind(&FlightRecorderNode::dumpCallback, this,
+                            std::placeholders::_1, std::placeholders::_2));
+
+#ifdef RM_FLIGHT_RECORDER_DISABLED
+    RCLCPP_WARN(get_logger(), "飞行记录器埋点已在编译期关闭，转储文件将为空");
+#endif
+    RCLCPP_INFO(get_logger(), "FlightRecorderNode 初始化完成（目录: %s, 窗口: %.1fs）",
+                config.output_dir.c_str(), window_s_);
+}
+
+FlightRecorderNode::~FlightRecorderNode() {
+    if (signal_installed_) {
+        std::signal(SIGUSR1, SIG_DFL);
+    }
+    FlightRecorder::global().stopDumper();
+}
+
+void FlightRecorderNode::signalHandler(int /*signum*/) {
+    FlightRecorder::global().requestDump(FlightDumpReason::SIGNAL);
+}
+
+void FlightRecorderNode::dumpCallback(
+    const std_srvs::srv::Trigger::Request::SharedPtr /*request*/,
+    std_srvs::srv::Trigger::Response::SharedPtr response)
+{
+    auto& recorder = FlightRecorder::global();
+    const auto path = recorder.makeDumpPath(FlightDumpReason::MANUAL);
+    const long count = recorder.dump(path, window_s_, FlightDumpReason::MANUAL);
+    response->success = count >= 0;
+    response->message = response->success
+        ? path + " (" + std::to_string(count) + " records)"
+        : "failed to write " + path;
+    RCLCPP_INFO(get_logger(), "手动转储: %s", response->message.c_str());
+}
+
+}  // namespace rm_auto_aim
+
+#include <rclcpp_components/register_node_macro.hpp>
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::FlightRecorderNode)
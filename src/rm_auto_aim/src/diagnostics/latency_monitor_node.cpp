@@ -0,0 +1,203 @@
+#include "rm_auto_aim/diagnostics/latency_monitor_node.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace rm_auto_aim {
+
+namespace {
+
+diagnostic_msgs::msg::KeyValue keyValue(const std::string& key, double value_ms) {
+    diagnostic_msgs::msg::KeyValue kv;
+    kv.key = key;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", value_ms);
+    kv.value = buf;
+    return kv;
+}
+
+diagnostic_msgs::msg::KeyValue keyValue(const std::string& key, const std::string& value) {
+    diagnostic_msgs::msg::KeyValue kv;
+    kv.key = key;
+    kv.value = value;
+    return kv;
+}
+
+void appendPercentiles(
+    diagnostic_msgs::msg::DiagnosticStatus& status, const std::string& prefix,
+    const LatencyHistogram::Snapshot& s) {
+    status.values.push_back(keyValue(prefix + "p50_ms", s.percentile(0.50) * 1e-6));
+    status.values.push_back(keyValue(prefix + "p90_ms", s.percentile(0.90) * 1e-6));
+    status.values.push_back(keyValue(prefix + "p99_ms", s.percentile(0.99) * 1e-6));
+    status.values.push_back(keyValue(prefix + "p999_ms", s.percentile(0.999) * 1e-6));
+    status.values.push_back(keyValue(prefix + "max_ms", s.max() * 1e-6));
+    status.values.push_back(keyValue(prefix + "mean_ms", s.mean() * 1e-6));
+}
+
+}  // namespace
+
+LatencyMonitorNode::LatencyMonitorNode(const rclcpp::NodeOptions& options)
+    : Node("latency_monitor", options)
+{
+    RCLCPP_INFO(get_logger(), "LatencyMonitorNode 初始化中...");
+
+    this->declare_parameter("enable_tracing", true);
+    this->declare_parameter("publish_period_s", 1.0);
+    this->declare_parameter("allocation_budget_per_frame", 0);
+    alloc_budget_per_frame_ = this->get_parameter("allocation_budget_per_frame").as_int();
+
+    auto& tracer = LatencyTracer::global();
+    tracer.setEnabled(this->get_parameter("enable_tracing").as_bool());
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; i++) {
+        const auto stage = static_cast<TraceStage>(i);
+        prev_since_capture_[i] = tracer.sinceCapture(stage).snapshot();
+        prev_stage_delta_[i] = tracer.stageDelta(stage).snapshot();
+    }
+
+    diagnostics_pub_ = this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+        "/diagnostics", 10);
+    dump_srv_ = this->create_service<std_srvs::srv::Trigger>(
+        "~/dump", std::bind(&LatencyMonitorNode::dumpCallback, this,
+                            std::placeholders::_1, std::placeholders::_2));
+
+    const double period = std::max(this->get_parameter("publish_period_s").as_double(), 0.1);
+    timer_ = this->create_wall_timer(
+        std::chrono::duration<double>(period),
+        std::bind(&LatencyMonitorNode::publishDiagnostics, this));
+
+    RCLCPP_INFO(get_logger(), "LatencyMonitorNode 初始化完成（追踪%s，分配计数%s）",
+                tracer.enabled() ? "开启" : "关闭",
+                AllocTracker::hooksActive() ? "开启" : "未加载钩子");
+}
+
+void LatencyMonitorNode::publishDiagnostics() {
+    auto& tracer = LatencyTracer::global();
+    diagnostic_msgs::msg::DiagnosticArray array;
+    array.header.stamp = this->now();
+
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; i++) {
+        const auto stage = static_cast<TraceStage>(i);
+        const auto since_capture = tracer.sinceCapture(stage).snapshot();
+        const auto stage_delta = tracer.stageDelta(stage).snapshot();
+        // 只发布本周期窗口内的分布
+        const auto window_total = since_capture - prev_since_capture_[i];
+        const auto window_delta = stage_delta - prev_stage_delta_[i];
+        prev_since_capture_[i] = since_capture;
+        prev_stage_delta_[i] = stage_delta;
+
+        diagnostic_msgs::msg::DiagnosticStatus status;
+        status.name = std::string("auto_aim/latency/") + traceStageName(stage);
+        status.hardware_id = "auto_aim";
+        status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+        status.message = window_total.count > 0 ? "ok" : "no samples";
+        status.values.push_back(keyValue("count", static_cast<double>(window_total.count)));
+        appendPercentiles(status, "total_", window_total);
+        appendPercentiles(status, "stage_", window_delta);
+        array.status.push_back(std::move(status));
+    }
+    array.status.push_back(allocationStatus());
+    diagnostics_pub_->publish(array);
+}
+
+diagnostic_msgs::msg::DiagnosticStatus LatencyMonitorNode::allocationStatus() {
+    diagnostic_msgs::msg::DiagnosticStatus status;
+    status.name = "auto_aim/allocations";
+    status.hardware_id = "auto_aim";
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    if (!AllocTracker::hooksActive()) {
+        status.message = "hooks inactive (LD_PRELOAD librm_alloc_hooks.so)";
+        return status;
+    }
+
+    auto count = [](uint64_t value) { return std::to_string(value); };
+    std::string over_budget;
+    for (size_t i = 0; i < ALLOC_TAG_COUNT; i++) {
+        const auto tag = static_cast<AllocTag>(i);
+        if (tag == AllocTag::OTHER) {
+            continue;  // 未标记的分配不按帧统计
+        }
+        const auto stats = AllocTracker::frameStats(tag);
+        const auto& prev = prev_alloc_frames_[i];
+        const uint64_t frames = stats.frames - prev.frames;
+        const std::string prefix = std::string(allocTagName(tag)) + "_";
+        status.values.push_back(keyValue(prefix + "frames", count(frames)));
+        if (frames > 0) {
+            const double allocs_per_frame =
+                static_cast<double>(stats.allocs - prev.allocs) / static_cast<double>(frames);
+            status.values.push_back(keyValue(prefix + "allocs_per_frame", allocs_per_frame));
+            status.values.push_back(keyValue(prefix + "allocs_max", count(stats.max_allocs)));
+            status.values.push_back(keyValue(
+                prefix + "bytes_per_frame",
+                static_cast<double>(stats.bytes - prev.bytes) / static_cast<double>(frames)));
+            if (alloc_budget_per_frame_ > 0 &&
+                stats.max_allocs > static_cast<uint64_t>(alloc_budget_per_frame_)) {
+                over_budget += (over_budget.empty() ? "" : ", ") + std::string(allocTagName(tag));
+            }
+        }
+        prev_alloc_frames_[i] = stats;
+    }
+
+    // 具名线程：窗口内分配次数（登记只增不减，下标与上次对应）
+    const auto threads = AllocTracker::threads();
+    for (size_t i = 0; i < threads.size(); i++) {
+        const auto& counters = threads[i].counters;
+        const uint64_t prev_allocs = i < prev_alloc_threads_.size()
+            ? prev_alloc_threads_[i].counters.allocs : 0;
+        status.values.push_back(keyValue("thread_" + threads[i].name + "_allocs",
+                                         count(counters.allocs - prev_allocs)));
+    }
+    prev_alloc_threads_ = threads;
+
+    if (!over_budget.empty()) {
+        status.level = diagnostic_msgs::msg::DiagnosticStatus::WARN;
+        status.message = "over budget (" + std::to_string(alloc_budget_per_frame_) +
+                         "/frame): " + over_budget;
+    } else {
+        status.message = "ok";
+    }
+    return status;
+}
+
+void LatencyMonitorNode::dumpCallback(
+    const std_srvs::srv::Trigger::Request::SharedPtr /*request*/,
+    std_srvs::srv::Trigger::Response::SharedPtr response)
+{
+    auto& tracer = LatencyTracer::global();
+    Snapshots since_capture;
+    Snapshots stage_delta;
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; i++) {
+        since_capture[i] = tracer.sinceCapture(static_cast<TraceStage>(i)).snapshot();
+        stage_delta[i] = tracer.stageDelta(static_cast<TraceStage>(i)).snapshot();
+    }
+    response->message = formatTable(since_capture, stage_delta);
+    response->success = true;
+    RCLCPP_INFO(get_logger(), "启动以来延迟统计:\n%s", response->message.c_str());
+}
+
+std::string LatencyMonitorNode::formatTable(
+    const Snapshots& since_capture, const Snapshots& stage_delta)
+{
+    std::string out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-16s %10s | %8s %8s %8s %8s | %8s %8s %8s\n",
+                  "stage", "count", "tot_p50", "tot_p99", "tot_p999", "tot_max",
+                  "stg_p50", "stg_p99", "stg_max");
+    out += line;
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; i++) {
+        const auto& t = since_capture[i];
+        const auto& d = stage_delta[i];
+        std::snprintf(line, sizeof(line),
+                      "%-16s %10lu | %8.3f %8.3f %8.3f %8.3f | %8.3f %8.3f %8.3f\n",
+                      traceStageName(static_cast<TraceStage>(i)), t.count,
+                      t.percentile(0.50) * 1e-6, t.percentile(0.99) * 1e-6,
+                      t.percentile(0.999) * 1e-6, t.max() * 1e-6,
+                      d.percentile(0.50) * 1e-6, d.percentile(0.99) * 1e-6, d.max() * 1e-6);
+        out += line;
+    }
+    return out;
+}
+
+}  // namespace rm_auto_aim
+
+#include <rclcpp_components/register_node_macro.hpp>
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::LatencyMonitorNode)
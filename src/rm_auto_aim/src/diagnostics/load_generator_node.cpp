@@ -0,0 +1,380 @@
+#include "rm_auto_aim/diagnostics/load_generator_node.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <opencv2/imgproc.hpp>
+
+#include "rm_auto_aim/detector/warmup.hpp"
+#include "rm_utils/buffer_pool.hpp"
+#include "rm_utils/latency_tracer.hpp"
+
+namespace rm_auto_aim {
+
+namespace {
+
+// 发布帧率上限
+constexpr double MAX_FPS = 1000.0;
+
+diagnostic_msgs::msg::KeyValue keyValue(const std::string& key, double value) {
+    diagnostic_msgs::msg::KeyValue kv;
+    kv.key = key;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", value);
+    kv.value = buf;
+    return kv;
+}
+
+}  // namespace
+
+LoadGeneratorNode::LoadGeneratorNode(const rclcpp::NodeOptions& options)
+    : Node("load_generator", options)
+{
+    RCLCPP_INFO(get_logger(), "LoadGeneratorNode 初始化中...");
+
+    width_ = static_cast<int>(this->declare_parameter("width", 1280));
+    height_ = static_cast<int>(this->declare_parameter("height", 1024));
+    clutter_ = static_cast<int>(this->declare_parameter("clutter", 8));
+    variants_ = static_cast<int>(std::max<int64_t>(1, this->declare_parameter("variants", 16)));
+    target_color_ = static_cast<int>(this->declare_parameter("target_color", 1));  // 0=BLUE, 1=RED
+    // 先把起始帧率限制在[1, MAX_FPS]，保证下面clamp的下限不大于上限
+    start_fps_ = std::clamp(this->declare_parameter("start_fps", 50.0), 1.0, MAX_FPS);
+    max_fps_ = std::clamp(this->declare_parameter("max_fps", MAX_FPS), start_fps_, MAX_FPS);
+    ramp_factor_ = std::max(this->declare_parameter("ramp_factor", 1.25), 1.01);
+    refine_steps_ = static_cast<int>(this->declare_parameter("refine_steps", 3));
+    step_duration_s_ = std::max(this->declare_parameter("step_duration_s", 3.0), 0.5);
+    warmup_s_ = this->declare_parameter("warmup_s", 2.0);
+    settle_s_ = std::max(this->declare_parameter("settle_s", 0.3), 0.05);
+    ready_timeout_s_ = this->declare_parameter("ready_timeout_s", 30.0);
+    latency_threshold_ms_ = this->declare_parameter("latency_threshold_ms", 20.0);
+    drop_threshold_ = this->declare_parameter("drop_threshold", 0.02);
+    config_label_ = this->declare_parameter("config_label", std::string("container"));
+    report_path_ = this->declare_parameter("report_path", std::string(""));
+    shutdown_on_finish_ = this->declare_parameter("shutdown_on_finish", true);
+    const auto camera_matrix = this->declare_parameter(
+        "camera_matrix", std::vector<double>{});
+    const int buffer_pool_size = static_cast<int>(this->declare_parameter("buffer_pool_size", 8));
+
+    // 内参：未配置时焦距取1.2倍宽度、主点位于图像中心
+    camera_info_msg_.width = width_;
+    camera_info_msg_.height = height_;
+    camera_info_msg_.distortion_model = "plumb_bob";
+    camera_info_msg_.d.assign(5, 0.0);
+    if (camera_matrix.size() == 9) {
+        std::copy(camera_matrix.begin(), camera_matrix.end(), camera_info_msg_.k.begin());
+    } else {
+        camera_info_msg_.k = {1.2 * width_, 0.0, width_ / 2.0,
+                              0.0, 1.2 * width_, height_ / 2.0,
+                              0.0, 0.0, 1.0};
+    }
+    camera_info_msg_.p = {camera_info_msg_.k[0], 0.0, camera_info_msg_.k[2], 0.0,
+                          0.0, camera_info_msg_.k[4], camera_info_msg_.k[5], 0.0,
+                          0.0, 0.0, 1.0, 0.0};
+
+    renderFrames();
+    BufferPool::global().reserve(static_cast<size_t>(std::max(buffer_pool_size, 1)),
+                                 static_cast<size_t>(width_) * height_ * 3);
+
+    image_pub_ = this->create_publisher<sensor_msgs::msg::Image>(
+        "/image_raw", rclcpp::SensorDataQoS());
+
+    // 与相机驱动一致：锁存发布，关闭进程内通信
+    rclcpp::PublisherOptions camera_info_options;
+    camera_info_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+    camera_info_pub_ = this->create_publisher<sensor_msgs::msg::CameraInfo>(
+        "/camera_info", rclcpp::QoS(1).reliable().transient_local(), camera_info_options);
+    diagnostics_pub_ = this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+        "/diagnostics", 10);
+    target_sub_ = this->create_subscription<rm_interfaces::msg::Target>(
+        "/solver/target", rclcpp::SensorDataQoS().keep_last(100),
+        std::bind(&LoadGeneratorNode::targetCallback, this, std::placeholders::_1));
+
+    publishCameraInfo();
+
+    running_ = true;
+    generator_thread_ = std::thread(&LoadGeneratorNode::generatorLoop, this);
+
+    RCLCPP_INFO(get_logger(),
+                "LoadGeneratorNode 初始化完成: [%s] %dx%d, 干扰物 %d, %.0f → %.0f fps (x%.2f), "
+                "阈值 p99 %.1f ms / 丢帧 %.1f%%",
+                config_label_.c_str(), width_, height_, clutter_, start_fps_, max_fps_,
+                ramp_factor_, latency_threshold_ms_, drop_threshold_ * 100.0);
+}
+
+LoadGeneratorNode::~LoadGeneratorNode() {
+    running_ = false;
+    if (generator_thread_.joinable()) {
+        generator_thread_.join();
+    }
+}
+
+void LoadGeneratorNode::renderFrames() {
+    const cv::Size size(width_, height_);
+    const auto color = static_cast<Color>(target_color_);
+    const cv::Mat base = makeWarmupFrame(size, color);
+    cv::RNG rng(0x5eed);  // 固定种子：同一配置每次生成相同的输入
+
+    frames_.clear();
+    for (int v = 0; v < variants_; v++) {
+        // 目标在画面中央附近水平往复移动
+        const double dx = 0.15 * width_ * std::sin(2.0 * CV_PI * v / variants_);
+        const cv::Mat shift = (cv::Mat_<double>(2, 3) << 1, 0, dx, 0, 1, 0);
+        cv::Mat frame;
+        cv::warpAffine(base, frame, shift, size, cv::INTER_NEAREST, cv::BORDER_CONSTANT,
+                       cv::Scalar(20, 20, 20));
+
+        // 干扰物：单根灯条（红/蓝，无法配对）、倾斜亮条与大块亮斑，避开画面中央的目标
+        for (int i = 0; i < clutter_; i++) {
+            const int x = rng.uniform(0, width_);
+            const int y = rng.uniform(0, height_);
+            if (std::abs(x - width_ / 2) < width_ / 4 && std::abs(y - height_ / 2) < height_ / 6) {
+                continue;
+            }
+            const int len = rng.uniform(height_ / 30 + 4, height_ / 8 + 8);
+            const cv::Scalar light = rng.uniform(0, 2) == 0 ? cv::Scalar(80, 80, 255)
+                                                            : cv::Scalar(255, 80, 80);
+            switch (rng.uniform(0, 3)) {
+                case 0:
+                    cv::rectangle(frame, cv::Rect(x, y, std::max(len / 5, 3), len), light, cv::FILLED);
+                    break;
+                case 1: {
+                    const double angle = rng.uniform(-1.2, 1.2);
+                    const cv::Point end(x + static_cast<int>(len * std::sin(angle)),
+                                        y + static_cast<int>(len * std::cos(angle)));
+                    cv::line(frame, {x, y}, end, light, std::max(len / 6, 2));
+                    break;
+                }
+                default:
+                    cv::circle(frame, {x, y}, len / 2, cv::Scalar(230, 230, 230), cv::FILLED);
+                    break;
+            }
+        }
+        frames_.push_back(frame);
+    }
+}
+
+void LoadGeneratorNode::publishCameraInfo() {
+    camera_info_msg_.header.stamp = this->now();
+    camera_info_msg_.header.frame_id = "camera_optical_frame";
+    camera_info_pub_->publish(camera_info_msg_);
+}
+
+void LoadGeneratorNode::publishFrame() {
+    const cv::Mat& frame = frames_[next_frame_];
+    next_frame_ = (next_frame_ + 1) % frames_.size();
+
+    // 与相机驱动一致：数据缓冲区取自全局池，检测节点处理完后归还
+    auto img_msg = std::make_unique<sensor_msgs::msg::Image>();
+    img_msg->height = static_cast<uint32_t>(height_);
+    img_msg->width = static_cast<uint32_t>(width_);
+    img_msg->encoding = "bgr8";
+    img_msg->is_bigendian = false;
+    img_msg->step = static_cast<uint32_t>(width_ * 3);
+    img_msg->data = BufferPool::global().acquire(frame.total() * frame.elemSize());
+    std::memcpy(img_msg->data.data(), frame.data, img_msg->data.size());
+
+    const int64_t stamp_ns = LatencyTracer::nowNs();
+    img_msg->header.stamp = rclcpp::Time(stamp_ns);
+    img_msg->header.frame_id = "camera_optical_frame";
+    LatencyTracer::global().mark(TraceStage::CAPTURE, stamp_ns);
+    image_pub_->publish(std::move(img_msg));
+}
+
+uint64_t LoadGeneratorNode::publishUntil(double fps, std::chrono::steady_clock::time_point deadline) {
+    const auto period = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / fps));
+    auto next = std::chrono::steady_clock::now();
+    uint64_t published = 0;
+    while (running_ && rclcpp::ok()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+        if (now < next) {
+            std::this_thread::sleep_until(std::min(next, deadline));
+            continue;
+        }
+        publishFrame();
+        published++;
+        // 落后超过一个周期时不补发（发生器自身的上限体现在achieved_fps中）
+        next = std::max(next + period, now);
+    }
+    return published;
+}
+
+LoadGeneratorNode::StepResult LoadGeneratorNode::runStep(double fps, double duration_s) {
+    StepResult result;
+    result.target_fps = fps;
+
+    step_start_ns_.store(LatencyTracer::nowNs(), std::memory_order_relaxed);
+    received_.store(0, std::memory_order_relaxed);
+    const auto before = latency_.snapshot();
+
+    const auto start = std::chrono::steady_clock::now();
+    result.published = publishUntil(
+        fps, start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(duration_s)));
+    const double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    // 停止发布后等待在途帧处理完
+    std::this_thread::sleep_for(std::chrono::duration<double>(settle_s_));
+    const auto window = latency_.snapshot() - before;
+
+    result.received = std::min(received_.load(std::memory_order_relaxed), result.published);
+    result.achieved_fps = elapsed > 0.0 ? result.published / elapsed : 0.0;
+    result.drop_rate = result.published > 0
+        ? 1.0 - static_cast<double>(result.received) / static_cast<double>(result.published)
+        : 1.0;
+    result.p50_ms = window.percentile(0.50) * 1e-6;
+    result.p99_ms = window.percentile(0.99) * 1e-6;
+    result.max_ms = window.max() * 1e-6;
+    // 发生器未达到目标帧率时本级不算通过（测得的是发生器而非下游的上限）
+    result.passed = result.received > 0 && result.p99_ms <= latency_threshold_ms_ &&
+                    result.drop_rate <= drop_threshold_ && result.achieved_fps >= 0.95 * fps;
+    return result;
+}
+
+void LoadGeneratorNode::generatorLoop() {
+    // 等待生命周期管理器激活检测/解算：以起始帧率发布直到收到第一条结果
+    const auto ready_deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(ready_timeout_s_));
+    while (running_ && total_received_.load() == 0) {
+        if (std::chrono::steady_clock::now() > ready_deadline) {
+            RCLCPP_ERROR(get_logger(), "%.0f s 内未收到 /solver/target，检查检测/解算是否已激活",
+                         ready_timeout_s_);
+            return;
+        }
+        publishUntil(start_fps_, std::chrono::steady_clock::now() + std::chrono::milliseconds(200));
+    }
+    if (!running_) {
+        return;
+    }
+    RCLCPP_INFO(get_logger(), "下游已就绪，预热 %.1f s 后开始逐级提升帧率", warmup_s_);
+    publishUntil(start_fps_, std::chrono::steady_clock::now() +
+                                 std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(warmup_s_)));
+
+    std::vector<StepResult> steps;
+    double sustainable = 0.0;
+    double failed_fps = 0.0;
+    auto runAndLog = [this, &steps](double fps) {
+        const auto step = runStep(fps, step_duration_s_);
+        RCLCPP_INFO(get_logger(),
+                    "[%s] 目标 %7.1f fps | 实际 %7.1f fps | 发布 %lu 收到 %lu 丢帧 %5.2f%% | "
+                    "p50 %6.2f p99 %6.2f max %6.2f ms | %s",
+                    config_label_.c_str(), step.target_fps, step.achieved_fps, step.published,
+                    step.received, step.drop_rate * 100.0, step.p50_ms, step.p99_ms, step.max_ms,
+                    step.passed ? "通过" : "超限");
+        steps.push_back(step);
+        return step;
+    };
+
+    // 逐级提升
+    for (double fps = start_fps_; running_; fps = std::min(fps * ramp_factor_, max_fps_)) {
+        const auto step = runAndLog(fps);
+        publishStatus(step, sustainable, false);
+        if (!step.passed) {
+            failed_fps = fps;
+            break;
+        }
+        sustainable = fps;
+        if (fps >= max_fps_) {
+            break;
+        }
+    }
+
+    // 在最后通过与首次失败之间二分细化
+    for (int i = 0; i < refine_steps_ && running_ && failed_fps > 0.0 && sustainable > 0.0; i++) {
+        const double fps = 0.5 * (sustainable + failed_fps);
+        const auto step = runAndLog(fps);
+        publishStatus(step, sustainable, false);
+        if (step.passed) {
+            sustainable = fps;
+        } else {
+            failed_fps = fps;
+        }
+    }
+
+    if (!running_) {
+        return;
+    }
+    report(steps, sustainable);
+    if (!steps.empty()) {
+        publishStatus(steps.back(), sustainable, true);
+    }
+    if (shutdown_on_finish_) {
+        rclcpp::shutdown();
+    }
+}
+
+void LoadGeneratorNode::targetCallback(const rm_interfaces::msg::Target::ConstSharedPtr& msg) {
+    const int64_t stamp_ns = rclcpp::Time(msg->header.stamp).nanoseconds();
+    total_received_.fetch_add(1, std::memory_order_relaxed);
+    if (stamp_ns < step_start_ns_.load(std::memory_order_relaxed)) {
+        return;  // 上一级的迟到结果
+    }
+    received_.fetch_add(1, std::memory_order_relaxed);
+    latency_.record(LatencyTracer::nowNs() - stamp_ns);
+}
+
+void LoadGeneratorNode::report(const std::vector<StepResult>& steps, double sustainable_fps) {
+    RCLCPP_INFO(get_logger(),
+                "[%s] %dx%d 干扰物 %d: 可持续帧率 %.1f fps（阈值 p99 %.1f ms / 丢帧 %.1f%%）%s",
+                config_label_.c_str(), width_, height_, clutter_, sustainable_fps,
+                latency_threshold_ms_, drop_threshold_ * 100.0,
+                sustainable_fps >= max_fps_ ? "，已达max_fps上限" : "");
+
+    if (report_path_.empty()) {
+        return;
+    }
+    std::FILE* file = std::fopen(report_path_.c_str(), "a");
+    if (!file) {
+        RCLCPP_WARN(get_logger(), "无法写入报告 %s", report_path_.c_str());
+        return;
+    }
+    std::fprintf(file,
+                 "{\"config\":\"%s\",\"width\":%d,\"height\":%d,\"clutter\":%d,"
+                 "\"latency_threshold_ms\":%.3f,\"drop_threshold\":%.4f,"
+                 "\"sustainable_fps\":%.1f,\"steps\":[",
+                 config_label_.c_str(), width_, height_, clutter_, latency_threshold_ms_,
+                 drop_threshold_, sustainable_fps);
+    for (size_t i = 0; i < steps.size(); i++) {
+        const auto& s = steps[i];
+        std::fprintf(file,
+                     "%s{\"target_fps\":%.1f,\"achieved_fps\":%.1f,\"published\":%lu,"
+                     "\"received\":%lu,\"drop_rate\":%.4f,\"p50_ms\":%.3f,\"p99_ms\":%.3f,"
+                     "\"max_ms\":%.3f,\"passed\":%s}",
+                     i == 0 ? "" : ",", s.target_fps, s.achieved_fps, s.published, s.received,
+                     s.drop_rate, s.p50_ms, s.p99_ms, s.max_ms, s.passed ? "true" : "false");
+    }
+    std::fprintf(file, "]}\n");
+    std::fclose(file);
+    RCLCPP_INFO(get_logger(), "结果已追加到 %s", report_path_.c_str());
+}
+
+void LoadGeneratorNode::publishStatus(const StepResult& step, double sustainable_fps, bool finished) {
+    diagnostic_msgs::msg::DiagnosticStatus status;
+    status.name = "auto_aim/load_generator";
+    status.hardware_id = "auto_aim";
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    status.message = (finished ? "finished [" : "ramping [") + config_label_ + "]";
+    status.values.push_back(keyValue("target_fps", step.target_fps));
+    status.values.push_back(keyValue("achieved_fps", step.achieved_fps));
+    status.values.push_back(keyValue("drop_rate", step.drop_rate));
+    status.values.push_back(keyValue("p50_ms", step.p50_ms));
+    status.values.push_back(keyValue("p99_ms", step.p99_ms));
+    status.values.push_back(keyValue("max_ms", step.max_ms));
+    status.values.push_back(keyValue("sustainable_fps", sustainable_fps));
+
+    diagnostic_msgs::msg::DiagnosticArray array;
+    array.header.stamp = this->now();
+    array.status.push_back(std::move(status));
+    diagnostics_pub_->publish(array);
+}
+
+}  // namespace rm_auto_aim
+
+#include <rclcpp_components/register_node_macro.hpp>
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::LoadGeneratorNode)
@@ -0,0 +1,103 @@
+#include "rm_auto_aim/diagnostics/rt_memory_node.hpp"
+
+#include <algorithm>
+
+namespace rm_auto_aim {
+
+namespace {
+
+diagnostic_msgs::msg::KeyValue keyValue(const std::string& key, uint64_t value) {
+    diagnostic_msgs::msg::KeyValue kv;
+    kv.key = key;
+    kv.value = std::to_string(value);
+    return kv;
+}
+
+}  // namespace
+
+RtMemoryNode::RtMemoryNode(const rclcpp::NodeOptions& options)
+    : Node("rt_memory", options)
+{
+    RCLCPP_INFO(get_logger(), "RtMemoryNode 初始化中...");
+
+    this->declare_parameter("enable", false);
+    this->declare_parameter("lock_memory", true);
+    this->declare_parameter("prefault_heap_mb", 64);
+    this->declare_parameter("prefault_stack_kb", 256);
+    this->declare_parameter("huge_pages", true);
+    this->declare_parameter("report_period_s", 5.0);
+
+    if (this->get_parameter("enable").as_bool()) {
+        RtMemoryOptions rt;
+        rt.lock_memory = this->get_parameter("lock_memory").as_bool();
+        rt.prefault_heap_bytes = static_cast<size_t>(
+            std::max<int64_t>(0, this->get_parameter("prefault_heap_mb").as_int())) << 20;
+        rt.prefault_stack_bytes = static_cast<size_t>(
+            std::max<int64_t>(0, this->get_parameter("prefault_stack_kb").as_int())) << 10;
+        rt.huge_pages = this->get_parameter("huge_pages").as_bool();
+
+        std::string message;
+        if (enableRtMemory(rt, &message)) {
+            RCLCPP_INFO(get_logger(), "实时内存模式已开启: %s", message.c_str());
+        } else {
+            RCLCPP_WARN(get_logger(), "实时内存模式部分降级: %s", message.c_str());
+        }
+    }
+
+    prev_report_ = readMemoryReport();
+    RCLCPP_INFO(get_logger(), "内存: %s", formatMemoryReport(prev_report_).c_str());
+
+    diagnostics_pub_ = this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+        "/diagnostics", 10);
+    report_srv_ = this->create_service<std_srvs::srv::Trigger>(
+        "~/report", std::bind(&RtMemoryNode::reportCallback, this,
+                              std::placeholders::_1, std::placeholders::_2));
+
+    const double period = std::max(this->get_parameter("report_period_s").as_double(), 0.1);
+    timer_ = this->create_wall_timer(
+        std::chrono::duration<double>(period), std::bind(&RtMemoryNode::publishReport, this));
+
+    RCLCPP_INFO(get_logger(), "RtMemoryNode 初始化完成");
+}
+
+void RtMemoryNode::publishReport() {
+    const auto report = readMemoryReport();
+    const uint64_t minor_delta = report.minor_faults - prev_report_.minor_faults;
+    const uint64_t major_delta = report.major_faults - prev_report_.major_faults;
+    prev_report_ = report;
+
+    diagnostic_msgs::msg::DiagnosticStatus status;
+    status.name = "auto_aim/memory";
+    status.hardware_id = "auto_aim";
+    // 稳态下仍有主缺页（读盘）说明热路径会被阻塞数毫秒
+    status.level = major_delta > 0 ? diagnostic_msgs::msg::DiagnosticStatus::WARN
+                                   : diagnostic_msgs::msg::DiagnosticStatus::OK;
+    status.message = rtMemoryEnabled() ? "rt memory" : "default memory";
+    status.values.push_back(keyValue("rss_kb", report.rss_kb));
+    status.values.push_back(keyValue("rss_peak_kb", report.rss_peak_kb));
+    status.values.push_back(keyValue("locked_kb", report.locked_kb));
+    status.values.push_back(keyValue("anon_huge_kb", report.anon_huge_kb));
+    status.values.push_back(keyValue("hugetlb_kb", report.hugetlb_kb));
+    status.values.push_back(keyValue("huge_buffer_kb", report.huge_buffer_kb));
+    status.values.push_back(keyValue("minor_faults_window", minor_delta));
+    status.values.push_back(keyValue("major_faults_window", major_delta));
+
+    diagnostic_msgs::msg::DiagnosticArray array;
+    array.header.stamp = this->now();
+    array.status.push_back(std::move(status));
+    diagnostics_pub_->publish(array);
+}
+
+void RtMemoryNode::reportCallback(
+    const std_srvs::srv::Trigger::Request::SharedPtr /*request*/,
+    std_srvs::srv::Trigger::Response::SharedPtr response)
+{
+    response->message = formatMemoryReport(readMemoryReport());
+    response->success = true;
+    RCLCPP_INFO(get_logger(), "内存: %s", response->message.c_str());
+}
+
+}  // namespace rm_auto_aim
+
+#include <rclcpp_components/register_node_macro.hpp>
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::RtMemoryNode)
@@ -0,0 +1,77 @@
+#include "rm_auto_aim/diagnostics/task_pool_node.hpp"
+
+#include <algorithm>
+
+namespace rm_auto_aim {
+
+namespace {
+
+diagnostic_msgs::msg::KeyValue keyValue(const std::string& key, uint64_t value) {
+    diagnostic_msgs::msg::KeyValue kv;
+    kv.key = key;
+    kv.value = std::to_string(value);
+    return kv;
+}
+
+}  // namespace
+
+TaskPoolNode::TaskPoolNode(const rclcpp::NodeOptions& options)
+    : Node("task_pool", options)
+{
+    const auto pool_options = declareTaskPoolOptions(*this);
+    this->declare_parameter("hot_pending_warn", 16);
+    this->declare_parameter("report_period_s", 5.0);
+    hot_pending_warn_ = static_cast<size_t>(
+        std::max<int64_t>(1, this->get_parameter("hot_pending_warn").as_int()));
+
+    std::string message;
+    if (TaskPool::global().start(pool_options, &message)) {
+        RCLCPP_INFO(get_logger(), "任务池已启动: %s", message.c_str());
+    } else {
+        RCLCPP_WARN(get_logger(), "%s", message.c_str());
+    }
+
+    diagnostics_pub_ = this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+        "/diagnostics", 10);
+    const double period = std::max(this->get_parameter("report_period_s").as_double(), 0.1);
+    timer_ = this->create_wall_timer(
+        std::chrono::duration<double>(period), std::bind(&TaskPoolNode::publishStats, this));
+}
+
+void TaskPoolNode::publishStats() {
+    diagnostic_msgs::msg::DiagnosticStatus status;
+    status.name = "auto_aim/task_pool";
+    status.hardware_id = "auto_aim";
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    status.message = "ok";
+
+    for (size_t i = 0; i < TASK_PRIORITY_COUNT; i++) {
+        const auto priority = static_cast<TaskPriority>(i);
+        const auto stats = TaskPool::global().stats(priority);
+        const auto& prev = prev_stats_[i];
+        const std::string prefix = std::string(taskPriorityName(priority)) + ".";
+        status.values.push_back(keyValue(prefix + "threads", static_cast<uint64_t>(stats.threads)));
+        status.values.push_back(keyValue(prefix + "pending", stats.pending));
+        status.values.push_back(keyValue(prefix + "executed_window", stats.executed - prev.executed));
+        status.values.push_back(keyValue(prefix + "stolen_window", stats.stolen - prev.stolen));
+        status.values.push_back(keyValue(prefix + "helped_window", stats.helped - prev.helped));
+        prev_stats_[i] = stats;
+    }
+
+    // 关键路径任务积压说明HOT线程不足或被其他线程抢占
+    const auto hot = TaskPool::global().stats(TaskPriority::HOT);
+    if (hot.pending >= hot_pending_warn_) {
+        status.level = diagnostic_msgs::msg::DiagnosticStatus::WARN;
+        status.message = "hot tasks backlog";
+    }
+
+    diagnostic_msgs::msg::DiagnosticArray array;
+    array.header.stamp = this->now();
+    array.status.push_back(std::move(status));
+    diagnostics_pub_->publish(array);
+}
+
+}  // namespace rm_auto_aim
+
+#include <rclcpp_components/register_node_macro.hpp>
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::TaskPoolNode)
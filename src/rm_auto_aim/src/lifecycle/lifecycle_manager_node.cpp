@@ -0,0 +1,308 @@
+#include "rm_auto_aim/lifecycle/lifecycle_manager_node.hpp"
+
+#include <lifecycle_msgs/msg/state.hpp>
+#include <lifecycle_msgs/msg/transition.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+#include "rm_utils/startup_clock.hpp"
+
+namespace rm_auto_aim {
+
+namespace {
+
+using lifecycle_msgs::msg::State;
+using lifecycle_msgs::msg::Transition;
+
+diagnostic_msgs::msg::KeyValue keyValue(const std::string& key, double seconds) {
+    diagnostic_msgs::msg::KeyValue kv;
+    kv.key = key;
+    if (seconds >= 0.0) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f", seconds);
+        kv.value = buf;
+    } else {
+        kv.value = "-";
+    }
+    return kv;
+}
+
+}  // namespace
+
+LifecycleManagerNode::LifecycleManagerNode(const rclcpp::NodeOptions& options)
+    : Node("lifecycle_manager", options)
+{
+    RCLCPP_INFO(get_logger(), "LifecycleManagerNode 初始化中...");
+
+    this->declare_parameter("managed_nodes", std::vector<std::string>{
+        "serial_driver", "armor_solver", "armor_detector", "camera_driver"});
+    this->declare_parameter("autostart", true);
+    this->declare_parameter("retry_period_s", 0.5);
+    this->declare_parameter("request_timeout_s", 10.0);
+    this->declare_parameter("supervise_period_s", 0.5);
+    this->declare_parameter("step_period_ms", 10);
+    this->declare_parameter("first_command_topic", "/solver/gimbal_cmd");
+
+    retry_period_s_ = std::max(this->get_parameter("retry_period_s").as_double(), 0.01);
+    request_timeout_s_ = std::max(this->get_parameter("request_timeout_s").as_double(), 0.1);
+    supervise_period_s_ = std::max(this->get_parameter("supervise_period_s").as_double(), 0.01);
+
+    // 受管节点与依赖（节点名相对本节点命名空间解析）
+    const auto names = this->get_parameter("managed_nodes").as_string_array();
+    stages_.resize(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        auto& stage = stages_[i];
+        stage.name = names[i];
+        this->declare_parameter(stage.name + ".depends_on", std::vector<std::string>{""});
+        this->declare_parameter(stage.name + ".required", true);
+        stage.required = this->get_parameter(stage.name + ".required").as_bool();
+        stage.get_state = this->create_client<lifecycle_msgs::srv::GetState>(
+            stage.name + "/get_state");
+        stage.change_state = this->create_client<lifecycle_msgs::srv::ChangeState>(
+            stage.name + "/change_state");
+    }
+    for (auto& stage : stages_) {
+        for (const auto& dep : this->get_parameter(stage.name + ".depends_on").as_string_array()) {
+            if (dep.empty()) continue;
+            auto it = std::find(names.begin(), names.end(), dep);
+            if (it == names.end()) {
+                RCLCPP_WARN(get_logger(), "%s 依赖的 %s 不在受管节点中，已忽略",
+                            stage.name.c_str(), dep.c_str());
+                continue;
+            }
+            stage.depends_on.push_back(static_cast<size_t>(it - names.begin()));
+        }
+    }
+
+    diagnostics_pub_ = this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+        "/diagnostics", 10);
+    first_command_sub_ = this->create_subscription<rm_interfaces::msg::GimbalCmd>(
+        this->get_parameter("first_command_topic").as_string(), rclcpp::SensorDataQoS(),
+        std::bind(&LifecycleManagerNode::firstCommandCallback, this, std::placeholders::_1));
+
+    if (this->get_parameter("autostart").as_bool()) {
+        step_timer_ = this->create_wall_timer(
+            std::chrono::milliseconds(std::max<int64_t>(
+                1, this->get_parameter("step_period_ms").as_int())),
+            std::bind(&LifecycleManagerNode::step, this));
+    }
+
+    RCLCPP_INFO(get_logger(), "LifecycleManagerNode 初始化完成: 管理 %zu 个节点（进程启动后 %.3f s）",
+                stages_.size(), secondsSinceProcessStart());
+}
+
+bool LifecycleManagerNode::dependenciesSatisfied(const Stage& stage) const {
+    for (size_t dep : stage.depends_on) {
+        const auto& d = stages_[dep];
+        if (d.phase == Phase::ACTIVE) continue;
+        // 非必需节点配置失败（如调试时无串口）时不阻塞下游
+        if (!d.required && d.configure_failed) continue;
+        return false;
+    }
+    return true;
+}
+
+void LifecycleManagerNode::step() {
+    const double now_s = secondsSinceProcessStart();
+    bool all_active = true;   // 全部激活
+    bool ready = true;        // 必需节点全部激活（非必需节点缺席不影响瞄准）
+    for (size_t i = 0; i < stages_.size(); i++) {
+        auto& stage = stages_[i];
+        all_active = all_active && stage.phase == Phase::ACTIVE;
+        ready = ready && (stage.phase == Phase::ACTIVE ||
+                          (!stage.required && stage.configure_failed));
+        if (stage.pending) {
+            if (now_s - stage.pending_since_s > request_timeout_s_) {
+                abandonRequest(i, now_s);
+            }
+            continue;
+        }
+
+        switch (stage.phase) {
+            case Phase::UNKNOWN:
+                if (now_s >= stage.retry_at_s && stage.get_state->service_is_ready()) {
+                    queryState(i);
+                }
+                break;
+            case Phase::UNCONFIGURED:
+                if (now_s >= stage.retry_at_s && stage.change_state->service_is_ready()) {
+                    requestTransition(i, Transition::TRANSITION_CONFIGURE);
+                }
+                break;
+            case Phase::CONFIGURED:
+                if (now_s >= stage.retry_at_s && dependenciesSatisfied(stage)) {
+                    requestTransition(i, Transition::TRANSITION_ACTIVATE);
+                }
+                break;
+            case Phase::ACTIVE:
+                // 持续监督：节点进程退出后服务消失，重启后回到未配置，均重新纳入管理
+                if (now_s >= stage.check_at_s) {
+                    stage.check_at_s = now_s + supervise_period_s_;
+                    if (stage.get_state->service_is_ready()) {
+                        queryState(i);
+                    } else {
+                        RCLCPP_WARN(get_logger(), "%s 的生命周期服务已消失（节点退出？），等待其重新上线",
+                                    stage.name.c_str());
+                        stage.phase = Phase::UNKNOWN;
+                    }
+                }
+                break;
+        }
+    }
+
+    if (ready && all_active_s_ < 0.0) {
+        all_active_s_ = now_s;
+        RCLCPP_INFO(get_logger(), "%s: 进程启动后 %.3f s（系统启动后 %.3f s）",
+                    all_active ? "全部节点已激活" : "必需节点已激活", all_active_s_,
+                    secondsSinceBoot());
+        publishReport();
+    }
+}
+
+void LifecycleManagerNode::queryState(size_t index) {
+    auto& stage = stages_[index];
+    stage.pending = true;
+    stage.pending_get_state = true;
+    stage.pending_since_s = secondsSinceProcessStart();
+    stage.pending_request_id = stage.get_state->async_send_request(
+        std::make_shared<lifecycle_msgs::srv::GetState::Request>(),
+        [this, index](rclcpp::Client<lifecycle_msgs::srv::GetState>::SharedFuture future) {
+            auto& stage = stages_[index];
+            stage.pending = false;
+            const uint8_t id = future.get()->current_state.id;
+            if (stage.phase == Phase::ACTIVE && id != State::PRIMARY_STATE_ACTIVE) {
+                RCLCPP_WARN(get_logger(), "%s 已离开激活状态（%u），重新管理",
+                            stage.name.c_str(), static_cast<unsigned>(id));
+            }
+            if (id == State::PRIMARY_STATE_ACTIVE) {
+                if (stage.phase != Phase::ACTIVE) {
+                    stage.phase = Phase::ACTIVE;
+                    stage.active_s = secondsSinceProcessStart();
+                }
+            } else if (id == State::PRIMARY_STATE_INACTIVE) {
+                stage.phase = Phase::CONFIGURED;
+                stage.configured_s = secondsSinceProcessStart();
+            } else if (id == State::PRIMARY_STATE_UNCONFIGURED) {
+                stage.phase = Phase::UNCONFIGURED;
+            } else {
+                // 过渡中或已终止：稍后再查
+                stage.phase = Phase::UNKNOWN;
+                stage.retry_at_s = secondsSinceProcessStart() + retry_period_s_;
+            }
+        }).request_id;
+}
+
+void LifecycleManagerNode::requestTransition(size_t index, uint8_t transition_id) {
+    auto& stage = stages_[index];
+    auto request = std::make_shared<lifecycle_msgs::srv::ChangeState::Request>();
+    request->transition.id = transition_id;
+    stage.pending = true;
+    stage.pending_get_state = false;
+    stage.pending_since_s = secondsSinceProcessStart();
+    if (transition_id == Transition::TRANSITION_CONFIGURE) {
+        stage.configure_attempts++;
+    }
+    stage.pending_request_id = stage.change_state->async_send_request(
+        request,
+        [this, index, transition_id](
+            rclcpp::Client<lifecycle_msgs::srv::ChangeState>::SharedFuture future) {
+            onTransitionDone(index, transition_id, future.get()->success);
+        }).request_id;
+}
+
+void LifecycleManagerNode::abandonRequest(size_t index, double now_s) {
+    auto& stage = stages_[index];
+    // 移除后迟到的响应被客户端丢弃，不会再进入回调
+    if (stage.pending_get_state) {
+        stage.get_state->remove_pending_request(stage.pending_request_id);
+    } else {
+        stage.change_state->remove_pending_request(stage.pending_request_id);
+    }
+    RCLCPP_WARN(get_logger(), "%s 的%s请求 %.1f s 未返回，放弃并重新查询状态",
+                stage.name.c_str(), stage.pending_get_state ? "状态查询" : "状态切换",
+                now_s - stage.pending_since_s);
+    stage.pending = false;
+    stage.phase = Phase::UNKNOWN;
+    stage.retry_at_s = now_s + retry_period_s_;
+}
+
+void LifecycleManagerNode::onTransitionDone(size_t index, uint8_t transition_id, bool success) {
+    auto& stage = stages_[index];
+    stage.pending = false;
+    const double now_s = secondsSinceProcessStart();
+
+    if (!success) {
+        if (transition_id == Transition::TRANSITION_CONFIGURE) {
+            stage.configure_failed = true;
+            if (stage.configure_attempts == 1) {
+                RCLCPP_WARN(get_logger(), "%s 尚未就绪，每 %.2f s 重试配置%s",
+                            stage.name.c_str(), retry_period_s_,
+                            stage.required ? "" : "（非必需，不阻塞下游）");
+            }
+        } else {
+            RCLCPP_WARN(get_logger(), "%s 激活失败，%.2f s 后重试",
+                        stage.name.c_str(), retry_period_s_);
+        }
+        stage.retry_at_s = now_s + retry_period_s_;
+        // 失败后节点可能停在任意状态，重新查询
+        stage.phase = Phase::UNKNOWN;
+        return;
+    }
+
+    if (transition_id == Transition::TRANSITION_CONFIGURE) {
+        stage.phase = Phase::CONFIGURED;
+        stage.configure_failed = false;
+        stage.configured_s = now_s;
+        RCLCPP_INFO(get_logger(), "%s 就绪: 进程启动后 %.3f s（配置 %d 次）",
+                    stage.name.c_str(), now_s, stage.configure_attempts);
+    } else {
+        stage.phase = Phase::ACTIVE;
+        stage.active_s = now_s;
+        RCLCPP_INFO(get_logger(), "%s 已激活: 进程启动后 %.3f s",
+                    stage.name.c_str(), now_s);
+    }
+    // 依赖它的节点不必等下一个周期
+    step();
+}
+
+void LifecycleManagerNode::firstCommandCallback(
+    const rm_interfaces::msg::GimbalCmd::ConstSharedPtr& /*msg*/)
+{
+    if (first_command_s_ >= 0.0) return;
+    first_command_s_ = secondsSinceProcessStart();
+    // 只统计第一条：取消订阅，稳态下命令发布不再为本节点额外走一遍中间件
+    first_command_sub_.reset();
+    if (all_active_s_ >= 0.0) {
+        RCLCPP_INFO(get_logger(), "首条云台命令: 进程启动后 %.3f s（全部激活后 %.3f s，系统启动后 %.3f s）",
+                    first_command_s_, first_command_s_ - all_active_s_, secondsSinceBoot());
+    } else {
+        RCLCPP_INFO(get_logger(), "首条云台命令: 进程启动后 %.3f s（系统启动后 %.3f s）",
+                    first_command_s_, secondsSinceBoot());
+    }
+    publishReport();
+}
+
+void LifecycleManagerNode::publishReport() {
+    diagnostic_msgs::msg::DiagnosticStatus status;
+    status.name = "auto_aim/startup";
+    status.hardware_id = "auto_aim";
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    status.message = first_command_s_ >= 0.0 ? "commanding" : "ready";
+    for (const auto& stage : stages_) {
+        status.values.push_back(keyValue(stage.name + ".ready_s", stage.configured_s));
+        status.values.push_back(keyValue(stage.name + ".active_s", stage.active_s));
+    }
+    status.values.push_back(keyValue("all_active_s", all_active_s_));
+    status.values.push_back(keyValue("first_command_s", first_command_s_));
+
+    diagnostic_msgs::msg::DiagnosticArray array;
+    array.header.stamp = this->now();
+    array.status.push_back(std::move(status));
+    diagnostics_pub_->publish(array);
+}
+
+}  // namespace rm_auto_aim
+
+#include <rclcpp_components/register_node_macro.hpp>
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::LifecycleManagerNode)
@@ -0,0 +1,508 @@
+#include "rm_auto_aim/pipeline/auto_aim_pipeline.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "rm_auto_aim/detector/armor_msg_builder.hpp"
+#include "rm_auto_aim/detector/warmup.hpp"
+#include "rm_hardware_driver/capture_timestamp.hpp"
+#include "rm_hardware_driver/serial_protocol.hpp"
+#include "rm_utils/alloc_tracker.hpp"
+#include "rm_utils/flight_recorder.hpp"
+#include "rm_utils/latency_tracer.hpp"
+#include "rm_utils/startup_clock.hpp"
+
+namespace rm_auto_aim {
+
+AutoAimPipeline::AutoAimPipeline(const rclcpp::NodeOptions& options)
+    : Node("auto_aim_pipeline", options)
+{
+    RCLCPP_INFO(get_logger(), "AutoAimPipeline 初始化中...");
+
+    declareParameters();
+
+    // 算法模块
+    detector_ = std::make_unique<ArmorDetector>(loadDetectorParams());
+    solver_ = std::make_unique<ArmorSolver>(loadSolverParams());
+
+    // 相机内参直接取自参数，无需等待/camera_info
+    auto k = this->get_parameter("camera.camera_matrix").as_double_array();
+    auto d = this->get_parameter("camera.distortion_coefficients").as_double_array();
+    cv::Mat camera_matrix(3, 3, CV_64F);
+    for (int i = 0; i < 9 && i < static_cast<int>(k.size()); i++) {
+        camera_matrix.at<double>(i / 3, i % 3) = k[i];
+    }
+    cv::Mat dist_coeffs(1, static_cast<int>(d.size()), CV_64F);
+    for (size_t i = 0; i < d.size(); i++) {
+        dist_coeffs.at<double>(0, static_cast<int>(i)) = d[i];
+    }
+    pnp_solver_ = std::make_unique<PnPSolver>(camera_matrix, dist_coeffs);
+
+    // 级间队列：图像内存池大小 = 就绪队列深度 + 采集/检测各持有一帧
+    size_t depth = static_cast<size_t>(std::max<int64_t>(
+        1, this->get_parameter("queue_depth").as_int()));
+    size_t pool_size = depth + 2;
+    free_frames_ = std::make_unique<SpscQueue<Frame>>(pool_size);
+    ready_frames_ = std::make_unique<SpscQueue<Frame>>(depth);
+    detections_ = std::make_unique<SpscQueue<Detection>>(depth);
+    observations_ = std::make_unique<SpscQueue<Observation>>(
+        static_cast<size_t>(this->get_parameter("observation_queue_depth").as_int()));
+
+    // 旁路发布
+    publish_observations_ = this->get_parameter("publish_observations").as_bool();
+    if (publish_observations_) {
+        armors_pub_ = this->create_publisher<rm_interfaces::msg::CompactArmors>(
+            "/detector/armors", rclcpp::SensorDataQoS());
+        target_pub_ = this->create_publisher<rm_interfaces::msg::Target>(
+            "/solver/target", rclcpp::SensorDataQoS());
+        gimbal_cmd_pub_ = this->create_publisher<rm_interfaces::msg::GimbalCmd>(
+            "/solver/gimbal_cmd", rclcpp::SensorDataQoS());
+        publish_timer_ = this->create_wall_timer(
+            std::chrono::milliseconds(5),
+            std::bind(&AutoAimPipeline::publishObservations, this));
+    }
+
+    openSerial();
+    if (!openCamera()) {
+        throw std::runtime_error("无法打开相机/视频源");
+    }
+
+    // 预分配图像内存
+    int width = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_WIDTH));
+    int height = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_HEIGHT));
+    const size_t frame_bytes = static_cast<size_t>(width) * height * 3;
+    frame_storage_.reserve(pool_size);
+    for (size_t i = 0; i < pool_size; i++) {
+        Frame frame;
+        if (rtHugePagesEnabled()) {
+            // 帧数据放在预触碰的大页缓冲区上；分辨率变化时cap_.read会自行重新分配
+            HugePageBuffer storage(frame_bytes);
+            if (storage.data()) {
+                frame.image = cv::Mat(height, width, CV_8UC3, storage.data());
+                frame_storage_.push_back(std::move(storage));
+            }
+        }
+        if (frame.image.empty()) {
+            frame.image.create(height, width, CV_8UC3);
+        }
+        free_frames_->tryPush(std::move(frame));
+    }
+
+    // 按实际分辨率预热 检测 → PnP → 跟踪 → 补偿，第一帧真实图像即为稳态延迟
+    if (this->get_parameter("warmup.enable").as_bool()) {
+        const int iterations = static_cast<int>(this->get_parameter("warmup.iterations").as_int());
+        const auto start = std::chrono::steady_clock::now();
+        const auto armors = warmUpDetection(
+            *detector_, pnp_solver_.get(), cv::Size(width, height), detect_color_, iterations);
+        const bool compensated = solver_->warmUp(iterations);
+        RCLCPP_INFO(get_logger(), "预热完成: %.1f ms, 合成帧装甲板 %u, 补偿路径%s",
+                    std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start).count(),
+                    static_cast<unsigned>(armors.count), compensated ? "已执行" : "未执行");
+    }
+
+    // 解算遥测：预热之后再挂上，合成帧不写入
+    if (this->get_parameter("telemetry.enable").as_bool()) {
+        TelemetryWriter::Options options;
+        options.block_rows = static_cast<uint32_t>(
+            std::max<int64_t>(1, this->get_parameter("telemetry.block_rows").as_int()));
+        options.queue_capacity = static_cast<size_t>(
+            std::max<int64_t>(2, this->get_parameter("telemetry.queue_capacity").as_int()));
+        options.placement = telemetry_placement_;
+        telemetry_ = std::make_unique<TelemetryWriter>();
+        std::string error;
+        if (openSolverTelemetry(*telemetry_, this->get_parameter("telemetry.output_dir").as_string(),
+                                options, &error)) {
+            RCLCPP_INFO(get_logger(), "解算遥测写入 %s", telemetry_->path().c_str());
+            solver_->setTelemetry(telemetry_.get());
+        } else {
+            RCLCPP_WARN(get_logger(), "解算遥测未开启: %s", error.c_str());
+            telemetry_.reset();
+        }
+    }
+
+    // 启动各级线程
+    running_ = true;
+    capture_thread_ = std::thread(&AutoAimPipeline::captureLoop, this);
+    detect_thread_ = std::thread(&AutoAimPipeline::detectLoop, this);
+    solve_thread_ = std::thread(&AutoAimPipeline::solveLoop, this);
+
+    RCLCPP_INFO(get_logger(), "AutoAimPipeline 初始化完成: %dx%d, 队列深度 %zu, 进程启动后 %.3f s",
+                width, height, depth, secondsSinceProcessStart());
+}
+
+AutoAimPipeline::~AutoAimPipeline() {
+    running_ = false;
+    for (auto* t : {&capture_thread_, &detect_thread_, &solve_thread_}) {
+        if (t->joinable()) {
+            t->join();
+        }
+    }
+    if (cap_.isOpened()) {
+        cap_.release();
+    }
+    serial_.close();
+    if (telemetry_) {
+        solver_->setTelemetry(nullptr);
+        telemetry_->close();
+        RCLCPP_INFO(get_logger(), "解算遥测 %lu 行, 丢弃 %lu 行",
+                    telemetry_->rowsWritten(), telemetry_->dropped());
+    }
+
+    RCLCPP_INFO(get_logger(), "采集 %lu 帧, 采集丢帧 %lu, 检测丢帧 %lu, 串口发送 %lu",
+                captured_.load(), capture_drops_.load(), detect_drops_.load(),
+                serial_writes_.load());
+}
+
+void AutoAimPipeline::declareParameters() {
+    // 流水线
+    this->declare_parameter("queue_depth", 2);
+    this->declare_parameter("observation_queue_depth", 64);
+    this->declare_parameter("publish_observations", true);
+    this->declare_parameter("warmup.enable", true);
+    this->declare_parameter("warmup.iterations", 20);
+    capture_placement_ = declareThreadPlacement(*this, "capture");
+    detect_placement_ = declareThreadPlacement(*this, "detection");
+    solve_placement_ = declareThreadPlacement(*this, "solving");
+    telemetry_placement_ = declareThreadPlacement(*this, "telemetry");
+    this->declare_parameter("telemetry.enable", false);
+    this->declare_parameter("telemetry.output_dir", "/tmp/rm_telemetry");
+    this->declare_parameter("telemetry.block_rows", 4096);
+    this->declare_parameter("telemetry.queue_capacity", 1024);
+
+    // 相机
+    this->declare_parameter("camera.camera_id", 0);
+    this->declare_parameter("camera.video_path", "");
+    this->declare_parameter("camera.frame_width", 640);
+    this->declare_parameter("camera.frame_height", 480);
+    this->declare_parameter("camera.fps", 30);
+    this->declare_parameter("camera.use_driver_timestamp", true);
+    this->declare_parameter("camera.timestamp_offset_ms", 0.0);
+    this->declare_parameter("camera.camera_matrix",
+        std::vector<double>{640.0, 0.0, 320.0, 0.0, 640.0, 240.0, 0.0, 0.0, 1.0});
+    this->declare_parameter("camera.distortion_coefficients",
+        std::vector<double>{0.0, 0.0, 0.0, 0.0, 0.0});
+
+    // 串口
+    this->declare_parameter("serial.port_name", "/dev/ttyUSB0");
+    this->declare_parameter("serial.baud_rate", 115200);
+
+    // 检测器（与armor_detector节点同名参数，加detector.前缀）
+    DetectorParams dp;
+    this->declare_parameter("detector.detect_color", 1);  // 0=BLUE, 1=RED
+    this->declare_parameter("detector.binary_threshold", dp.binary_threshold);
+    this->declare_parameter("detector.light.min_ratio", dp.light_min_ratio);
+    this->declare_parameter("detector.light.max_ratio", dp.light_max_ratio);
+    this->declare_parameter("detector.light.max_angle", dp.light_max_angle);
+    this->declare_parameter("detector.light.color_diff_thresh", dp.light_color_diff_thresh);
+    this->declare_parameter("detector.armor.min_small_center_distance",
+                            dp.armor_min_small_center_distance);
+    this->declare_parameter("detector.armor.max_small_center_distance",
+                            dp.armor_max_small_center_distance);
+    this->declare_parameter("detector.armor.min_large_center_distance",
+                            dp.armor_min_large_center_distance);
+    this->declare_parameter("detector.armor.max_large_center_distance",
+                            dp.armor_max_large_center_distance);
+    this->declare_parameter("detector.armor.max_angle", dp.armor_max_angle);
+    this->declare_parameter("detector.classifier.confidence", dp.classifier_confidence);
+    this->declare_parameter("detector.estimator.optimize_yaw", dp.optimize_yaw);
+    this->declare_parameter("detector.estimator.search_range", dp.search_range);
+
+    // 解算器（与armor_solver节点同名参数）
+    SolverParams sp;
+    this->declare_parameter("solver.bullet_speed", sp.bullet_speed);
+    this->declare_parameter("solver.gravity", sp.gravity);
+    this->declare_parameter("solver.resistance", sp.resistance);
+    this->declare_parameter("solver.max_tracking_v_yaw", sp.max_tracking_v_yaw);
+    this->declare_parameter("solver.side_angle", sp.side_angle);
+    this->declare_parameter("solver.coming_angle", sp.coming_angle);
+    this->declare_parameter("solver.leaving_angle", sp.leaving_angle);
+    this->declare_parameter("tracker.max_match_distance", sp.max_match_distance);
+    this->declare_parameter("tracker.max_match_yaw_diff", sp.max_match_yaw_diff);
+    this->declare_parameter("tracker.tracking_thres", sp.tracking_thres);
+    this->declare_parameter("tracker.lost_time_thres", sp.lost_time_thres);
+    this->declare_parameter("ekf.sigma2_q_x", sp.sigma2_q_x);
+    this->declare_parameter("ekf.sigma2_q_y", sp.sigma2_q_y);
+    this->declare_parameter("ekf.sigma2_q_z", sp.sigma2_q_z);
+    this->declare_parameter("ekf.sigma2_q_yaw", sp.sigma2_q_yaw);
+    this->declare_parameter("ekf.sigma2_q_r", sp.sigma2_q_r);
+    this->declare_parameter("ekf.r_x", sp.r_x);
+    this->declare_parameter("ekf.r_y", sp.r_y);
+    this->declare_parameter("ekf.r_z", sp.r_z);
+    this->declare_parameter("ekf.r_yaw", sp.r_yaw);
+}
+
+DetectorParams AutoAimPipeline::loadDetectorParams() {
+    DetectorParams p;
+    p.binary_threshold = this->get_parameter("detector.binary_threshold").as_int();
+    p.light_min_ratio = this->get_parameter("detector.light.min_ratio").as_double();
+    p.light_max_ratio = this->get_parameter("detector.light.max_ratio").as_double();
+    p.light_max_angle = this->get_parameter("detector.light.max_angle").as_double();
+    p.light_color_diff_thresh =
+        this->get_parameter("detector.light.color_diff_thresh").as_int();
+    p.armor_min_small_center_distance =
+        this->get_parameter("detector.armor.min_small_center_distance").as_double();
+    p.armor_max_small_center_distance =
+        this->get_parameter("detector.armor.max_small_center_distance").as_double();
+    p.armor_min_large_center_distance =
+        this->get_parameter("detector.armor.min_large_center_distance").as_double();
+    p.armor_max_large_center_distance =
+        this->get_parameter("detector.armor.max_large_center_distance").as_double();
+    p.armor_max_angle = this->get_parameter("detector.armor.max_angle").as_double();
+    p.classifier_confidence =
+        this->get_parameter("detector.classifier.confidence").as_double();
+    p.optimize_yaw = this->get_parameter("detector.estimator.optimize_yaw").as_bool();
+    p.search_range = this->get_parameter("detector.estimator.search_range").as_double();
+    // 快速通路不绘制调试图
+    p.debug = false;
+
+    detect_color_ = static_cast<Color>(this->get_parameter("detector.detect_color").as_int());
+    return p;
+}
+
+SolverParams AutoAimPipeline::loadSolverParams() {
+    SolverParams p;
+    p.bullet_speed = this->get_parameter("solver.bullet_speed").as_double();
+    p.gravity = this->get_parameter("solver.gravity").as_double();
+    p.resistance = this->get_parameter("solver.resistance").as_double();
+    p.max_tracking_v_yaw = this->get_parameter("solver.max_tracking_v_yaw").as_double();
+    p.side_angle = this->get_parameter("solver.side_angle").as_double();
+    p.coming_angle = this->get_parameter("solver.coming_angle").as_double();
+    p.leaving_angle = this->get_parameter("solver.leaving_angle").as_double();
+    p.max_match_distance = this->get_parameter("tracker.max_match_distance").as_double();
+    p.max_match_yaw_diff = this->get_parameter("tracker.max_match_yaw_diff").as_double();
+    p.tracking_thres = static_cast<int>(this->get_parameter("tracker.tracking_thres").as_int());
+    p.lost_time_thres = this->get_parameter("tracker.lost_time_thres").as_double();
+    p.sigma2_q_x = this->get_parameter("ekf.sigma2_q_x").as_double();
+    p.sigma2_q_y = this->get_parameter("ekf.sigma2_q_y").as_double();
+    p.sigma2_q_z = this->get_parameter("ekf.sigma2_q_z").as_double();
+    p.sigma2_q_yaw = this->get_parameter("ekf.sigma2_q_yaw").as_double();
+    p.sigma2_q_r = this->get_parameter("ekf.sigma2_q_r").as_double();
+    p.r_x = this->get_parameter("ekf.r_x").as_double();
+    p.r_y = this->get_parameter("ekf.r_y").as_double();
+    p.r_z = this->get_parameter("ekf.r_z").as_double();
+    p.r_yaw = this->get_parameter("ekf.r_yaw").as_double();
+    return p;
+}
+
+bool AutoAimPipeline::openCamera() {
+    video_path_ = this->get_parameter("camera.video_path").as_string();
+    fps_ = this->get_parameter("camera.fps").as_int();
+    use_driver_timestamp_ =
+        video_path_.empty() && this->get_parameter("camera.use_driver_timestamp").as_bool();
+    timestamp_offset_ns_ = static_cast<int64_t>(
+        this->get_parameter("camera.timestamp_offset_ms").as_double() * 1e6);
+
+    if (!video_path_.empty()) {
+        RCLCPP_INFO(get_logger(), "使用视频文件: %s", video_path_.c_str());
+        return cap_.open(video_path_);
+    }
+
+    int camera_id = this->get_parameter("camera.camera_id").as_int();
+    RCLCPP_INFO(get_logger(), "使用相机ID: %d", camera_id);
+    if (!cap_.open(camera_id, cv::CAP_V4L2)) {
+        return false;
+    }
+    cap_.set(cv::CAP_PROP_FRAME_WIDTH, this->get_parameter("camera.frame_width").as_int());
+    cap_.set(cv::CAP_PROP_FRAME_HEIGHT, this->get_parameter("camera.frame_height").as_int());
+    cap_.set(cv::CAP_PROP_FPS, fps_);
+    // 设置MJPG格式以提高帧率
+    cap_.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    return true;
+}
+
+void AutoAimPipeline::openSerial() {
+    auto port_name = this->get_parameter("serial.port_name").as_string();
+    int baud_rate = this->get_parameter("serial.baud_rate").as_int();
+    std::string error;
+    if (serial_.open(port_name, baud_rate, &error)) {
+        RCLCPP_INFO(get_logger(), "串口 %s 已打开", port_name.c_str());
+    } else {
+        RCLCPP_WARN(get_logger(), "%s，流水线以无串口模式运行", error.c_str());
+    }
+}
+
+void AutoAimPipeline::placeCurrentThread(ThreadPlacement placement, const std::string& name) {
+    placement.name = name;
+    std::string message;
+    if (applyThreadPlacement(placement, &message)) {
+        RCLCPP_INFO(get_logger(), "线程 %s: %s", name.c_str(), message.c_str());
+    } else {
+        RCLCPP_WARN(get_logger(), "线程 %s 放置降级: %s", name.c_str(), message.c_str());
+    }
+}
+
+void AutoAimPipeline::captureLoop() {
+    placeCurrentThread(capture_placement_, "capture");
+
+    // 视频文件按fps节流；实际相机由硬件帧率决定节奏
+    const bool throttle = !video_path_.empty() && fps_ > 0;
+    const auto target_duration = std::chrono::microseconds(1000000 / std::max(fps_, 1));
+
+    Frame frame;
+    bool has_frame = false;
+    uint64_t seq = 0;
+
+    while (running_ && rclcpp::ok()) {
+        auto start = std::chrono::steady_clock::now();
+
+        // 取空闲图像内存；全部在途时复用手上这一帧（丢弃其内容）
+        if (!has_frame) {
+            has_frame = free_frames_->tryPop(frame);
+            if (!has_frame) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+        }
+
+        AllocScope alloc_scope(AllocTag::CAPTURE, true);
+        if (!cap_.read(frame.image) || frame.image.empty()) {
+            if (!video_path_.empty()) {
+                cap_.set(cv::CAP_PROP_POS_FRAMES, 0);
+                continue;
+            }
+            RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000, "相机读取失败");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        // 采集时间戳（驱动缓冲区时间戳，不含解码耗时），解算dt以此为准
+        frame.stamp_ns = captureStamp(
+            cap_, use_driver_timestamp_, timestamp_offset_ns_,
+            this->now().nanoseconds()).stamp_ns;
+        frame.seq = seq++;
+        captured_.fetch_add(1, std::memory_order_relaxed);
+        LatencyTracer::global().mark(TraceStage::CAPTURE, frame.stamp_ns);
+
+        if (ready_frames_->tryPush(std::move(frame))) {
+            has_frame = false;
+        } else {
+            // 检测跟不上：丢弃本帧，内存留待下一次采集
+            capture_drops_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (throttle) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed < target_duration) {
+                std::this_thread::sleep_for(target_duration - elapsed);
+            }
+        }
+    }
+}
+
+void AutoAimPipeline::detectLoop() {
+    placeCurrentThread(detect_placement_, "detection");
+
+    auto& tracer = LatencyTracer::global();
+    Frame frame;
+    while (ready_frames_->popWait(frame, running_)) {
+        AllocScope alloc_scope(AllocTag::DETECT, true);
+        tracer.mark(TraceStage::DETECT_START, frame.stamp_ns);
+        const auto& image = frame.image;
+        auto armors = detector_->detect(image, detect_color_);
+        tracer.mark(TraceStage::DETECT_END, frame.stamp_ns);
+
+        Detection detection;
+        detection.seq = frame.seq;
+        detection.armors.stamp_ns = frame.stamp_ns;
+
+        const cv::Point2f img_center(image.cols / 2.0f, image.rows / 2.0f);
+        pnp_solver_->solveAll(armors, img_center, detection.armors);
+
+        tracer.mark(TraceStage::PNP_DONE, frame.stamp_ns);
+
+        // 图像内存交还采集线程（池大小与队列容量匹配，不会失败）
+        free_frames_->tryPush(std::move(frame));
+
+        if (!detections_->tryPush(std::move(detection))) {
+            detect_drops_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void AutoAimPipeline::solveLoop() {
+    placeCurrentThread(solve_placement_, "solving");
+
+    Detection detection;
+    int64_t last_stamp_ns = 0;
+    bool first_frame = true;
+
+    while (detections_->popWait(detection, running_)) {
+        AllocScope alloc_scope(AllocTag::SOLVE, true);
+
+        // 计算dt
+        int64_t stamp_ns = detection.armors.stamp_ns;
+        double dt = 0.01;  // 默认10ms
+        if (!first_frame) {
+            dt = static_cast<double>(stamp_ns - last_stamp_ns) * 1e-9;
+            if (dt <= 0 || dt > 1.0) dt = 0.01;
+        }
+        first_frame = false;
+        last_stamp_ns = stamp_ns;
+
+        auto cmd = solver_->solve(detection.armors, dt);
+
+        // 关键路径终点：直接写串口
+        if (cmd.valid && serial_.isOpen()) {
+            auto packet = packGimbalCmd(cmd.yaw, cmd.pitch, cmd.fire);
+            LatencyTracer::global().mark(TraceStage::COMMAND_PUBLISH, stamp_ns);
+            const ssize_t written = serial_.write(packet.data.data(), Packet16::SIZE);
+            if (written > 0) {
+                if (serial_writes_.fetch_add(1, std::memory_order_relaxed) == 0) {
+                    RCLCPP_INFO(get_logger(), "首条云台命令: 进程启动后 %.3f s（系统启动后 %.3f s）",
+                                secondsSinceProcessStart(), secondsSinceBoot());
+                }
+                LatencyTracer::global().mark(TraceStage::SERIAL_WRITE, stamp_ns);
+            }
+            RM_FLIGHT_RECORD(FlightEvent::SERIAL_SEND, cmd.yaw, cmd.pitch, cmd.fire, written);
+        }
+
+        if (!publish_observations_) {
+            continue;
+        }
+
+        // 旁路观测：串口写入之后再组装，不影响命令延迟
+        Observation obs;
+        obs.target.header.stamp = rclcpp::Time(stamp_ns);
+        obs.target.header.frame_id = ARMOR_FRAME_ID;
+        obs.target.tracking = cmd.valid;
+        if (cmd.valid) {
+            const auto& tracker = solver_->tracker();
+            const auto& state = tracker.getState();
+            obs.target.id = armorSymbolName(tracker.trackedSymbol());
+            obs.target.armors_num = tracker.targetArmorsNum();
+            obs.target.position.x = state(0);
+            obs.target.position.y = state(2);
+            obs.target.position.z = state(4);
+            obs.target.velocity.x = state(1);
+            obs.target.velocity.y = state(3);
+            obs.target.velocity.z = state(5);
+            obs.target.yaw = state(6);
+            obs.target.v_yaw = state(7);
+            obs.target.radius_1 = state(8);
+            obs.target.d_zc = state(9);
+
+            obs.has_cmd = true;
+            obs.gimbal_cmd.header = obs.target.header;
+            obs.gimbal_cmd.yaw = cmd.yaw;
+            obs.gimbal_cmd.pitch = cmd.pitch;
+            obs.gimbal_cmd.fire = cmd.fire;
+        }
+        obs.armors = detection.armors;
+        observations_->tryPush(std::move(obs));
+    }
+}
+
+void AutoAimPipeline::publishObservations() {
+    Observation obs;
+    while (observations_->tryPop(obs)) {
+        auto armors_msg = std::make_unique<rm_interfaces::msg::CompactArmors>();
+        toMsg(obs.armors, *armors_msg);
+        armors_pub_->publish(std::move(armors_msg));
+        target_pub_->publish(std::move(obs.target));
+        if (obs.has_cmd) {
+            gimbal_cmd_pub_->publish(std::move(obs.gimbal_cmd));
+        }
+    }
+}
+
+}  // namespace rm_auto_aim
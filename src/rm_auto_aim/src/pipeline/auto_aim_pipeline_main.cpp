@@ -0,0 +1,50 @@
+#include <rclcpp/rclcpp.hpp>
+
+#include "rm_auto_aim/diagnostics/flight_recorder_node.hpp"
+#include "rm_auto_aim/diagnostics/latency_monitor_node.hpp"
+#include "rm_auto_aim/diagnostics/rt_memory_node.hpp"
+#include "rm_auto_aim/diagnostics/task_pool_node.hpp"
+#include "rm_auto_aim/pipeline/auto_aim_pipeline.hpp"
+
+int main(int argc, char** argv) {
+    rclcpp::init(argc, argv);
+    // 实时内存模式须在流水线分配帧缓冲区、启动线程之前开启
+    auto rt_memory = std::make_shared<rm_auto_aim::RtMemoryNode>(
+        rclcpp::NodeOptions().arguments({"--ros-args", "-r", "__node:=rt_memory"}));
+    // 任务池先于流水线启动：预热与检测中的并行PnP即在池线程上执行
+    auto task_pool = std::make_shared<rm_auto_aim::TaskPoolNode>(
+        rclcpp::NodeOptions().arguments({"--ros-args", "-r", "__node:=task_pool"}));
+    std::shared_ptr<rm_auto_aim::AutoAimPipeline> node;
+    try {
+        node = std::make_shared<rm_auto_aim::AutoAimPipeline>(rclcpp::NodeOptions());
+    } catch (const std::exception& e) {
+        // 初始化失败（如相机还在枚举）：非零退出，由launch重启重试
+        RCLCPP_FATAL(rclcpp::get_logger("auto_aim_pipeline"), "流水线初始化失败: %s", e.what());
+        task_pool.reset();
+        rm_auto_aim::TaskPool::global().stop();
+        rt_memory.reset();
+        rclcpp::shutdown();
+        return 1;
+    }
+    // 延迟监视与流水线同进程，读取同一个全局追踪器；
+    // 本地重映射节点名，避免被launch的全局 __node 重映射改成流水线的名字
+    auto monitor = std::make_shared<rm_auto_aim::LatencyMonitorNode>(
+        rclcpp::NodeOptions().arguments({"--ros-args", "-r", "__node:=latency_monitor"}));
+    auto flight_recorder = std::make_shared<rm_auto_aim::FlightRecorderNode>(
+        rclcpp::NodeOptions().arguments({"--ros-args", "-r", "__node:=flight_recorder"}));
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(node);
+    executor.add_node(monitor);
+    executor.add_node(flight_recorder);
+    executor.add_node(rt_memory);
+    executor.add_node(task_pool);
+    executor.spin();
+    flight_recorder.reset();
+    monitor.reset();
+    node.reset();
+    task_pool.reset();
+    rm_auto_aim::TaskPool::global().stop();
+    rt_memory.reset();
+    rclcpp::shutdown();
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include "rm_auto_aim/solver/armor_solver.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "rm_utils/latency_tracer.hpp"
+
+namespace rm_auto_aim {
+
+ArmorSolver::ArmorSolver(const SolverParams& params) {
+    setParams(params);
+}
+
+void ArmorSolver::setParams(const SolverParams& params) {
+    params_ = params;
+    trajectory_compensator_.setParams(
+        params_.bullet_speed, params_.gravity, params_.resistance);
+    tracker_.setParams(
+        params_.max_match_distance, params_.max_match_yaw_diff,
+        params_.tracking_thres, params_.lost_time_thres);
+    tracker_.setEKFParams(
+        params_.sigma2_q_x, params_.sigma2_q_y, params_.sigma2_q_z,
+        params_.sigma2_q_yaw, params_.sigma2_q_r,
+        params_.r_x, params_.r_y, params_.r_z, params_.r_yaw);
+}
+
+GimbalCommand ArmorSolver::solve(const ArmorObservations& armors, double dt) {
+    auto& tracer = LatencyTracer::global();
+    const int64_t stamp_ns = armors.stamp_ns;
+
+    // 更新跟踪器（含EKF预测+更新）
+    tracker_.update(armors, dt);
+    tracer.mark(TraceStage::TRACKER_UPDATE, stamp_ns);
+
+    GimbalCommand cmd;
+    auto tracker_state = tracker_.state();
+    if (tracker_state != TrackerState::TRACKING &&
+        tracker_state != TrackerState::TEMP_LOST) {
+        if (telemetry_) {
+            recordTelemetry(armors, dt, cmd);
+        }
+        return cmd;
+    }
+
+    // 计算瞄准点
+    const auto& state = tracker_.getState();
+    double v_yaw = state(7);
+    Eigen::Vector3d aim_point = calcAimPoint(state, v_yaw);
+
+    // 弹道补偿：计算pitch
+    double compensated_pitch = trajectory_compensator_.compensate(
+        aim_point.x(), aim_point.y(), aim_point.z());
+
+    // 计算yaw
+    double yaw_cmd = std::atan2(aim_point.x(), aim_point.z());
+
+    // 手动补偿
+    double dist = aim_point.norm();
+    auto manual_comp = manual_compensator_.getCompensation(dist);
+    compensated_pitch += manual_comp.pitch_offset;
+    yaw_cmd += manual_comp.yaw_offset;
+
+    cmd.valid = true;
+    cmd.yaw = yaw_cmd;
+    cmd.pitch = compensated_pitch;
+    cmd.fire = (tracker_state == TrackerState::TRACKING);
+    cmd.aim_point = aim_point;
+    tracer.mark(TraceStage::COMPENSATION, stamp_ns);
+    if (telemetry_) {
+        recordTelemetry(armors, dt, cmd);
+    }
+    return cmd;
+}
+
+void ArmorSolver::recordTelemetry(
+    const ArmorObservations& armors, double dt, const GimbalCommand& cmd)
+{
+    // 预热用的合成帧时间戳为0，不写入
+    if (armors.stamp_ns == 0) {
+        return;
+    }
+
+    SolverTelemetryRecord record{};
+    record.stamp_ns = armors.stamp_ns;
+    record.solve_ns = LatencyTracer::nowNs();
+    record.dt = dt;
+
+    const auto tracker_state = tracker_.state();
+    record.tracker_state = static_cast<uint8_t>(tracker_state);
+    if (tracker_state != TrackerState::LOST) {
+        const auto& covariance = tracker_.covariance();
+        const auto& state = tracker_.getState();
+        for (int i = 0; i < 10; i++) {
+            record.state[i] = state(i);
+            record.cov_diag[i] = covariance(i, i);
+        }
+        record.small_gyro = isSmallGyro(state(7));
+    }
+
+    record.matched_index = tracker_.lastMatchIndex();
+    const auto& innovation = tracker_.lastInnovation();
+    for (int i = 0; i < 4; i++) {
+        record.innovation[i] = record.matched_index >= 0
+            ? innovation(i) : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    for (int i = 0; i < 3; i++) {
+        record.aim_point[i] = cmd.aim_point(i);
+    }
+    record.cmd_yaw = cmd.yaw;
+    record.cmd_pitch = cmd.pitch;
+    record.armors_num = tracker_.targetArmorsNum();
+    record.observations = armors.count;
+    record.camera = armors.camera;
+    record.tracked_symbol = static_cast<uint8_t>(tracker_.trackedSymbol());
+    record.valid = cmd.valid;
+    record.fire = cmd.fire;
+    telemetry_->append(record);
+}
+
+bool ArmorSolver::warmUp(int iterations) {
+    // 正前方3m处缓慢平移的一块装甲板
+    ArmorObservations armors;
+    armors.count = 1;
+    auto& armor = armors.armors[0];
+    armor.symbol = ArmorSymbol::INFANTRY_3;
+    armor.position = Eigen::Vector3d(0.1, 0.05, 3.0);
+    armor.setOrientation(Eigen::Quaterniond::Identity());
+
+    bool compensated = false;
+    for (int i = 0; i < iterations; i++) {
+        armor.position.x() = 0.1 + 0.002 * i;
+        compensated |= solve(armors, 0.01).valid;
+    }
+    tracker_.reset();
+    return compensated;
+}
+
+Eigen::Vector3d ArmorSolver::calcAimPoint(
+    const ArmorEKF::StateVec& state, double v_yaw)
+{
+    if (isSmallGyro(v_yaw)) {
+        // 小陀螺模式：选择最优装甲板
+        return selectBestArmor(state, tracker_.targetArmorsNum());
+    }
+
+    // 普通模式：直接瞄准预测的装甲板位置
+    double xc = state(0), yc = state(2), zc = state(4);
+    double yaw = state(6), r = state(8), d_zc = state(9);
+
+    Eigen::Vector3d aim;
+    aim.x() = xc - r * std::cos(yaw);
+    aim.y() = yc - r * std::sin(yaw);
+    aim.z() = zc + d_zc;
+
+    return aim;
+}
+
+bool ArmorSolver::isSmallGyro(double v_yaw) const {
+    return std::abs(v_yaw) > params_.max_tracking_v_yaw;
+}
+
+Eigen::Vector3d ArmorSolver::selectBestArmor(
+    const ArmorEKF::StateVec& state, int armors_num)
+{
+    double xc = state(0), yc = state(2), zc = state(4);
+    double yaw = state(6), r = state(8), d_zc = state(9);
+
+    // 计算所有装甲板位置
+    double angle_step = 2.0 * M_PI / armors_num;
+    double min_yaw_diff = std::numeric_limits<double>::max();
+    Eigen::Vector3d best_point;
+
+    for (int i = 0; i < armors_num; i++) {
+        double armor_yaw = yaw + i * angle_step;
+
+        // 归一化到[-pi, pi]
+        while (armor_yaw > M_PI) armor_yaw -= 2 * M_PI;
+        while (armor_yaw < -M_PI) armor_yaw += 2 * M_PI;
+
+        Eigen::Vector3d armor_pos;
+        armor_pos.x() = xc - r * std::cos(armor_yaw);
+        armor_pos.y() = yc - r * std::sin(armor_yaw);
+        armor_pos.z() = zc + ((i % 2 == 0) ? d_zc : -d_zc);
+
+        // 选择正对相机的那块装甲板（yaw最接近0的）
+        double yaw_to_cam = std::atan2(armor_pos.x(), armor_pos.z());
+        double yaw_diff = std::abs(yaw_to_cam);
+
+        if (yaw_diff < min_yaw_diff) {
+            min_yaw_diff = yaw_diff;
+            best_point = armor_pos;
+        }
+    }
+
+    return best_point;
+}
+
+}  // namespace rm_auto_aim
@@ -1,25 +1,122 @@
 #include "rm_auto_aim/solver/armor_solver_node.hpp"
 
-#include <cmath>
+#include <algorithm>
+
+#include "rm_auto_aim/detector/armor_msg_builder.hpp"
+#include "rm_utils/alloc_tracker.hpp"
+#include "rm_utils/latency_tracer.hpp"
 
 namespace rm_auto_aim {
 
+namespace {
+
+// 可热更新的参数（均映射到SolverParams）
+const std::vector<std::string> kReloadableParams = {
+    "ekf.sigma2_q_x", "ekf.sigma2_q_y", "ekf.sigma2_q_z", "ekf.sigma2_q_yaw", "ekf.sigma2_q_r",
+    "ekf.r_x", "ekf.r_y", "ekf.r_z", "ekf.r_yaw",
+    "tracker.max_match_distance", "tracker.max_match_yaw_diff",
+    "tracker.tracking_thres", "tracker.lost_time_thres",
+    "solver.bullet_speed", "solver.gravity", "solver.resistance",
+    "solver.max_tracking_v_yaw", "solver.side_angle", "solver.coming_angle",
+    "solver.leaving_angle",
+};
+
+// 把单个参数写入配置，不是可热更新参数时返回false
+bool applyParameter(SolverParams& p, const rclcpp::Parameter& param) {
+    const auto& name = param.get_name();
+    // EKF噪声
+    if (name == "ekf.sigma2_q_x") p.sigma2_q_x = param.as_double();
+    else if (name == "ekf.sigma2_q_y") p.sigma2_q_y = param.as_double();
+    else if (name == "ekf.sigma2_q_z") p.sigma2_q_z = param.as_double();
+    else if (name == "ekf.sigma2_q_yaw") p.sigma2_q_yaw = param.as_double();
+    else if (name == "ekf.sigma2_q_r") p.sigma2_q_r = param.as_double();
+    else if (name == "ekf.r_x") p.r_x = param.as_double();
+    else if (name == "ekf.r_y") p.r_y = param.as_double();
+    else if (name == "ekf.r_z") p.r_z = param.as_double();
+    else if (name == "ekf.r_yaw") p.r_yaw = param.as_double();
+    // 跟踪器
+    else if (name == "tracker.max_match_distance") p.max_match_distance = param.as_double();
+    else if (name == "tracker.max_match_yaw_diff") p.max_match_yaw_diff = param.as_double();
+    else if (name == "tracker.tracking_thres") p.tracking_thres = static_cast<int>(param.as_int());
+    else if (name == "tracker.lost_time_thres") p.lost_time_thres = param.as_double();
+    // 弹道
+    else if (name == "solver.bullet_speed") p.bullet_speed = param.as_double();
+    else if (name == "solver.gravity") p.gravity = param.as_double();
+    else if (name == "solver.resistance") p.resistance = param.as_double();
+    // 反陀螺
+    else if (name == "solver.max_tracking_v_yaw") p.max_tracking_v_yaw = param.as_double();
+    else if (name == "solver.side_angle") p.side_angle = param.as_double();
+    else if (name == "solver.coming_angle") p.coming_angle = param.as_double();
+    else if (name == "solver.leaving_angle") p.leaving_angle = param.as_double();
+    else return false;
+    return true;
+}
+
+// 校验配置，合法返回nullptr，否则返回原因
+const char* checkParams(const SolverParams& p) {
+    if (!(p.bullet_speed > 0.0)) return "solver.bullet_speed 必须大于0";
+    if (p.tracking_thres < 1) return "tracker.tracking_thres 必须不小于1";
+    const double noises[] = {p.sigma2_q_x, p.sigma2_q_y, p.sigma2_q_z, p.sigma2_q_yaw,
+                             p.sigma2_q_r, p.r_x, p.r_y, p.r_z, p.r_yaw};
+    for (double noise : noises) {
+        if (!(noise > 0.0)) return "ekf.* 噪声方差必须大于0";
+    }
+    return nullptr;
+}
+
+}  // namespace
+
 ArmorSolverNode::ArmorSolverNode(const rclcpp::NodeOptions& options)
-    : Node("armor_solver", options)
+    : rclcpp_lifecycle::LifecycleNode("armor_solver", options)
 {
-    RCLCPP_INFO(get_logger(), "ArmorSolverNode 初始化中...");
-
     declareParameters();
-    loadParams();
+    solve_placement_ = declareThreadPlacement(*this, "solving");
+    telemetry_placement_ = declareThreadPlacement(*this, "telemetry");
+    param_callback_ = this->add_on_set_parameters_callback(
+        std::bind(&ArmorSolverNode::onParametersSet, this, std::placeholders::_1));
+}
+
+ArmorSolverNode::~ArmorSolverNode() {
+    stopSolving();
+}
 
-    // 初始化跟踪器
-    tracker_ = std::make_unique<ArmorTracker>();
-    // 从参数加载tracker配置（在loadParams中完成）
+ArmorSolverNode::CallbackReturn ArmorSolverNode::on_configure(const rclcpp_lifecycle::State&) {
+    // 初始化解算器（参数同时发布为当前配置，之后的修改经参数回调热更新）
+    const auto params = loadParams();
+    if (const char* reason = checkParams(params)) {
+        RCLCPP_ERROR(get_logger(), "解算参数非法: %s", reason);
+        return CallbackReturn::FAILURE;
+    }
+    applied_config_version_ = config_.publish(params);
+    config_reader_ = std::make_unique<RcuCell<SolverParams>::Reader>(config_);
+    solver_ = std::make_unique<ArmorSolver>(params);
+    if (!loadExtrinsics()) {
+        // 失败保持未配置：释放已创建的解算器与配置读者，下次configure从头开始
+        releaseResources();
+        return CallbackReturn::FAILURE;
+    }
 
-    // 订阅装甲板检测结果
-    armors_sub_ = this->create_subscription<rm_interfaces::msg::Armors>(
+    // 预热 跟踪 → 瞄准点 → 弹道补偿（首次分配与冷缓存不落在第一帧真实数据上）
+    if (this->get_parameter("warmup.enable").as_bool()) {
+        const auto start = std::chrono::steady_clock::now();
+        const bool compensated =
+            solver_->warmUp(static_cast<int>(this->get_parameter("warmup.iterations").as_int()));
+        RCLCPP_INFO(get_logger(), "解算预热完成: %.1f ms%s",
+                    std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start).count(),
+                    compensated ? "" : "（未进入跟踪，补偿路径未预热）");
+    }
+    openTelemetry();
+
+    // 订阅装甲板检测结果（放入专用回调组，激活后才有线程执行）
+    solve_group_ = this->create_callback_group(
+        rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    rclcpp::SubscriptionOptions armors_options;
+    armors_options.callback_group = solve_group_;
+    armors_sub_ = this->create_subscription<rm_interfaces::msg::CompactArmors>(
         "/detector/armors", rclcpp::SensorDataQoS(),
-        std::bind(&ArmorSolverNode::armorsCallback, this, std::placeholders::_1));
+        std::bind(&ArmorSolverNode::armorsCallback, this, std::placeholders::_1),
+        armors_options);
 
     // 发布目标信息
     target_pub_ = this->create_publisher<rm_interfaces::msg::Target>(
@@ -29,7 +126,110 @@ ArmorSolverNode::ArmorSolverNode(const rclcpp::NodeOptions& options)
     gimbal_cmd_pub_ = this->create_publisher<rm_interfaces::msg::GimbalCmd>(
         "/solver/gimbal_cmd", rclcpp::SensorDataQoS());
 
-    RCLCPP_INFO(get_logger(), "ArmorSolverNode 初始化完成");
+    solve_executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    solve_executor_->add_callback_group(solve_group_, this->get_node_base_interface());
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorSolverNode::CallbackReturn ArmorSolverNode::on_activate(const rclcpp_lifecycle::State&) {
+    target_pub_->on_activate();
+    gimbal_cmd_pub_->on_activate();
+    fusion_.reset();
+
+    // 解算线程
+    solving_ = true;
+    solve_thread_ = std::thread([this]() {
+        placeCurrentThread(solve_placement_, "solving");
+        // spin_once轮询退出标志，停止时不依赖cancel()与spin()的先后顺序
+        while (solving_ && rclcpp::ok()) {
+            solve_executor_->spin_once(std::chrono::milliseconds(100));
+        }
+    });
+    RCLCPP_INFO(get_logger(), "解算线程已启动");
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorSolverNode::CallbackReturn ArmorSolverNode::on_deactivate(const rclcpp_lifecycle::State&) {
+    stopSolving();
+    target_pub_->on_deactivate();
+    gimbal_cmd_pub_->on_deactivate();
+    RCLCPP_INFO(get_logger(), "解算线程已停止");
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorSolverNode::CallbackReturn ArmorSolverNode::on_cleanup(const rclcpp_lifecycle::State&) {
+    releaseResources();
+    return CallbackReturn::SUCCESS;
+}
+
+ArmorSolverNode::CallbackReturn ArmorSolverNode::on_shutdown(const rclcpp_lifecycle::State&) {
+    stopSolving();
+    releaseResources();
+    return CallbackReturn::SUCCESS;
+}
+
+void ArmorSolverNode::stopSolving() {
+    solving_ = false;
+    if (solve_thread_.joinable()) {
+        solve_thread_.join();
+    }
+}
+
+void ArmorSolverNode::releaseResources() {
+    solve_executor_.reset();
+    armors_sub_.reset();
+    solve_group_.reset();
+    target_pub_.reset();
+    gimbal_cmd_pub_.reset();
+    closeTelemetry();
+    solver_.reset();
+    config_reader_.reset();
+}
+
+void ArmorSolverNode::openTelemetry() {
+    if (!this->get_parameter("telemetry.enable").as_bool()) {
+        return;
+    }
+    TelemetryWriter::Options options;
+    options.block_rows = static_cast<uint32_t>(
+        std::max<int64_t>(1, this->get_parameter("telemetry.block_rows").as_int()));
+    options.queue_capacity = static_cast<size_t>(
+        std::max<int64_t>(2, this->get_parameter("telemetry.queue_capacity").as_int()));
+    options.placement = telemetry_placement_;
+
+    auto writer = std::make_unique<TelemetryWriter>();
+    std::string error;
+    if (!openSolverTelemetry(*writer, this->get_parameter("telemetry.output_dir").as_string(),
+                             options, &error)) {
+        RCLCPP_WARN(get_logger(), "解算遥测未开启: %s", error.c_str());
+        return;
+    }
+    RCLCPP_INFO(get_logger(), "解算遥测写入 %s", writer->path().c_str());
+    telemetry_ = std::move(writer);
+    solver_->setTelemetry(telemetry_.get());
+}
+
+void ArmorSolverNode::closeTelemetry() {
+    if (!telemetry_) {
+        return;
+    }
+    if (solver_) {
+        solver_->setTelemetry(nullptr);
+    }
+    telemetry_->close();
+    RCLCPP_INFO(get_logger(), "解算遥测已关闭: %lu 行, 丢弃 %lu 行",
+                telemetry_->rowsWritten(), telemetry_->dropped());
+    telemetry_.reset();
+}
+
+void ArmorSolverNode::placeCurrentThread(ThreadPlacement placement, const std::string& name) {
+    placement.name = name;
+    std::string message;
+    if (applyThreadPlacement(placement, &message)) {
+        RCLCPP_INFO(get_logger(), "线程 %s: %s", name.c_str(), message.c_str());
+    } else {
+        RCLCPP_WARN(get_logger(), "线程 %s 放置降级: %s", name.c_str(), message.c_str());
+    }
 }
 
 void ArmorSolverNode::declareParameters() {
@@ -58,156 +258,154 @@ void ArmorSolverNode::declareParameters() {
     this->declare_parameter("solver.side_angle", 15.0);
     this->declare_parameter("solver.coming_angle", 1.222);
     this->declare_parameter("solver.leaving_angle", 0.524);
+    // 启动预热
+    this->declare_parameter("warmup.enable", true);
+    this->declare_parameter("warmup.iterations", 20);
+    // 解算遥测
+    this->declare_parameter("telemetry.enable", false);
+    this->declare_parameter("telemetry.output_dir", "/tmp/rm_telemetry");
+    this->declare_parameter("telemetry.block_rows", 4096);
+    this->declare_parameter("telemetry.queue_capacity", 1024);
+    // 多相机外参：每相机 [x, y, z, roll, pitch, yaw]（m, rad），0号为参考相机
+    this->declare_parameter("camera_extrinsics", std::vector<double>(6, 0.0));
     // 调试
     this->declare_parameter("debug", false);
 }
 
-void ArmorSolverNode::loadParams() {
-    // 弹道参数
-    bullet_speed_ = this->get_parameter("solver.bullet_speed").as_double();
-    gravity_ = this->get_parameter("solver.gravity").as_double();
-    resistance_ = this->get_parameter("solver.resistance").as_double();
-    trajectory_compensator_.setParams(bullet_speed_, gravity_, resistance_);
+bool ArmorSolverNode::loadExtrinsics() {
+    const auto values = this->get_parameter("camera_extrinsics").as_double_array();
+    if (values.empty() || values.size() % 6 != 0) {
+        RCLCPP_ERROR(get_logger(), "camera_extrinsics 长度须为6的整数倍，当前为 %zu", values.size());
+        return false;
+    }
+    std::vector<CameraExtrinsic> extrinsics;
+    for (size_t i = 0; i < values.size(); i += 6) {
+        extrinsics.push_back(CameraExtrinsic::fromXyzRpy(&values[i]));
+    }
+    fusion_.setExtrinsics(extrinsics);
+    if (extrinsics.size() > 1) {
+        RCLCPP_INFO(get_logger(), "多相机融合: %zu 路相机", extrinsics.size());
+    }
+    return true;
+}
 
-    // 反陀螺
-    max_tracking_v_yaw_ = this->get_parameter("solver.max_tracking_v_yaw").as_double();
-    side_angle_ = this->get_parameter("solver.side_angle").as_double();
-    coming_angle_ = this->get_parameter("solver.coming_angle").as_double();
-    leaving_angle_ = this->get_parameter("solver.leaving_angle").as_double();
+SolverParams ArmorSolverNode::loadParams() {
+    SolverParams p;
+    // EKF噪声、跟踪器、弹道与反陀螺参数
+    for (const auto& param : this->get_parameters(kReloadableParams)) {
+        applyParameter(p, param);
+    }
 
     debug_ = this->get_parameter("debug").as_bool();
+    return p;
 }
 
-void ArmorSolverNode::armorsCallback(
-    const rm_interfaces::msg::Armors::ConstSharedPtr& msg)
+rcl_interfaces::msg::SetParametersResult ArmorSolverNode::onParametersSet(
+    const std::vector<rclcpp::Parameter>& params)
 {
-    // 计算dt
-    rclcpp::Time now = msg->header.stamp;
-    double dt = 0.01;  // 默认10ms
-    if (!first_frame_) {
-        dt = (now - last_time_).seconds();
-        if (dt <= 0 || dt > 1.0) dt = 0.01;
-    }
-    first_frame_ = false;
-    last_time_ = now;
-
-    // 更新跟踪器（含EKF预测+更新）
-    tracker_->update(*msg, dt);
-
-    // 构造Target消息
-    rm_interfaces::msg::Target target_msg;
-    target_msg.header = msg->header;
-
-    auto tracker_state = tracker_->state();
-    if (tracker_state == TrackerState::TRACKING ||
-        tracker_state == TrackerState::TEMP_LOST) {
-        target_msg.tracking = true;
-        target_msg.id = tracker_->trackedId();
-        target_msg.armors_num = tracker_->targetArmorsNum();
-
-        auto state = tracker_->getState();
-        // EKF状态: [xc, v_xc, yc, v_yc, zc, v_zc, yaw, v_yaw, r, d_zc]
-        target_msg.position.x = state(0);
-        target_msg.position.y = state(2);
-        target_msg.position.z = state(4);
-        target_msg.velocity.x = state(1);
-        target_msg.velocity.y = state(3);
-        target_msg.velocity.z = state(5);
-        target_msg.yaw = state(6);
-        target_msg.v_yaw = state(7);
-        target_msg.radius_1 = state(8);
-        target_msg.d_zc = state(9);
-
-        // 计算瞄准点
-        double v_yaw = state(7);
-        Eigen::Vector3d aim_point = calcAimPoint(state, v_yaw);
-
-        // 弹道补偿：计算pitch
-        double compensated_pitch = trajectory_compensator_.compensate(
-            aim_point.x(), aim_point.y(), aim_point.z());
-
-        // 计算yaw
-        double yaw_cmd = std::atan2(aim_point.x(), aim_point.z());
-
-        // 手动补偿
-        double dist = aim_point.norm();
-        auto manual_comp = manual_compensator_.getCompensation(dist);
-        compensated_pitch += manual_comp.pitch_offset;
-        yaw_cmd += manual_comp.yaw_offset;
-
-        // 发布云台控制命令
-        rm_interfaces::msg::GimbalCmd gimbal_cmd;
-        gimbal_cmd.header = msg->header;
-        gimbal_cmd.yaw = yaw_cmd;
-        gimbal_cmd.pitch = compensated_pitch;
-        gimbal_cmd.fire = (tracker_state == TrackerState::TRACKING);
-        gimbal_cmd_pub_->publish(gimbal_cmd);
-
-    } else {
-        target_msg.tracking = false;
+    rcl_interfaces::msg::SetParametersResult result;
+    result.successful = true;
+
+    // 未配置时只接受修改，configure时统一读取
+    const bool configured = !config_.empty();
+    SolverParams config = configured ? config_.copy() : SolverParams{};
+    bool reloadable = false;
+    for (const auto& param : params) {
+        if (applyParameter(config, param)) {
+            reloadable = true;
+        } else if (configured) {
+            RCLCPP_INFO(get_logger(), "参数 %s 在重新configure后生效", param.get_name().c_str());
+        }
     }
-
-    target_pub_->publish(target_msg);
+    if (!reloadable || !configured) {
+        return result;
+    }
+    if (const char* reason = checkParams(config)) {
+        result.successful = false;
+        result.reason = reason;
+        return result;
+    }
+    const uint64_t version = config_.publish(config);
+    RCLCPP_INFO(get_logger(), "解算参数已更新（版本 %lu），下一帧生效", version);
+    return result;
 }
 
-Eigen::Vector3d ArmorSolverNode::calcAimPoint(
-    const Eigen::VectorXd& state, double v_yaw)
+void ArmorSolverNode::armorsCallback(
+    const rm_interfaces::msg::CompactArmors::ConstSharedPtr& msg)
 {
-    if (isSmallGyro(v_yaw)) {
-        // 小陀螺模式：选择最优装甲板
-        return selectBestArmor(state, tracker_->targetArmorsNum());
+    // 参数热更新：无锁读取当前配置，版本变化时在帧间整体替换（不计入本帧分配）
+    {
+        const auto config = config_reader_->read();
+        if (config.version() != applied_config_version_) {
+            solver_->setParams(*config);
+            applied_config_version_ = config.version();
+        }
     }
 
-    // 普通模式：直接瞄准预测的装甲板位置
-    double xc = state(0), yc = state(2), zc = state(4);
-    double yaw = state(6), r = state(8), d_zc = state(9);
+    // 本帧（跟踪 + 补偿 + 命令发布）的堆分配计入SOLVE
+    AllocScope alloc_scope(AllocTag::SOLVE, true);
 
-    Eigen::Vector3d aim;
-    aim.x() = xc - r * std::cos(yaw);
-    aim.y() = yc - r * std::sin(yaw);
-    aim.z() = zc + d_zc;
+    fromMsg(*msg, observations_);
 
-    return aim;
-}
+    // 变换到参考相机坐标系并计算dt；迟到帧、其他相机的空帧不送入跟踪器
+    const int64_t stamp_ns = observations_.stamp_ns;
+    double dt = CameraFusion::DEFAULT_DT;
+    const auto verdict = fusion_.prepare(observations_, dt);
+    if (verdict != CameraFusion::Verdict::ACCEPT) {
+        if (verdict == CameraFusion::Verdict::UNKNOWN_CAMERA) {
+            RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
+                                 "相机 %u 没有外参（camera_extrinsics 只有 %zu 路），观测已丢弃",
+                                 static_cast<unsigned>(observations_.camera), fusion_.cameraCount());
+        }
+        // 拒收的帧也发布Target（跟踪状态不变），锁步相机等待的是每一帧的确认
+        const auto state = solver_->tracker().state();
+        publishTarget(msg->stamp,
+                      state == TrackerState::TRACKING || state == TrackerState::TEMP_LOST);
+        return;
+    }
 
-bool ArmorSolverNode::isSmallGyro(double v_yaw) const {
-    return std::abs(v_yaw) > max_tracking_v_yaw_;
+    // 跟踪 + 瞄准点选择 + 弹道补偿
+    const auto cmd = solver_->solve(observations_, dt);
+    if (cmd.valid) {
+        // 发布云台控制命令
+        auto gimbal_cmd = std::make_unique<rm_interfaces::msg::GimbalCmd>();
+        gimbal_cmd->header.stamp = msg->stamp;
+        gimbal_cmd->header.frame_id = ARMOR_FRAME_ID;
+        gimbal_cmd->yaw = cmd.yaw;
+        gimbal_cmd->pitch = cmd.pitch;
+        gimbal_cmd->fire = cmd.fire;
+        gimbal_cmd_pub_->publish(std::move(gimbal_cmd));
+        LatencyTracer::global().mark(TraceStage::COMMAND_PUBLISH, stamp_ns);
+    }
+    publishTarget(msg->stamp, cmd.valid);
 }
 
-Eigen::Vector3d ArmorSolverNode::selectBestArmor(
-    const Eigen::VectorXd& state, int armors_num)
-{
-    double xc = state(0), yc = state(2), zc = state(4);
-    double yaw = state(6), r = state(8), d_zc = state(9);
-
-    // 计算所有装甲板位置
-    double angle_step = 2.0 * M_PI / armors_num;
-    double min_yaw_diff = std::numeric_limits<double>::max();
-    Eigen::Vector3d best_point;
-
-    for (int i = 0; i < armors_num; i++) {
-        double armor_yaw = yaw + i * angle_step;
+void ArmorSolverNode::publishTarget(const builtin_interfaces::msg::Time& stamp, bool tracking) {
+    auto target_msg = std::make_unique<rm_interfaces::msg::Target>();
+    target_msg->header.stamp = stamp;
+    target_msg->header.frame_id = ARMOR_FRAME_ID;
+    target_msg->tracking = tracking;
 
-        // 归一化到[-pi, pi]
-        while (armor_yaw > M_PI) armor_yaw -= 2 * M_PI;
-        while (armor_yaw < -M_PI) armor_yaw += 2 * M_PI;
+    if (tracking) {
+        const auto& tracker = solver_->tracker();
+        target_msg->id = armorSymbolName(tracker.trackedSymbol());
+        target_msg->armors_num = tracker.targetArmorsNum();
 
-        Eigen::Vector3d armor_pos;
-        armor_pos.x() = xc - r * std::cos(armor_yaw);
-        armor_pos.y() = yc - r * std::sin(armor_yaw);
-        armor_pos.z() = zc + ((i % 2 == 0) ? d_zc : -d_zc);
-
-        // 选择正对相机的那块装甲板（yaw最接近0的）
-        double yaw_to_cam = std::atan2(armor_pos.x(), armor_pos.z());
-        double yaw_diff = std::abs(yaw_to_cam);
-
-        if (yaw_diff < min_yaw_diff) {
-            min_yaw_diff = yaw_diff;
-            best_point = armor_pos;
-        }
+        const auto& state = tracker.getState();
+        // EKF状态: [xc, v_xc, yc, v_yc, zc, v_zc, yaw, v_yaw, r, d_zc]
+        target_msg->position.x = state(0);
+        target_msg->position.y = state(2);
+        target_msg->position.z = state(4);
+        target_msg->velocity.x = state(1);
+        target_msg->velocity.y = state(3);
+        target_msg->velocity.z = state(5);
+        target_msg->yaw = state(6);
+        target_msg->v_yaw = state(7);
+        target_msg->radius_1 = state(8);
+        target_msg->d_zc = state(9);
     }
 
-    return best_point;
+    target_pub_->publish(std::move(target_msg));
 }
 
 }  // namespace rm_auto_aim
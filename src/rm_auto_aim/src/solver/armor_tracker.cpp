@@ -3,14 +3,11 @@
 #include <cmath>
 #include <limits>
 
+#include "rm_utils/flight_recorder.hpp"
+
 namespace rm_auto_aim {
 
-ArmorTracker::ArmorTracker() {
-    ekf_ = std::make_unique<ExtendedKalmanFilter>(10, 4);
-    ekf_->setFunctions(
-        [](const Eigen::VectorXd& x, double dt) { return predictFunc(x, dt); },
-        [](const Eigen::VectorXd& x) { return measureFunc(x); });
-}
+ArmorTracker::ArmorTracker() = default;
 
 void ArmorTracker::setParams(
     double max_match_distance, double max_match_yaw_diff,
@@ -38,7 +35,7 @@ void ArmorTracker::setEKFParams(
     r_yaw_ = r_yaw;
 
     // 设置EKF噪声矩阵
-    Eigen::MatrixXd Q = Eigen::MatrixXd::Identity(10, 10);
+    ArmorEKF::StateMat Q = ArmorEKF::StateMat::Identity();
     Q(0, 0) = sigma2_q_x_;  Q(1, 1) = sigma2_q_x_;   // xc, v_xc
     Q(2, 2) = sigma2_q_y_;  Q(3, 3) = sigma2_q_y_;   // yc, v_yc
     Q(4, 4) = sigma2_q_z_;  Q(5, 5) = sigma2_q_z_;   // zc, v_zc
@@ -46,30 +43,41 @@ void ArmorTracker::setEKFParams(
     Q(8, 8) = sigma2_q_r_;                             // r
     Q(9, 9) = sigma2_q_z_;                             // d_zc
 
-    Eigen::MatrixXd R = Eigen::MatrixXd::Identity(4, 4);
+    ArmorEKF::MeasMat R = ArmorEKF::MeasMat::Identity();
     R(0, 0) = r_x_;
     R(1, 1) = r_y_;
     R(2, 2) = r_z_;
     R(3, 3) = r_yaw_;
 
-    ekf_->setNoiseMatrices(Q, R);
+    ekf_.setNoiseMatrices(Q, R);
 }
 
-void ArmorTracker::update(const rm_interfaces::msg::Armors& armors, double dt) {
+void ArmorTracker::reset() {
+    state_ = TrackerState::LOST;
+    tracked_symbol_ = ArmorSymbol::UNKNOWN;
+    detect_count_ = 0;
+    lost_count_ = 0;
+    lost_time_ = 0;
+}
+
+void ArmorTracker::update(const ArmorObservations& armors, double dt) {
+    const TrackerState prev_state = state_;
+    last_match_idx_ = -1;
+
     // EKF预测步
     if (state_ == TrackerState::TRACKING || state_ == TrackerState::TEMP_LOST) {
-        ekf_->predict(dt);
+        ekf_.predict(dt);
     }
 
     // 当前帧检测到的装甲板数量
-    bool detected = !armors.armors.empty();
+    bool detected = armors.count > 0;
 
     switch (state_) {
         case TrackerState::LOST: {
             if (detected) {
                 // 找到最近的装甲板初始化
                 initEKF(armors.armors[0]);
-                tracked_id_ = armors.armors[0].number;
+                tracked_symbol_ = armors.armors[0].symbol;
                 state_ = TrackerState::DETECTING;
                 detect_count_ = 1;
             }
@@ -81,14 +89,7 @@ void ArmorTracker::update(const rm_interfaces::msg::Armors& armors, double dt) {
                 int match_idx = matchArmor(armors);
                 if (match_idx >= 0) {
                     // 匹配成功，更新EKF
-                    const auto& armor = armors.armors[match_idx];
-                    Eigen::Vector4d z;
-                    z << armor.pose.position.x,
-                         armor.pose.position.y,
-                         armor.pose.position.z,
-                         2.0 * std::atan2(armor.pose.orientation.z,
-                                          armor.pose.orientation.w);
-                    ekf_->update(z);
+                    updateEKF(armors.armors[match_idx]);
 
                     detect_count_++;
                     if (detect_count_ >= tracking_thres_) {
@@ -97,7 +98,7 @@ void ArmorTracker::update(const rm_interfaces::msg::Armors& armors, double dt) {
                 } else {
                     // 未匹配，重新初始化
                     initEKF(armors.armors[0]);
-                    tracked_id_ = armors.armors[0].number;
+                    tracked_symbol_ = armors.armors[0].symbol;
                     detect_count_ = 1;
                 }
             } else {
@@ -111,14 +112,7 @@ void ArmorTracker::update(const rm_interfaces::msg::Armors& armors, double dt) {
             if (detected) {
                 int match_idx = matchArmor(armors);
                 if (match_idx >= 0) {
-                    const auto& armor = armors.armors[match_idx];
-                    Eigen::Vector4d z;
-                    z << armor.pose.position.x,
-                         armor.pose.position.y,
-                         armor.pose.position.z,
-                         2.0 * std::atan2(armor.pose.orientation.z,
-                                          armor.pose.orientation.w);
-                    ekf_->update(z);
+                    updateEKF(armors.armors[match_idx]);
                     lost_count_ = 0;
                     lost_time_ = 0;
                 } else {
@@ -147,14 +141,7 @@ void ArmorTracker::update(const rm_interfaces::msg::Armors& armors, double dt) {
             if (detected) {
                 int match_idx = matchArmor(armors);
                 if (match_idx >= 0) {
-                    const auto& armor = armors.armors[match_idx];
-                    Eigen::Vector4d z;
-                    z << armor.pose.position.x,
-                         armor.pose.position.y,
-                         armor.pose.position.z,
-                         2.0 * std::atan2(armor.pose.orientation.z,
-                                          armor.pose.orientation.w);
-                    ekf_->update(z);
+                    updateEKF(armors.armors[match_idx]);
                     state_ = TrackerState::TRACKING;
                     lost_count_ = 0;
                     lost_time_ = 0;
@@ -169,24 +156,39 @@ void ArmorTracker::update(const rm_interfaces::msg::Armors& armors, double dt) {
         }
     }
 
-    // 根据tracked_id确定目标装甲板数量
-    if (tracked_id_ == "1" || tracked_id_ == "hero") {
-        target_armors_num_ = 2;  // 英雄双甲
-    } else if (tracked_id_ == "sentry" || tracked_id_ == "outpost") {
-        target_armors_num_ = 3;  // 哨兵/前哨站三甲
-    } else {
-        target_armors_num_ = 4;  // 步兵四甲
+    if (state_ != prev_state) {
+        RM_FLIGHT_RECORD(FlightEvent::TRACKER_STATE,
+                         static_cast<double>(prev_state), static_cast<double>(state_),
+                         detect_count_, lost_time_);
+        if (state_ == TrackerState::LOST) {
+            // 丢失前的几秒记录最有诊断价值，交由后台线程转储
+            RM_FLIGHT_DUMP(FlightDumpReason::TRACKER_LOST);
+        }
+    }
+
+    // 根据目标编号确定目标装甲板数量
+    switch (tracked_symbol_) {
+        case ArmorSymbol::HERO:
+            target_armors_num_ = 2;  // 英雄双甲
+            break;
+        case ArmorSymbol::SENTRY:
+        case ArmorSymbol::OUTPOST:
+            target_armors_num_ = 3;  // 哨兵/前哨站三甲
+            break;
+        default:
+            target_armors_num_ = 4;  // 步兵四甲
+            break;
     }
 }
 
-void ArmorTracker::initEKF(const rm_interfaces::msg::Armor& armor) {
-    double x = armor.pose.position.x;
-    double y = armor.pose.position.y;
-    double z = armor.pose.position.z;
-    double yaw = 2.0 * std::atan2(armor.pose.orientation.z, armor.pose.orientation.w);
+void ArmorTracker::initEKF(const ArmorObservation& armor) {
+    double x = armor.position.x();
+    double y = armor.position.y();
+    double z = armor.position.z();
+    double yaw = armor.yaw;
 
     // 初始状态: 位置=装甲板位置, 速度=0, r=0.2m(初始估计)
-    Eigen::VectorXd x0 = Eigen::VectorXd::Zero(10);
+    ArmorEKF::StateVec x0 = ArmorEKF::StateVec::Zero();
     x0(0) = x;     // xc
     x0(1) = 0;     // v_xc
     x0(2) = y;     // yc
@@ -198,61 +200,50 @@ void ArmorTracker::initEKF(const rm_interfaces::msg::Armor& armor) {
     x0(8) = 0.2;   // r (初始旋转半径估计)
     x0(9) = 0;     // d_zc
 
-    ekf_->init(x0);
+    ekf_.init(x0);
 }
 
-int ArmorTracker::matchArmor(const rm_interfaces::msg::Armors& armors) {
+void ArmorTracker::updateEKF(const ArmorObservation& armor) {
+    Eigen::Vector4d z;
+    z << armor.position, armor.yaw;
+    ekf_.update(z);
+    // 新息：观测与预测观测之差，持续偏大说明模型或噪声参数失配
+    const auto& innovation = ekf_.innovation();
+    RM_FLIGHT_RECORD(FlightEvent::EKF_INNOVATION,
+                     innovation(0), innovation(1), innovation(2), innovation(3));
+}
+
+int ArmorTracker::matchArmor(const ArmorObservations& armors) {
     // 用预测位置与检测结果做关联
-    auto state = ekf_->state();
-    Eigen::Vector4d predicted_z = measureFunc(state);
+    const Eigen::Vector4d predicted_z = ArmorMeasureModel()(ekf_.state());
 
     double min_dist = std::numeric_limits<double>::max();
     int best_idx = -1;
+    double best_yaw_diff = 0.0;
 
-    for (size_t i = 0; i < armors.armors.size(); i++) {
+    for (uint8_t i = 0; i < armors.count; i++) {
         const auto& armor = armors.armors[i];
 
         // 位置距离
-        double dx = armor.pose.position.x - predicted_z(0);
-        double dy = armor.pose.position.y - predicted_z(1);
-        double dz = armor.pose.position.z - predicted_z(2);
-        double dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        double dist = (armor.position - predicted_z.head<3>()).norm();
 
         // yaw差异
-        double det_yaw = 2.0 * std::atan2(armor.pose.orientation.z,
-                                            armor.pose.orientation.w);
-        double yaw_diff = std::abs(det_yaw - predicted_z(3));
+        double yaw_diff = std::abs(armor.yaw - predicted_z(3));
         while (yaw_diff > M_PI) yaw_diff = std::abs(yaw_diff - 2 * M_PI);
 
         if (dist < max_match_distance_ && yaw_diff < max_match_yaw_diff_) {
             if (dist < min_dist) {
                 min_dist = dist;
                 best_idx = static_cast<int>(i);
+                best_yaw_diff = yaw_diff;
             }
         }
     }
 
+    last_match_idx_ = best_idx;
+    RM_FLIGHT_RECORD(FlightEvent::TRACKER_MATCH, best_idx,
+                     best_idx >= 0 ? min_dist : -1.0, armors.count, best_yaw_diff);
     return best_idx;
 }
 
-Eigen::VectorXd ArmorTracker::predictFunc(const Eigen::VectorXd& x, double dt) {
-    // 匀速+匀角速度运动模型
-    Eigen::VectorXd x1 = x;
-    x1(0) += x(1) * dt;   // xc += v_xc * dt
-    x1(2) += x(3) * dt;   // yc += v_yc * dt
-    x1(4) += x(5) * dt;   // zc += v_zc * dt
-    x1(6) += x(7) * dt;   // yaw += v_yaw * dt
-    return x1;
-}
-
-Eigen::Vector4d ArmorTracker::measureFunc(const Eigen::VectorXd& x) {
-    // 从旋转中心反推装甲板位置
-    Eigen::Vector4d z;
-    z(0) = x(0) - std::cos(x(6)) * x(8);  // x_armor = xc - r*cos(yaw)
-    z(1) = x(2) - std::sin(x(6)) * x(8);  // y_armor = yc - r*sin(yaw)
-    z(2) = x(4) + x(9);                   // z_armor = zc + d_zc
-    z(3) = x(6);                           // yaw
-    return z;
-}
-
 }  // namespace rm_auto_aim
@@ -0,0 +1,76 @@
+#include "rm_auto_aim/solver/camera_fusion.hpp"
+
+namespace rm_auto_aim {
+
+CameraExtrinsic CameraExtrinsic::fromXyzRpy(const double* values) {
+    CameraExtrinsic extrinsic;
+    extrinsic.translation = Eigen::Vector3d(values[0], values[1], values[2]);
+    extrinsic.rotation = Eigen::AngleAxisd(values[5], Eigen::Vector3d::UnitZ()) *
+                         Eigen::AngleAxisd(values[4], Eigen::Vector3d::UnitY()) *
+                         Eigen::AngleAxisd(values[3], Eigen::Vector3d::UnitX());
+    return extrinsic;
+}
+
+void CameraExtrinsic::apply(ArmorObservations& armors) const {
+    for (uint8_t i = 0; i < armors.count; i++) {
+        auto& armor = armors.armors[i];
+        armor.position = rotation * armor.position + translation;
+        armor.setOrientation(rotation * armor.orientation);
+    }
+}
+
+CameraFusion::CameraFusion() {
+    setExtrinsics({});
+}
+
+void CameraFusion::setExtrinsics(const std::vector<CameraExtrinsic>& extrinsics) {
+    extrinsics_ = extrinsics;
+    if (extrinsics_.empty()) {
+        extrinsics_.emplace_back();
+    }
+    reset();
+}
+
+void CameraFusion::reset() {
+    last_stamp_ns_ = 0;
+    last_camera_ = -1;
+    last_seen_camera_ = -1;
+}
+
+CameraFusion::Verdict CameraFusion::prepare(ArmorObservations& armors, double& dt) {
+    const int camera = armors.camera;
+    Verdict verdict = Verdict::ACCEPT;
+    if (camera >= static_cast<int>(extrinsics_.size())) {
+        verdict = Verdict::UNKNOWN_CAMERA;
+    } else if (armors.empty() && last_seen_camera_ >= 0 && camera != last_seen_camera_) {
+        verdict = Verdict::NO_INFORMATION;
+    } else if (last_camera_ >= 0 && camera != last_camera_ && armors.stamp_ns < last_stamp_ns_) {
+        verdict = Verdict::STALE;
+    }
+    counts_[static_cast<size_t>(verdict)]++;
+    if (verdict != Verdict::ACCEPT) {
+        return verdict;
+    }
+
+    // 计算dt：不同相机同一时刻触发时dt为0（只做更新不做外推）
+    dt = DEFAULT_DT;
+    if (last_camera_ >= 0) {
+        dt = static_cast<double>(armors.stamp_ns - last_stamp_ns_) * 1e-9;
+        const bool same_instant = dt == 0.0 && camera != last_camera_;
+        if (!same_instant && (dt <= 0 || dt > 1.0)) {
+            dt = DEFAULT_DT;
+        }
+    }
+    last_stamp_ns_ = armors.stamp_ns;
+    last_camera_ = camera;
+    if (!armors.empty()) {
+        last_seen_camera_ = camera;
+    }
+
+    if (camera != 0) {
+        extrinsics_[camera].apply(armors);
+    }
+    return verdict;
+}
+
+}  // namespace rm_auto_aim
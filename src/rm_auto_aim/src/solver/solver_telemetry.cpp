@@ -0,0 +1,67 @@
+#include "rm_auto_aim/solver/solver_telemetry.hpp"
+
+#include <cstddef>
+
+namespace rm_auto_aim {
+
+namespace {
+
+constexpr const char* kStateNames[10] = {
+    "xc", "v_xc", "yc", "v_yc", "zc", "v_zc", "yaw", "v_yaw", "r", "d_zc"};
+constexpr const char* kObsNames[4] = {"x", "y", "z", "yaw"};
+constexpr const char* kAxisNames[3] = {"x", "y", "z"};
+
+std::vector<TelemetryColumn> buildColumns() {
+    using R = SolverTelemetryRecord;
+    auto offset = [](size_t base, size_t index, size_t size) {
+        return static_cast<uint32_t>(base + index * size);
+    };
+
+    std::vector<TelemetryColumn> columns;
+    columns.push_back({"stamp_ns", TelemetryType::I64, offsetof(R, stamp_ns)});
+    columns.push_back({"solve_ns", TelemetryType::I64, offsetof(R, solve_ns)});
+    columns.push_back({"dt", TelemetryType::F64, offsetof(R, dt)});
+    for (size_t i = 0; i < 10; i++) {
+        columns.push_back({kStateNames[i], TelemetryType::F64,
+                           offset(offsetof(R, state), i, sizeof(double))});
+    }
+    for (size_t i = 0; i < 10; i++) {
+        columns.push_back({std::string("cov_") + kStateNames[i], TelemetryType::F64,
+                           offset(offsetof(R, cov_diag), i, sizeof(double))});
+    }
+    for (size_t i = 0; i < 4; i++) {
+        columns.push_back({std::string("innov_") + kObsNames[i], TelemetryType::F64,
+                           offset(offsetof(R, innovation), i, sizeof(double))});
+    }
+    for (size_t i = 0; i < 3; i++) {
+        columns.push_back({std::string("aim_") + kAxisNames[i], TelemetryType::F64,
+                           offset(offsetof(R, aim_point), i, sizeof(double))});
+    }
+    columns.push_back({"cmd_yaw", TelemetryType::F64, offsetof(R, cmd_yaw)});
+    columns.push_back({"cmd_pitch", TelemetryType::F64, offsetof(R, cmd_pitch)});
+    columns.push_back({"matched_index", TelemetryType::I32, offsetof(R, matched_index)});
+    columns.push_back({"armors_num", TelemetryType::I32, offsetof(R, armors_num)});
+    columns.push_back({"observations", TelemetryType::U8, offsetof(R, observations)});
+    columns.push_back({"camera", TelemetryType::U8, offsetof(R, camera)});
+    columns.push_back({"tracker_state", TelemetryType::U8, offsetof(R, tracker_state)});
+    columns.push_back({"tracked_symbol", TelemetryType::U8, offsetof(R, tracked_symbol)});
+    columns.push_back({"valid", TelemetryType::U8, offsetof(R, valid)});
+    columns.push_back({"fire", TelemetryType::U8, offsetof(R, fire)});
+    columns.push_back({"small_gyro", TelemetryType::U8, offsetof(R, small_gyro)});
+    return columns;
+}
+
+}  // namespace
+
+const std::vector<TelemetryColumn>& solverTelemetryColumns() {
+    static const std::vector<TelemetryColumn> columns = buildColumns();
+    return columns;
+}
+
+bool openSolverTelemetry(TelemetryWriter& writer, const std::string& output_dir,
+                         const TelemetryWriter::Options& options, std::string* error) {
+    return writer.open(makeTelemetryPath(output_dir, "solver"), solverTelemetryColumns(),
+                       sizeof(SolverTelemetryRecord), options, error);
+}
+
+}  // namespace rm_auto_aim
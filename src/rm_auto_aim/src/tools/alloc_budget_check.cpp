@@ -0,0 +1,157 @@
+// 稳态分配预算检查：合成帧依次经过 检测 → PnP → 跟踪解算，统计每帧堆分配次数
+// 用法: alloc_budget_check [--frames N] [--warmup N] [--budget N] [--detect-budget N]
+//                          [--solve-budget N] [--width W] [--height H]
+// 预热帧之后任一阶段单帧分配次数超过该阶段预算时返回非零（colcon test 中注册为测试）。
+// 解算阶段（跟踪/EKF/弹道补偿）目标为零分配，默认预算0；检测阶段的分配来自OpenCV内部
+// （findContours、solvePnPGeneric），默认预算64。--budget 同时设置两个阶段。
+// 本程序直接链接 librm_alloc_hooks.so，无需 LD_PRELOAD。
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+#include "rm_auto_aim/detector/warmup.hpp"
+#include "rm_auto_aim/solver/armor_solver.hpp"
+#include "rm_utils/alloc_tracker.hpp"
+
+using rm_auto_aim::AllocScope;
+using rm_auto_aim::AllocTag;
+using rm_auto_aim::AllocTracker;
+
+namespace {
+
+struct StageStats {
+    uint64_t frames = 0;
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+    uint64_t max_allocs = 0;
+
+    void add(const rm_auto_aim::AllocCounters& frame) {
+        frames++;
+        allocs += frame.allocs;
+        bytes += frame.bytes;
+        max_allocs = std::max(max_allocs, frame.allocs);
+    }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int frames = 600;
+    int warmup = 60;
+    long detect_budget = 64;
+    long solve_budget = 0;
+    int width = 1280;
+    int height = 1024;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const long value = std::strtol(argv[i + 1], nullptr, 10);
+        if (std::strcmp(argv[i], "--frames") == 0) {
+            frames = static_cast<int>(value);
+        } else if (std::strcmp(argv[i], "--warmup") == 0) {
+            warmup = static_cast<int>(value);
+        } else if (std::strcmp(argv[i], "--budget") == 0) {
+            detect_budget = value;
+            solve_budget = value;
+        } else if (std::strcmp(argv[i], "--detect-budget") == 0) {
+            detect_budget = value;
+        } else if (std::strcmp(argv[i], "--solve-budget") == 0) {
+            solve_budget = value;
+        } else if (std::strcmp(argv[i], "--width") == 0) {
+            width = static_cast<int>(value);
+        } else if (std::strcmp(argv[i], "--height") == 0) {
+            height = static_cast<int>(value);
+        } else {
+            std::fprintf(stderr,
+                         "用法: %s [--frames N] [--warmup N] [--budget N] [--detect-budget N]"
+                         " [--solve-budget N] [--width W] [--height H]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if (!AllocTracker::hooksActive()) {
+        std::fprintf(stderr, "分配计数钩子未生效（librm_alloc_hooks.so 未加载）\n");
+        return 2;
+    }
+
+    // 合成输入：目标装甲板在画面中缓慢平移，循环使用（测量开始前全部生成好）
+    const cv::Size size(width, height);
+    const auto color = rm_auto_aim::Color::RED;
+    const cv::Mat base = rm_auto_aim::makeWarmupFrame(size, color);
+    std::vector<cv::Mat> inputs;
+    for (int dx = -40; dx <= 40; dx += 10) {
+        const cv::Mat shift = (cv::Mat_<double>(2, 3) << 1, 0, dx, 0, 1, 0);
+        cv::Mat frame;
+        cv::warpAffine(base, frame, shift, size, cv::INTER_NEAREST, cv::BORDER_CONSTANT,
+                       cv::Scalar(20, 20, 20));
+        inputs.push_back(frame);
+    }
+
+    // 默认内参：主点位于图像中心，焦距约为宽度
+    const auto calibration = rm_auto_aim::calibrationFromArrays(
+        {1.2 * width, 0.0, width / 2.0, 0.0, 1.2 * width, height / 2.0, 0.0, 0.0, 1.0}, {},
+        width, height);
+    rm_auto_aim::ArmorDetector detector(rm_auto_aim::DetectorParams{});
+    rm_auto_aim::PnPSolver pnp_solver(calibration.camera_matrix, calibration.dist_coeffs);
+    rm_auto_aim::ArmorSolver solver(rm_auto_aim::SolverParams{});
+    const cv::Point2f img_center(width / 2.0f, height / 2.0f);
+
+    rm_auto_aim::ArmorObservations observations;
+    StageStats detect_stats;
+    StageStats solve_stats;
+    uint64_t detected = 0;
+    uint64_t tracked = 0;
+    constexpr int64_t FRAME_INTERVAL_NS = 10'000'000;  // 100 fps
+
+    for (int i = 0; i < warmup + frames; i++) {
+        const bool measure = i >= warmup;
+        const auto& image = inputs[static_cast<size_t>(i) % inputs.size()];
+        {
+            AllocScope scope(AllocTag::DETECT);
+            observations.clear();
+            observations.stamp_ns = (i + 1) * FRAME_INTERVAL_NS;
+            const auto armors = detector.detect(image, color);
+            pnp_solver.solveAll(armors, img_center, observations);
+            if (measure) {
+                detect_stats.add(scope.delta());
+            }
+        }
+        {
+            AllocScope scope(AllocTag::SOLVE);
+            const auto cmd = solver.solve(observations, FRAME_INTERVAL_NS * 1e-9);
+            if (measure) {
+                solve_stats.add(scope.delta());
+                tracked += cmd.valid ? 1 : 0;
+            }
+        }
+        if (measure) {
+            detected += observations.empty() ? 0 : 1;
+        }
+    }
+
+    bool ok = true;
+    auto report = [&ok](const char* name, const StageStats& stats, long budget) {
+        const double n = stats.frames > 0 ? static_cast<double>(stats.frames) : 1.0;
+        std::printf("%-8s %8lu %14.2f %10lu %16.1f\n", name, stats.frames, stats.allocs / n,
+                    stats.max_allocs, stats.bytes / n);
+        if (stats.max_allocs > static_cast<uint64_t>(std::max(budget, 0L))) {
+            std::fprintf(stderr, "%s 阶段单帧最大分配 %lu 次，超出预算 %ld\n", name,
+                         stats.max_allocs, budget);
+            ok = false;
+        }
+    };
+    std::printf("%-8s %8s %14s %10s %16s\n", "stage", "frames", "allocs/frame", "max", "bytes/frame");
+    report("detect", detect_stats, detect_budget);
+    report("solve", solve_stats, solve_budget);
+    std::printf("检出帧 %lu / %d，跟踪帧 %lu / %d\n", detected, frames, tracked, frames);
+    if (detected == 0) {
+        // 合成帧未检出时解算路径只走了丢失分支，结果不代表稳态
+        std::fprintf(stderr, "合成帧未检出装甲板，检查检测参数\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "rm_auto_aim/solver/armor_tracker.hpp"
+
+namespace rm_auto_aim {
+namespace {
+
+/**
+ * @brief 参考实现：定长模板化之前的动态维度EKF（VectorXd/MatrixXd + std::function）
+ *
+ * 除去掉头文件/源文件拆分外保持原样，尤其是yaw新息在update()内归一化、
+ * 协方差用Joseph形式更新——ArmorEKF把前者挪进了ArmorMeasureModel::residual，
+ * 两者逐步结果须一致。
+ */
+class ReferenceEKF {
+public:
+    using VecX = Eigen::VectorXd;
+    using MatXX = Eigen::MatrixXd;
+    using PredictFunc = std::function<VecX(const VecX&, double)>;
+    using MeasureFunc = std::function<Eigen::Vector4d(const VecX&)>;
+
+    ReferenceEKF(int n_states, int n_obs) : n_states_(n_states) {
+        x_ = VecX::Zero(n_states);
+        P_ = MatXX::Identity(n_states, n_states);
+        Q_ = MatXX::Identity(n_states, n_states);
+        R_ = MatXX::Identity(n_obs, n_obs);
+    }
+
+    void setFunctions(PredictFunc f, MeasureFunc h) {
+        f_ = std::move(f);
+        h_ = std::move(h);
+    }
+
+    void setNoiseMatrices(const MatXX& Q, const MatXX& R) {
+        Q_ = Q;
+        R_ = R;
+    }
+
+    void init(const VecX& x0) {
+        x_ = x0;
+        P_ = MatXX::Identity(n_states_, n_states_) * 0.1;
+    }
+
+    void predict(double dt) {
+        MatXX F = computeF(x_, dt);
+        x_ = f_(x_, dt);
+        P_ = F * P_ * F.transpose() + Q_;
+    }
+
+    void update(const Eigen::Vector4d& z) {
+        auto H = computeH(x_);
+
+        Eigen::Vector4d y = z - h_(x_);
+        while (y(3) > M_PI) y(3) -= 2 * M_PI;
+        while (y(3) < -M_PI) y(3) += 2 * M_PI;
+
+        Eigen::Matrix4d S = H * P_ * H.transpose() + R_;
+        auto K = P_ * H.transpose() * S.inverse();
+
+        x_ = x_ + K * y;
+        y_ = y;
+
+        MatXX I = MatXX::Identity(n_states_, n_states_);
+        MatXX IKH = I - K * H;
+        P_ = IKH * P_ * IKH.transpose() + K * R_ * K.transpose();
+    }
+
+    const VecX& state() const { return x_; }
+    const MatXX& covariance() const { return P_; }
+    const Eigen::Vector4d& innovation() const { return y_; }
+
+private:
+    MatXX computeF(const VecX& x, double dt) {
+        MatXX F = MatXX::Identity(n_states_, n_states_);
+        const double eps = 1e-5;
+        VecX f0 = f_(x, dt);
+        for (int i = 0; i < n_states_; i++) {
+            VecX x_perturbed = x;
+            x_perturbed(i) += eps;
+            F.col(i) = (f_(x_perturbed, dt) - f0) / eps;
+        }
+        return F;
+    }
+
+    Eigen::Matrix<double, 4, Eigen::Dynamic> computeH(const VecX& x) {
+        Eigen::Matrix<double, 4, Eigen::Dynamic> H =
+            Eigen::Matrix<double, 4, Eigen::Dynamic>::Zero(4, n_states_);
+        const double eps = 1e-5;
+        Eigen::Vector4d h0 = h_(x);
+        for (int i = 0; i < n_states_; i++) {
+            VecX x_perturbed = x;
+            x_perturbed(i) += eps;
+            H.col(i) = (h_(x_perturbed) - h0) / eps;
+        }
+        return H;
+    }
+
+    int n_states_;
+    VecX x_;
+    MatXX P_;
+    MatXX Q_;
+    MatXX R_;
+    Eigen::Vector4d y_ = Eigen::Vector4d::Zero();
+    PredictFunc f_;
+    MeasureFunc h_;
+};
+
+/**
+ * @brief 旧跟踪器的predictFunc/measureFunc（与ArmorMotionModel/ArmorMeasureModel同式）
+ */
+ReferenceEKF::VecX referencePredict(const ReferenceEKF::VecX& x, double dt) {
+    ReferenceEKF::VecX x1 = x;
+    x1(0) += x(1) * dt;
+    x1(2) += x(3) * dt;
+    x1(4) += x(5) * dt;
+    x1(6) += x(7) * dt;
+    return x1;
+}
+
+Eigen::Vector4d referenceMeasure(const ReferenceEKF::VecX& x) {
+    Eigen::Vector4d z;
+    z(0) = x(0) - std::cos(x(6)) * x(8);
+    z(1) = x(2) - std::sin(x(6)) * x(8);
+    z(2) = x(4) + x(9);
+    z(3) = x(6);
+    return z;
+}
+
+/**
+ * @brief 一帧回放记录：dt与观测，has_measurement为false表示掉帧（只预测）
+ */
+struct ReplayStep {
+    double dt;
+    bool has_measurement;
+    Eigen::Vector4d z;
+};
+
+/**
+ * @brief 生成确定性的小陀螺观测序列
+ *
+ * 旋转中心匀速平移、整车以v_yaw自旋，观测yaw与检测端一致落在[-pi, pi]，
+ * 因此滤波器内未归一化的yaw每转一圈都要经历一次新息回绕。
+ * 噪声取自固定种子的mt19937原始输出（不经std::*_distribution，跨标准库可复现），
+ * 每隔drop_every帧掉一帧。
+ */
+std::vector<ReplayStep> makeSpinningSequence(int frames, double v_yaw, int drop_every) {
+    std::mt19937 rng(20240601u);
+    auto noise = [&rng](double amplitude) {
+        return (static_cast<double>(rng()) / 4294967295.0 - 0.5) * 2.0 * amplitude;
+    };
+
+    const double xc0 = 4.0, yc0 = 0.5, zc = 0.1;
+    const double vx = 0.3, vy = -0.2;
+    const double r = 0.25;
+
+    std::vector<ReplayStep> seq;
+    seq.reserve(frames);
+    double t = 0;
+    for (int i = 0; i < frames; i++) {
+        ReplayStep step;
+        step.dt = 0.01 + noise(0.002);
+        t += step.dt;
+        step.has_measurement = drop_every <= 0 || (i % drop_every) != drop_every - 1;
+
+        const double xc = xc0 + vx * t;
+        const double yc = yc0 + vy * t;
+        const double yaw = std::remainder(v_yaw * t, 2 * M_PI);
+        step.z(0) = xc - std::cos(yaw) * r + noise(0.01);
+        step.z(1) = yc - std::sin(yaw) * r + noise(0.01);
+        step.z(2) = zc + noise(0.01);
+        step.z(3) = yaw + noise(0.03);
+        seq.push_back(step);
+    }
+    return seq;
+}
+
+/**
+ * @brief 跟踪器默认噪声参数下的Q/R（与ArmorTracker::setEKFParams同式）
+ */
+void trackerNoise(ArmorEKF::StateMat& Q, ArmorEKF::MeasMat& R) {
+    const double q_x = 0.008, q_y = 0.008, q_z = 0.008, q_yaw = 1.30, q_r = 98.0;
+    Q = ArmorEKF::StateMat::Identity();
+    Q(0, 0) = q_x;   Q(1, 1) = q_x;
+    Q(2, 2) = q_y;   Q(3, 3) = q_y;
+    Q(4, 4) = q_z;   Q(5, 5) = q_z;
+    Q(6, 6) = q_yaw; Q(7, 7) = q_yaw;
+    Q(8, 8) = q_r;
+    Q(9, 9) = q_z;
+
+    R = ArmorEKF::MeasMat::Identity();
+    R(0, 0) = 0.0005;
+    R(1, 1) = 0.0005;
+    R(2, 2) = 0.0005;
+    R(3, 3) = 0.005;
+}
+
+/**
+ * @brief 与ArmorTracker::initEKF相同：以首帧装甲板位置初始化，r取0.2
+ */
+ArmorEKF::StateVec initialState(const ReplayStep& first) {
+    ArmorEKF::StateVec x0 = ArmorEKF::StateVec::Zero();
+    x0(0) = first.z(0);
+    x0(2) = first.z(1);
+    x0(4) = first.z(2);
+    x0(6) = first.z(3);
+    x0(8) = 0.2;
+    return x0;
+}
+
+/**
+ * @brief 相对差 ||a - b|| / max(||b||, 1)
+ */
+template <typename A, typename B>
+double relativeDiff(const A& a, const B& b) {
+    return (a - b).norm() / std::max(b.norm(), 1.0);
+}
+
+// 两者只在Eigen定长/动态内核的求和顺序上不同，逐步差异停留在舍入量级
+// （实测状态/新息~5e-10，协方差~2e-8）；yaw回绕出错时差异为O(1)
+constexpr double STATE_TOL = 1e-8;
+constexpr double COV_TOL = 1e-6;
+constexpr double INNOVATION_TOL = 1e-8;
+
+/**
+ * @brief 回放结果统计
+ */
+struct ReplayStats {
+    int updates = 0;
+    int yaw_wraps = 0;   // 原始yaw残差越过±pi、需归一化的更新次数
+};
+
+/**
+ * @brief 把序列同时喂给ArmorEKF与参考实现，逐步比较状态、协方差与新息
+ */
+ReplayStats replayAndCompare(const std::vector<ReplayStep>& seq) {
+    ArmorEKF::StateMat Q;
+    ArmorEKF::MeasMat R;
+    trackerNoise(Q, R);
+
+    const ArmorEKF::StateVec x0 = initialState(seq.front());
+
+    ArmorEKF ekf;
+    ekf.setNoiseMatrices(Q, R);
+    ekf.init(x0);
+
+    ReferenceEKF ref(ArmorEKF::STATES, ArmorEKF::MEASUREMENTS);
+    ref.setFunctions(referencePredict, referenceMeasure);
+    ref.setNoiseMatrices(Q, R);
+    ref.init(x0);
+
+    ReplayStats stats;
+    for (size_t i = 1; i < seq.size(); i++) {
+        const ReplayStep& step = seq[i];
+        ekf.predict(step.dt);
+        ref.predict(step.dt);
+        EXPECT_LT(relativeDiff(ekf.state(), ref.state()), STATE_TOL) << "predict, step " << i;
+
+        if (step.has_measurement) {
+            const double raw_yaw_residual = step.z(3) - ekf.state()(6);
+            if (std::abs(raw_yaw_residual) > M_PI) stats.yaw_wraps++;
+
+            ekf.update(step.z);
+            ref.update(step.z);
+            stats.updates++;
+
+            EXPECT_LT(relativeDiff(ekf.innovation(), ref.innovation()), INNOVATION_TOL)
+                << "innovation, step " << i;
+            EXPECT_LE(std::abs(ekf.innovation()(3)), M_PI) << "yaw innovation, step " << i;
+            EXPECT_LT(relativeDiff(ekf.state(), ref.state()), STATE_TOL) << "update, step " << i;
+        }
+        EXPECT_LT(relativeDiff(ekf.covariance(), ref.covariance()), COV_TOL)
+            << "covariance, step " << i;
+
+        if (::testing::Test::HasFailure()) break;   // 首个偏差处停下，避免刷屏
+    }
+    return stats;
+}
+
+TEST(ArmorEKF, MatchesReferenceOnSpinningReplay) {
+    // 小陀螺约1转/秒，每37帧掉一帧
+    const auto seq = makeSpinningSequence(1500, 6.0, 37);
+    const ReplayStats stats = replayAndCompare(seq);
+
+    // 序列必须真的覆盖yaw回绕与掉帧，否则比较不到ArmorMeasureModel::residual
+    EXPECT_GT(stats.yaw_wraps, 10);
+    EXPECT_LT(stats.updates, static_cast<int>(seq.size()) - 1);
+}
+
+TEST(ArmorEKF, MatchesReferenceOnReverseSpin) {
+    // 反向自旋：yaw从-pi侧回绕
+    const auto seq = makeSpinningSequence(1500, -6.0, 0);
+    const ReplayStats stats = replayAndCompare(seq);
+    EXPECT_GT(stats.yaw_wraps, 10);
+}
+
+TEST(ArmorEKF, JosephUpdateStaysSymmetricPositiveWithTinyR) {
+    // 观测噪声远小于先验时，标准形式P = (I - KH)P 的对消误差会让P失去对称并出现负特征值
+    // （实测R = 1e-12·I时不对称度~5e-14、最小特征值~-9e-11），Joseph形式仍保持对称正定
+    ArmorEKF::StateMat Q;
+    ArmorEKF::MeasMat R;
+    trackerNoise(Q, R);
+    R = ArmorEKF::MeasMat::Identity() * 1e-12;
+
+    const auto seq = makeSpinningSequence(200, 6.0, 0);
+    ArmorEKF ekf;
+    ekf.setNoiseMatrices(Q, R);
+    ekf.init(initialState(seq.front()));
+    for (size_t i = 1; i < seq.size(); i++) {
+        ekf.predict(seq[i].dt);
+        ekf.update(seq[i].z);
+
+        const ArmorEKF::StateMat& P = ekf.covariance();
+        ASSERT_LT((P - P.transpose()).norm() / P.norm(), 1e-15) << "step " << i;
+        Eigen::SelfAdjointEigenSolver<ArmorEKF::StateMat> eig(P);
+        ASSERT_GT(eig.eigenvalues().minCoeff(), 0.0) << "step " << i;
+    }
+}
+
+}  // namespace
+}  // namespace rm_auto_aim
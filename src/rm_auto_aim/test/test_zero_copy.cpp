@@ -0,0 +1,422 @@
+#include <gtest/gtest.h>
+
+#include <lifecycle_msgs/msg/state.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "rm_auto_aim/detector/armor_detector_node.hpp"
+#include "rm_auto_aim/solver/armor_solver_node.hpp"
+#include "rm_hardware_driver/camera_driver_node.hpp"
+#include "rm_hardware_driver/serial_driver_node.hpp"
+#include "rm_hardware_driver/serial_protocol.hpp"
+#include "rm_recorder/log_reader.hpp"
+#include "rm_recorder/recorder_node.hpp"
+#include "rm_utils/buffer_pool.hpp"
+
+namespace rm_auto_aim {
+namespace {
+
+constexpr int kWidth = 640;
+constexpr int kHeight = 480;
+constexpr int kFrames = 60;
+
+using LifecycleState = lifecycle_msgs::msg::State;
+
+/**
+ * @brief 测试临时目录（进程号区分，析构时删除）
+ */
+class TempDir {
+public:
+    explicit TempDir(const std::string& tag)
+        : path_(std::filesystem::temp_directory_path() /
+                ("rm_zero_copy_" + tag + "_" + std::to_string(::getpid())))
+    {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+    ~TempDir() { std::filesystem::remove_all(path_); }
+
+    const std::filesystem::path& path() const { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
+/**
+ * @brief 生成kFrames帧的合成视频（MJPG/AVI，OpenCV内置编解码，不依赖FFmpeg）
+ */
+std::string writeTestVideo(const std::filesystem::path& dir) {
+    const auto path = (dir / "frames.avi").string();
+    cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 30.0,
+                           cv::Size(kWidth, kHeight));
+    cv::Mat frame(kHeight, kWidth, CV_8UC3);
+    for (int i = 0; i < kFrames; i++) {
+        frame.setTo(cv::Scalar(40, 40, 40));
+        cv::rectangle(frame, cv::Rect(20 + i * 8, 200, 60, 40), cv::Scalar(255, 255, 255), -1);
+        writer.write(frame);
+    }
+    return path;
+}
+
+rclcpp::NodeOptions cameraOptions(const std::string& video_path) {
+    // 视频锁步：发布一帧后等解算节点的Target确认，回放不丢帧、帧数确定
+    return rclcpp::NodeOptions()
+        .use_intra_process_comms(true)
+        .parameter_overrides({
+            {"video_path", video_path},
+            {"frame_width", kWidth},
+            {"frame_height", kHeight},
+            {"video_lockstep", true},
+            {"lockstep_timeout_ms", 2000},
+        });
+}
+
+rclcpp::NodeOptions detectorOptions() {
+    return rclcpp::NodeOptions()
+        .use_intra_process_comms(true)
+        .parameter_overrides({
+            {"camera_matrix", std::vector<double>{600.0, 0.0, 320.0, 0.0, 600.0, 240.0, 0.0, 0.0, 1.0}},
+            {"image_width", kWidth},
+            {"image_height", kHeight},
+            {"calibration_cache", ""},
+            {"warmup.enable", false},
+            {"detect_color_from_serial", false},
+            {"detect_workers", 1},
+        });
+}
+
+rclcpp::NodeOptions solverOptions() {
+    return rclcpp::NodeOptions()
+        .use_intra_process_comms(true)
+        .parameter_overrides({{"warmup.enable", false}});
+}
+
+struct PoolCounters {
+    uint64_t acquires;
+    uint64_t releases;
+    uint64_t foreign;
+
+    static PoolCounters read() {
+        const auto& pool = BufferPool::global();
+        return {pool.acquires(), pool.releases(), pool.foreignReleases()};
+    }
+};
+
+/**
+ * @brief 后台线程转动执行器（相机/检测/解算各有自己的线程，主线程只负责等待结果）
+ */
+class SpinThread {
+public:
+    explicit SpinThread(rclcpp::Executor& executor)
+        : executor_(executor),
+          thread_([this] {
+              while (!stop_) executor_.spin_once(std::chrono::milliseconds(10));
+          }) {}
+    ~SpinThread() {
+        stop_ = true;
+        thread_.join();
+    }
+
+private:
+    rclcpp::Executor& executor_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+bool waitUntil(const std::function<bool()>& done, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/**
+ * @brief 探针订阅：记录每条消息的地址
+ *
+ * 与下游节点一样以ConstSharedPtr接收。同一话题上的进程内订阅者都取共享指针时，
+ * unique_ptr发布的对象被提升为shared_ptr原样交给每个订阅者；只要有订阅者要独占
+ * （或走进程间），探针拿到的就是拷贝，地址与发布的不同。
+ */
+template <typename MsgT>
+class AddressProbe {
+public:
+    AddressProbe(rclcpp::Node& node, const std::string& topic) {
+        sub_ = node.create_subscription<MsgT>(
+            topic, rclcpp::SensorDataQoS(),
+            [this](typename MsgT::ConstSharedPtr msg) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                addresses_.push_back(msg.get());
+            });
+    }
+
+    size_t count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return addresses_.size();
+    }
+
+    std::vector<const MsgT*> addresses() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return addresses_;
+    }
+
+private:
+    typename rclcpp::Subscription<MsgT>::SharedPtr sub_;
+    mutable std::mutex mutex_;
+    std::vector<const MsgT*> addresses_;
+};
+
+/**
+ * @brief 伪终端：从端交给串口节点当作串口打开，测试从主端读出节点写出的字节
+ */
+class PseudoTerminal {
+public:
+    PseudoTerminal() {
+        master_ = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (master_ >= 0 && ::grantpt(master_) == 0 && ::unlockpt(master_) == 0) {
+            slave_name_ = ::ptsname(master_);
+        }
+    }
+    ~PseudoTerminal() {
+        if (master_ >= 0) ::close(master_);
+    }
+
+    bool valid() const { return !slave_name_.empty(); }
+    const std::string& slaveName() const { return slave_name_; }
+
+    /**
+     * @brief 读满size字节（超时返回false）
+     */
+    bool readExact(uint8_t* out, size_t size, std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        size_t got = 0;
+        while (got < size) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) return false;
+            pollfd pfd{master_, POLLIN, 0};
+            if (::poll(&pfd, 1, static_cast<int>(left)) <= 0) continue;
+            const ssize_t n = ::read(master_, out + got, size - got);
+            if (n > 0) got += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+private:
+    int master_ = -1;
+    std::string slave_name_;
+};
+
+// 统计目录下录制文件中的图像记录数
+size_t countImageRecords(const std::filesystem::path& dir) {
+    size_t images = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().extension() != ".rmlog") continue;
+        LogReader reader;
+        std::string error;
+        if (!reader.open(entry.path().string(), &error)) continue;
+        for (const auto& index : reader.index()) {
+            images += index.type == static_cast<uint16_t>(RecordType::IMAGE);
+        }
+    }
+    return images;
+}
+
+/**
+ * @brief 真实相机节点回放合成视频，经检测→解算，统计缓冲区池与解算确认数
+ * @param extra 额外加入执行器的节点（如录制节点）
+ */
+void runVideoPipeline(const std::vector<rclcpp::Node::SharedPtr>& extra) {
+    TempDir video_dir("video");
+    const auto video = writeTestVideo(video_dir.path());
+
+    auto camera = std::make_shared<CameraDriverNode>(cameraOptions(video));
+    auto detector = std::make_shared<ArmorDetectorNode>(detectorOptions());
+    auto solver = std::make_shared<ArmorSolverNode>(solverOptions());
+    auto probe_node = std::make_shared<rclcpp::Node>(
+        "test_probe", rclcpp::NodeOptions().use_intra_process_comms(true));
+    AddressProbe<rm_interfaces::msg::Target> targets(*probe_node, "/solver/target");
+
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(camera->get_node_base_interface());
+    executor.add_node(detector->get_node_base_interface());
+    executor.add_node(solver->get_node_base_interface());
+    executor.add_node(probe_node);
+    for (const auto& node : extra) executor.add_node(node);
+
+    ASSERT_EQ(detector->configure().id(), LifecycleState::PRIMARY_STATE_INACTIVE);
+    ASSERT_EQ(solver->configure().id(), LifecycleState::PRIMARY_STATE_INACTIVE);
+    ASSERT_EQ(camera->configure().id(), LifecycleState::PRIMARY_STATE_INACTIVE) << "无法打开测试视频";
+    ASSERT_EQ(detector->activate().id(), LifecycleState::PRIMARY_STATE_ACTIVE);
+    ASSERT_EQ(solver->activate().id(), LifecycleState::PRIMARY_STATE_ACTIVE);
+
+    const auto before = PoolCounters::read();
+    {
+        SpinThread spin(executor);
+        ASSERT_EQ(camera->activate().id(), LifecycleState::PRIMARY_STATE_ACTIVE);
+        EXPECT_TRUE(waitUntil([&] { return targets.count() >= static_cast<size_t>(kFrames); },
+                              std::chrono::seconds(30)))
+            << "锁步回放只确认了 " << targets.count() << " 帧";
+        // 最后一帧的确认可能先于录制节点处理转交的图像，继续转动直到缓冲区全部归还
+        EXPECT_TRUE(waitUntil([] { return BufferPool::global().outstanding() == 0; },
+                              std::chrono::seconds(5)));
+        camera->deactivate();
+    }
+    // 检测节点停止时把信箱里剩余的帧经转交/回收路径归还
+    detector->deactivate();
+    solver->deactivate();
+    const auto after = PoolCounters::read();
+
+    EXPECT_EQ(targets.count(), static_cast<size_t>(kFrames));
+    // 预解码在文件末尾多取一块缓冲区（读失败即归还），因此只要求取还相等
+    EXPECT_GE(after.acquires - before.acquires, static_cast<uint64_t>(kFrames));
+    EXPECT_EQ(after.foreign - before.foreign, 0u) << "相机发布的图像在途中被拷贝";
+    EXPECT_EQ(after.releases - before.releases, after.acquires - before.acquires)
+        << "有缓冲区在传递途中被销毁（被拷贝或订阅队列溢出）";
+    EXPECT_EQ(BufferPool::global().outstanding(), 0u);
+}
+
+}  // namespace
+
+// 采集→检测→解算：真实相机节点锁步回放，检测节点归还的必须是相机从池中取出的原缓冲区
+TEST(ZeroCopyPipeline, CameraToSolver) {
+    runVideoPipeline({});
+}
+
+// 开启录制后仍零拷贝：录制节点不订阅 /image_raw，而是接收检测节点用完后转交的原消息
+TEST(ZeroCopyPipeline, CameraToSolverWithRecorder) {
+    TempDir log_dir("log");
+    auto recorder = std::make_shared<RecorderNode>(
+        rclcpp::NodeOptions()
+            .use_intra_process_comms(true)
+            .parameter_overrides({{"output_dir", log_dir.path().string()}}));
+
+    runVideoPipeline({recorder});
+
+    // 录制节点析构时关闭文件，之后统计录到的图像
+    recorder.reset();
+    EXPECT_EQ(countImageRecords(log_dir.path()), static_cast<size_t>(kFrames));
+}
+
+// 检测→解算：CompactArmors以unique_ptr发布，解算节点与探针拿到的是同一对象，且每帧都被解算
+TEST(ZeroCopyPipeline, DetectorToSolver) {
+    auto solver = std::make_shared<ArmorSolverNode>(solverOptions());
+    auto node = std::make_shared<rclcpp::Node>(
+        "test_detector", rclcpp::NodeOptions().use_intra_process_comms(true));
+    // 与ArmorDetectorNode相同的话题与QoS
+    auto armors_pub = node->create_publisher<rm_interfaces::msg::CompactArmors>(
+        "/detector/armors", rclcpp::SensorDataQoS());
+    AddressProbe<rm_interfaces::msg::CompactArmors> armors(*node, "/detector/armors");
+    AddressProbe<rm_interfaces::msg::Target> targets(*node, "/solver/target");
+
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(solver->get_node_base_interface());
+    executor.add_node(node);
+    ASSERT_EQ(solver->configure().id(), LifecycleState::PRIMARY_STATE_INACTIVE);
+    ASSERT_EQ(solver->activate().id(), LifecycleState::PRIMARY_STATE_ACTIVE);
+
+    // 解算节点与探针都在进程内订阅，发布不走序列化
+    EXPECT_EQ(armors_pub->get_subscription_count(), 2u);
+    EXPECT_EQ(armors_pub->get_intra_process_subscription_count(), 2u);
+
+    std::vector<const rm_interfaces::msg::CompactArmors*> published;
+    {
+        SpinThread spin(executor);
+        const int64_t base_ns = node->now().nanoseconds();
+        for (int i = 0; i < kFrames; i++) {
+            auto msg = std::make_unique<rm_interfaces::msg::CompactArmors>();
+            msg->stamp = rclcpp::Time(base_ns + i * 10000000LL);
+            msg->camera_id = 0;
+            msg->armors_num = 0;
+            published.push_back(msg.get());
+            armors_pub->publish(std::move(msg));
+            // 逐帧等解算确认，地址不会在比较前被复用
+            ASSERT_TRUE(waitUntil([&] { return targets.count() > static_cast<size_t>(i); },
+                                  std::chrono::seconds(2)))
+                << "第 " << i << " 帧未被解算";
+        }
+        EXPECT_TRUE(waitUntil([&] { return armors.count() >= static_cast<size_t>(kFrames); }, std::chrono::seconds(2)));
+    }
+    solver->deactivate();
+
+    EXPECT_EQ(armors.addresses(), published) << "检测→解算途中CompactArmors被拷贝";
+    EXPECT_EQ(targets.count(), static_cast<size_t>(kFrames));
+}
+
+// 解算→串口：GimbalCmd以unique_ptr发布，串口节点与探针拿到的是同一对象，且每条都写出到串口
+TEST(ZeroCopyPipeline, SolverToSerial) {
+    PseudoTerminal pty;
+    ASSERT_TRUE(pty.valid()) << "无法创建伪终端";
+
+    auto serial = std::make_shared<SerialDriverNode>(
+        rclcpp::NodeOptions()
+            .use_intra_process_comms(true)
+            .parameter_overrides({{"port_name", pty.slaveName()}}));
+    auto node = std::make_shared<rclcpp::Node>(
+        "test_solver", rclcpp::NodeOptions().use_intra_process_comms(true));
+    // 与ArmorSolverNode相同的话题与QoS
+    auto cmd_pub = node->create_publisher<rm_interfaces::msg::GimbalCmd>(
+        "/solver/gimbal_cmd", rclcpp::SensorDataQoS());
+    AddressProbe<rm_interfaces::msg::GimbalCmd> cmds(*node, "/solver/gimbal_cmd");
+
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(serial->get_node_base_interface());
+    executor.add_node(node);
+    ASSERT_EQ(serial->configure().id(), LifecycleState::PRIMARY_STATE_INACTIVE);
+    ASSERT_EQ(serial->activate().id(), LifecycleState::PRIMARY_STATE_ACTIVE);
+
+    EXPECT_EQ(cmd_pub->get_subscription_count(), 2u);
+    EXPECT_EQ(cmd_pub->get_intra_process_subscription_count(), 2u);
+
+    std::vector<const rm_interfaces::msg::GimbalCmd*> published;
+    {
+        SpinThread spin(executor);
+        for (int i = 0; i < kFrames; i++) {
+            auto msg = std::make_unique<rm_interfaces::msg::GimbalCmd>();
+            msg->header.stamp = node->now();
+            msg->yaw = 0.01 * i;
+            msg->pitch = -0.005 * i;
+            msg->fire = (i % 2) == 0;
+            const auto expected = packGimbalCmd(msg->yaw, msg->pitch, msg->fire);
+            published.push_back(msg.get());
+            cmd_pub->publish(std::move(msg));
+
+            // 逐条等串口写出，地址不会在比较前被复用
+            std::array<uint8_t, Packet16::SIZE> written{};
+            ASSERT_TRUE(pty.readExact(written.data(), written.size(), std::chrono::seconds(2)))
+                << "第 " << i << " 条命令未写出到串口";
+            EXPECT_EQ(written, expected.data) << "第 " << i << " 条命令";
+        }
+        EXPECT_TRUE(waitUntil([&] { return cmds.count() >= static_cast<size_t>(kFrames); }, std::chrono::seconds(2)));
+    }
+    serial->deactivate();
+
+    EXPECT_EQ(cmds.addresses(), published) << "解算→串口途中GimbalCmd被拷贝";
+}
+
+}  // namespace rm_auto_aim
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    rclcpp::init(argc, argv);
+    const int result = RUN_ALL_TESTS();
+    rclcpp::shutdown();
+    return result;
+}
@@ -0,0 +1,79 @@
+import os
+import yaml
+from ament_index_python.packages import get_package_prefix, get_package_share_directory
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, GroupAction
+from launch.substitutions import LaunchConfiguration, PythonExpression
+from launch_ros.actions import Node, PushRosNamespace
+from launch_ros.parameter_descriptions import ParameterValue
+
+
+def generate_launch_description():
+    """比赛模式：单进程快速通路流水线（替代bringup中的四节点容器）"""
+
+    # ===== 包路径 =====
+    bringup_dir = get_package_share_directory('rm_bringup')
+    params_dir = os.path.join(bringup_dir, 'config', 'node_params')
+    pipeline_params = os.path.join(params_dir, 'auto_aim_pipeline_params.yaml')
+    latency_params = os.path.join(params_dir, 'latency_monitor_params.yaml')
+    flight_recorder_params = os.path.join(params_dir, 'flight_recorder_params.yaml')
+    layout_params = os.path.join(params_dir, 'execution_layout.yaml')
+    rt_memory_params = os.path.join(params_dir, 'rt_memory_params.yaml')
+    task_pool_params = os.path.join(params_dir, 'task_pool_params.yaml')
+
+    # 实时内存模式默认值取自YAML，可由启动参数覆盖
+    with open(rt_memory_params, 'r') as f:
+        rt_memory_default = (yaml.safe_load(f) or {}).get('rt_memory', {}) \
+            .get('ros__parameters', {}).get('enable', False)
+
+    # ===== 启动参数 =====
+    namespace_arg = DeclareLaunchArgument(
+        'namespace', default_value='',
+        description='ROS2 namespace'
+    )
+
+    rt_memory_arg = DeclareLaunchArgument(
+        'rt_memory', default_value=str(rt_memory_default).lower(),
+        description='Lock and prefault process memory, use huge pages for frame buffers'
+    )
+    rt_memory_enabled = LaunchConfiguration('rt_memory')
+
+    # 分配计数：预加载malloc钩子，/diagnostics 中发布各阶段每帧堆分配次数（有少量开销，调试用）
+    alloc_tracking_arg = DeclareLaunchArgument(
+        'alloc_tracking', default_value='false',
+        description='Preload the allocation counting hooks and publish per-frame allocation metrics'
+    )
+    alloc_hooks_lib = os.path.join(get_package_prefix('rm_utils'), 'lib', 'librm_alloc_hooks.so')
+    alloc_preload = PythonExpression([
+        "'", alloc_hooks_lib, "' if '", LaunchConfiguration('alloc_tracking'), "' == 'true' else ''"])
+
+    # ===== 流水线进程 =====
+    pipeline_node = Node(
+        package='rm_auto_aim',
+        executable='auto_aim_pipeline',
+        name='auto_aim_pipeline',
+        parameters=[pipeline_params, latency_params, flight_recorder_params, layout_params,
+                    rt_memory_params, task_pool_params,
+                    {'enable': ParameterValue(rt_memory_enabled, value_type=bool)}],
+        additional_env={'GLIBC_TUNABLES': PythonExpression([
+            "'glibc.malloc.hugetlb=1' if '", rt_memory_enabled, "' == 'true' else ''"]),
+                        'LD_PRELOAD': alloc_preload},
+        # 相机打不开时进程以非零码退出，稍后重启重试
+        respawn=True,
+        respawn_delay=2.0,
+        output='screen',
+    )
+
+    auto_aim_group = GroupAction(
+        actions=[
+            PushRosNamespace(LaunchConfiguration('namespace')),
+            pipeline_node,
+        ]
+    )
+
+    return LaunchDescription([
+        namespace_arg,
+        rt_memory_arg,
+        alloc_tracking_arg,
+        auto_aim_group,
+    ])
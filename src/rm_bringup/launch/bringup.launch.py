@@ -1,18 +1,20 @@
 import os
-from ament_index_python.packages import get_package_share_directory
+import yaml
+from ament_index_python.packages import get_package_prefix, get_package_share_directory
 from launch import LaunchDescription
 from launch.actions import (
     DeclareLaunchArgument,
-    TimerAction,
     GroupAction,
 )
-from launch.substitutions import LaunchConfiguration
+from launch.conditions import IfCondition
+from launch.substitutions import LaunchConfiguration, PythonExpression
 from launch_ros.actions import (
     ComposableNodeContainer,
-    Node,
+    LoadComposableNodes,
     PushRosNamespace,
 )
 from launch_ros.descriptions import ComposableNode
+from launch_ros.parameter_descriptions import ParameterValue
 
 
 def generate_launch_description():
@@ -27,7 +29,21 @@ def generate_launch_description():
     detector_params = os.path.join(params_dir, 'armor_detector_params.yaml')
     solver_params = os.path.join(params_dir, 'armor_solver_params.yaml')
     camera_params = os.path.join(params_dir, 'camera_driver_params.yaml')
+    long_camera_params = os.path.join(params_dir, 'long_camera_driver_params.yaml')
+    multi_camera_params = os.path.join(params_dir, 'multi_camera_params.yaml')
     serial_params = os.path.join(params_dir, 'serial_driver_params.yaml')
+    latency_params = os.path.join(params_dir, 'latency_monitor_params.yaml')
+    flight_recorder_params = os.path.join(params_dir, 'flight_recorder_params.yaml')
+    recorder_params = os.path.join(params_dir, 'recorder_params.yaml')
+    layout_params = os.path.join(params_dir, 'execution_layout.yaml')
+    rt_memory_params = os.path.join(params_dir, 'rt_memory_params.yaml')
+    lifecycle_params = os.path.join(params_dir, 'lifecycle_manager_params.yaml')
+    task_pool_params = os.path.join(params_dir, 'task_pool_params.yaml')
+
+    # 实时内存模式默认值取自YAML，可由启动参数覆盖
+    with open(rt_memory_params, 'r') as f:
+        rt_memory_default = (yaml.safe_load(f) or {}).get('rt_memory', {}) \
+            .get('ros__parameters', {}).get('enable', False)
 
     # ===== 启动参数 =====
     namespace_arg = DeclareLaunchArgument(
@@ -38,6 +54,50 @@ def generate_launch_description():
         'debug', default_value='true',
         description='Enable debug mode'
     )
+    record_arg = DeclareLaunchArgument(
+        'record', default_value='false',
+        description='Record raw inputs to an .rmlog file'
+    )
+
+    rt_memory_arg = DeclareLaunchArgument(
+        'rt_memory', default_value=str(rt_memory_default).lower(),
+        description='Lock and prefault process memory, use huge pages for frame buffers'
+    )
+    rt_memory_enabled = LaunchConfiguration('rt_memory')
+
+    # 第二路相机：加载 long_camera_driver，检测/解算/生命周期管理叠加 multi_camera_params.yaml
+    second_camera_arg = DeclareLaunchArgument(
+        'second_camera', default_value='false',
+        description='Load a second camera driver and fuse both cameras into one tracker'
+    )
+
+    def multi_camera_overlay(base_params):
+        # 未启用时重复加载节点自身的参数文件（等价于不覆盖）
+        return PythonExpression([
+            "'", multi_camera_params, "' if '", LaunchConfiguration('second_camera'),
+            "' == 'true' else '", base_params, "'"])
+
+    # 分配计数：预加载malloc钩子，/diagnostics 中发布各阶段每帧堆分配次数（有少量开销，调试用）
+    alloc_tracking_arg = DeclareLaunchArgument(
+        'alloc_tracking', default_value='false',
+        description='Preload the allocation counting hooks and publish per-frame allocation metrics'
+    )
+    alloc_hooks_lib = os.path.join(get_package_prefix('rm_utils'), 'lib', 'librm_alloc_hooks.so')
+    alloc_preload = PythonExpression([
+        "'", alloc_hooks_lib, "' if '", LaunchConfiguration('alloc_tracking'), "' == 'true' else ''"])
+
+    # 所有组件开启进程内通信：unique_ptr发布的消息在节点间直接转移所有权
+    intra_process = [{'use_intra_process_comms': True}]
+
+    # ===== 执行布局 =====
+    # 容器线程池（调试/日志）的CPU由taskset前缀设置；关键线程在各节点内自行绑定
+    with open(layout_params, 'r') as f:
+        layout = yaml.safe_load(f) or {}
+    debug_cpus = (layout.get('auto_aim_container', {})
+                  .get('ros__parameters', {})
+                  .get('threads.debug.cpus', [-1]))
+    debug_cpus = [str(c) for c in debug_cpus if c >= 0 and c < os.cpu_count()]
+    container_prefix = 'taskset -c ' + ','.join(debug_cpus) if debug_cpus else None
 
     # ===== 核心节点容器 (组件化，共享进程，零拷贝通信) =====
     auto_aim_container = ComposableNodeContainer(
@@ -45,62 +105,134 @@ def generate_launch_description():
         namespace='',
         package='rclcpp_components',
         executable='component_container_mt',  # 多线程容器
+        prefix=container_prefix,
+        # 实时内存模式下malloc也使用透明大页（承载图像消息的帧缓冲区）；分配计数模式下预加载malloc钩子
+        additional_env={'GLIBC_TUNABLES': PythonExpression([
+            "'glibc.malloc.hugetlb=1' if '", rt_memory_enabled, "' == 'true' else ''"]),
+                        'LD_PRELOAD': alloc_preload},
         composable_node_descriptions=[
+            # 实时内存模式（须最先加载：在其他节点分配缓冲区、创建线程之前生效）
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::RtMemoryNode',
+                name='rt_memory',
+                parameters=[rt_memory_params,
+                            {'enable': ParameterValue(rt_memory_enabled, value_type=bool)}],
+            ),
+            # 进程级任务池（先于检测/解算加载，各模块的并行与后台任务都在这组线程上执行）
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::TaskPoolNode',
+                name='task_pool',
+                parameters=[task_pool_params, layout_params],
+            ),
+            # 生命周期管理：相机/检测/解算/串口为生命周期节点，就绪后按依赖逐级激活
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::LifecycleManagerNode',
+                name='lifecycle_manager',
+                parameters=[lifecycle_params, multi_camera_overlay(lifecycle_params)],
+            ),
             # 相机驱动
             ComposableNode(
                 package='rm_hardware_driver',
                 plugin='rm_auto_aim::CameraDriverNode',
                 name='camera_driver',
-                parameters=[camera_params],
+                parameters=[camera_params, layout_params],
+                extra_arguments=intra_process,
             ),
             # 装甲板检测器
             ComposableNode(
                 package='rm_auto_aim',
                 plugin='rm_auto_aim::ArmorDetectorNode',
                 name='armor_detector',
-                parameters=[detector_params],
+                parameters=[detector_params, layout_params,
+                            multi_camera_overlay(detector_params)],
+                extra_arguments=intra_process,
             ),
             # 装甲板解算器
             ComposableNode(
                 package='rm_auto_aim',
                 plugin='rm_auto_aim::ArmorSolverNode',
                 name='armor_solver',
-                parameters=[solver_params],
+                parameters=[solver_params, layout_params, multi_camera_overlay(solver_params)],
+                extra_arguments=intra_process,
+            ),
+            # 串口驱动（与解算节点同进程，云台命令不再经过DDS）
+            ComposableNode(
+                package='rm_hardware_driver',
+                plugin='rm_auto_aim::SerialDriverNode',
+                name='serial_driver',
+                parameters=[serial_params, layout_params],
+                extra_arguments=intra_process,
+            ),
+            # 端到端延迟监视（读取同进程内各节点的计时点）
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::LatencyMonitorNode',
+                name='latency_monitor',
+                parameters=[latency_params],
+            ),
+            # 飞行记录器（跟踪丢失/信号/服务触发转储最近几秒的热路径事件）
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::FlightRecorderNode',
+                name='flight_recorder',
+                parameters=[flight_recorder_params],
             ),
         ],
         output='screen',
     )
 
-    # ===== 串口驱动 (延迟1.5s启动) =====
-    serial_driver = TimerAction(
-        period=1.5,
-        actions=[
-            Node(
+    # ===== 原始输入录制（可选，须加载到同一容器：图像由检测节点用完后经进程内通信转交，不拷贝） =====
+    recorder_loader = LoadComposableNodes(
+        target_container='auto_aim_container',
+        composable_node_descriptions=[
+            ComposableNode(
+                package='rm_recorder',
+                plugin='rm_auto_aim::RecorderNode',
+                name='recorder',
+                parameters=[recorder_params],
+                extra_arguments=intra_process,
+            ),
+        ],
+        condition=IfCondition(LaunchConfiguration('record')),
+    )
+
+    # ===== 第二路相机（可选，加载到同一容器，话题重映射到 /long_camera/ 下） =====
+    long_camera_loader = LoadComposableNodes(
+        target_container='auto_aim_container',
+        composable_node_descriptions=[
+            ComposableNode(
                 package='rm_hardware_driver',
-                executable='serial_driver_node',
-                name='serial_driver',
-                parameters=[serial_params],
-                output='screen',
+                plugin='rm_auto_aim::CameraDriverNode',
+                name='long_camera_driver',
+                parameters=[long_camera_params, layout_params],
+                remappings=[('/image_raw', '/long_camera/image_raw'),
+                            ('/camera_info', '/long_camera/camera_info')],
+                extra_arguments=intra_process,
             ),
         ],
+        condition=IfCondition(LaunchConfiguration('second_camera')),
     )
 
     # ===== 组合启动 =====
+    # 不使用固定延时：各节点由lifecycle_manager按就绪情况激活；LoadComposableNodes自行等待容器服务
     auto_aim_group = GroupAction(
         actions=[
             PushRosNamespace(LaunchConfiguration('namespace')),
-            # 先启动核心容器
-            TimerAction(
-                period=0.5,
-                actions=[auto_aim_container],
-            ),
-            # 延迟启动串口
-            serial_driver,
+            auto_aim_container,
+            recorder_loader,
+            long_camera_loader,
         ]
     )
 
     return LaunchDescription([
         namespace_arg,
         debug_arg,
+        record_arg,
+        rt_memory_arg,
+        alloc_tracking_arg,
+        second_camera_arg,
         auto_aim_group,
     ])
@@ -0,0 +1,123 @@
+import os
+from ament_index_python.packages import get_package_share_directory
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, EmitEvent, OpaqueFunction, RegisterEventHandler
+from launch.event_handlers import OnProcessExit
+from launch.events import Shutdown
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+
+def _containers(context):
+    """按部署方式组织 负载发生器 + 检测 + 解算"""
+
+    bringup_dir = get_package_share_directory('rm_bringup')
+    params_dir = os.path.join(bringup_dir, 'config', 'node_params')
+    detector_params = os.path.join(params_dir, 'armor_detector_params.yaml')
+    solver_params = os.path.join(params_dir, 'armor_solver_params.yaml')
+    generator_params = os.path.join(params_dir, 'load_generator_params.yaml')
+    lifecycle_params = os.path.join(params_dir, 'replay_lifecycle_manager_params.yaml')
+    task_pool_params = os.path.join(params_dir, 'task_pool_params.yaml')
+
+    mode = LaunchConfiguration('mode').perform(context)
+    if mode not in ('process', 'container', 'intra_process'):
+        raise RuntimeError("mode must be one of: process, container, intra_process")
+    intra_process = [{'use_intra_process_comms': mode == 'intra_process'}]
+
+    generator_overrides = {'config_label': mode}
+    for key in ('width', 'height', 'clutter'):
+        value = LaunchConfiguration(key).perform(context)
+        if value:
+            generator_overrides[key] = int(value)
+
+    task_pool = ComposableNode(
+        package='rm_auto_aim',
+        plugin='rm_auto_aim::TaskPoolNode',
+        name='task_pool',
+        parameters=[task_pool_params],
+    )
+    lifecycle_manager = ComposableNode(
+        package='rm_auto_aim',
+        plugin='rm_auto_aim::LifecycleManagerNode',
+        name='lifecycle_manager',
+        parameters=[lifecycle_params],
+    )
+    generator = ComposableNode(
+        package='rm_auto_aim',
+        plugin='rm_auto_aim::LoadGeneratorNode',
+        name='load_generator',
+        parameters=[generator_params, generator_overrides],
+        extra_arguments=intra_process,
+    )
+    detector = ComposableNode(
+        package='rm_auto_aim',
+        plugin='rm_auto_aim::ArmorDetectorNode',
+        name='armor_detector',
+        parameters=[detector_params],
+        extra_arguments=intra_process,
+    )
+    solver = ComposableNode(
+        package='rm_auto_aim',
+        plugin='rm_auto_aim::ArmorSolverNode',
+        name='armor_solver',
+        parameters=[solver_params],
+        extra_arguments=intra_process,
+    )
+
+    def container(name, nodes):
+        return ComposableNodeContainer(
+            name=name,
+            namespace='',
+            package='rclcpp_components',
+            executable='component_container_mt',
+            composable_node_descriptions=nodes,
+            output='screen',
+        )
+
+    if mode == 'process':
+        # 独立进程：发生器/检测/解算各一个容器，消息经DDS序列化传递
+        generator_container = container('load_generator_container', [generator])
+        others = [
+            container('detector_container', [task_pool, lifecycle_manager, detector]),
+            container('solver_container', [solver]),
+        ]
+    else:
+        # 同一容器：container 关闭进程内通信（仍走中间件），intra_process 直接转移所有权
+        generator_container = container(
+            'load_test_container', [task_pool, lifecycle_manager, generator, detector, solver])
+        others = []
+
+    # 发生器测完后退出所在进程，随即结束整个测试
+    shutdown_on_finish = RegisterEventHandler(OnProcessExit(
+        target_action=generator_container, on_exit=[EmitEvent(event=Shutdown())]))
+    return [generator_container, *others, shutdown_on_finish]
+
+
+def generate_launch_description():
+    """吞吐上限测试：合成负载逐级提升帧率，报告各部署方式下可持续的帧率"""
+
+    mode_arg = DeclareLaunchArgument(
+        'mode', default_value='intra_process',
+        description='Deployment under test: process | container | intra_process'
+    )
+    width_arg = DeclareLaunchArgument(
+        'width', default_value='',
+        description='Synthetic frame width (empty: from load_generator_params.yaml)'
+    )
+    height_arg = DeclareLaunchArgument(
+        'height', default_value='',
+        description='Synthetic frame height (empty: from load_generator_params.yaml)'
+    )
+    clutter_arg = DeclareLaunchArgument(
+        'clutter', default_value='',
+        description='Number of distractor objects per frame (empty: from load_generator_params.yaml)'
+    )
+
+    return LaunchDescription([
+        mode_arg,
+        width_arg,
+        height_arg,
+        clutter_arg,
+        OpaqueFunction(function=_containers),
+    ])
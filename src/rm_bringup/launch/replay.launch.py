@@ -0,0 +1,100 @@
+import os
+from ament_index_python.packages import get_package_share_directory
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, GroupAction
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer, PushRosNamespace
+from launch_ros.descriptions import ComposableNode
+
+
+def generate_launch_description():
+    """回放模式：用录制的 .rmlog 代替相机和串口驱动，驱动检测与解算"""
+
+    # ===== 包路径 =====
+    bringup_dir = get_package_share_directory('rm_bringup')
+    params_dir = os.path.join(bringup_dir, 'config', 'node_params')
+
+    # ===== 参数文件路径 =====
+    detector_params = os.path.join(params_dir, 'armor_detector_params.yaml')
+    solver_params = os.path.join(params_dir, 'armor_solver_params.yaml')
+    replay_params = os.path.join(params_dir, 'replay_params.yaml')
+    lifecycle_params = os.path.join(params_dir, 'replay_lifecycle_manager_params.yaml')
+    task_pool_params = os.path.join(params_dir, 'task_pool_params.yaml')
+
+    # ===== 启动参数 =====
+    namespace_arg = DeclareLaunchArgument(
+        'namespace', default_value='',
+        description='ROS2 namespace'
+    )
+    log_path_arg = DeclareLaunchArgument(
+        'log_path', description='Path of the .rmlog file to replay'
+    )
+    rate_arg = DeclareLaunchArgument(
+        'rate', default_value='1.0',
+        description='Replay speed (<=0: as fast as possible)'
+    )
+
+    intra_process = [{'use_intra_process_comms': True}]
+
+    # ===== 回放容器 =====
+    replay_container = ComposableNodeContainer(
+        name='auto_aim_replay_container',
+        namespace='',
+        package='rclcpp_components',
+        executable='component_container_mt',
+        composable_node_descriptions=[
+            # 进程级任务池（先于检测/解算加载）
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::TaskPoolNode',
+                name='task_pool',
+                parameters=[task_pool_params],
+            ),
+            # 检测/解算为生命周期节点，由管理节点配置并激活
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::LifecycleManagerNode',
+                name='lifecycle_manager',
+                parameters=[lifecycle_params],
+            ),
+            ComposableNode(
+                package='rm_recorder',
+                plugin='rm_auto_aim::ReplayNode',
+                name='replay',
+                parameters=[replay_params, {
+                    'log_path': LaunchConfiguration('log_path'),
+                    'rate': LaunchConfiguration('rate'),
+                }],
+                extra_arguments=intra_process,
+            ),
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::ArmorDetectorNode',
+                name='armor_detector',
+                parameters=[detector_params],
+                extra_arguments=intra_process,
+            ),
+            ComposableNode(
+                package='rm_auto_aim',
+                plugin='rm_auto_aim::ArmorSolverNode',
+                name='armor_solver',
+                parameters=[solver_params],
+                extra_arguments=intra_process,
+            ),
+        ],
+        output='screen',
+    )
+
+    replay_group = GroupAction(
+        actions=[
+            PushRosNamespace(LaunchConfiguration('namespace')),
+            replay_container,
+        ]
+    )
+
+    return LaunchDescription([
+        namespace_arg,
+        log_path_arg,
+        rate_arg,
+        replay_group,
+    ])
@@ -1,13 +1,22 @@
 #pragma once
 
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
 #include <sensor_msgs/msg/image.hpp>
-#include <image_transport/image_transport.hpp>
+#include <std_msgs/msg/float64.hpp>
 #include <opencv2/videoio.hpp>
 
+#include "rm_interfaces/msg/target.hpp"
+#include "rm_hardware_driver/mjpeg_decoder.hpp"
+#include "rm_hardware_driver/v4l2_capture.hpp"
+#include "rm_utils/spsc_queue.hpp"
+#include "rm_utils/thread_placement.hpp"
+
 #include <thread>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace rm_auto_aim {
 
@@ -15,34 +24,148 @@ namespace rm_auto_aim {
  * @brief 通用相机驱动节点
  *
  * 支持:
- * - USB相机 (V4L2)
- * - 视频文件输入 (用于调试)
+ * - USB相机 (OpenCV VideoCapture 或原生V4L2 mmap流式采集)
+ * - V4L2 MJPG: 多线程libjpeg-turbo解码（可缩放/ROI），按采集顺序发布
+ * - 视频文件输入 (用于调试)；锁步模式下逐帧等待下游确认、播完即停，用于批量评估
  *
  * 工业相机(HIK/Dahua)需另外集成对应SDK。
  * 本节点提供基础的OpenCV VideoCapture驱动。
+ *
+ * 生命周期: configure 打开设备、预分配缓冲区并发布相机内参（失败则保持未配置，
+ * 由管理节点重试），activate 启动采集/解码线程，deactivate 停止采集，cleanup 关闭设备。
  */
-class CameraDriverNode : public rclcpp::Node {
+class CameraDriverNode : public rclcpp_lifecycle::LifecycleNode {
 public:
+    using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+
     explicit CameraDriverNode(const rclcpp::NodeOptions& options);
     ~CameraDriverNode() override;
 
+    CallbackReturn on_configure(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_activate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_deactivate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_cleanup(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_shutdown(const rclcpp_lifecycle::State& state) override;
+
 private:
     /**
-     * @brief 相机采集线程
+     * @brief 停止采集/解码/发布线程
+     */
+    void stopThreads();
+
+    /**
+     * @brief 关闭设备，释放解码器、队列与发布器
+     */
+    void releaseDevice();
+
+    /**
+     * @brief 打开相机/视频文件（OpenCV VideoCapture）
+     */
+    bool openVideoCapture();
+
+    /**
+     * @brief 打开相机（原生V4L2后端）
+     */
+    bool openV4l2();
+
+    /**
+     * @brief 相机采集线程（按后端分派）
      */
     void captureLoop();
+    void captureLoopVideoCapture();
+    void captureLoopV4l2();
+
+    /**
+     * @brief 视频文件锁步发布：发布一帧后等待下游确认再发布下一帧
+     */
+    void captureLoopLockstep();
+
+    /**
+     * @brief 视频文件预解码线程（锁步模式），队满时阻塞而非丢帧
+     */
+    void prefetchLoop();
+
+    /**
+     * @brief 下游确认回调（解算节点每帧输出一条Target，按时间戳匹配）
+     */
+    void ackCallback(const rm_interfaces::msg::Target::ConstSharedPtr& msg);
+
+    // MJPG解码任务：驱动缓冲区随任务转移到解码线程，解码完归还驱动
+    struct DecodeJob {
+        V4l2Buffer buffer;
+        int64_t stamp_ns = 0;
+    };
+    struct DecodedFrame {
+        sensor_msgs::msg::Image::UniquePtr msg;  // 解码失败时为空
+        int64_t stamp_ns = 0;
+    };
+    struct DecodeWorker {
+        std::unique_ptr<MjpegDecoder> decoder;
+        std::unique_ptr<SpscQueue<DecodeJob>> jobs;          // 采集 → 解码
+        std::unique_ptr<SpscQueue<DecodedFrame>> results;    // 解码 → 发布
+        std::thread thread;
+    };
+
+    /**
+     * @brief 按参数创建MJPG解码器/解码线程，并修正输出分辨率和相机内参
+     */
+    void setupMjpegDecoding();
+    void applyRoiToCameraInfo(int roi_x, int roi_y, int scale_denom);
+
+    // 解码线程与按序发布线程
+    void decodeLoop(DecodeWorker* worker);
+    void publishLoop();
+
+    /**
+     * @brief 对当前线程应用放置配置并记录结果
+     */
+    void placeCurrentThread(ThreadPlacement placement, const std::string& name);
+
+    /**
+     * @brief 解码/转换一帧到池化图像消息
+     * @param decoder MJPG解码器，为空时按YUYV转换
+     * @return 失败返回空
+     */
+    sensor_msgs::msg::Image::UniquePtr decodeFrame(
+        const V4l2Buffer& buffer, MjpegDecoder* decoder);
+
+    void publishFrame(sensor_msgs::msg::Image::UniquePtr img_msg, int64_t stamp_ns);
 
     /**
      * @brief 加载相机内参（从YAML参数）
      */
     void loadCameraInfo();
 
+    /**
+     * @brief 发布（锁存）相机内参，仅在打开相机和分辨率变化时调用
+     */
+    void publishCameraInfo();
+
+    /**
+     * @brief 记录并发布采集→发布延迟
+     */
+    void recordLatency(int64_t latency_ns);
+
+    // 锁步模式预解码帧
+    struct PrefetchedFrame {
+        sensor_msgs::msg::Image::UniquePtr msg;
+        uint64_t index = 0;
+    };
+
+    // 当前分辨率下一帧BGR图像的字节数
+    size_t frameBytes() const;
+
     // 相机参数
     int camera_id_;
     std::string video_path_;
     int frame_width_;
     int frame_height_;
     int fps_;
+    std::string frame_id_;
+
+    // 时间戳
+    bool use_driver_timestamp_ = true;
+    int64_t timestamp_offset_ns_ = 0;
 
     // 相机内参
     std::vector<double> camera_matrix_;
@@ -52,13 +175,53 @@ private:
     // OpenCV相机
     cv::VideoCapture cap_;
 
+    // 原生V4L2后端
+    std::string backend_;
+    V4l2Capture v4l2_;
+    bool v4l2_grab_newest_ = true;
+
+    // MJPG解码
+    std::unique_ptr<MjpegDecoder> inline_decoder_;
+    std::vector<std::unique_ptr<DecodeWorker>> decode_workers_;
+    std::thread publish_thread_;
+    uint64_t decode_drops_ = 0;
+
     // 采集线程
     std::atomic<bool> running_{false};
     std::thread capture_thread_;
 
-    // ROS发布器
-    image_transport::CameraPublisher camera_pub_;
+    // 线程放置：采集/按序发布线程用capture，解码/预解码线程用decode
+    ThreadPlacement capture_placement_;
+    ThreadPlacement decode_placement_;
+
+    // 视频文件锁步模式
+    bool lockstep_ = false;
+    bool deterministic_stamps_ = true;
+    bool shutdown_on_eof_ = false;
+    int lockstep_timeout_ms_ = 1000;
+    double video_fps_ = 0.0;  // 视频文件自身帧率（用于确定性时间戳）
+    int64_t lockstep_stamp_base_ns_ = 0;  // 确定性时间戳的起点（激活时刻）
+    bool since_capture_disabled_ = false;  // 本节点关闭了延迟追踪的sinceCapture
+    std::unique_ptr<SpscQueue<PrefetchedFrame>> prefetch_queue_;
+    std::thread prefetch_thread_;
+    std::atomic<bool> prefetch_done_{false};  // 预解码线程读到文件末尾
+    std::mutex ack_mutex_;
+    std::condition_variable ack_cv_;
+    int64_t pending_stamp_ns_ = -1;  // 等待确认的帧时间戳
+    bool acked_ = false;
+    rclcpp::Subscription<rm_interfaces::msg::Target>::SharedPtr ack_sub_;
+
+    // ROS发布器（图像以unique_ptr发布，进程内通信时零拷贝传递给检测节点，
+    // 数据缓冲区由BufferPool循环复用；相机内参为锁存话题）
+    rclcpp_lifecycle::LifecyclePublisher<sensor_msgs::msg::Image>::SharedPtr image_pub_;
+    rclcpp::Publisher<sensor_msgs::msg::CameraInfo>::SharedPtr camera_info_pub_;
     sensor_msgs::msg::CameraInfo camera_info_msg_;
+
+    // 采集延迟
+    rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::Float64>::SharedPtr latency_pub_;
+    double latency_sum_ms_ = 0.0;
+    double latency_max_ms_ = 0.0;
+    uint64_t latency_count_ = 0;
 };
 
 }  // namespace rm_auto_aim
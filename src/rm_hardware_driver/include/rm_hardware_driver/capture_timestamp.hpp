@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <opencv2/videoio.hpp>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 采集时间戳换算
+ *
+ * V4L2后端下 VideoCapture::get(CAP_PROP_POS_MSEC) 返回驱动填写的缓冲区时间戳
+ * （CLOCK_MONOTONIC，帧数据写入完成时刻），不含解码耗时和调度抖动。
+ * 这里将其换算到ROS时间；驱动不提供时间戳或时间戳不可信时，
+ * 退化为“读取返回时刻 - 固定偏移”（视频文件也使用该方式）。
+ */
+struct CaptureStamp {
+    int64_t stamp_ns = 0;        // ROS时间
+    bool from_driver = false;    // 是否来自驱动缓冲区时间戳
+};
+
+// 单调时钟当前时间（与V4L2缓冲区时间戳同源）
+inline int64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 单调时钟时间戳换算为ROS时间
+ * @param mono_ns 单调时钟时间戳
+ * @param ros_now_ns 当前ROS时间
+ * @param mono_now_ns 与ros_now_ns同一时刻采样的单调时钟
+ */
+inline int64_t monotonicToRosNs(int64_t mono_ns, int64_t ros_now_ns, int64_t mono_now_ns) {
+    return ros_now_ns - (mono_now_ns - mono_ns);
+}
+
+/**
+ * @brief 计算刚读出的一帧的采集时间戳（须在read()返回后立即调用）
+ * @param cap 已读出本帧的VideoCapture
+ * @param use_driver_stamp 是否尝试使用驱动时间戳（视频文件应为false）
+ * @param fallback_offset_ns 退化时从读取返回时刻减去的固定偏移
+ * @param ros_now_ns 当前ROS时间
+ */
+inline CaptureStamp captureStamp(
+    const cv::VideoCapture& cap, bool use_driver_stamp,
+    int64_t fallback_offset_ns, int64_t ros_now_ns)
+{
+    // 驱动时间戳与当前时刻相差超过该值视为不可信（驱动未填写/时钟源不同）
+    constexpr int64_t MAX_DRIVER_AGE_NS = 1'000'000'000;
+
+    const int64_t mono_now_ns = monotonicNowNs();
+    CaptureStamp result;
+
+    if (use_driver_stamp) {
+        double pos_msec = cap.get(cv::CAP_PROP_POS_MSEC);
+        auto driver_ns = static_cast<int64_t>(pos_msec * 1e6);
+        int64_t age_ns = mono_now_ns - driver_ns;
+        if (pos_msec > 0 && age_ns >= 0 && age_ns < MAX_DRIVER_AGE_NS) {
+            result.stamp_ns = monotonicToRosNs(driver_ns, ros_now_ns, mono_now_ns);
+            result.from_driver = true;
+            return result;
+        }
+    }
+
+    result.stamp_ns = ros_now_ns - fallback_offset_ns;
+    return result;
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief MJPG解码参数
+ *
+ * ROI以原始分辨率像素坐标给出（宽/高为0表示整幅），
+ * 输出图像为ROI按1/scale_denom缩放后的结果。
+ */
+struct MjpegDecodeOptions {
+    int scale_denom = 1;  // 1/2/4/8，由libjpeg在DCT阶段缩放，比解码后再缩放省时
+    int roi_x = 0;
+    int roi_y = 0;
+    int roi_width = 0;
+    int roi_height = 0;
+};
+
+/**
+ * @brief 基于libjpeg-turbo的MJPG解码器（BGR输出，不依赖ROS/OpenCV）
+ *
+ * 每个解码线程持有一个实例（内部解码上下文不可并发使用）。
+ * ROI解码通过jpeg_crop_scanline/jpeg_skip_scanlines跳过ROI外的行列，
+ * ROI外的部分不做IDCT。
+ */
+class MjpegDecoder {
+public:
+    /**
+     * @param src_width/src_height 相机原始分辨率
+     * @param options 缩放/ROI参数（越界时裁剪到图像内）
+     */
+    MjpegDecoder(int src_width, int src_height, const MjpegDecodeOptions& options);
+    ~MjpegDecoder();
+
+    MjpegDecoder(const MjpegDecoder&) = delete;
+    MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+
+    // 输出图像尺寸
+    int outputWidth() const { return out_width_; }
+    int outputHeight() const { return out_height_; }
+
+    // 原始分辨率下实际使用的ROI（用于修正相机内参）
+    int roiX() const { return roi_x_; }
+    int roiY() const { return roi_y_; }
+    int scaleDenom() const { return scale_denom_; }
+
+    /**
+     * @brief 解码一帧到BGR缓冲区
+     * @param jpeg 压缩数据
+     * @param size 压缩数据字节数
+     * @param dst 输出缓冲区（outputHeight() 行，每行 dst_step 字节）
+     * @param dst_step 输出行跨度
+     * @return 数据损坏或尺寸与配置不符时返回false
+     */
+    bool decode(const uint8_t* jpeg, size_t size, uint8_t* dst, size_t dst_step);
+
+private:
+    struct Context;
+
+    int src_width_;
+    int src_height_;
+    int scale_denom_;
+    int roi_x_;
+    int roi_y_;
+    int out_width_;
+    int out_height_;
+
+    std::unique_ptr<Context> ctx_;
+    std::vector<uint8_t> row_buffer_;  // ROI水平裁剪时的行缓冲
+};
+
+}  // namespace rm_auto_aim
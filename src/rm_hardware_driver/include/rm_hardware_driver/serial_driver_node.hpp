@@ -1,14 +1,17 @@
 #pragma once
 
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
 #include <thread>
 #include <atomic>
 #include <string>
 #include <mutex>
 
 #include "rm_hardware_driver/fixed_packet.hpp"
+#include "rm_hardware_driver/serial_port.hpp"
 #include "rm_interfaces/msg/gimbal_cmd.hpp"
 #include "rm_interfaces/msg/serial_receive_data.hpp"
+#include "rm_utils/thread_placement.hpp"
 
 namespace rm_auto_aim {
 
@@ -20,13 +23,29 @@ namespace rm_auto_aim {
  * 2. 从下位机接收数据，发布 SerialReceiveData 消息
  *
  * 协议: 固定长度包, Infantry协议
+ *
+ * 生命周期: configure 打开串口（失败则保持未配置，由管理节点重试），
+ * activate 启动收发线程，deactivate 停止收发，cleanup 关闭串口。
  */
-class SerialDriverNode : public rclcpp::Node {
+class SerialDriverNode : public rclcpp_lifecycle::LifecycleNode {
 public:
+    using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+
     explicit SerialDriverNode(const rclcpp::NodeOptions& options);
     ~SerialDriverNode() override;
 
+    CallbackReturn on_configure(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_activate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_deactivate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_cleanup(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_shutdown(const rclcpp_lifecycle::State& state) override;
+
 private:
+    /**
+     * @brief 停止收发线程
+     */
+    void stopThreads();
+
     /**
      * @brief 打开串口
      */
@@ -38,9 +57,14 @@ private:
     void closePort();
 
     /**
-     * @brief 发送线程
+     * @brief 发送线程：按绝对时间点以固定频率发送最新命令
      */
-    void sendThread();
+    void sendLoop();
+
+    /**
+     * @brief 发送一次最新命令（无新命令时跳过）
+     */
+    void sendPending();
 
     /**
      * @brief 接收线程
@@ -53,35 +77,42 @@ private:
     void gimbalCmdCallback(const rm_interfaces::msg::GimbalCmd::ConstSharedPtr& msg);
 
     /**
-     * @brief 打包云台控制数据
+     * @brief 解包接收数据
      */
-    Packet16 packGimbalCmd(double yaw, double pitch, bool fire);
+    void unpackReceiveData(const Packet16& packet);
 
     /**
-     * @brief 解包接收数据
+     * @brief 对当前线程应用放置配置并记录结果
      */
-    void unpackReceiveData(const Packet16& packet);
+    void placeCurrentThread(ThreadPlacement placement, const std::string& name);
 
     // 串口参数
     std::string port_name_;
     int baud_rate_;
-    int fd_ = -1;  // 串口文件描述符
+    SerialPort port_;
 
-    // 线程控制
+    // 线程控制（running_: 收发线程运行中，仅激活状态下为true）
     std::atomic<bool> running_{false};
     std::thread receive_thread_;
+    std::thread send_thread_;
+    int send_rate_hz_ = 1000;
+
+    // 收发线程的CPU亲和性与实时优先级
+    ThreadPlacement tx_placement_;
+    ThreadPlacement rx_placement_;
 
     // 最新的发送数据（线程安全）
     std::mutex send_mutex_;
     Packet16 send_packet_;
+    int64_t send_stamp_ns_ = 0;  // 待发送命令对应的帧时间戳（延迟追踪）
+    double send_yaw_ = 0.0;      // 待发送命令原值（飞行记录器）
+    double send_pitch_ = 0.0;
+    bool send_fire_ = false;
     bool has_new_data_ = false;
 
     // ROS接口
     rclcpp::Subscription<rm_interfaces::msg::GimbalCmd>::SharedPtr gimbal_cmd_sub_;
-    rclcpp::Publisher<rm_interfaces::msg::SerialReceiveData>::SharedPtr receive_pub_;
-
-    // 定时发送
-    rclcpp::TimerBase::SharedPtr send_timer_;
+    rclcpp_lifecycle::LifecyclePublisher<rm_interfaces::msg::SerialReceiveData>::SharedPtr receive_pub_;
 };
 
 }  // namespace rm_auto_aim
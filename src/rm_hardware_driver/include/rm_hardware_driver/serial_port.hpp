@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief Linux串口封装
+ *
+ * 只负责打开/配置(8N1, 原始模式)/读写/关闭，不依赖ROS，
+ * 供串口驱动节点和融合流水线共用。
+ */
+class SerialPort {
+public:
+    SerialPort() = default;
+    ~SerialPort();
+
+    SerialPort(const SerialPort&) = delete;
+    SerialPort& operator=(const SerialPort&) = delete;
+
+    /**
+     * @brief 打开并配置串口
+     * @param port_name 设备路径
+     * @param baud_rate 波特率
+     * @param error [out] 失败原因（可为空）
+     * @return 是否成功
+     */
+    bool open(const std::string& port_name, int baud_rate, std::string* error = nullptr);
+
+    /**
+     * @brief 关闭串口
+     */
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    /**
+     * @brief 写入数据（非阻塞）
+     * @return 实际写入字节数，失败返回-1
+     */
+    ssize_t write(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 读取数据（VTIME=100ms超时）
+     * @return 实际读取字节数，失败返回-1
+     */
+    ssize_t read(uint8_t* data, size_t size);
+
+private:
+    int fd_ = -1;  // 串口文件描述符
+};
+
+}  // namespace rm_auto_aim
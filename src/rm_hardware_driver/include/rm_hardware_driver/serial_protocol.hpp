@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "rm_hardware_driver/fixed_packet.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 打包云台控制数据
+ *
+ * 打包: [header][yaw_h][yaw_l][pitch_h][pitch_l][fire]...[checksum][tail]
+ * yaw/pitch 转为角度后放大100倍以int16传输。
+ */
+inline Packet16 packGimbalCmd(double yaw, double pitch, bool fire) {
+    Packet16 packet;
+
+    auto yaw_int = static_cast<int16_t>(yaw * 180.0 / M_PI * 100);
+    auto pitch_int = static_cast<int16_t>(pitch * 180.0 / M_PI * 100);
+    uint8_t fire_byte = fire ? 1 : 0;
+
+    packet.load<int16_t>(1, yaw_int);
+    packet.load<int16_t>(3, pitch_int);
+    packet.load<uint8_t>(5, fire_byte);
+    packet.setChecksum();
+
+    return packet;
+}
+
+}  // namespace rm_auto_aim
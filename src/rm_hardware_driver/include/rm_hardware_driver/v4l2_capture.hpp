@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rm_auto_aim {
+
+class V4l2Capture;
+
+/**
+ * @brief 已出队的V4L2缓冲区（只读视图，移动语义）
+ *
+ * 直接指向驱动mmap内存，不做拷贝；析构或release()时重新入队。
+ * 持有期间驱动少一个可用缓冲区，处理完应尽快释放。
+ * 所有缓冲区必须在V4l2Capture::close()之前释放。
+ */
+class V4l2Buffer {
+public:
+    V4l2Buffer() = default;
+    ~V4l2Buffer() { release(); }
+
+    V4l2Buffer(const V4l2Buffer&) = delete;
+    V4l2Buffer& operator=(const V4l2Buffer&) = delete;
+    V4l2Buffer(V4l2Buffer&& other) noexcept { *this = std::move(other); }
+    V4l2Buffer& operator=(V4l2Buffer&& other) noexcept;
+
+    /**
+     * @brief 重新入队（归还驱动）
+     */
+    void release();
+
+    bool valid() const { return owner_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t bytes() const { return bytes_; }
+    // 驱动时间戳（CLOCK_MONOTONIC, ns），驱动未提供单调时间戳时为0
+    int64_t stampNs() const { return stamp_ns_; }
+    // 驱动帧序号（可用于检测驱动层丢帧）
+    uint32_t sequence() const { return sequence_; }
+
+private:
+    friend class V4l2Capture;
+
+    V4l2Capture* owner_ = nullptr;
+    uint32_t index_ = 0;
+    const uint8_t* data_ = nullptr;
+    size_t bytes_ = 0;
+    int64_t stamp_ns_ = 0;
+    uint32_t sequence_ = 0;
+};
+
+/**
+ * @brief 原生V4L2 mmap流式采集
+ *
+ * VIDIOC_REQBUFS申请queue_depth个mmap缓冲区并全部入队，
+ * 之后每帧 DQBUF → 下游直接读取驱动内存 → QBUF。
+ * grab_newest模式下一次出队时清空已就绪的旧帧，只返回最新一帧，
+ * 保证不处理过期图像。不依赖ROS/OpenCV，可用vivid虚拟设备验证。
+ */
+class V4l2Capture {
+public:
+    V4l2Capture() = default;
+    ~V4l2Capture();
+
+    V4l2Capture(const V4l2Capture&) = delete;
+    V4l2Capture& operator=(const V4l2Capture&) = delete;
+
+    /**
+     * @brief 打开设备、协商格式、申请缓冲区并开始采集
+     * @param device 设备路径，如 /dev/video0
+     * @param width/height 期望分辨率（以驱动协商结果为准）
+     * @param fourcc 像素格式（MJPG/YUYV...）
+     * @param fps 期望帧率（驱动不支持时忽略）
+     * @param queue_depth 驱动缓冲区数量
+     * @param error [out] 失败原因（可为空）
+     */
+    bool open(
+        const std::string& device, uint32_t width, uint32_t height, uint32_t fourcc,
+        int fps, int queue_depth, std::string* error = nullptr);
+
+    /**
+     * @brief 停止采集并释放缓冲区
+     */
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    /**
+     * @brief 出队一帧
+     * @param out [out] 出队的缓冲区（原先持有的缓冲区先被释放）
+     * @param timeout_ms 等待超时
+     * @param grab_newest 丢弃已就绪的旧帧，只返回最新一帧
+     * @return 超时或出错返回false
+     */
+    bool dequeue(V4l2Buffer& out, int timeout_ms, bool grab_newest);
+
+    // 协商后的实际格式
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    uint32_t fourcc() const { return fourcc_; }
+    uint32_t bytesPerLine() const { return bytes_per_line_; }
+    size_t queueDepth() const { return buffers_.size(); }
+
+    // grab_newest模式下丢弃的旧帧数
+    uint64_t skippedFrames() const { return skipped_frames_; }
+
+    /**
+     * @brief "MJPG"/"YUYV"等字符串转为fourcc
+     */
+    static uint32_t fourccFromString(const std::string& name);
+
+private:
+    friend class V4l2Buffer;
+
+    struct MappedBuffer {
+        void* start = nullptr;
+        size_t length = 0;
+    };
+
+    bool requeue(uint32_t index);
+
+    int fd_ = -1;
+    std::vector<MappedBuffer> buffers_;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t fourcc_ = 0;
+    uint32_t bytes_per_line_ = 0;
+    bool streaming_ = false;
+    uint64_t skipped_frames_ = 0;
+};
+
+}  // namespace rm_auto_aim
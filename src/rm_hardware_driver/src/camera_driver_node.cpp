@@ -1,21 +1,60 @@
 #include "rm_hardware_driver/camera_driver_node.hpp"
 
-#include <cv_bridge/cv_bridge.h>
+#include <algorithm>
+#include <cstring>
 #include <opencv2/imgproc.hpp>
 
+#include "rm_hardware_driver/capture_timestamp.hpp"
+#include "rm_hardware_driver/mjpeg_decoder.hpp"
+#include "rm_utils/alloc_tracker.hpp"
+#include "rm_utils/buffer_pool.hpp"
+#include "rm_utils/latency_tracer.hpp"
+
 namespace rm_auto_aim {
 
 CameraDriverNode::CameraDriverNode(const rclcpp::NodeOptions& options)
-    : Node("camera_driver", options)
+    : rclcpp_lifecycle::LifecycleNode("camera_driver", options)
 {
-    RCLCPP_INFO(get_logger(), "CameraDriverNode 初始化中...");
-
-    // 声明参数
+    // 声明参数（打开设备等耗时操作在configure中完成）
     this->declare_parameter("camera_id", 0);
     this->declare_parameter("video_path", "");
     this->declare_parameter("frame_width", 640);
     this->declare_parameter("frame_height", 480);
     this->declare_parameter("fps", 30);
+    // 图像与内参消息的坐标系（多相机时各实例不同）
+    this->declare_parameter("frame_id", "camera_optical_frame");
+    // 采集后端: "opencv"(VideoCapture) 或 "v4l2"(原生mmap流式采集)
+    this->declare_parameter("backend", "opencv");
+    // V4L2设备路径（为空时使用 /dev/video<camera_id>）
+    this->declare_parameter("device", "");
+    // V4L2像素格式: "MJPG" 或 "YUYV"
+    this->declare_parameter("pixel_format", "MJPG");
+    // V4L2驱动缓冲区数量
+    this->declare_parameter("v4l2_queue_depth", 4);
+    // 每次只取最新一帧，丢弃驱动队列中积压的旧帧
+    this->declare_parameter("v4l2_grab_newest", true);
+    // MJPG并行解码线程数（0: 在采集线程内解码）
+    this->declare_parameter("decode_workers", 2);
+    // MJPG缩放解码（1/2/4/8）与ROI解码 [x, y, width, height]（原始分辨率坐标，宽高为0表示整幅）
+    this->declare_parameter("decode_scale", 1);
+    this->declare_parameter("decode_roi", std::vector<int64_t>{0, 0, 0, 0});
+    // 图像缓冲区池大小（在途帧数上限，超出时新分配）
+    this->declare_parameter("buffer_pool_size", 4);
+    // 时间戳：优先使用驱动缓冲区时间戳；视频文件或驱动不提供时，
+    // 使用“读取返回时刻 - timestamp_offset_ms”
+    this->declare_parameter("use_driver_timestamp", true);
+    this->declare_parameter("timestamp_offset_ms", 0.0);
+    // 视频文件锁步模式：发布一帧后等待下游确认（lockstep_ack_topic）再发布下一帧，
+    // 不丢帧、不按fps节流，播完即停
+    this->declare_parameter("video_lockstep", false);
+    this->declare_parameter("lockstep_ack_topic", "/solver/target");
+    this->declare_parameter("lockstep_timeout_ms", 1000);
+    // 预解码帧数
+    this->declare_parameter("video_prefetch_frames", 4);
+    // 锁步模式时间戳按帧序号生成：激活时刻 + (index+1)/视频帧率，帧间时间多次运行完全一致
+    this->declare_parameter("video_deterministic_stamps", true);
+    // 锁步模式播完后关闭进程（批处理脚本用）
+    this->declare_parameter("shutdown_on_eof", false);
 
     // 相机内参参数
     this->declare_parameter("camera_matrix",
@@ -24,69 +63,521 @@ CameraDriverNode::CameraDriverNode(const rclcpp::NodeOptions& options)
     this->declare_parameter("distortion_coefficients",
         std::vector<double>{0.0, 0.0, 0.0, 0.0, 0.0});
 
+    capture_placement_ = declareThreadPlacement(*this, "capture");
+    decode_placement_ = declareThreadPlacement(*this, "decode");
+}
+
+CameraDriverNode::~CameraDriverNode() {
+    stopThreads();
+    releaseDevice();
+}
+
+CameraDriverNode::CallbackReturn CameraDriverNode::on_configure(const rclcpp_lifecycle::State&) {
     camera_id_ = this->get_parameter("camera_id").as_int();
     video_path_ = this->get_parameter("video_path").as_string();
     frame_width_ = this->get_parameter("frame_width").as_int();
     frame_height_ = this->get_parameter("frame_height").as_int();
     fps_ = this->get_parameter("fps").as_int();
+    frame_id_ = this->get_parameter("frame_id").as_string();
+    backend_ = this->get_parameter("backend").as_string();
+    v4l2_grab_newest_ = this->get_parameter("v4l2_grab_newest").as_bool();
+    use_driver_timestamp_ = this->get_parameter("use_driver_timestamp").as_bool();
+    timestamp_offset_ns_ = static_cast<int64_t>(
+        this->get_parameter("timestamp_offset_ms").as_double() * 1e6);
+    lockstep_ = this->get_parameter("video_lockstep").as_bool();
+    if (lockstep_ && video_path_.empty()) {
+        RCLCPP_WARN(get_logger(), "video_lockstep 仅用于视频文件输入，已忽略");
+        lockstep_ = false;
+    }
+    deterministic_stamps_ = this->get_parameter("video_deterministic_stamps").as_bool();
+    shutdown_on_eof_ = this->get_parameter("shutdown_on_eof").as_bool();
+    lockstep_timeout_ms_ = this->get_parameter("lockstep_timeout_ms").as_int();
 
     // 加载内参
     loadCameraInfo();
 
     // 创建发布器
-    camera_pub_ = image_transport::create_camera_publisher(this, "/image_raw");
+    image_pub_ = this->create_publisher<sensor_msgs::msg::Image>(
+        "/image_raw", rclcpp::SensorDataQoS());
+    // 采集→发布延迟（ms），仅在有订阅者时发布（节点私有话题，多相机实例互不混淆）
+    latency_pub_ = this->create_publisher<std_msgs::msg::Float64>(
+        "~/capture_latency", rclcpp::SensorDataQoS());
+
+    // 相机内参为锁存话题（transient_local），只在打开相机/分辨率变化时发布；
+    // 进程内通信不支持transient_local，该发布器单独关闭进程内通信。
+    // 使用普通发布器：配置完成即发布，检测节点在相机激活前就能拿到内参
+    rclcpp::PublisherOptions camera_info_options;
+    camera_info_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+    camera_info_pub_ = rclcpp::create_publisher<sensor_msgs::msg::CameraInfo>(
+        *this, "/camera_info", rclcpp::QoS(1).reliable().transient_local(),
+        camera_info_options);
 
-    // 打开相机
+    // 打开相机（视频文件始终走VideoCapture）
     bool opened = false;
-    if (!video_path_.empty()) {
-        opened = cap_.open(video_path_);
-        RCLCPP_INFO(get_logger(), "使用视频文件: %s", video_path_.c_str());
+    if (video_path_.empty() && backend_ == "v4l2") {
+        opened = openV4l2();
     } else {
-        cap_.open(camera_id_, cv::CAP_V4L2);
-        if (cap_.isOpened()) {
-            cap_.set(cv::CAP_PROP_FRAME_WIDTH, frame_width_);
-            cap_.set(cv::CAP_PROP_FRAME_HEIGHT, frame_height_);
-            cap_.set(cv::CAP_PROP_FPS, fps_);
-            // 设置MJPG格式以提高帧率
-            cap_.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
-            opened = true;
-        }
-        RCLCPP_INFO(get_logger(), "使用相机ID: %d", camera_id_);
+        opened = openVideoCapture();
     }
-
-    if (!opened || !cap_.isOpened()) {
+    if (!opened) {
+        // 设备打开即就绪；失败时保持未配置，由管理节点重试（USB相机可能还在枚举）
         RCLCPP_ERROR(get_logger(), "无法打开相机/视频源！");
-        return;
+        releaseDevice();
+        return CallbackReturn::FAILURE;
     }
+    camera_info_msg_.width = frame_width_;
+    camera_info_msg_.height = frame_height_;
 
     RCLCPP_INFO(get_logger(), "相机已打开: %dx%d @ %d fps",
                 frame_width_, frame_height_, fps_);
 
-    // 启动采集线程
+    // 预分配图像缓冲区
+    auto pool_size = static_cast<size_t>(this->get_parameter("buffer_pool_size").as_int());
+    if (lockstep_) {
+        // 锁步模式：预解码队列 + 预解码线程手中一帧 + 下游在途一帧
+        const auto prefetch = static_cast<size_t>(
+            std::max<int64_t>(1, this->get_parameter("video_prefetch_frames").as_int()));
+        prefetch_queue_ = std::make_unique<SpscQueue<PrefetchedFrame>>(prefetch);
+        pool_size = std::max(pool_size, prefetch_queue_->capacity() + 2);
+
+        video_fps_ = cap_.get(cv::CAP_PROP_FPS);
+        if (!(video_fps_ > 0.0)) {
+            video_fps_ = std::max(fps_, 1);
+        }
+        ack_sub_ = this->create_subscription<rm_interfaces::msg::Target>(
+            this->get_parameter("lockstep_ack_topic").as_string(), rclcpp::SensorDataQoS(),
+            std::bind(&CameraDriverNode::ackCallback, this, std::placeholders::_1));
+        RCLCPP_INFO(get_logger(), "视频锁步模式: 预解码 %zu 帧, 视频帧率 %.2f, 确认话题 %s",
+                    prefetch_queue_->capacity(), video_fps_, ack_sub_->get_topic_name());
+    }
+    // 按节点名预留：多相机实例共享进程内缓冲区池，各自占一份
+    BufferPool::global().reserve(pool_size, frameBytes(), get_name());
+
+    publishCameraInfo();
+    return CallbackReturn::SUCCESS;
+}
+
+CameraDriverNode::CallbackReturn CameraDriverNode::on_activate(const rclcpp_lifecycle::State&) {
+    image_pub_->on_activate();
+    latency_pub_->on_activate();
+
+    // 启动采集线程（并行解码时另起解码线程和按序发布线程）
     running_ = true;
+    for (auto& worker : decode_workers_) {
+        worker->thread = std::thread(&CameraDriverNode::decodeLoop, this, worker.get());
+    }
+    if (!decode_workers_.empty()) {
+        publish_thread_ = std::thread(&CameraDriverNode::publishLoop, this);
+    }
+    if (lockstep_) {
+        // 确定性时间戳以激活时刻为起点，与ROS时间同一量级（不从纪元0起算）；
+        // 但锁步回放快于或慢于实时，时间戳不是真实采集时刻，采集起算的延迟统计无意义，关闭之
+        lockstep_stamp_base_ns_ = this->now().nanoseconds();
+        if (deterministic_stamps_) {
+            LatencyTracer::global().setSinceCaptureEnabled(false);
+            since_capture_disabled_ = true;
+            RCLCPP_INFO(get_logger(), "锁步确定性时间戳: 已关闭采集起算的延迟统计（各阶段耗时照常统计）");
+        }
+        prefetch_done_ = false;
+        prefetch_thread_ = std::thread(&CameraDriverNode::prefetchLoop, this);
+    }
     capture_thread_ = std::thread(&CameraDriverNode::captureLoop, this);
 
-    RCLCPP_INFO(get_logger(), "CameraDriverNode 初始化完成");
+    RCLCPP_INFO(get_logger(), "相机采集已启动");
+    return CallbackReturn::SUCCESS;
 }
 
-CameraDriverNode::~CameraDriverNode() {
+CameraDriverNode::CallbackReturn CameraDriverNode::on_deactivate(const rclcpp_lifecycle::State&) {
+    stopThreads();
+    image_pub_->on_deactivate();
+    latency_pub_->on_deactivate();
+    RCLCPP_INFO(get_logger(), "相机采集已停止");
+    return CallbackReturn::SUCCESS;
+}
+
+CameraDriverNode::CallbackReturn CameraDriverNode::on_cleanup(const rclcpp_lifecycle::State&) {
+    releaseDevice();
+    return CallbackReturn::SUCCESS;
+}
+
+CameraDriverNode::CallbackReturn CameraDriverNode::on_shutdown(const rclcpp_lifecycle::State&) {
+    stopThreads();
+    releaseDevice();
+    return CallbackReturn::SUCCESS;
+}
+
+void CameraDriverNode::stopThreads() {
     running_ = false;
+    ack_cv_.notify_all();
     if (capture_thread_.joinable()) {
         capture_thread_.join();
     }
+    if (prefetch_thread_.joinable()) {
+        prefetch_thread_.join();
+    }
+    for (auto& worker : decode_workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    if (publish_thread_.joinable()) {
+        publish_thread_.join();
+    }
+    if (since_capture_disabled_) {
+        LatencyTracer::global().setSinceCaptureEnabled(true);
+        since_capture_disabled_ = false;
+    }
+
+    // 停止时仍在队列中的解码任务/结果直接丢弃（驱动缓冲区归还驱动，图像缓冲区归还池）：
+    // 重新激活时采集与发布序号都从0开始，队列必须为空，轮转对应关系才成立
+    for (auto& worker : decode_workers_) {
+        DecodeJob job;
+        while (worker->jobs->tryPop(job)) {
+            job.buffer.release();
+        }
+        DecodedFrame result;
+        while (worker->results->tryPop(result)) {
+            if (result.msg) {
+                BufferPool::global().release(std::move(result.msg->data));
+            }
+        }
+    }
+    // 锁步预解码的残留帧同样归还池：重新激活时预解码序号从0开始，旧帧不能排在新帧之前发布
+    if (prefetch_queue_) {
+        PrefetchedFrame prefetched;
+        while (prefetch_queue_->tryPop(prefetched)) {
+            if (prefetched.msg) {
+                BufferPool::global().release(std::move(prefetched.msg->data));
+            }
+        }
+    }
+}
+
+void CameraDriverNode::releaseDevice() {
+    // 队列中未处理的任务持有驱动缓冲区，须在关闭设备前释放
+    decode_workers_.clear();
+    inline_decoder_.reset();
+    prefetch_queue_.reset();
+    ack_sub_.reset();
+
     if (cap_.isOpened()) {
         cap_.release();
     }
+    v4l2_.close();
+
+    image_pub_.reset();
+    latency_pub_.reset();
+    camera_info_pub_.reset();
+}
+
+bool CameraDriverNode::openVideoCapture() {
+    if (!video_path_.empty()) {
+        RCLCPP_INFO(get_logger(), "使用视频文件: %s", video_path_.c_str());
+        if (!cap_.open(video_path_)) {
+            return false;
+        }
+    } else {
+        RCLCPP_INFO(get_logger(), "使用相机ID: %d", camera_id_);
+        if (!cap_.open(camera_id_, cv::CAP_V4L2)) {
+            return false;
+        }
+        cap_.set(cv::CAP_PROP_FRAME_WIDTH, frame_width_);
+        cap_.set(cv::CAP_PROP_FRAME_HEIGHT, frame_height_);
+        cap_.set(cv::CAP_PROP_FPS, fps_);
+        // 设置MJPG格式以提高帧率
+        cap_.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    }
+
+    // 以实际输出分辨率为准（视频文件或相机可能不支持配置的分辨率）
+    int actual_width = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_WIDTH));
+    int actual_height = static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_HEIGHT));
+    if (actual_width > 0 && actual_height > 0) {
+        frame_width_ = actual_width;
+        frame_height_ = actual_height;
+    }
+    return true;
+}
+
+bool CameraDriverNode::openV4l2() {
+    auto device = this->get_parameter("device").as_string();
+    if (device.empty()) {
+        device = "/dev/video" + std::to_string(camera_id_);
+    }
+    auto pixel_format = this->get_parameter("pixel_format").as_string();
+    if (pixel_format != "MJPG" && pixel_format != "YUYV") {
+        RCLCPP_ERROR(get_logger(), "不支持的像素格式: %s", pixel_format.c_str());
+        return false;
+    }
+    int queue_depth = this->get_parameter("v4l2_queue_depth").as_int();
+
+    std::string error;
+    if (!v4l2_.open(device, frame_width_, frame_height_,
+                    V4l2Capture::fourccFromString(pixel_format), fps_, queue_depth,
+                    &error)) {
+        RCLCPP_ERROR(get_logger(), "%s", error.c_str());
+        return false;
+    }
+
+    // 以驱动协商结果为准
+    frame_width_ = static_cast<int>(v4l2_.width());
+    frame_height_ = static_cast<int>(v4l2_.height());
+    RCLCPP_INFO(get_logger(), "V4L2后端: %s %s, 缓冲区 %zu 个, %s",
+                device.c_str(), pixel_format.c_str(), v4l2_.queueDepth(),
+                v4l2_grab_newest_ ? "只取最新帧" : "顺序取帧");
+
+    if (pixel_format == "MJPG") {
+        setupMjpegDecoding();
+    }
+    return true;
+}
+
+void CameraDriverNode::setupMjpegDecoding() {
+    MjpegDecodeOptions options;
+    options.scale_denom = this->get_parameter("decode_scale").as_int();
+    auto roi = this->get_parameter("decode_roi").as_integer_array();
+    if (roi.size() == 4) {
+        options.roi_x = static_cast<int>(roi[0]);
+        options.roi_y = static_cast<int>(roi[1]);
+        options.roi_width = static_cast<int>(roi[2]);
+        options.roi_height = static_cast<int>(roi[3]);
+    }
+
+    // 每个解码线程独占一个解码器；解码器只依赖几何参数，逐个构造即可
+    auto make_decoder = [&]() {
+        return std::make_unique<MjpegDecoder>(frame_width_, frame_height_, options);
+    };
+    auto decoder = make_decoder();
+    const int src_width = frame_width_;
+    const int src_height = frame_height_;
+
+    // 输出分辨率为ROI缩放后的尺寸，相机内参同步修正
+    frame_width_ = decoder->outputWidth();
+    frame_height_ = decoder->outputHeight();
+    if (frame_width_ != src_width || frame_height_ != src_height) {
+        applyRoiToCameraInfo(decoder->roiX(), decoder->roiY(), decoder->scaleDenom());
+        RCLCPP_INFO(get_logger(), "MJPG解码输出: %dx%d (ROI起点 %d,%d, 缩放 1/%d)",
+                    frame_width_, frame_height_, decoder->roiX(), decoder->roiY(),
+                    decoder->scaleDenom());
+    }
+
+    int workers = this->get_parameter("decode_workers").as_int();
+    if (workers <= 0) {
+        inline_decoder_ = std::move(decoder);
+        return;
+    }
+
+    // 每个解码线程持有一个驱动缓冲区在途，驱动队列需留有余量
+    if (static_cast<int>(v4l2_.queueDepth()) <= workers + 1) {
+        RCLCPP_WARN(get_logger(), "v4l2_queue_depth(%zu) 应大于 decode_workers+1(%d)",
+                    v4l2_.queueDepth(), workers + 1);
+    }
+    for (int i = 0; i < workers; i++) {
+        auto worker = std::make_unique<DecodeWorker>();
+        worker->decoder = i == 0 ? std::move(decoder) : make_decoder();
+        worker->jobs = std::make_unique<SpscQueue<DecodeJob>>(2);
+        worker->results = std::make_unique<SpscQueue<DecodedFrame>>(2);
+        decode_workers_.push_back(std::move(worker));
+    }
+    RCLCPP_INFO(get_logger(), "MJPG并行解码: %d 线程", workers);
+}
+
+void CameraDriverNode::applyRoiToCameraInfo(int roi_x, int roi_y, int scale_denom) {
+    // K = [fx 0 cx; 0 fy cy; 0 0 1]，P同理（第4列为0）
+    const double s = 1.0 / scale_denom;
+    auto& k = camera_info_msg_.k;
+    auto& p = camera_info_msg_.p;
+    k[0] *= s;
+    k[4] *= s;
+    k[2] = (k[2] - roi_x) * s;
+    k[5] = (k[5] - roi_y) * s;
+    p[0] *= s;
+    p[5] *= s;
+    p[2] = (p[2] - roi_x) * s;
+    p[6] = (p[6] - roi_y) * s;
+}
+
+void CameraDriverNode::placeCurrentThread(ThreadPlacement placement, const std::string& name) {
+    placement.name = name;
+    std::string message;
+    if (applyThreadPlacement(placement, &message)) {
+        RCLCPP_INFO(get_logger(), "线程 %s: %s", name.c_str(), message.c_str());
+    } else {
+        RCLCPP_WARN(get_logger(), "线程 %s 放置降级: %s", name.c_str(), message.c_str());
+    }
 }
 
 void CameraDriverNode::captureLoop() {
-    cv::Mat frame;
+    placeCurrentThread(capture_placement_, "capture");
+    if (v4l2_.isOpen()) {
+        captureLoopV4l2();
+    } else if (lockstep_) {
+        captureLoopLockstep();
+    } else {
+        captureLoopVideoCapture();
+    }
+}
+
+void CameraDriverNode::captureLoopV4l2() {
+    V4l2Buffer buffer;
+    uint64_t seq = 0;
+
+    // 停止期间驱动队列里积压的是旧帧，重新激活时先丢弃
+    if (v4l2_.dequeue(buffer, 0, true)) {
+        buffer.release();
+    }
+
+    while (running_ && rclcpp::ok()) {
+        // 只取最新帧时，等目标解码线程取走上一个任务再出队：积压留在驱动队列里由
+        // grab_newest丢弃，交给解码的总是此刻最新的一帧（而不是在任务队列里排队的旧帧）
+        if (v4l2_grab_newest_ && !decode_workers_.empty()) {
+            const auto& jobs = *decode_workers_[seq % decode_workers_.size()]->jobs;
+            while (jobs.sizeApprox() > 0 && running_) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            if (!running_) {
+                break;
+            }
+        }
+
+        // 出队（阻塞至有帧或超时）
+        if (!v4l2_.dequeue(buffer, 1000, v4l2_grab_newest_)) {
+            RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000, "V4L2出队超时");
+            continue;
+        }
+
+        // 驱动时间戳（CLOCK_MONOTONIC）换算为ROS时间
+        const int64_t ros_now_ns = this->now().nanoseconds();
+        const int64_t stamp_ns = (use_driver_timestamp_ && buffer.stampNs() > 0)
+            ? monotonicToRosNs(buffer.stampNs(), ros_now_ns, monotonicNowNs())
+            : ros_now_ns - timestamp_offset_ns_;
+
+        if (decode_workers_.empty()) {
+            // 采集线程内解码并发布
+            auto img_msg = decodeFrame(buffer, inline_decoder_.get());
+            buffer.release();
+            if (img_msg) {
+                publishFrame(std::move(img_msg), stamp_ns);
+            }
+            continue;
+        }
+
+        // 按序号轮转分发给解码线程（驱动缓冲区随任务转移，零拷贝）；
+        // 顺序取帧时目标线程积压则丢弃本帧，序号不递增，保证发布端按轮转顺序取回即为原始顺序
+        DecodeJob job;
+        job.buffer = std::move(buffer);
+        job.stamp_ns = stamp_ns;
+        if (decode_workers_[seq % decode_workers_.size()]->jobs->tryPush(std::move(job))) {
+            seq++;
+        } else {
+            decode_drops_++;
+            RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
+                                 "解码线程积压，已丢弃 %lu 帧", decode_drops_);
+        }
+    }
+}
+
+void CameraDriverNode::decodeLoop(DecodeWorker* worker) {
+    size_t index = 0;
+    while (index < decode_workers_.size() && decode_workers_[index].get() != worker) {
+        index++;
+    }
+    placeCurrentThread(decode_placement_, "decode" + std::to_string(index));
+
+    DecodeJob job;
+    while (worker->jobs->popWait(job, running_)) {
+        DecodedFrame result;
+        result.stamp_ns = job.stamp_ns;
+        result.msg = decodeFrame(job.buffer, worker->decoder.get());
+        job.buffer.release();
+
+        // 结果必须送达（解码失败也占一个序号），发布端慢时等待；停止时归还本帧缓冲区
+        if (!worker->results->pushWait(std::move(result), running_)) {
+            if (result.msg) {
+                BufferPool::global().release(std::move(result.msg->data));
+            }
+            return;
+        }
+    }
+}
+
+void CameraDriverNode::publishLoop() {
+    placeCurrentThread(capture_placement_, "cam_publish");
+
+    // 按分发顺序依次从各解码线程取结果，输出即按采集序号有序
+    DecodedFrame result;
+    for (uint64_t seq = 0;; seq++) {
+        auto& worker = decode_workers_[seq % decode_workers_.size()];
+        if (!worker->results->popWait(result, running_)) {
+            break;
+        }
+        if (result.msg) {
+            publishFrame(std::move(result.msg), result.stamp_ns);
+        }
+    }
+}
+
+sensor_msgs::msg::Image::UniquePtr CameraDriverNode::decodeFrame(
+    const V4l2Buffer& buffer, MjpegDecoder* decoder)
+{
+    auto& pool = BufferPool::global();
+    auto img_msg = std::make_unique<sensor_msgs::msg::Image>();
+    img_msg->height = frame_height_;
+    img_msg->width = frame_width_;
+    img_msg->encoding = "bgr8";
+    img_msg->is_bigendian = false;
+    img_msg->step = static_cast<uint32_t>(frame_width_ * 3);
+    img_msg->data = pool.acquire(frameBytes());
+
+    // 直接从驱动mmap内存解码/转换到消息缓冲区，中间无拷贝
+    bool ok = false;
+    if (decoder) {
+        ok = decoder->decode(buffer.data(), buffer.bytes(), img_msg->data.data(), img_msg->step);
+    } else {
+        cv::Mat frame(frame_height_, frame_width_, CV_8UC3, img_msg->data.data());
+        const cv::Mat yuyv(frame_height_, frame_width_, CV_8UC2,
+                           const_cast<uint8_t*>(buffer.data()), v4l2_.bytesPerLine());
+        cv::cvtColor(yuyv, frame, cv::COLOR_YUV2BGR_YUYV);
+        ok = frame.data == img_msg->data.data();
+    }
+
+    if (!ok) {
+        RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000, "V4L2帧解码失败");
+        pool.release(std::move(img_msg->data));
+        return nullptr;
+    }
+    return img_msg;
+}
+
+void CameraDriverNode::publishFrame(sensor_msgs::msg::Image::UniquePtr img_msg, int64_t stamp_ns) {
+    AllocScope alloc_scope(AllocTag::CAPTURE, true);
+    img_msg->header.stamp = rclcpp::Time(stamp_ns);
+    img_msg->header.frame_id = frame_id_;
+    LatencyTracer::global().mark(TraceStage::CAPTURE, stamp_ns);
+    image_pub_->publish(std::move(img_msg));
+    recordLatency(this->now().nanoseconds() - stamp_ns);
+}
+
+void CameraDriverNode::captureLoopVideoCapture() {
     auto target_duration = std::chrono::microseconds(1000000 / fps_);
 
     while (running_ && rclcpp::ok()) {
         auto start = std::chrono::steady_clock::now();
+        AllocScope alloc_scope(AllocTag::CAPTURE, true);
+
+        // 图像数据缓冲区取自全局池，cv::Mat直接引用消息缓冲区，
+        // 采集结果写入消息内存本身；订阅者处理完后将缓冲区归还池中
+        auto& pool = BufferPool::global();
+        auto img_msg = std::make_unique<sensor_msgs::msg::Image>();
+        img_msg->height = frame_height_;
+        img_msg->width = frame_width_;
+        img_msg->encoding = "bgr8";
+        img_msg->is_bigendian = false;
+        img_msg->step = static_cast<uint32_t>(frame_width_ * 3);
+        img_msg->data = pool.acquire(frameBytes());
+        cv::Mat frame(frame_height_, frame_width_, CV_8UC3, img_msg->data.data());
 
         if (!cap_.read(frame) || frame.empty()) {
+            pool.release(std::move(img_msg->data));
             // 视频文件播完可循环
             if (!video_path_.empty()) {
                 cap_.set(cv::CAP_PROP_POS_FRAMES, 0);
@@ -97,19 +588,40 @@ void CameraDriverNode::captureLoop() {
             continue;
         }
 
-        // 转换为ROS消息
-        auto stamp = this->now();
+        // 分辨率与预期不一致时VideoCapture会重新分配内存，
+        // 此时按实际分辨率更新并拷贝本帧，后续帧恢复直接写入
+        if (frame.data != img_msg->data.data()) {
+            RCLCPP_WARN(get_logger(), "采集分辨率变化: %dx%d -> %dx%d",
+                        frame_width_, frame_height_, frame.cols, frame.rows);
+            frame_width_ = frame.cols;
+            frame_height_ = frame.rows;
+            camera_info_msg_.width = frame_width_;
+            camera_info_msg_.height = frame_height_;
+            img_msg->height = frame_height_;
+            img_msg->width = frame_width_;
+            img_msg->step = static_cast<uint32_t>(frame.step);
+            pool.release(std::move(img_msg->data));
+            img_msg->data = pool.acquire(frame.total() * frame.elemSize());
+            std::memcpy(img_msg->data.data(), frame.data, img_msg->data.size());
+            publishCameraInfo();
+        }
 
-        auto img_msg = cv_bridge::CvImage(
-            std_msgs::msg::Header(), "bgr8", frame).toImageMsg();
-        img_msg->header.stamp = stamp;
-        img_msg->header.frame_id = "camera_optical_frame";
+        // 采集时间戳（驱动缓冲区时间戳，不含解码耗时）
+        auto capture_stamp = captureStamp(
+            cap_, use_driver_timestamp_ && video_path_.empty(),
+            timestamp_offset_ns_, this->now().nanoseconds());
+        if (use_driver_timestamp_ && video_path_.empty() && !capture_stamp.from_driver) {
+            RCLCPP_WARN_ONCE(get_logger(), "相机后端未提供缓冲区时间戳，退化为读取时刻");
+        }
+        img_msg->header.stamp = rclcpp::Time(capture_stamp.stamp_ns);
+        img_msg->header.frame_id = frame_id_;
 
-        camera_info_msg_.header.stamp = stamp;
-        camera_info_msg_.header.frame_id = "camera_optical_frame";
+        // 发布（转移所有权，进程内订阅者直接拿到同一块内存）
+        LatencyTracer::global().mark(TraceStage::CAPTURE, capture_stamp.stamp_ns);
+        image_pub_->publish(std::move(img_msg));
 
-        // 发布
-        camera_pub_.publish(*img_msg, camera_info_msg_);
+        // 采集→发布延迟
+        recordLatency(this->now().nanoseconds() - capture_stamp.stamp_ns);
 
         // 帧率控制
         auto elapsed = std::chrono::steady_clock::now() - start;
@@ -119,6 +631,152 @@ void CameraDriverNode::captureLoop() {
     }
 }
 
+void CameraDriverNode::prefetchLoop() {
+    placeCurrentThread(decode_placement_, "prefetch");
+
+    auto& pool = BufferPool::global();
+    for (uint64_t index = 0; running_; index++) {
+        PrefetchedFrame prefetched;
+        prefetched.index = index;
+        prefetched.msg = std::make_unique<sensor_msgs::msg::Image>();
+        auto& img_msg = *prefetched.msg;
+        img_msg.height = frame_height_;
+        img_msg.width = frame_width_;
+        img_msg.encoding = "bgr8";
+        img_msg.is_bigendian = false;
+        img_msg.step = static_cast<uint32_t>(frame_width_ * 3);
+        img_msg.data = pool.acquire(frameBytes());
+        cv::Mat frame(frame_height_, frame_width_, CV_8UC3, img_msg.data.data());
+
+        if (!cap_.read(frame) || frame.empty()) {
+            pool.release(std::move(img_msg.data));
+            break;  // 文件末尾
+        }
+        if (frame.data != img_msg.data.data()) {
+            // 个别帧分辨率与文件头不一致：拷贝到按实际大小分配的缓冲区
+            img_msg.height = frame.rows;
+            img_msg.width = frame.cols;
+            img_msg.step = static_cast<uint32_t>(frame.step);
+            pool.release(std::move(img_msg.data));
+            img_msg.data = pool.acquire(frame.total() * frame.elemSize());
+            std::memcpy(img_msg.data.data(), frame.data, img_msg.data.size());
+        }
+
+        // 队满时等待发布线程取走（反压，不丢帧）
+        if (!prefetch_queue_->pushWait(std::move(prefetched), running_)) {
+            pool.release(std::move(prefetched.msg->data));
+            break;
+        }
+    }
+    prefetch_done_ = true;
+}
+
+void CameraDriverNode::captureLoopLockstep() {
+    const auto timeout = std::chrono::milliseconds(std::max(lockstep_timeout_ms_, 1));
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t frames = 0;
+    uint64_t timeouts = 0;
+    double round_trip_sum_ms = 0.0;
+    double round_trip_max_ms = 0.0;
+
+    PrefetchedFrame prefetched;
+    while (running_ && rclcpp::ok()) {
+        if (!prefetch_queue_->tryPop(prefetched)) {
+            // 队列为空且预解码已结束：文件播完（先读标志再确认队列，避免漏掉最后几帧）
+            if (prefetch_done_.load()) {
+                if (!prefetch_queue_->tryPop(prefetched)) break;
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+        }
+
+        const int64_t stamp_ns = deterministic_stamps_
+            ? lockstep_stamp_base_ns_ +
+              static_cast<int64_t>(static_cast<double>(prefetched.index + 1) * 1e9 / video_fps_)
+            : this->now().nanoseconds();
+        {
+            std::lock_guard<std::mutex> lock(ack_mutex_);
+            pending_stamp_ns_ = stamp_ns;
+            acked_ = false;
+        }
+
+        const auto publish_time = std::chrono::steady_clock::now();
+        prefetched.msg->header.stamp = rclcpp::Time(stamp_ns);
+        prefetched.msg->header.frame_id = frame_id_;
+        LatencyTracer::global().mark(TraceStage::CAPTURE, stamp_ns);
+        image_pub_->publish(std::move(prefetched.msg));
+        frames++;
+
+        // 等待下游处理完本帧
+        std::unique_lock<std::mutex> lock(ack_mutex_);
+        if (!ack_cv_.wait_for(lock, timeout, [this] { return acked_ || !running_; })) {
+            timeouts++;
+            RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
+                                 "第 %lu 帧等待下游确认超时", prefetched.index);
+        }
+        lock.unlock();
+
+        const double round_trip_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - publish_time).count();
+        round_trip_sum_ms += round_trip_ms;
+        round_trip_max_ms = std::max(round_trip_max_ms, round_trip_ms);
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    RCLCPP_INFO(get_logger(),
+                "视频锁步回放结束: %lu 帧, 用时 %.2f s, 吞吐 %.1f fps, "
+                "往返 平均 %.2f ms / 最大 %.2f ms, 确认超时 %lu",
+                frames, elapsed, elapsed > 0.0 ? frames / elapsed : 0.0,
+                frames > 0 ? round_trip_sum_ms / frames : 0.0, round_trip_max_ms, timeouts);
+
+    if (shutdown_on_eof_ && running_) {
+        rclcpp::shutdown();
+    }
+}
+
+void CameraDriverNode::ackCallback(const rm_interfaces::msg::Target::ConstSharedPtr& msg) {
+    const int64_t stamp_ns = rclcpp::Time(msg->header.stamp).nanoseconds();
+    std::lock_guard<std::mutex> lock(ack_mutex_);
+    // 超时后迟到的旧帧确认直接忽略
+    if (stamp_ns == pending_stamp_ns_) {
+        acked_ = true;
+        ack_cv_.notify_one();
+    }
+}
+
+void CameraDriverNode::recordLatency(int64_t latency_ns) {
+    double latency_ms = static_cast<double>(latency_ns) * 1e-6;
+
+    if (latency_pub_->get_subscription_count() > 0) {
+        std_msgs::msg::Float64 msg;
+        msg.data = latency_ms;
+        latency_pub_->publish(msg);
+    }
+
+    // 周期统计
+    latency_sum_ms_ += latency_ms;
+    latency_max_ms_ = std::max(latency_max_ms_, latency_ms);
+    latency_count_++;
+    if (latency_count_ >= static_cast<uint64_t>(std::max(fps_, 1)) * 5) {
+        RCLCPP_DEBUG(get_logger(), "采集延迟: 平均 %.2f ms, 最大 %.2f ms (%lu帧)",
+                     latency_sum_ms_ / latency_count_, latency_max_ms_, latency_count_);
+        latency_sum_ms_ = 0.0;
+        latency_max_ms_ = 0.0;
+        latency_count_ = 0;
+    }
+}
+
+size_t CameraDriverNode::frameBytes() const {
+    return static_cast<size_t>(frame_width_) * frame_height_ * 3;
+}
+
+void CameraDriverNode::publishCameraInfo() {
+    camera_info_msg_.header.stamp = this->now();
+    camera_info_msg_.header.frame_id = frame_id_;
+    camera_info_pub_->publish(camera_info_msg_);
+}
+
 void CameraDriverNode::loadCameraInfo() {
     camera_matrix_ = this->get_parameter("camera_matrix").as_double_array();
     dist_coeffs_ = this->get_parameter("distortion_coefficients").as_double_array();
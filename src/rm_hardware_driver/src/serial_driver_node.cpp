@@ -1,32 +1,45 @@
 #include "rm_hardware_driver/serial_driver_node.hpp"
 
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
 #include <cstring>
 
-// Linux串口头文件
-#ifdef __linux__
-#include <fcntl.h>
-#include <termios.h>
-#include <unistd.h>
-#include <errno.h>
-#endif
+#include "rm_hardware_driver/serial_protocol.hpp"
+#include "rm_utils/flight_recorder.hpp"
+#include "rm_utils/latency_tracer.hpp"
 
 namespace rm_auto_aim {
 
 SerialDriverNode::SerialDriverNode(const rclcpp::NodeOptions& options)
-    : Node("serial_driver", options)
+    : rclcpp_lifecycle::LifecycleNode("serial_driver", options)
 {
-    RCLCPP_INFO(get_logger(), "SerialDriverNode 初始化中...");
-
-    // 声明参数
+    // 声明参数（打开串口等耗时操作在configure中完成）
     this->declare_parameter("port_name", "/dev/ttyUSB0");
     this->declare_parameter("baud_rate", 115200);
     this->declare_parameter("enable_data_print", false);
+    this->declare_parameter("send_rate_hz", 1000);
+    tx_placement_ = declareThreadPlacement(*this, "serial_tx");
+    rx_placement_ = declareThreadPlacement(*this, "serial_rx");
+}
+
+SerialDriverNode::~SerialDriverNode() {
+    stopThreads();
+    closePort();
+}
 
+SerialDriverNode::CallbackReturn SerialDriverNode::on_configure(const rclcpp_lifecycle::State&) {
     port_name_ = this->get_parameter("port_name").as_string();
     baud_rate_ = this->get_parameter("baud_rate").as_int();
+    send_rate_hz_ = std::max(1, static_cast<int>(this->get_parameter("send_rate_hz").as_int()));
 
-    // 订阅云台命令
+    // 串口打开即就绪；失败时保持未配置，由管理节点重试（设备可能还在枚举）
+    if (!openPort()) {
+        RCLCPP_ERROR(get_logger(), "无法打开串口 %s", port_name_.c_str());
+        return CallbackReturn::FAILURE;
+    }
+
+    // 订阅云台命令（未激活时回调直接丢弃）
     gimbal_cmd_sub_ = this->create_subscription<rm_interfaces::msg::GimbalCmd>(
         "/solver/gimbal_cmd", rclcpp::SensorDataQoS(),
         std::bind(&SerialDriverNode::gimbalCmdCallback, this, std::placeholders::_1));
@@ -35,156 +48,144 @@ SerialDriverNode::SerialDriverNode(const rclcpp::NodeOptions& options)
     receive_pub_ = this->create_publisher<rm_interfaces::msg::SerialReceiveData>(
         "/serial/receive", rclcpp::SensorDataQoS());
 
-    // 打开串口
-    if (openPort()) {
-        running_ = true;
-        // 启动接收线程
-        receive_thread_ = std::thread(&SerialDriverNode::receiveThread, this);
-        // 定时发送 (1kHz)
-        send_timer_ = this->create_wall_timer(
-            std::chrono::milliseconds(1),
-            std::bind(&SerialDriverNode::sendThread, this));
-        RCLCPP_INFO(get_logger(), "串口 %s 已打开", port_name_.c_str());
-    } else {
-        RCLCPP_ERROR(get_logger(), "无法打开串口 %s", port_name_.c_str());
+    RCLCPP_INFO(get_logger(), "串口 %s 已打开", port_name_.c_str());
+    return CallbackReturn::SUCCESS;
+}
+
+SerialDriverNode::CallbackReturn SerialDriverNode::on_activate(const rclcpp_lifecycle::State&) {
+    receive_pub_->on_activate();
+    {
+        // 丢弃激活前残留的命令
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        has_new_data_ = false;
     }
+    running_ = true;
+    // 启动接收线程
+    receive_thread_ = std::thread(&SerialDriverNode::receiveThread, this);
+    // 独立发送线程（不与执行器中的日志/调试回调争抢）
+    send_thread_ = std::thread(&SerialDriverNode::sendLoop, this);
+    RCLCPP_INFO(get_logger(), "串口收发已启动");
+    return CallbackReturn::SUCCESS;
+}
 
-    RCLCPP_INFO(get_logger(), "SerialDriverNode 初始化完成");
+SerialDriverNode::CallbackReturn SerialDriverNode::on_deactivate(const rclcpp_lifecycle::State&) {
+    stopThreads();
+    receive_pub_->on_deactivate();
+    RCLCPP_INFO(get_logger(), "串口收发已停止");
+    return CallbackReturn::SUCCESS;
 }
 
-SerialDriverNode::~SerialDriverNode() {
+SerialDriverNode::CallbackReturn SerialDriverNode::on_cleanup(const rclcpp_lifecycle::State&) {
+    gimbal_cmd_sub_.reset();
+    receive_pub_.reset();
+    closePort();
+    return CallbackReturn::SUCCESS;
+}
+
+SerialDriverNode::CallbackReturn SerialDriverNode::on_shutdown(const rclcpp_lifecycle::State&) {
+    stopThreads();
+    gimbal_cmd_sub_.reset();
+    receive_pub_.reset();
+    closePort();
+    return CallbackReturn::SUCCESS;
+}
+
+void SerialDriverNode::stopThreads() {
     running_ = false;
     if (receive_thread_.joinable()) {
         receive_thread_.join();
     }
-    closePort();
+    if (send_thread_.joinable()) {
+        send_thread_.join();
+    }
 }
 
 bool SerialDriverNode::openPort() {
-#ifdef __linux__
-    fd_ = open(port_name_.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
-    if (fd_ < 0) {
-        RCLCPP_ERROR(get_logger(), "打开串口失败: %s", strerror(errno));
-        return false;
-    }
-
-    // 配置串口
-    struct termios tty;
-    memset(&tty, 0, sizeof(tty));
-    if (tcgetattr(fd_, &tty) != 0) {
-        RCLCPP_ERROR(get_logger(), "获取串口属性失败");
-        close(fd_);
-        fd_ = -1;
+    std::string error;
+    if (!port_.open(port_name_, baud_rate_, &error)) {
+        RCLCPP_ERROR(get_logger(), "%s", error.c_str());
         return false;
     }
-
-    // 波特率
-    speed_t speed;
-    switch (baud_rate_) {
-        case 9600: speed = B9600; break;
-        case 115200: speed = B115200; break;
-        case 460800: speed = B460800; break;
-        case 921600: speed = B921600; break;
-        default: speed = B115200; break;
-    }
-    cfsetospeed(&tty, speed);
-    cfsetispeed(&tty, speed);
-
-    // 8N1, 无流控
-    tty.c_cflag &= ~PARENB;    // 无校验
-    tty.c_cflag &= ~CSTOPB;    // 1位停止位
-    tty.c_cflag &= ~CSIZE;
-    tty.c_cflag |= CS8;         // 8位数据位
-    tty.c_cflag &= ~CRTSCTS;   // 无硬件流控
-    tty.c_cflag |= CREAD | CLOCAL;
-
-    // 原始模式
-    tty.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
-    tty.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL);
-    tty.c_oflag &= ~OPOST;
-
-    // 读取超时
-    tty.c_cc[VMIN] = 0;
-    tty.c_cc[VTIME] = 1;  // 100ms超时
-
-    if (tcsetattr(fd_, TCSANOW, &tty) != 0) {
-        RCLCPP_ERROR(get_logger(), "设置串口属性失败");
-        close(fd_);
-        fd_ = -1;
-        return false;
-    }
-
-    tcflush(fd_, TCIOFLUSH);
     return true;
-#else
-    RCLCPP_WARN(get_logger(), "串口通信仅支持Linux平台，当前使用虚拟模式");
-    return false;
-#endif
 }
 
 void SerialDriverNode::closePort() {
-#ifdef __linux__
-    if (fd_ >= 0) {
-        close(fd_);
-        fd_ = -1;
-    }
-#endif
+    port_.close();
 }
 
 void SerialDriverNode::gimbalCmdCallback(
     const rm_interfaces::msg::GimbalCmd::ConstSharedPtr& msg)
 {
+    if (!running_) return;
+
     std::lock_guard<std::mutex> lock(send_mutex_);
     send_packet_ = packGimbalCmd(msg->yaw, msg->pitch, msg->fire);
+    send_stamp_ns_ = rclcpp::Time(msg->header.stamp).nanoseconds();
+    send_yaw_ = msg->yaw;
+    send_pitch_ = msg->pitch;
+    send_fire_ = msg->fire;
     has_new_data_ = true;
 }
 
-Packet16 SerialDriverNode::packGimbalCmd(double yaw, double pitch, bool fire) {
-    Packet16 packet;
-
-    // 将浮点数转为int16 (放大100倍传输)
-    auto yaw_int = static_cast<int16_t>(yaw * 180.0 / M_PI * 100);
-    auto pitch_int = static_cast<int16_t>(pitch * 180.0 / M_PI * 100);
-    uint8_t fire_byte = fire ? 1 : 0;
+void SerialDriverNode::placeCurrentThread(ThreadPlacement placement, const std::string& name) {
+    placement.name = name;
+    std::string message;
+    if (applyThreadPlacement(placement, &message)) {
+        RCLCPP_INFO(get_logger(), "线程 %s: %s", name.c_str(), message.c_str());
+    } else {
+        RCLCPP_WARN(get_logger(), "线程 %s 放置降级: %s", name.c_str(), message.c_str());
+    }
+}
 
-    // 打包: [header][yaw_h][yaw_l][pitch_h][pitch_l][fire]...[checksum][tail]
-    packet.load<int16_t>(1, yaw_int);
-    packet.load<int16_t>(3, pitch_int);
-    packet.load<uint8_t>(5, fire_byte);
-    packet.setChecksum();
+void SerialDriverNode::sendLoop() {
+    placeCurrentThread(tx_placement_, "serial_tx");
 
-    return packet;
+    const auto period = std::chrono::nanoseconds(1000000000LL / send_rate_hz_);
+    auto next = std::chrono::steady_clock::now();
+    while (running_) {
+        sendPending();
+        // 按绝对时间点休眠，周期不随发送耗时漂移
+        next += period;
+        std::this_thread::sleep_until(next);
+        const auto now = std::chrono::steady_clock::now();
+        if (now - next > period) {
+            // 被长时间抢占后重新对齐，不连发补偿
+            next = now;
+        }
+    }
 }
 
-void SerialDriverNode::sendThread() {
-#ifdef __linux__
-    if (fd_ < 0) return;
+void SerialDriverNode::sendPending() {
+    if (!port_.isOpen()) return;
 
     std::lock_guard<std::mutex> lock(send_mutex_);
     if (!has_new_data_) return;
 
-    ssize_t written = write(fd_, send_packet_.data.data(), Packet16::SIZE);
+    ssize_t written = port_.write(send_packet_.data.data(), Packet16::SIZE);
     if (written < 0) {
         RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000,
                              "串口发送失败: %s", strerror(errno));
+    } else {
+        LatencyTracer::global().mark(TraceStage::SERIAL_WRITE, send_stamp_ns_);
     }
+    RM_FLIGHT_RECORD(FlightEvent::SERIAL_SEND, send_yaw_, send_pitch_, send_fire_, written);
     has_new_data_ = false;
-#endif
 }
 
 void SerialDriverNode::receiveThread() {
-#ifdef __linux__
+    placeCurrentThread(rx_placement_, "serial_rx");
+
     std::array<uint8_t, 256> buffer;
     std::array<uint8_t, Packet16::SIZE> packet_buffer;
     size_t packet_idx = 0;
 
     while (running_) {
-        if (fd_ < 0) {
+        if (!port_.isOpen()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
             continue;
         }
 
-        ssize_t bytes_read = read(fd_, buffer.data(), buffer.size());
+        ssize_t bytes_read = port_.read(buffer.data(), buffer.size());
         if (bytes_read <= 0) {
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
             continue;
@@ -213,7 +214,6 @@ void SerialDriverNode::receiveThread() {
             }
         }
     }
-#endif
 }
 
 void SerialDriverNode::unpackReceiveData(const Packet16& packet) {
@@ -234,6 +234,9 @@ void SerialDriverNode::unpackReceiveData(const Packet16& packet) {
     msg.color = packet.read<uint8_t>(9);
     msg.mode = packet.read<uint8_t>(10);
 
+    RM_FLIGHT_RECORD(FlightEvent::SERIAL_RECEIVE, msg.cur_yaw, msg.cur_pitch,
+                     msg.bullet_speed, msg.color);
+
     receive_pub_->publish(msg);
 }
 
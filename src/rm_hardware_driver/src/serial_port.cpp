@@ -0,0 +1,114 @@
+#include "rm_hardware_driver/serial_port.hpp"
+
+#include <cstring>
+
+// Linux串口头文件
+#ifdef __linux__
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace rm_auto_aim {
+
+SerialPort::~SerialPort() {
+    close();
+}
+
+bool SerialPort::open(const std::string& port_name, int baud_rate, std::string* error) {
+#ifdef __linux__
+    close();
+
+    fd_ = ::open(port_name.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd_ < 0) {
+        if (error) *error = std::string("打开串口失败: ") + strerror(errno);
+        return false;
+    }
+
+    // 配置串口
+    struct termios tty;
+    memset(&tty, 0, sizeof(tty));
+    if (tcgetattr(fd_, &tty) != 0) {
+        if (error) *error = "获取串口属性失败";
+        close();
+        return false;
+    }
+
+    // 波特率
+    speed_t speed;
+    switch (baud_rate) {
+        case 9600: speed = B9600; break;
+        case 115200: speed = B115200; break;
+        case 460800: speed = B460800; break;
+        case 921600: speed = B921600; break;
+        default: speed = B115200; break;
+    }
+    cfsetospeed(&tty, speed);
+    cfsetispeed(&tty, speed);
+
+    // 8N1, 无流控
+    tty.c_cflag &= ~PARENB;    // 无校验
+    tty.c_cflag &= ~CSTOPB;    // 1位停止位
+    tty.c_cflag &= ~CSIZE;
+    tty.c_cflag |= CS8;         // 8位数据位
+    tty.c_cflag &= ~CRTSCTS;   // 无硬件流控
+    tty.c_cflag |= CREAD | CLOCAL;
+
+    // 原始模式
+    tty.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL);
+    tty.c_oflag &= ~OPOST;
+
+    // 读取超时
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 1;  // 100ms超时
+
+    if (tcsetattr(fd_, TCSANOW, &tty) != 0) {
+        if (error) *error = "设置串口属性失败";
+        close();
+        return false;
+    }
+
+    tcflush(fd_, TCIOFLUSH);
+    return true;
+#else
+    (void)port_name;
+    (void)baud_rate;
+    if (error) *error = "串口通信仅支持Linux平台";
+    return false;
+#endif
+}
+
+void SerialPort::close() {
+#ifdef __linux__
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+ssize_t SerialPort::write(const uint8_t* data, size_t size) {
+#ifdef __linux__
+    if (fd_ < 0) return -1;
+    return ::write(fd_, data, size);
+#else
+    (void)data;
+    (void)size;
+    return -1;
+#endif
+}
+
+ssize_t SerialPort::read(uint8_t* data, size_t size) {
+#ifdef __linux__
+    if (fd_ < 0) return -1;
+    return ::read(fd_, data, size);
+#else
+    (void)data;
+    (void)size;
+    return -1;
+#endif
+}
+
+}  // namespace rm_auto_aim
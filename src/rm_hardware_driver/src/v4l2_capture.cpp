@@ -0,0 +1,298 @@
+#include "rm_hardware_driver/v4l2_capture.hpp"
+
+#include <cstring>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace rm_auto_aim {
+
+// ==================== V4l2Buffer ====================
+
+V4l2Buffer& V4l2Buffer::operator=(V4l2Buffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        owner_ = other.owner_;
+        index_ = other.index_;
+        data_ = other.data_;
+        bytes_ = other.bytes_;
+        stamp_ns_ = other.stamp_ns_;
+        sequence_ = other.sequence_;
+        other.owner_ = nullptr;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+void V4l2Buffer::release() {
+    if (owner_) {
+        owner_->requeue(index_);
+        owner_ = nullptr;
+        data_ = nullptr;
+        bytes_ = 0;
+    }
+}
+
+// ==================== V4l2Capture ====================
+
+#ifdef __linux__
+namespace {
+
+// ioctl被信号打断时重试
+int xioctl(int fd, unsigned long request, void* arg) {
+    int ret;
+    do {
+        ret = ioctl(fd, request, arg);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+void setError(std::string* error, const std::string& what) {
+    if (error) *error = what + ": " + strerror(errno);
+}
+
+}  // namespace
+#endif
+
+V4l2Capture::~V4l2Capture() {
+    close();
+}
+
+uint32_t V4l2Capture::fourccFromString(const std::string& name) {
+    char c[4] = {' ', ' ', ' ', ' '};
+    for (size_t i = 0; i < 4 && i < name.size(); i++) {
+        c[i] = name[i];
+    }
+    return static_cast<uint32_t>(c[0]) | (static_cast<uint32_t>(c[1]) << 8) |
+           (static_cast<uint32_t>(c[2]) << 16) | (static_cast<uint32_t>(c[3]) << 24);
+}
+
+bool V4l2Capture::open(
+    const std::string& device, uint32_t width, uint32_t height, uint32_t fourcc,
+    int fps, int queue_depth, std::string* error)
+{
+#ifdef __linux__
+    close();
+
+    fd_ = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd_ < 0) {
+        setError(error, "打开设备失败 " + device);
+        return false;
+    }
+
+    // 能力检查：视频采集 + 流式IO
+    v4l2_capability cap{};
+    if (xioctl(fd_, VIDIOC_QUERYCAP, &cap) < 0) {
+        setError(error, "VIDIOC_QUERYCAP失败");
+        close();
+        return false;
+    }
+    uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps
+                                                              : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        if (error) *error = device + " 不支持视频采集/流式IO";
+        close();
+        return false;
+    }
+
+    // 格式协商
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = width;
+    fmt.fmt.pix.height = height;
+    fmt.fmt.pix.pixelformat = fourcc;
+    fmt.fmt.pix.field = V4L2_FIELD_ANY;
+    if (xioctl(fd_, VIDIOC_S_FMT, &fmt) < 0) {
+        setError(error, "VIDIOC_S_FMT失败");
+        close();
+        return false;
+    }
+    if (fmt.fmt.pix.pixelformat != fourcc) {
+        if (error) *error = "设备不支持请求的像素格式";
+        close();
+        return false;
+    }
+    width_ = fmt.fmt.pix.width;
+    height_ = fmt.fmt.pix.height;
+    fourcc_ = fmt.fmt.pix.pixelformat;
+    bytes_per_line_ = fmt.fmt.pix.bytesperline;
+
+    // 帧率（部分驱动不支持，失败忽略）
+    if (fps > 0) {
+        v4l2_streamparm parm{};
+        parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        parm.parm.capture.timeperframe.numerator = 1;
+        parm.parm.capture.timeperframe.denominator = static_cast<uint32_t>(fps);
+        xioctl(fd_, VIDIOC_S_PARM, &parm);
+    }
+
+    // 申请mmap缓冲区
+    v4l2_requestbuffers req{};
+    req.count = static_cast<uint32_t>(queue_depth < 2 ? 2 : queue_depth);
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+        setError(error, "VIDIOC_REQBUFS失败");
+        close();
+        return false;
+    }
+
+    buffers_.resize(req.count);
+    for (uint32_t i = 0; i < req.count; i++) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(fd_, VIDIOC_QUERYBUF, &buf) < 0) {
+            setError(error, "VIDIOC_QUERYBUF失败");
+            close();
+            return false;
+        }
+        void* start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                           fd_, buf.m.offset);
+        if (start == MAP_FAILED) {
+            setError(error, "mmap失败");
+            close();
+            return false;
+        }
+        buffers_[i].start = start;
+        buffers_[i].length = buf.length;
+    }
+
+    // 全部入队并开始采集
+    for (uint32_t i = 0; i < req.count; i++) {
+        if (!requeue(i)) {
+            setError(error, "VIDIOC_QBUF失败");
+            close();
+            return false;
+        }
+    }
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) {
+        setError(error, "VIDIOC_STREAMON失败");
+        close();
+        return false;
+    }
+    streaming_ = true;
+    return true;
+#else
+    (void)device; (void)width; (void)height; (void)fourcc; (void)fps; (void)queue_depth;
+    if (error) *error = "V4L2仅支持Linux";
+    return false;
+#endif
+}
+
+void V4l2Capture::close() {
+#ifdef __linux__
+    if (fd_ < 0) {
+        return;
+    }
+    if (streaming_) {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(fd_, VIDIOC_STREAMOFF, &type);
+        streaming_ = false;
+    }
+    for (auto& buffer : buffers_) {
+        if (buffer.start) {
+            munmap(buffer.start, buffer.length);
+        }
+    }
+    buffers_.clear();
+
+    // 释放驱动侧缓冲区
+    v4l2_requestbuffers req{};
+    req.count = 0;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    xioctl(fd_, VIDIOC_REQBUFS, &req);
+
+    ::close(fd_);
+    fd_ = -1;
+#endif
+}
+
+bool V4l2Capture::dequeue(V4l2Buffer& out, int timeout_ms, bool grab_newest) {
+    out.release();
+#ifdef __linux__
+    if (fd_ < 0) {
+        return false;
+    }
+
+    pollfd pfd{};
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    int ret;
+    do {
+        ret = poll(&pfd, 1, timeout_ms);
+    } while (ret < 0 && errno == EINTR);
+    if (ret <= 0) {
+        return false;  // 超时或出错
+    }
+
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_DQBUF, &buf) < 0) {
+        return false;
+    }
+
+    // 只要最新帧：继续非阻塞出队，旧帧立即归还驱动
+    if (grab_newest) {
+        v4l2_buffer next{};
+        next.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        next.memory = V4L2_MEMORY_MMAP;
+        while (xioctl(fd_, VIDIOC_DQBUF, &next) == 0) {
+            requeue(buf.index);
+            buf = next;
+            skipped_frames_++;
+        }
+    }
+
+    // 驱动标记为损坏的帧直接归还
+    if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+        requeue(buf.index);
+        return false;
+    }
+
+    out.owner_ = this;
+    out.index_ = buf.index;
+    out.data_ = static_cast<const uint8_t*>(buffers_[buf.index].start);
+    out.bytes_ = buf.bytesused;
+    out.sequence_ = buf.sequence;
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        out.stamp_ns_ = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000000LL +
+                        static_cast<int64_t>(buf.timestamp.tv_usec) * 1000LL;
+    } else {
+        out.stamp_ns_ = 0;
+    }
+    return true;
+#else
+    (void)timeout_ms; (void)grab_newest;
+    return false;
+#endif
+}
+
+bool V4l2Capture::requeue(uint32_t index) {
+#ifdef __linux__
+    if (fd_ < 0) {
+        return false;
+    }
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    return xioctl(fd_, VIDIOC_QBUF, &buf) == 0;
+#else
+    (void)index;
+    return false;
+#endif
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 原始输入日志（.rmlog）二进制格式
+ *
+ * 文件布局:
+ *   [FileHeader 64B][Record][Record]...
+ *   Record = [RecordHeader 32B][payload, 8字节对齐]
+ *
+ * 时间索引写在同名 .idx 文件中（IndexEntry数组）；索引缺失或不完整
+ * （例如录制中途断电）时可顺序扫描记录重建。FileHeader.data_end为0
+ * 表示文件未正常关闭，此时以扫描到的最后一条有效记录为准。
+ * 所有字段为小端、主机字节序（仅在x86/ARM小端平台间使用）。
+ */
+
+// 记录类型
+enum class RecordType : uint16_t {
+    IMAGE = 1,           // ImageMeta + 像素数据（可压缩）
+    CAMERA_INFO = 2,     // sensor_msgs/CameraInfo（CDR）
+    SERIAL_RECEIVE = 3,  // rm_interfaces/SerialReceiveData（CDR）
+    GIMBAL_CMD = 4,      // rm_interfaces/GimbalCmd（CDR）
+};
+
+// 记录标志
+constexpr uint16_t RECORD_FLAG_LZ4 = 0x0001;  // 图像像素数据经LZ4压缩
+
+constexpr char LOG_MAGIC[8] = {'R', 'M', 'L', 'O', 'G', 0, 0, 1};
+constexpr uint32_t LOG_VERSION = 1;
+constexpr uint32_t RECORD_MAGIC = 0x43524D52;  // "RMRC"
+constexpr size_t RECORD_ALIGN = 8;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_bytes;
+    uint64_t data_end;        // 有效数据结束偏移（0: 未正常关闭）
+    uint64_t record_count;
+    int64_t start_time_ns;    // 第一条记录的记录时间
+    int64_t end_time_ns;      // 最后一条记录的记录时间
+    uint8_t reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader必须为64字节");
+
+struct RecordHeader {
+    uint32_t magic;
+    uint16_t type;            // RecordType
+    uint16_t flags;
+    int64_t log_time_ns;      // 录制节点收到消息的时刻（回放按此节奏）
+    uint32_t payload_bytes;   // 存储的payload字节数（不含对齐填充）
+    uint32_t raw_bytes;       // 图像像素数据解压后字节数（其它类型等于payload_bytes）
+    uint64_t reserved;
+};
+static_assert(sizeof(RecordHeader) == 32, "RecordHeader必须为32字节");
+
+// 图像记录头（位于IMAGE记录payload开头，不压缩）
+struct ImageMeta {
+    int64_t stamp_ns;         // 原始header.stamp
+    uint32_t width;
+    uint32_t height;
+    uint32_t step;
+    uint8_t is_bigendian;
+    uint8_t reserved[3];
+    char encoding[16];
+    char frame_id[32];
+};
+static_assert(sizeof(ImageMeta) == 72, "ImageMeta必须为72字节");
+
+struct IndexEntry {
+    int64_t log_time_ns;
+    uint64_t offset;          // RecordHeader在日志文件中的偏移
+    uint16_t type;
+    uint16_t flags;
+    uint32_t payload_bytes;
+};
+static_assert(sizeof(IndexEntry) == 24, "IndexEntry必须为24字节");
+
+inline size_t alignRecord(size_t bytes) {
+    return (bytes + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+}  // namespace rm_auto_aim
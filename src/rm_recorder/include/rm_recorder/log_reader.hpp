@@ -0,0 +1,72 @@
+#pragma once
+
+#include "rm_recorder/log_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 单条记录的只读视图（指向映射内存，随LogReader关闭失效）
+ */
+struct RecordView {
+    RecordType type = RecordType::IMAGE;
+    uint16_t flags = 0;
+    int64_t log_time_ns = 0;
+    const uint8_t* payload = nullptr;
+    size_t payload_bytes = 0;
+    uint32_t raw_bytes = 0;
+};
+
+/**
+ * @brief 日志读取器（整体只读mmap，不依赖ROS）
+ *
+ * 优先加载 .idx 时间索引；索引缺失、与文件不一致或文件未正常关闭时
+ * 顺序扫描记录重建索引（扫描到第一条无效记录为止）。
+ */
+class LogReader {
+public:
+    LogReader() = default;
+    ~LogReader();
+
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
+    bool open(const std::string& path, std::string* error);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    size_t size() const { return index_.size(); }
+    const std::vector<IndexEntry>& index() const { return index_; }
+    bool record(size_t i, RecordView& out) const;
+
+    /**
+     * @brief 第一条记录时间不早于log_time_ns的记录序号（索引按记录时间非递减）
+     */
+    size_t seek(int64_t log_time_ns) const;
+
+    int64_t startTimeNs() const { return index_.empty() ? 0 : index_.front().log_time_ns; }
+    int64_t endTimeNs() const { return index_.empty() ? 0 : index_.back().log_time_ns; }
+    // 文件是否正常关闭（否则索引由扫描恢复）
+    bool closedCleanly() const { return closed_cleanly_; }
+
+    /**
+     * @brief 解析图像记录：输出元数据，并将像素数据（必要时解压）写入dst
+     * @param dst 至少record.raw_bytes字节
+     */
+    static bool decodeImage(const RecordView& record, ImageMeta& meta, uint8_t* dst, size_t dst_bytes);
+
+private:
+    bool loadIndex(const std::string& path);
+    void scanIndex();
+
+    const uint8_t* data_ = nullptr;
+    size_t bytes_ = 0;
+    bool closed_cleanly_ = false;
+    std::vector<IndexEntry> index_;
+};
+
+}  // namespace rm_auto_aim
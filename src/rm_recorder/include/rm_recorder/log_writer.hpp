@@ -0,0 +1,92 @@
+#pragma once
+
+#include "rm_recorder/log_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 日志写入选项
+ */
+struct LogWriterOptions {
+    size_t chunk_bytes = 256u << 20;  // 每次扩展并映射的文件块大小
+    bool compress_images = false;     // 图像像素数据LZ4压缩（编译时未找到LZ4则忽略）
+};
+
+/**
+ * @brief 分块内存映射日志写入器（不依赖ROS）
+ *
+ * 文件按chunk_bytes逐块fallocate扩展并mmap，记录直接写入映射内存，
+ * 单条记录超出当前映射剩余空间时从该记录起点重新映射下一块，
+ * 文件内容始终连续。时间索引通过带缓冲的stdio追加到 .idx 文件。
+ * 非线程安全：只应由单个后台写线程调用。
+ */
+class LogWriter {
+public:
+    LogWriter() = default;
+    ~LogWriter();
+
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    bool open(const std::string& path, const LogWriterOptions& options, std::string* error);
+
+    /**
+     * @brief 写回文件头、截断到实际长度并关闭
+     */
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    /**
+     * @brief 追加一条原样存储的记录（CDR序列化消息等）
+     */
+    bool append(RecordType type, int64_t log_time_ns, const void* payload, size_t bytes);
+
+    /**
+     * @brief 追加一条图像记录，像素数据按选项压缩（压缩无收益时原样存储）
+     */
+    bool appendImage(int64_t log_time_ns, const ImageMeta& meta, const uint8_t* data, size_t bytes);
+
+    const std::string& path() const { return path_; }
+    uint64_t recordCount() const { return record_count_; }
+    uint64_t bytesWritten() const { return write_pos_; }
+    // 图像原始字节数 / 实际存储字节数
+    uint64_t imageRawBytes() const { return image_raw_bytes_; }
+    uint64_t imageStoredBytes() const { return image_stored_bytes_; }
+
+    static bool compressionAvailable();
+
+private:
+    /**
+     * @brief 保证从write_pos_起有bytes字节可写映射，返回写入位置
+     */
+    uint8_t* reserve(size_t bytes);
+    bool mapFrom(uint64_t offset, size_t min_bytes);
+    void unmap();
+    void commit(
+        RecordType type, uint16_t flags, int64_t log_time_ns, uint8_t* record, size_t payload_bytes,
+        uint32_t raw_bytes);
+
+    std::string path_;
+    LogWriterOptions options_;
+    int fd_ = -1;
+    std::FILE* index_file_ = nullptr;
+
+    uint8_t* map_ = nullptr;   // 当前映射基址
+    uint64_t map_offset_ = 0;  // 当前映射在文件中的起始偏移（页对齐）
+    size_t map_bytes_ = 0;
+    uint64_t file_bytes_ = 0;  // 已分配的文件长度
+    uint64_t write_pos_ = 0;   // 下一条记录的文件偏移
+
+    uint64_t record_count_ = 0;
+    int64_t start_time_ns_ = 0;
+    int64_t end_time_ns_ = 0;
+    uint64_t image_raw_bytes_ = 0;
+    uint64_t image_stored_bytes_ = 0;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp/serialization.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "rm_interfaces/msg/gimbal_cmd.hpp"
+#include "rm_interfaces/msg/serial_receive_data.hpp"
+#include "rm_recorder/log_writer.hpp"
+#include "rm_utils/spsc_queue.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 原始输入录制节点
+ *
+ * 录制主相机图像、/camera_info、/serial/receive、/solver/gimbal_cmd 到 .rmlog。
+ * 图像不订阅 /image_raw（与检测节点同时订阅会让相机在发布时为第二个订阅者深拷贝整帧），
+ * 而是接收检测节点用完后经 /armor_detector/image_tee 转交的帧：所有权转移、不拷贝，
+ * 写完后数据缓冲区归还缓冲区池。须与检测节点在同一容器内并启用进程内通信。
+ * 订阅回调只把消息的共享指针（不拷贝）放入有界SPSC队列，队满即丢弃并计数；
+ * 压缩、序列化和写入映射内存都在后台写线程完成，录制不会反压相机采集。
+ * 所有订阅位于默认（互斥）回调组，保证队列只有一个生产者。
+ */
+class RecorderNode : public rclcpp::Node {
+public:
+    explicit RecorderNode(const rclcpp::NodeOptions& options);
+    ~RecorderNode() override;
+
+private:
+    // 待写入的消息（类型擦除的只读共享指针）
+    struct LogItem {
+        RecordType type = RecordType::IMAGE;
+        int64_t log_time_ns = 0;
+        std::shared_ptr<const void> msg;
+    };
+
+    /**
+     * @brief 入队（回调线程），队满时丢弃
+     */
+    void enqueue(RecordType type, std::shared_ptr<const void> msg);
+
+    /**
+     * @brief 后台写线程
+     */
+    void writerLoop();
+
+    /**
+     * @brief 写入一条记录
+     */
+    void writeItem(const LogItem& item);
+
+    /**
+     * @brief CDR序列化后写入
+     */
+    template <typename MsgT>
+    void writeSerialized(RecordType type, int64_t log_time_ns, const MsgT& msg);
+
+    /**
+     * @brief 定期打印录制统计
+     */
+    void reportStats();
+
+    LogWriter writer_;
+    SpscQueue<LogItem> queue_;
+    std::atomic<bool> running_{false};
+    std::thread writer_thread_;
+
+    // 写线程复用的序列化缓冲区
+    rclcpp::SerializedMessage serialized_;
+
+    // 统计（按RecordType下标）
+    std::array<std::atomic<uint64_t>, 5> dropped_{};
+    std::atomic<uint64_t> write_failures_{0};
+    // 写线程每写一条后同步的写入器计数（LogWriter本身非线程安全）
+    std::atomic<uint64_t> records_written_{0};
+    std::atomic<uint64_t> bytes_written_{0};
+    std::atomic<uint64_t> image_raw_bytes_{0};
+    std::atomic<uint64_t> image_stored_bytes_{0};
+
+    // ROS接口
+    rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr image_sub_;
+    rclcpp::Subscription<sensor_msgs::msg::CameraInfo>::SharedPtr camera_info_sub_;
+    rclcpp::Subscription<rm_interfaces::msg::SerialReceiveData>::SharedPtr serial_sub_;
+    rclcpp::Subscription<rm_interfaces::msg::GimbalCmd>::SharedPtr gimbal_cmd_sub_;
+    rclcpp::TimerBase::SharedPtr stats_timer_;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include "rm_interfaces/msg/gimbal_cmd.hpp"
+#include "rm_interfaces/msg/serial_receive_data.hpp"
+#include "rm_recorder/log_reader.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 原始输入回放节点
+ *
+ * 按录制时刻的间隔（除以rate）回放 .rmlog，消息header.stamp保持录制时的原值。
+ * 图像发布到 /image_raw（数据取自BufferPool，检测节点用完归还），
+ * 相机内参以锁存方式发布到 /camera_info，串口数据发布到 /serial/receive；
+ * 录制的云台命令发布到 /replay/gimbal_cmd，便于与实时解算结果对比。
+ */
+class ReplayNode : public rclcpp::Node {
+public:
+    explicit ReplayNode(const rclcpp::NodeOptions& options);
+    ~ReplayNode() override;
+
+private:
+    /**
+     * @brief 回放线程
+     */
+    void replayLoop();
+
+    /**
+     * @brief 等待到steady时刻target，期间可被停止打断
+     * @return 被停止时返回false
+     */
+    bool waitUntil(std::chrono::steady_clock::time_point target);
+
+    /**
+     * @brief 发布一条记录
+     */
+    void publishRecord(const RecordView& record);
+
+    void publishImage(const RecordView& record);
+
+    template <typename MsgT>
+    bool deserialize(const RecordView& record, MsgT& msg);
+
+    LogReader reader_;
+    double rate_;         // 回放倍速，<=0 为尽快回放
+    bool loop_;
+    double start_offset_s_;
+    size_t buffer_pool_size_;
+    bool pool_reserved_ = false;
+
+    std::atomic<bool> running_{false};
+    std::thread replay_thread_;
+
+    // 统计
+    uint64_t published_ = 0;
+    uint64_t decode_failures_ = 0;
+
+    // ROS接口
+    rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr image_pub_;
+    rclcpp::Publisher<sensor_msgs::msg::CameraInfo>::SharedPtr camera_info_pub_;
+    rclcpp::Publisher<rm_interfaces::msg::SerialReceiveData>::SharedPtr serial_pub_;
+    rclcpp::Publisher<rm_interfaces::msg::GimbalCmd>::SharedPtr gimbal_cmd_pub_;
+};
+
+}  // namespace rm_auto_aim
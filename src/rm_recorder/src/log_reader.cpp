@@ -0,0 +1,171 @@
+#include "rm_recorder/log_reader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef RM_RECORDER_WITH_LZ4
+#include <lz4.h>
+#endif
+
+namespace rm_auto_aim {
+
+LogReader::~LogReader() {
+    close();
+}
+
+bool LogReader::open(const std::string& path, std::string* error) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (error) *error = "open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        if (error) *error = path + ": not a log file";
+        ::close(fd);
+        return false;
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+    void* ptr = mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        if (error) *error = "mmap " + path + ": " + std::strerror(errno);
+        bytes_ = 0;
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(ptr);
+    madvise(ptr, bytes_, MADV_SEQUENTIAL);
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || header.version != LOG_VERSION) {
+        if (error) *error = path + ": bad magic or version";
+        close();
+        return false;
+    }
+    // 未正常关闭时文件尾部是预分配的零页，按扫描结果截断
+    closed_cleanly_ = header.data_end != 0 && header.data_end <= bytes_;
+    if (closed_cleanly_) {
+        bytes_ = header.data_end;
+    }
+
+    if (!closed_cleanly_ || !loadIndex(path + ".idx")) {
+        scanIndex();
+    }
+    return true;
+}
+
+void LogReader::close() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), bytes_);
+        data_ = nullptr;
+    }
+    bytes_ = 0;
+    closed_cleanly_ = false;
+    index_.clear();
+}
+
+bool LogReader::loadIndex(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    index_.clear();
+    IndexEntry entry;
+    while (std::fread(&entry, sizeof(entry), 1, file) == 1) {
+        index_.push_back(entry);
+    }
+    std::fclose(file);
+
+    // 抽查：每条索引必须指向同类型的有效记录头
+    for (const auto& e : index_) {
+        RecordHeader header;
+        if (e.offset + sizeof(RecordHeader) + e.payload_bytes > bytes_) {
+            return false;
+        }
+        std::memcpy(&header, data_ + e.offset, sizeof(header));
+        if (header.magic != RECORD_MAGIC || header.type != e.type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LogReader::scanIndex() {
+    index_.clear();
+    size_t offset = sizeof(FileHeader);
+    while (offset + sizeof(RecordHeader) <= bytes_) {
+        RecordHeader header;
+        std::memcpy(&header, data_ + offset, sizeof(header));
+        if (header.magic != RECORD_MAGIC ||
+            offset + sizeof(RecordHeader) + header.payload_bytes > bytes_) {
+            break;
+        }
+        IndexEntry entry{};
+        entry.log_time_ns = header.log_time_ns;
+        entry.offset = offset;
+        entry.type = header.type;
+        entry.flags = header.flags;
+        entry.payload_bytes = header.payload_bytes;
+        index_.push_back(entry);
+        offset += alignRecord(sizeof(RecordHeader) + header.payload_bytes);
+    }
+}
+
+bool LogReader::record(size_t i, RecordView& out) const {
+    if (i >= index_.size()) {
+        return false;
+    }
+    RecordHeader header;
+    std::memcpy(&header, data_ + index_[i].offset, sizeof(header));
+    out.type = static_cast<RecordType>(header.type);
+    out.flags = header.flags;
+    out.log_time_ns = header.log_time_ns;
+    out.payload = data_ + index_[i].offset + sizeof(RecordHeader);
+    out.payload_bytes = header.payload_bytes;
+    out.raw_bytes = header.raw_bytes;
+    return true;
+}
+
+size_t LogReader::seek(int64_t log_time_ns) const {
+    const auto it = std::lower_bound(
+        index_.begin(), index_.end(), log_time_ns,
+        [](const IndexEntry& e, int64_t t) { return e.log_time_ns < t; });
+    return static_cast<size_t>(it - index_.begin());
+}
+
+bool LogReader::decodeImage(const RecordView& record, ImageMeta& meta, uint8_t* dst, size_t dst_bytes) {
+    if (record.type != RecordType::IMAGE || record.payload_bytes < sizeof(ImageMeta) ||
+        dst_bytes < record.raw_bytes) {
+        return false;
+    }
+    std::memcpy(&meta, record.payload, sizeof(meta));
+    const uint8_t* src = record.payload + sizeof(ImageMeta);
+    const size_t stored = record.payload_bytes - sizeof(ImageMeta);
+
+    if (record.flags & RECORD_FLAG_LZ4) {
+#ifdef RM_RECORDER_WITH_LZ4
+        const int n = LZ4_decompress_safe(
+            reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst), static_cast<int>(stored),
+            static_cast<int>(record.raw_bytes));
+        return n == static_cast<int>(record.raw_bytes);
+#else
+        return false;  // 本机编译时未启用LZ4
+#endif
+    }
+    if (stored != record.raw_bytes) {
+        return false;
+    }
+    std::memcpy(dst, src, stored);
+    return true;
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,254 @@
+#include "rm_recorder/log_writer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef RM_RECORDER_WITH_LZ4
+#include <lz4.h>
+#endif
+
+namespace rm_auto_aim {
+
+namespace {
+
+size_t pageSize() {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+void setError(std::string* error, const std::string& what) {
+    if (error) {
+        *error = what + ": " + std::strerror(errno);
+    }
+}
+
+}  // namespace
+
+LogWriter::~LogWriter() {
+    close();
+}
+
+bool LogWriter::compressionAvailable() {
+#ifdef RM_RECORDER_WITH_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LogWriter::open(const std::string& path, const LogWriterOptions& options, std::string* error) {
+    close();
+    path_ = path;
+    options_ = options;
+    // 块大小至少1MB且按页对齐
+    options_.chunk_bytes = std::max<size_t>(options_.chunk_bytes, 1u << 20);
+    options_.chunk_bytes = (options_.chunk_bytes + pageSize() - 1) / pageSize() * pageSize();
+    if (!compressionAvailable()) {
+        options_.compress_images = false;
+    }
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        setError(error, "open " + path);
+        return false;
+    }
+    index_file_ = std::fopen((path + ".idx").c_str(), "wb");
+    if (!index_file_) {
+        setError(error, "open " + path + ".idx");
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    file_bytes_ = 0;
+    write_pos_ = 0;
+    record_count_ = 0;
+    start_time_ns_ = end_time_ns_ = 0;
+    image_raw_bytes_ = image_stored_bytes_ = 0;
+    if (!mapFrom(0, sizeof(FileHeader))) {
+        setError(error, "map " + path);
+        close();
+        return false;
+    }
+
+    // 文件头先写入data_end=0，正常关闭时再回填
+    FileHeader header{};
+    std::memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+    header.version = LOG_VERSION;
+    header.header_bytes = sizeof(FileHeader);
+    std::memcpy(map_, &header, sizeof(header));
+    write_pos_ = sizeof(FileHeader);
+    return true;
+}
+
+void LogWriter::close() {
+    if (fd_ < 0) {
+        return;
+    }
+    unmap();
+    if (index_file_) {
+        std::fclose(index_file_);
+        index_file_ = nullptr;
+    }
+
+    // 截掉预分配的尾部空间，回填文件头
+    if (ftruncate(fd_, static_cast<off_t>(write_pos_)) == 0) {
+        FileHeader header{};
+        std::memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+        header.version = LOG_VERSION;
+        header.header_bytes = sizeof(FileHeader);
+        header.data_end = write_pos_;
+        header.record_count = record_count_;
+        header.start_time_ns = start_time_ns_;
+        header.end_time_ns = end_time_ns_;
+        if (pwrite(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+            // 文件头未回填时读取端按未正常关闭处理（扫描恢复）
+        }
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool LogWriter::mapFrom(uint64_t offset, size_t min_bytes) {
+    unmap();
+    // 映射起点页对齐，覆盖[offset, offset + min_bytes)并至少一个块
+    const uint64_t aligned = offset / pageSize() * pageSize();
+    const size_t head = static_cast<size_t>(offset - aligned);
+    size_t bytes = std::max(options_.chunk_bytes, head + min_bytes);
+    bytes = (bytes + pageSize() - 1) / pageSize() * pageSize();
+
+    const uint64_t end = aligned + bytes;
+    if (end > file_bytes_) {
+        // 预分配磁盘块，避免写映射内存时在缺页路径上分配
+        if (posix_fallocate(fd_, static_cast<off_t>(file_bytes_),
+                            static_cast<off_t>(end - file_bytes_)) != 0 &&
+            ftruncate(fd_, static_cast<off_t>(end)) != 0) {
+            return false;
+        }
+        file_bytes_ = end;
+    }
+
+    void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(aligned));
+    if (ptr == MAP_FAILED) {
+        return false;
+    }
+    madvise(ptr, bytes, MADV_SEQUENTIAL);
+    map_ = static_cast<uint8_t*>(ptr);
+    map_offset_ = aligned;
+    map_bytes_ = bytes;
+    return true;
+}
+
+void LogWriter::unmap() {
+    if (map_) {
+        // 异步回写：不等待磁盘，页缓存由内核按需刷出
+        msync(map_, map_bytes_, MS_ASYNC);
+        munmap(map_, map_bytes_);
+        map_ = nullptr;
+        map_bytes_ = 0;
+    }
+}
+
+uint8_t* LogWriter::reserve(size_t bytes) {
+    if (write_pos_ + bytes > map_offset_ + map_bytes_) {
+        if (!mapFrom(write_pos_, bytes)) {
+            return nullptr;
+        }
+    }
+    return map_ + (write_pos_ - map_offset_);
+}
+
+void LogWriter::commit(
+    RecordType type, uint16_t flags, int64_t log_time_ns, uint8_t* record, size_t payload_bytes,
+    uint32_t raw_bytes) {
+    RecordHeader header{};
+    header.magic = RECORD_MAGIC;
+    header.type = static_cast<uint16_t>(type);
+    header.flags = flags;
+    header.log_time_ns = log_time_ns;
+    header.payload_bytes = static_cast<uint32_t>(payload_bytes);
+    header.raw_bytes = raw_bytes;
+    std::memcpy(record, &header, sizeof(header));
+
+    const size_t total = alignRecord(sizeof(RecordHeader) + payload_bytes);
+    // 对齐填充清零，保证扫描时下一条记录位置确定
+    std::memset(record + sizeof(RecordHeader) + payload_bytes, 0, total - sizeof(RecordHeader) - payload_bytes);
+
+    IndexEntry entry{};
+    entry.log_time_ns = log_time_ns;
+    entry.offset = write_pos_;
+    entry.type = header.type;
+    entry.flags = flags;
+    entry.payload_bytes = header.payload_bytes;
+    std::fwrite(&entry, sizeof(entry), 1, index_file_);
+
+    if (record_count_ == 0) {
+        start_time_ns_ = log_time_ns;
+    }
+    end_time_ns_ = log_time_ns;
+    ++record_count_;
+    write_pos_ += total;
+}
+
+bool LogWriter::append(RecordType type, int64_t log_time_ns, const void* payload, size_t bytes) {
+    if (fd_ < 0 || bytes > UINT32_MAX) {
+        return false;
+    }
+    uint8_t* record = reserve(alignRecord(sizeof(RecordHeader) + bytes));
+    if (!record) {
+        return false;
+    }
+    std::memcpy(record + sizeof(RecordHeader), payload, bytes);
+    commit(type, 0, log_time_ns, record, bytes, static_cast<uint32_t>(bytes));
+    return true;
+}
+
+bool LogWriter::appendImage(int64_t log_time_ns, const ImageMeta& meta, const uint8_t* data, size_t bytes) {
+    if (fd_ < 0 || bytes > UINT32_MAX - sizeof(ImageMeta)) {
+        return false;
+    }
+
+    size_t max_data = bytes;
+#ifdef RM_RECORDER_WITH_LZ4
+    if (options_.compress_images) {
+        max_data = std::max<size_t>(bytes, LZ4_compressBound(static_cast<int>(bytes)));
+    }
+#endif
+    uint8_t* record = reserve(alignRecord(sizeof(RecordHeader) + sizeof(ImageMeta) + max_data));
+    if (!record) {
+        return false;
+    }
+    uint8_t* payload = record + sizeof(RecordHeader);
+    std::memcpy(payload, &meta, sizeof(meta));
+    uint8_t* dst = payload + sizeof(ImageMeta);
+
+    size_t stored = bytes;
+    uint16_t flags = 0;
+#ifdef RM_RECORDER_WITH_LZ4
+    if (options_.compress_images) {
+        // 直接压缩进映射内存；无收益（噪声大的图像）时回退原样存储
+        const int n = LZ4_compress_default(
+            reinterpret_cast<const char*>(data), reinterpret_cast<char*>(dst), static_cast<int>(bytes),
+            static_cast<int>(max_data));
+        if (n > 0 && static_cast<size_t>(n) < bytes) {
+            stored = static_cast<size_t>(n);
+            flags |= RECORD_FLAG_LZ4;
+        }
+    }
+#endif
+    if (!(flags & RECORD_FLAG_LZ4)) {
+        std::memcpy(dst, data, bytes);
+    }
+
+    image_raw_bytes_ += bytes;
+    image_stored_bytes_ += stored;
+    commit(RecordType::IMAGE, flags, log_time_ns, record, sizeof(ImageMeta) + stored, static_cast<uint32_t>(bytes));
+    return true;
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,205 @@
+#include "rm_recorder/recorder_node.hpp"
+
+#include <rclcpp_components/register_node_macro.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+
+#include "rm_utils/buffer_pool.hpp"
+
+namespace rm_auto_aim {
+
+namespace {
+
+// 输出文件名：<prefix>_YYYYmmdd_HHMMSS.rmlog
+std::string makeLogPath(const std::string& dir, const std::string& prefix) {
+    const std::time_t now = std::time(nullptr);
+    std::tm tm{};
+    localtime_r(&now, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+    return (std::filesystem::path(dir) / (prefix + "_" + stamp + ".rmlog")).string();
+}
+
+void copyString(char* dst, size_t dst_size, const std::string& src) {
+    const size_t n = std::min(src.size(), dst_size - 1);
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+}  // namespace
+
+RecorderNode::RecorderNode(const rclcpp::NodeOptions& options)
+    : Node("recorder", options),
+      queue_(static_cast<size_t>(std::max<int64_t>(
+          2, this->declare_parameter("queue_depth", 64))))
+{
+    RCLCPP_INFO(get_logger(), "RecorderNode 初始化中...");
+
+    this->declare_parameter("output_dir", "/tmp/rm_logs");
+    this->declare_parameter("file_prefix", "auto_aim");
+    this->declare_parameter("chunk_mb", 256);
+    this->declare_parameter("compress_images", false);
+    this->declare_parameter("record_images", true);
+
+    const auto output_dir = this->get_parameter("output_dir").as_string();
+    LogWriterOptions writer_options;
+    writer_options.chunk_bytes = static_cast<size_t>(
+        std::max<int64_t>(1, this->get_parameter("chunk_mb").as_int())) << 20;
+    writer_options.compress_images = this->get_parameter("compress_images").as_bool();
+    if (writer_options.compress_images && !LogWriter::compressionAvailable()) {
+        RCLCPP_WARN(get_logger(), "编译时未启用LZ4，图像将不压缩存储");
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(output_dir, ec);
+    const auto path = makeLogPath(output_dir, this->get_parameter("file_prefix").as_string());
+    std::string error;
+    if (!writer_.open(path, writer_options, &error)) {
+        RCLCPP_ERROR(get_logger(), "无法创建日志: %s", error.c_str());
+        return;
+    }
+
+    running_ = true;
+    writer_thread_ = std::thread(&RecorderNode::writerLoop, this);
+
+    if (this->get_parameter("record_images").as_bool()) {
+        // 检测节点转交的用完的帧（独占所有权）：写完后数据缓冲区归还相机的缓冲区池
+        image_sub_ = this->create_subscription<sensor_msgs::msg::Image>(
+            "/armor_detector/image_tee", rclcpp::SensorDataQoS(),
+            [this](sensor_msgs::msg::Image::UniquePtr msg) {
+                std::shared_ptr<sensor_msgs::msg::Image> image(
+                    msg.release(), [](sensor_msgs::msg::Image* img) {
+                        BufferPool::global().release(std::move(img->data));
+                        delete img;
+                    });
+                enqueue(RecordType::IMAGE, std::move(image));
+            });
+    }
+
+    // 相机内参为锁存话题，进程内通信不支持transient_local
+    rclcpp::SubscriptionOptions cam_info_options;
+    cam_info_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+    camera_info_sub_ = this->create_subscription<sensor_msgs::msg::CameraInfo>(
+        "/camera_info", rclcpp::QoS(1).reliable().transient_local(),
+        [this](sensor_msgs::msg::CameraInfo::ConstSharedPtr msg) {
+            enqueue(RecordType::CAMERA_INFO, std::move(msg));
+        },
+        cam_info_options);
+
+    serial_sub_ = this->create_subscription<rm_interfaces::msg::SerialReceiveData>(
+        "/serial/receive", rclcpp::SensorDataQoS(),
+        [this](rm_interfaces::msg::SerialReceiveData::ConstSharedPtr msg) {
+            enqueue(RecordType::SERIAL_RECEIVE, std::move(msg));
+        });
+
+    gimbal_cmd_sub_ = this->create_subscription<rm_interfaces::msg::GimbalCmd>(
+        "/solver/gimbal_cmd", rclcpp::SensorDataQoS(),
+        [this](rm_interfaces::msg::GimbalCmd::ConstSharedPtr msg) {
+            enqueue(RecordType::GIMBAL_CMD, std::move(msg));
+        });
+
+    stats_timer_ = this->create_wall_timer(
+        std::chrono::seconds(5), std::bind(&RecorderNode::reportStats, this));
+
+    RCLCPP_INFO(get_logger(), "RecorderNode 初始化完成，录制到 %s", path.c_str());
+}
+
+RecorderNode::~RecorderNode() {
+    running_ = false;
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    // 写完队列中剩余的消息再关闭文件
+    LogItem item;
+    while (queue_.tryPop(item)) {
+        writeItem(item);
+    }
+    writer_.close();
+}
+
+void RecorderNode::enqueue(RecordType type, std::shared_ptr<const void> msg) {
+    LogItem item;
+    item.type = type;
+    item.log_time_ns = this->now().nanoseconds();
+    item.msg = std::move(msg);
+    if (!queue_.tryPush(std::move(item))) {
+        dropped_[static_cast<size_t>(type)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RecorderNode::writerLoop() {
+    LogItem item;
+    while (queue_.popWait(item, running_)) {
+        writeItem(item);
+        item.msg.reset();  // 尽早释放消息内存
+        records_written_.store(writer_.recordCount(), std::memory_order_relaxed);
+        bytes_written_.store(writer_.bytesWritten(), std::memory_order_relaxed);
+        image_raw_bytes_.store(writer_.imageRawBytes(), std::memory_order_relaxed);
+        image_stored_bytes_.store(writer_.imageStoredBytes(), std::memory_order_relaxed);
+    }
+}
+
+void RecorderNode::writeItem(const LogItem& item) {
+    bool ok = true;
+    switch (item.type) {
+        case RecordType::IMAGE: {
+            const auto& img = *static_cast<const sensor_msgs::msg::Image*>(item.msg.get());
+            ImageMeta meta{};
+            meta.stamp_ns = rclcpp::Time(img.header.stamp).nanoseconds();
+            meta.width = img.width;
+            meta.height = img.height;
+            meta.step = img.step;
+            meta.is_bigendian = img.is_bigendian;
+            copyString(meta.encoding, sizeof(meta.encoding), img.encoding);
+            copyString(meta.frame_id, sizeof(meta.frame_id), img.header.frame_id);
+            ok = writer_.appendImage(item.log_time_ns, meta, img.data.data(), img.data.size());
+            break;
+        }
+        case RecordType::CAMERA_INFO:
+            writeSerialized(item.type, item.log_time_ns,
+                            *static_cast<const sensor_msgs::msg::CameraInfo*>(item.msg.get()));
+            return;
+        case RecordType::SERIAL_RECEIVE:
+            writeSerialized(item.type, item.log_time_ns,
+                            *static_cast<const rm_interfaces::msg::SerialReceiveData*>(item.msg.get()));
+            return;
+        case RecordType::GIMBAL_CMD:
+            writeSerialized(item.type, item.log_time_ns,
+                            *static_cast<const rm_interfaces::msg::GimbalCmd*>(item.msg.get()));
+            return;
+    }
+    if (!ok) {
+        write_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template <typename MsgT>
+void RecorderNode::writeSerialized(RecordType type, int64_t log_time_ns, const MsgT& msg) {
+    static const rclcpp::Serialization<MsgT> serializer;
+    serializer.serialize_message(&msg, &serialized_);
+    const auto& raw = serialized_.get_rcl_serialized_message();
+    if (!writer_.append(type, log_time_ns, raw.buffer, raw.buffer_length)) {
+        write_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RecorderNode::reportStats() {
+    const double mb = static_cast<double>(bytes_written_.load()) / (1 << 20);
+    const uint64_t raw = image_raw_bytes_.load();
+    const double ratio = raw > 0 ? static_cast<double>(image_stored_bytes_.load()) / raw : 1.0;
+    RCLCPP_INFO(get_logger(),
+                "已录制 %lu 条 / %.1f MB，图像压缩比 %.2f，队列 %zu，"
+                "丢弃 图像:%lu 串口:%lu 命令:%lu，写失败 %lu",
+                records_written_.load(), mb, ratio, queue_.sizeApprox(),
+                dropped_[static_cast<size_t>(RecordType::IMAGE)].load(),
+                dropped_[static_cast<size_t>(RecordType::SERIAL_RECEIVE)].load(),
+                dropped_[static_cast<size_t>(RecordType::GIMBAL_CMD)].load(),
+                write_failures_.load());
+}
+
+}  // namespace rm_auto_aim
+
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::RecorderNode)
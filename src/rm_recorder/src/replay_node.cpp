@@ -0,0 +1,195 @@
+#include "rm_recorder/replay_node.hpp"
+
+#include <rclcpp/serialization.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include "rm_utils/buffer_pool.hpp"
+
+namespace rm_auto_aim {
+
+ReplayNode::ReplayNode(const rclcpp::NodeOptions& options)
+    : Node("replay", options)
+{
+    RCLCPP_INFO(get_logger(), "ReplayNode 初始化中...");
+
+    this->declare_parameter("log_path", "");
+    this->declare_parameter("rate", 1.0);
+    this->declare_parameter("loop", false);
+    this->declare_parameter("start_offset_s", 0.0);
+    this->declare_parameter("publish_gimbal_cmd", true);
+    this->declare_parameter("buffer_pool_size", 4);
+
+    const auto log_path = this->get_parameter("log_path").as_string();
+    rate_ = this->get_parameter("rate").as_double();
+    loop_ = this->get_parameter("loop").as_bool();
+    start_offset_s_ = this->get_parameter("start_offset_s").as_double();
+    buffer_pool_size_ = static_cast<size_t>(
+        std::max<int64_t>(1, this->get_parameter("buffer_pool_size").as_int()));
+
+    std::string error;
+    if (!reader_.open(log_path, &error)) {
+        RCLCPP_ERROR(get_logger(), "无法打开日志: %s", error.c_str());
+        return;
+    }
+    if (!reader_.closedCleanly()) {
+        RCLCPP_WARN(get_logger(), "日志未正常关闭，已扫描恢复 %zu 条记录", reader_.size());
+    }
+
+    image_pub_ = this->create_publisher<sensor_msgs::msg::Image>(
+        "/image_raw", rclcpp::SensorDataQoS());
+
+    // 与相机驱动一致：锁存发布，关闭进程内通信
+    rclcpp::PublisherOptions camera_info_options;
+    camera_info_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+    camera_info_pub_ = this->create_publisher<sensor_msgs::msg::CameraInfo>(
+        "/camera_info", rclcpp::QoS(1).reliable().transient_local(), camera_info_options);
+
+    serial_pub_ = this->create_publisher<rm_interfaces::msg::SerialReceiveData>(
+        "/serial/receive", rclcpp::SensorDataQoS());
+    if (this->get_parameter("publish_gimbal_cmd").as_bool()) {
+        gimbal_cmd_pub_ = this->create_publisher<rm_interfaces::msg::GimbalCmd>(
+            "/replay/gimbal_cmd", rclcpp::SensorDataQoS());
+    }
+
+    running_ = true;
+    replay_thread_ = std::thread(&ReplayNode::replayLoop, this);
+
+    RCLCPP_INFO(get_logger(), "ReplayNode 初始化完成: %s, %zu 条记录, %.1f s, 倍速 %.2f (<=0为尽快)",
+                log_path.c_str(), reader_.size(),
+                (reader_.endTimeNs() - reader_.startTimeNs()) * 1e-9, rate_);
+}
+
+ReplayNode::~ReplayNode() {
+    running_ = false;
+    if (replay_thread_.joinable()) {
+        replay_thread_.join();
+    }
+}
+
+void ReplayNode::replayLoop() {
+    const int64_t start_ns = reader_.startTimeNs() + static_cast<int64_t>(start_offset_s_ * 1e9);
+    const size_t first = reader_.seek(start_ns);
+
+    do {
+        const auto wall_start = std::chrono::steady_clock::now();
+        for (size_t i = first; i < reader_.size() && running_; i++) {
+            RecordView record;
+            if (!reader_.record(i, record)) {
+                continue;
+            }
+            if (rate_ > 0.0) {
+                // 按录制间隔/倍速定时；记录时间回退时立即发布
+                const auto offset = std::chrono::nanoseconds(static_cast<int64_t>(
+                    std::max<int64_t>(0, record.log_time_ns - start_ns) / rate_));
+                if (!waitUntil(wall_start + offset)) {
+                    break;
+                }
+            }
+            publishRecord(record);
+        }
+        const double elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - wall_start).count();
+        RCLCPP_INFO(get_logger(), "回放一轮完成: 已发布 %lu 条, 解码失败 %lu, 用时 %.2f s",
+                    published_, decode_failures_, elapsed);
+    } while (loop_ && running_);
+}
+
+bool ReplayNode::waitUntil(std::chrono::steady_clock::time_point target) {
+    // 分段睡眠，节点析构时不必等待长间隔结束
+    constexpr auto kSlice = std::chrono::milliseconds(100);
+    while (running_) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= target) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(target - now, kSlice));
+    }
+    return false;
+}
+
+void ReplayNode::publishRecord(const RecordView& record) {
+    switch (record.type) {
+        case RecordType::IMAGE:
+            publishImage(record);
+            return;
+        case RecordType::CAMERA_INFO: {
+            sensor_msgs::msg::CameraInfo msg;
+            if (deserialize(record, msg)) {
+                camera_info_pub_->publish(msg);
+                published_++;
+            }
+            return;
+        }
+        case RecordType::SERIAL_RECEIVE: {
+            auto msg = std::make_unique<rm_interfaces::msg::SerialReceiveData>();
+            if (deserialize(record, *msg)) {
+                serial_pub_->publish(std::move(msg));
+                published_++;
+            }
+            return;
+        }
+        case RecordType::GIMBAL_CMD: {
+            if (!gimbal_cmd_pub_) {
+                return;
+            }
+            auto msg = std::make_unique<rm_interfaces::msg::GimbalCmd>();
+            if (deserialize(record, *msg)) {
+                gimbal_cmd_pub_->publish(std::move(msg));
+                published_++;
+            }
+            return;
+        }
+    }
+}
+
+void ReplayNode::publishImage(const RecordView& record) {
+    auto& pool = BufferPool::global();
+    if (!pool_reserved_) {
+        pool.reserve(buffer_pool_size_, record.raw_bytes);
+        pool_reserved_ = true;
+    }
+
+    auto msg = std::make_unique<sensor_msgs::msg::Image>();
+    msg->data = pool.acquire(record.raw_bytes);
+    ImageMeta meta;
+    if (!LogReader::decodeImage(record, meta, msg->data.data(), msg->data.size())) {
+        pool.release(std::move(msg->data));
+        decode_failures_++;
+        return;
+    }
+
+    // 原样恢复录制时的时间戳
+    msg->header.stamp = rclcpp::Time(meta.stamp_ns);
+    msg->header.frame_id = meta.frame_id;
+    msg->width = meta.width;
+    msg->height = meta.height;
+    msg->step = meta.step;
+    msg->is_bigendian = meta.is_bigendian;
+    msg->encoding = meta.encoding;
+    image_pub_->publish(std::move(msg));
+    published_++;
+}
+
+template <typename MsgT>
+bool ReplayNode::deserialize(const RecordView& record, MsgT& msg) {
+    static const rclcpp::Serialization<MsgT> serializer;
+    rclcpp::SerializedMessage serialized(record.payload_bytes);
+    auto& raw = serialized.get_rcl_serialized_message();
+    std::memcpy(raw.buffer, record.payload, record.payload_bytes);
+    raw.buffer_length = record.payload_bytes;
+    try {
+        serializer.deserialize_message(&serialized, &msg);
+    } catch (const std::exception& e) {
+        RCLCPP_WARN_THROTTLE(get_logger(), *get_clock(), 1000, "反序列化失败: %s", e.what());
+        decode_failures_++;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace rm_auto_aim
+
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_auto_aim::ReplayNode)
@@ -0,0 +1,3 @@
+# 导入目标：rm_utils::rm_utils 与 rm_utils::rm_alloc_hooks（分配计数钩子，按需显式链接）
+find_package(Threads REQUIRED)
+include("${rm_utils_DIR}/export_rm_utilsExport.cmake")
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 分配计数的作用域标签（按流水线阶段划分）
+ */
+enum class AllocTag : uint8_t {
+    OTHER = 0,    // 未标记的作用域
+    CAPTURE,      // 采集/图像发布
+    DETECT,       // 检测 + PnP + 检测结果发布
+    SOLVE,        // 跟踪 + 补偿 + 命令发布
+    COUNT
+};
+
+constexpr size_t ALLOC_TAG_COUNT = static_cast<size_t>(AllocTag::COUNT);
+
+const char* allocTagName(AllocTag tag);
+
+/**
+ * @brief 分配计数（次数与字节数）
+ */
+struct AllocCounters {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+
+    AllocCounters operator-(const AllocCounters& other) const {
+        return {allocs - other.allocs, frees - other.frees, bytes - other.bytes};
+    }
+};
+
+/**
+ * @brief 进程级堆分配计数
+ *
+ * 计数本身由可选的 librm_alloc_hooks.so 驱动：该库替换 malloc/calloc/realloc/
+ * memalign/free（operator new 最终也走 malloc），每次分配调用 onAlloc()。
+ * 未加载该库时所有计数保持为0，hooksActive()为false，其余代码无需区分。
+ * 加载方式: LD_PRELOAD=<prefix>/lib/librm_alloc_hooks.so，或可执行文件直接链接。
+ *
+ * 计数按三个维度累加，全部为relaxed原子或线程局部变量，分配路径上不会再分配：
+ *   - 线程：threadCounters() 返回调用线程自启动以来的计数
+ *   - 标签：AllocScope 设置的当前线程作用域标签
+ *   - 具名线程：registerThread() 登记后可在 threads() 中按名字查看
+ */
+class AllocTracker {
+public:
+    static constexpr size_t MAX_THREADS = 64;
+
+    struct ThreadEntry {
+        std::string name;
+        AllocCounters counters;
+    };
+
+    /**
+     * @brief 每帧分配统计（由各阶段在帧结束时记录）
+     */
+    struct FrameStats {
+        uint64_t frames = 0;
+        uint64_t allocs = 0;       // 累计分配次数
+        uint64_t bytes = 0;        // 累计分配字节数
+        uint64_t max_allocs = 0;   // 单帧最大分配次数（读取时清零，即两次读取之间的窗口最大值）
+    };
+
+    static bool hooksActive() noexcept;
+
+    // 仅供分配钩子调用
+    static void markHooksActive() noexcept;
+    static void onAlloc(size_t bytes) noexcept;
+    static void onFree() noexcept;
+
+    static AllocCounters threadCounters() noexcept;
+    static AllocCounters tagCounters(AllocTag tag) noexcept;
+
+    /**
+     * @brief 为调用线程分配具名计数槽（超过MAX_THREADS后不再登记）
+     */
+    static void registerThread(const std::string& name);
+    static std::vector<ThreadEntry> threads();
+
+    static void recordFrame(AllocTag tag, const AllocCounters& frame) noexcept;
+    static FrameStats frameStats(AllocTag tag) noexcept;
+};
+
+/**
+ * @brief 作用域标签（RAII）：作用域内调用线程的分配计入tag，析构时恢复外层标签
+ *
+ * record_frame为true时析构时把作用域内的分配作为一帧记录到 AllocTracker::recordFrame。
+ */
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag tag, bool record_frame = false) noexcept;
+    ~AllocScope();
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+    /**
+     * @brief 作用域开始以来调用线程的分配计数
+     */
+    AllocCounters delta() const noexcept { return AllocTracker::threadCounters() - start_; }
+
+private:
+    AllocTag tag_;
+    AllocTag prev_tag_;
+    bool record_frame_;
+    AllocCounters start_;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 进程级字节缓冲区池（用于图像消息数据复用）
+ *
+ * 相机节点从池中取出缓冲区写入图像，以unique_ptr发布；
+ * 进程内订阅者处理完后把缓冲区交还池中，稳态下不再分配/释放整帧内存。
+ * 组件容器中的所有节点共享同一个实例（global()），需编译为共享库。
+ *
+ * 取/还时短暂加锁，临界区只有vector移动与在途登记，相对整帧拷贝可忽略。
+ *
+ * 取出的缓冲区按数据地址登记为在途，归还时核对来源：进程内传递途中若被深拷贝
+ * （如同一话题混用UniquePtr与ConstSharedPtr订阅），订阅者归还的是拷贝而非池中缓冲区，
+ * 计为外来归还，原缓冲区则一直在途。两者均为0即说明采集→检测全程零拷贝。
+ */
+class BufferPool {
+public:
+    using Buffer = std::vector<uint8_t>;
+
+    /**
+     * @brief 进程内全局实例
+     */
+    static BufferPool& global();
+
+    /**
+     * @brief 预分配缓冲区
+     *
+     * 池中保留上限为各owner预留数之和（多路相机各自预留；同一owner重复预留只更新其份额）。
+     * 不同尺寸的缓冲区混用时，容量不足者在acquire中扩容一次后即按大尺寸复用。
+     * @param count 缓冲区数量
+     * @param bytes 每个缓冲区大小
+     * @param owner 预留者（如相机节点名）
+     */
+    void reserve(size_t count, size_t bytes, const std::string& owner = "");
+
+    /**
+     * @brief 取出一个大小为bytes的缓冲区
+     *
+     * 池中无可用缓冲区（或容量不足）时新分配，并计入miss。
+     */
+    Buffer acquire(size_t bytes);
+
+    /**
+     * @brief 归还缓冲区；超过保留上限时直接释放
+     *
+     * 不是由本池取出的缓冲区照常回收，并计入外来归还。
+     */
+    void release(Buffer&& buffer);
+
+    // 统计
+    size_t available() const;
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+    uint64_t acquires() const { return acquires_.load(std::memory_order_relaxed); }
+    uint64_t releases() const { return releases_.load(std::memory_order_relaxed); }
+    uint64_t foreignReleases() const { return foreign_releases_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 已取出尚未归还的缓冲区数量
+     */
+    size_t outstanding() const;
+
+private:
+    // 在途登记上限：超出时丢弃最早的登记（只会在缓冲区大量泄漏时发生）
+    static constexpr size_t MAX_IN_FLIGHT = 256;
+
+    mutable std::mutex mutex_;
+    std::vector<Buffer> free_;
+    std::vector<const uint8_t*> in_flight_;
+    std::map<std::string, size_t> reservations_;
+    size_t max_buffers_ = 0;
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> acquires_{0};
+    std::atomic<uint64_t> releases_{0};
+    std::atomic<uint64_t> foreign_releases_{0};
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 飞行记录器事件ID（离线解码器据此打印事件名和参数名，只可追加不可改号）
+ */
+enum class FlightEvent : uint16_t {
+    TRACKER_STATE = 1,   // 跟踪状态切换
+    TRACKER_MATCH = 2,   // 装甲板关联结果
+    EKF_INNOVATION = 3,  // EKF观测新息（观测 - 预测观测）
+    SERIAL_SEND = 4,     // 串口发送云台命令
+    SERIAL_RECEIVE = 5,  // 串口收到下位机数据
+    FRAME_DROPPED = 6,   // 检测邮箱覆盖丢帧
+    DUMP_REQUEST = 7,    // 请求转储
+};
+
+struct FlightEventInfo {
+    const char* name;
+    const char* args[4];  // 参数名，nullptr表示未使用
+};
+
+/**
+ * @brief 事件描述，未知ID返回名称为"unknown"的描述
+ */
+const FlightEventInfo& flightEventInfo(uint16_t id);
+
+enum class FlightDumpReason : uint8_t {
+    MANUAL = 0,        // 服务调用
+    SIGNAL = 1,        // SIGUSR1
+    TRACKER_LOST = 2,  // 跟踪器进入LOST
+};
+
+const char* flightDumpReasonName(FlightDumpReason reason);
+
+// 定长二进制记录（48字节）
+struct FlightRecord {
+    int64_t stamp_ns;     // CLOCK_REALTIME，与相机时间戳同一时基
+    uint16_t event;       // FlightEvent
+    uint16_t thread_id;   // 记录线程编号（转储文件中附线程名表）
+    uint32_t seq;         // 线程内序号（低32位）
+    double args[4];
+};
+static_assert(sizeof(FlightRecord) == 48, "FlightRecord必须为48字节");
+
+// 转储文件（.rmfr）: [FlightDumpHeader][FlightThreadInfo × thread_count][FlightRecord × record_count]
+constexpr char FLIGHT_DUMP_MAGIC[8] = {'R', 'M', 'F', 'R', 0, 0, 0, 1};
+
+struct FlightDumpHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t thread_count;
+    uint32_t reason;      // FlightDumpReason
+    uint64_t record_count;
+    int64_t dump_time_ns;
+};
+static_assert(sizeof(FlightDumpHeader) == 40, "FlightDumpHeader必须为40字节");
+
+struct FlightThreadInfo {
+    uint32_t id;
+    char name[20];
+};
+static_assert(sizeof(FlightThreadInfo) == 24, "FlightThreadInfo必须为24字节");
+
+/**
+ * @brief 常开的飞行记录器（进程级，不依赖ROS）
+ *
+ * 每个线程第一次记录时分配自己的环形缓冲区（单写者，无锁），
+ * record()只写一条定长记录并发布head，开销与一次CLOCK_REALTIME相当。
+ * 转储时逐个环拷贝并用前后两次head判定被覆盖的记录，按时间排序后写文件。
+ * requestDump()只写一个原子量，可在信号处理函数中调用；实际转储由后台线程完成。
+ * 线程退出后其环仍保留，转储可看到它生前的记录。
+ *
+ * 热路径请使用 RM_FLIGHT_RECORD / RM_FLIGHT_DUMP 宏，
+ * 编译时定义 RM_FLIGHT_RECORDER_DISABLED 后宏不产生任何代码，参数也不求值。
+ */
+class FlightRecorder {
+public:
+    static constexpr size_t kRingRecords = 16384;  // 每线程记录数（2的幂）
+
+    struct DumpConfig {
+        std::string output_dir = "/tmp/rm_flight";
+        double window_s = 10.0;               // 转储最近多少秒
+        double min_interval_s = 5.0;          // 跟踪丢失触发的最小转储间隔
+        bool dump_on_tracker_lost = true;
+        // 转储完成回调（后台线程调用）：文件路径、记录数（失败为-1）
+        std::function<void(const std::string&, long)> on_dump;
+    };
+
+    static FlightRecorder& global();
+
+    void record(FlightEvent event, double a0 = 0.0, double a1 = 0.0,
+                double a2 = 0.0, double a3 = 0.0) noexcept;
+
+    /**
+     * @brief 请求后台线程转储（异步信号安全）
+     */
+    void requestDump(FlightDumpReason reason) noexcept {
+        pending_reason_.store(static_cast<int>(reason), std::memory_order_relaxed);
+    }
+
+    void startDumper(const DumpConfig& config);
+    void stopDumper();
+
+    /**
+     * @brief 立即把最近window_s秒的记录写入path
+     * @return 写入的记录数，失败返回-1
+     */
+    long dump(const std::string& path, double window_s, FlightDumpReason reason) const;
+
+    /**
+     * @brief 按配置目录生成转储文件名 flight_<时间>_<原因>.rmfr
+     */
+    std::string makeDumpPath(FlightDumpReason reason) const;
+
+    const DumpConfig& config() const { return config_; }
+
+    ~FlightRecorder();
+
+private:
+    struct Ring {
+        std::array<FlightRecord, kRingRecords> records;
+        std::atomic<uint64_t> head{0};
+        uint16_t thread_id = 0;
+        char thread_name[20] = {};
+    };
+
+    FlightRecorder() = default;
+    Ring* threadRing();
+    void dumperLoop();
+
+    mutable std::mutex rings_mutex_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+
+    std::atomic<int> pending_reason_{-1};
+    std::atomic<bool> dumper_running_{false};
+    std::thread dumper_thread_;
+    DumpConfig config_;
+};
+
+}  // namespace rm_auto_aim
+
+#ifndef RM_FLIGHT_RECORDER_DISABLED
+#define RM_FLIGHT_RECORD(...) ::rm_auto_aim::FlightRecorder::global().record(__VA_ARGS__)
+#define RM_FLIGHT_DUMP(reason) ::rm_auto_aim::FlightRecorder::global().requestDump(reason)
+#else
+// 参数放在不求值的sizeof中：不产生代码，也不触发未使用变量告警
+#define RM_FLIGHT_RECORD(...) ((void)sizeof((__VA_ARGS__, 0)))
+#define RM_FLIGHT_DUMP(reason) ((void)sizeof(reason))
+#endif
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 无锁对数-线性延迟直方图（HDR风格，单位ns）
+ *
+ * 每个2的幂区间再等分为 2^kSubBucketBits 个子桶，相对误差不超过 1/32（约3%），
+ * 覆盖 0 ~ 2^40 ns（约18分钟），超出部分计入最后一个桶。
+ * record()只有两次relaxed原子加，可在任意线程常开；读取通过snapshot()拷贝，
+ * 两次快照相减即得到窗口内的分布。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int64_t kSubBuckets = int64_t{1} << kSubBucketBits;
+    static constexpr int kMaxBits = 40;
+    static constexpr size_t kBuckets = static_cast<size_t>((kMaxBits - kSubBucketBits + 1) * kSubBuckets);
+
+    struct Snapshot {
+        std::array<uint64_t, kBuckets> counts{};
+        uint64_t count = 0;
+        int64_t sum_ns = 0;
+
+        /**
+         * @brief 分位数（q∈[0,1]），返回所在桶的中值，无样本时为0
+         */
+        int64_t percentile(double q) const {
+            if (count == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBuckets; i++) {
+                seen += counts[i];
+                if (seen >= rank) return bucketMid(i);
+            }
+            return bucketMid(kBuckets - 1);
+        }
+
+        // 最大值所在桶的上界
+        int64_t max() const {
+            for (size_t i = kBuckets; i-- > 0;) {
+                if (counts[i] != 0) return bucketLower(i) + bucketWidth(i) - 1;
+            }
+            return 0;
+        }
+
+        double mean() const { return count > 0 ? static_cast<double>(sum_ns) / count : 0.0; }
+
+        // 窗口分布：当前快照减去较早的快照
+        Snapshot operator-(const Snapshot& earlier) const {
+            Snapshot diff;
+            for (size_t i = 0; i < kBuckets; i++) {
+                diff.counts[i] = counts[i] - earlier.counts[i];
+            }
+            diff.count = count - earlier.count;
+            diff.sum_ns = sum_ns - earlier.sum_ns;
+            return diff;
+        }
+    };
+
+    void record(int64_t ns) noexcept {
+        counts_[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns > 0 ? ns : 0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 拷贝当前计数（与record并发时为近似一致的快照）
+     */
+    Snapshot snapshot() const {
+        Snapshot s;
+        for (size_t i = 0; i < kBuckets; i++) {
+            s.counts[i] = counts_[i].load(std::memory_order_relaxed);
+            s.count += s.counts[i];
+        }
+        s.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    static size_t bucketIndex(int64_t ns) noexcept {
+        if (ns < kSubBuckets) {
+            return ns > 0 ? static_cast<size_t>(ns) : 0;
+        }
+        const uint64_t v = static_cast<uint64_t>(ns);
+        const int msb = 63 - __builtin_clzll(v);
+        if (msb >= kMaxBits) {
+            return kBuckets - 1;
+        }
+        const int shift = msb - kSubBucketBits;
+        return static_cast<size_t>((shift + 1) * kSubBuckets + static_cast<int64_t>(v >> shift) - kSubBuckets);
+    }
+
+    static int64_t bucketLower(size_t index) noexcept {
+        const int64_t i = static_cast<int64_t>(index);
+        if (i < kSubBuckets) return i;
+        const int shift = static_cast<int>(i / kSubBuckets) - 1;
+        return (kSubBuckets + i % kSubBuckets) << shift;
+    }
+
+    static int64_t bucketWidth(size_t index) noexcept {
+        const int64_t i = static_cast<int64_t>(index);
+        return i < kSubBuckets ? 1 : int64_t{1} << (i / kSubBuckets - 1);
+    }
+
+    static int64_t bucketMid(size_t index) noexcept {
+        return bucketLower(index) + bucketWidth(index) / 2;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<int64_t> sum_ns_{0};
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "rm_utils/latency_histogram.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 关键路径上的计时点（按流水线先后顺序）
+ */
+enum class TraceStage : uint8_t {
+    CAPTURE = 0,       // 相机发布/交给检测（相对曝光时刻即采集延迟）
+    DETECT_START,      // 检测开始
+    DETECT_END,        // 灯条/装甲板检测完成
+    PNP_DONE,          // PnP解算完成、检测结果发出
+    TRACKER_UPDATE,    // 跟踪器（EKF）更新完成
+    COMPENSATION,      // 瞄准点选择+弹道补偿完成
+    COMMAND_PUBLISH,   // 云台命令发出
+    SERIAL_WRITE,      // 串口write()返回
+    COUNT
+};
+
+constexpr size_t TRACE_STAGE_COUNT = static_cast<size_t>(TraceStage::COUNT);
+
+const char* traceStageName(TraceStage stage);
+
+/**
+ * @brief 进程级端到端延迟追踪
+ *
+ * 以帧的采集时间戳（header.stamp，随Image→CompactArmors→Target/GimbalCmd一路传递）
+ * 作为帧序号。每个计时点记录两类无锁直方图：
+ *   - sinceCapture: 从曝光（采集时间戳）到该计时点，即端到端累计延迟
+ *   - stageDelta:   该帧上一个已记录计时点到该计时点的耗时
+ * 上一计时点的时刻保存在按帧号散列的小环形表中，跨线程只有relaxed原子读写。
+ * mark()开销为一次CLOCK_REALTIME（vDSO）加数次原子操作，比赛中可常开。
+ *
+ * 时间基准与相机时间戳一致（ROS系统时间）；回放旧日志时sinceCapture无意义，
+ * stageDelta仍然有效。帧时间戳不是真实采集时刻时（如视频锁步的合成时间戳），
+ * 由时间戳的产生者关闭sinceCapture。组件容器内所有节点共享同一实例（global()）。
+ */
+class LatencyTracer {
+public:
+    static LatencyTracer& global();
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 是否记录sinceCapture（关闭时stageDelta照常记录）
+     */
+    void setSinceCaptureEnabled(bool enabled) {
+        since_capture_enabled_.store(enabled, std::memory_order_relaxed);
+    }
+    bool sinceCaptureEnabled() const {
+        return since_capture_enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 记录帧frame_stamp_ns到达stage（时间戳<=0的合成帧如启动预热帧不计入）
+     */
+    void mark(TraceStage stage, int64_t frame_stamp_ns) noexcept {
+        if (enabled() && frame_stamp_ns > 0) {
+            mark(stage, frame_stamp_ns, nowNs());
+        }
+    }
+    void mark(TraceStage stage, int64_t frame_stamp_ns, int64_t now_ns) noexcept;
+
+    const LatencyHistogram& sinceCapture(TraceStage stage) const {
+        return since_capture_[static_cast<size_t>(stage)];
+    }
+    const LatencyHistogram& stageDelta(TraceStage stage) const {
+        return stage_delta_[static_cast<size_t>(stage)];
+    }
+
+    // 与相机时间戳同一时基的当前时刻
+    static int64_t nowNs() noexcept {
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+private:
+    // 最近若干帧各计时点的时刻（按帧号散列，覆盖旧帧）
+    static constexpr size_t kFrameSlots = 64;
+    struct FrameSlot {
+        std::atomic<int64_t> frame{-1};
+        std::array<std::atomic<int64_t>, TRACE_STAGE_COUNT> stamps{};
+    };
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<bool> since_capture_enabled_{true};
+    std::array<FrameSlot, kFrameSlots> slots_;
+    std::array<LatencyHistogram, TRACE_STAGE_COUNT> since_capture_;
+    std::array<LatencyHistogram, TRACE_STAGE_COUNT> stage_delta_;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 单槽“最新者胜”邮箱
+ *
+ * 生产者put时直接覆盖尚未被取走的旧值，并把被覆盖的值交还调用方
+ * （用于归还缓冲区和统计丢帧）；消费者take阻塞等待新值。
+ * 消费者拿到的永远是最新一帧，排队延迟至多一帧处理时间。
+ * T需可默认构造、可移动并能转换为bool（如unique_ptr），空值表示槽为空。
+ */
+template <typename T>
+class LatestMailbox {
+public:
+    /**
+     * @brief 放入新值
+     * @return 被覆盖的旧值（槽原本为空时返回空值）
+     */
+    T put(T&& value) {
+        T displaced;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            displaced = std::exchange(slot_, std::move(value));
+        }
+        cv_.notify_one();
+        return displaced;
+    }
+
+    /**
+     * @brief 阻塞取出最新值
+     * @return 取到返回true，邮箱关闭返回false
+     */
+    bool take(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return static_cast<bool>(slot_) || closed_; });
+        if (closed_) {
+            return false;
+        }
+        out = std::move(slot_);
+        slot_ = T{};
+        return true;
+    }
+
+    /**
+     * @brief 关闭邮箱，唤醒等待中的消费者；返回槽中残留值
+     */
+    T close() {
+        T remaining;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            remaining = std::move(slot_);
+            slot_ = T{};
+        }
+        cv_.notify_all();
+        return remaining;
+    }
+
+    /**
+     * @brief 重新打开已关闭的邮箱（消费者线程重启前调用）
+     */
+    void reopen() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = false;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    T slot_{};
+    bool closed_ = false;
+};
+
+/**
+ * @brief 多路“最新者胜”邮箱组（多路输入、多个消费者）
+ *
+ * 每路一个单槽，覆盖语义同LatestMailbox。消费者take时在所有有值且未被占用的路中
+ * 取最早放入的一路，并占用该路直到done()：同一路的帧按到达顺序、至多由一个消费者处理，
+ * 不同路可由多个消费者并行处理，每路的排队延迟仍至多一帧处理时间。
+ */
+template <typename T>
+class LatestMailboxGroup {
+public:
+    /**
+     * @brief 设置路数（须在没有消费者时调用，清空所有槽）
+     */
+    void resize(size_t lanes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lanes_.clear();
+        lanes_.resize(lanes);
+    }
+
+    size_t size() const { return lanes_.size(); }
+
+    /**
+     * @brief 向第lane路放入新值
+     * @return 被覆盖的旧值（槽原本为空时返回空值）
+     */
+    T put(size_t lane, T&& value) {
+        T displaced;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& target = lanes_[lane];
+            displaced = std::exchange(target.slot, std::move(value));
+            target.seq = ++next_seq_;
+        }
+        cv_.notify_one();
+        return displaced;
+    }
+
+    /**
+     * @brief 阻塞取出最早放入且未被占用的一路，并占用该路
+     * @param lane 输出取到的路号，处理完后须调用done(lane)
+     * @return 取到返回true，邮箱组关闭返回false
+     */
+    bool take(T& out, size_t& lane) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            if (closed_) {
+                return false;
+            }
+            size_t best = lanes_.size();
+            for (size_t i = 0; i < lanes_.size(); i++) {
+                const auto& candidate = lanes_[i];
+                if (candidate.slot && !candidate.busy &&
+                    (best == lanes_.size() || candidate.seq < lanes_[best].seq)) {
+                    best = i;
+                }
+            }
+            if (best < lanes_.size()) {
+                out = std::move(lanes_[best].slot);
+                lanes_[best].slot = T{};
+                lanes_[best].busy = true;
+                lane = best;
+                return true;
+            }
+            cv_.wait(lock);
+        }
+    }
+
+    /**
+     * @brief 释放take占用的路（该路期间到达的新值可被其他消费者取走）
+     */
+    void done(size_t lane) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lanes_[lane].busy = false;
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief 关闭邮箱组，唤醒所有消费者；返回各路残留值（下标即路号，无残留的路为空值）
+     */
+    std::vector<T> close() {
+        std::vector<T> remaining;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            remaining.resize(lanes_.size());
+            for (size_t i = 0; i < lanes_.size(); i++) {
+                remaining[i] = std::move(lanes_[i].slot);
+                lanes_[i].slot = T{};
+                lanes_[i].busy = false;
+            }
+        }
+        cv_.notify_all();
+        return remaining;
+    }
+
+    /**
+     * @brief 重新打开已关闭的邮箱组（消费者线程重启前调用）
+     */
+    void reopen() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = false;
+    }
+
+private:
+    struct Lane {
+        T slot{};
+        uint64_t seq = 0;    // 放入序号，越小越早
+        bool busy = false;   // 正被某个消费者处理
+    };
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Lane> lanes_;
+    uint64_t next_seq_ = 0;
+    bool closed_ = false;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief RCU式不可变配置单元（多读者、写者互斥）
+ *
+ * 写者构造完整的新配置对象后用一次原子指针交换发布，读者只会看到旧版本或新版本，
+ * 不会看到更新到一半的配置。读者在热路径上只做原子读写（无锁、无分配）：
+ * 每个读者线程持有一个Reader，读取时在自己的槽中登记当前纪元，读完清零；
+ * 写者把被替换的旧对象挂到退役表，待所有登记纪元都晚于其退役纪元后再释放
+ * （释放只发生在写者一侧，即publish()调用方）。
+ *
+ * 每个版本带递增版本号，读者可据此只在配置变化时重建派生状态。
+ * 用法：热路径每帧取一次快照并在本帧内使用，不要跨帧持有ReadGuard，否则旧版本迟迟不能释放。
+ */
+template <typename T>
+class RcuCell {
+    struct Node {
+        T value;
+        uint64_t version;
+    };
+
+public:
+    /**
+     * @brief 读快照：析构时结束本次读取
+     */
+    class ReadGuard {
+    public:
+        ReadGuard(std::atomic<uint64_t>* slot, const Node* node) : slot_(slot), node_(node) {}
+        ~ReadGuard() {
+            if (slot_) {
+                slot_->store(0, std::memory_order_release);
+            }
+        }
+        ReadGuard(ReadGuard&& other) noexcept
+            : slot_(std::exchange(other.slot_, nullptr)), node_(other.node_) {}
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        const T& operator*() const { return node_->value; }
+        const T* operator->() const { return &node_->value; }
+        uint64_t version() const { return node_->version; }
+
+    private:
+        std::atomic<uint64_t>* slot_;
+        const Node* node_;
+    };
+
+    /**
+     * @brief 读者句柄（每个读者线程一个，构造/析构在热路径之外）
+     */
+    class Reader {
+    public:
+        explicit Reader(RcuCell& cell) : cell_(&cell), slot_(cell.registerReader()) {}
+        ~Reader() {
+            if (cell_) {
+                cell_->unregisterReader(slot_);
+            }
+        }
+        Reader(Reader&& other) noexcept
+            : cell_(std::exchange(other.cell_, nullptr)), slot_(other.slot_) {}
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        /**
+         * @brief 取当前配置快照（无锁；未发布过配置时不可调用）
+         */
+        ReadGuard read() const {
+            // 先登记纪元再读指针（均为seq_cst）：写者要么看到登记而推迟释放，
+            // 要么其交换先于本次读取，本次必然读到新指针
+            slot_->store(cell_->epoch_.load());
+            return ReadGuard(slot_, cell_->current_.load());
+        }
+
+    private:
+        RcuCell* cell_;
+        std::atomic<uint64_t>* slot_;
+    };
+
+    RcuCell() = default;
+
+    ~RcuCell() {
+        delete current_.load();
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    /**
+     * @brief 发布新配置，替换下来的旧配置在无读者引用后释放
+     * @return 新版本号（从1开始递增）
+     */
+    uint64_t publish(T value) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        const Node* old = current_.exchange(new Node{std::move(value), version_ + 1});
+        const uint64_t retire_epoch = epoch_.fetch_add(1);
+        if (old) {
+            retired_.emplace_back(retire_epoch, std::unique_ptr<const Node>(old));
+        }
+        reclaim();
+        return ++version_;
+    }
+
+    /**
+     * @brief 写者侧读取当前配置（与publish互斥，用于在当前配置基础上修改后再发布）
+     */
+    T copy() const {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return current_.load()->value;
+    }
+
+    bool empty() const { return current_.load() == nullptr; }
+
+    /**
+     * @brief 当前版本号（未发布过为0）
+     */
+    uint64_t version() const {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return version_;
+    }
+
+    /**
+     * @brief 尚未释放的旧版本数量
+     */
+    size_t retiredCount() const {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return retired_.size();
+    }
+
+private:
+    // 每个读者一个槽（独占缓存行）：0表示不在读，否则为开始读取时的纪元
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};
+        bool in_use = false;
+    };
+
+    std::atomic<uint64_t>* registerReader() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        for (auto& slot : slots_) {
+            if (!slot->in_use) {
+                slot->in_use = true;
+                return &slot->epoch;
+            }
+        }
+        slots_.push_back(std::make_unique<Slot>());
+        slots_.back()->in_use = true;
+        return &slots_.back()->epoch;
+    }
+
+    void unregisterReader(std::atomic<uint64_t>* epoch) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        for (auto& slot : slots_) {
+            if (&slot->epoch == epoch) {
+                slot->epoch.store(0);
+                slot->in_use = false;
+            }
+        }
+        reclaim();
+    }
+
+    // 释放所有读者都已越过的旧版本（持有writer_mutex_调用）
+    void reclaim() {
+        uint64_t oldest_reader = UINT64_MAX;
+        for (const auto& slot : slots_) {
+            const uint64_t epoch = slot->epoch.load();
+            if (epoch != 0 && epoch < oldest_reader) {
+                oldest_reader = epoch;
+            }
+        }
+        size_t kept = 0;
+        for (auto& entry : retired_) {
+            // 纪元不晚于退役纪元的读者可能仍持有该版本
+            if (entry.first >= oldest_reader) {
+                retired_[kept++] = std::move(entry);
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    std::atomic<const Node*> current_{nullptr};
+    std::atomic<uint64_t> epoch_{1};
+    mutable std::mutex writer_mutex_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<std::pair<uint64_t, std::unique_ptr<const Node>>> retired_;
+    uint64_t version_ = 0;
+};
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 实时内存模式配置
+ */
+struct RtMemoryOptions {
+    bool lock_memory = true;                    // mlockall(MCL_CURRENT | MCL_FUTURE)
+    size_t prefault_heap_bytes = 64u << 20;     // 预触碰并常驻的堆空间
+    size_t prefault_stack_bytes = 256u << 10;   // 每个放置线程预触碰的栈空间
+    bool huge_pages = true;                     // 帧缓冲/检测中间图像使用大页
+};
+
+/**
+ * @brief 进程级实时内存模式
+ *
+ * 关闭malloc的堆收缩和mmap分配（释放的内存留在堆中，再次分配不缺页），
+ * 所有线程共用主分配区，预触碰一段堆空间，然后锁定全部现有及将来的映射。
+ * 应在进程启动早期、创建帧缓冲区之前调用一次。
+ * 锁定失败（RLIMIT_MEMLOCK不足或无权限）时降级为只预触碰，不影响运行。
+ * @param message 输出实际生效情况或降级原因，可为nullptr
+ * @return 全部按配置生效返回true
+ */
+bool enableRtMemory(const RtMemoryOptions& options, std::string* message);
+
+bool rtMemoryEnabled();
+bool rtHugePagesEnabled();
+const RtMemoryOptions& rtMemoryOptions();
+
+/**
+ * @brief 预触碰调用线程的栈（applyThreadPlacement在实时内存模式下自动调用）
+ */
+void prefaultCurrentStack(size_t bytes);
+
+/**
+ * @brief 大页后备的定长缓冲区
+ *
+ * 依次尝试：hugetlbfs大页（MAP_HUGETLB）→ 透明大页（MADV_HUGEPAGE）→ 普通页，
+ * 分配时整块预触碰，之后访问不再缺页。大小向上取整到2MB。
+ */
+class HugePageBuffer {
+public:
+    enum class Backing : uint8_t { NONE, HUGETLB, TRANSPARENT, NORMAL };
+
+    HugePageBuffer() = default;
+    explicit HugePageBuffer(size_t bytes);
+    ~HugePageBuffer();
+
+    HugePageBuffer(HugePageBuffer&& other) noexcept;
+    HugePageBuffer& operator=(HugePageBuffer&& other) noexcept;
+    HugePageBuffer(const HugePageBuffer&) = delete;
+    HugePageBuffer& operator=(const HugePageBuffer&) = delete;
+
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    Backing backing() const { return backing_; }
+
+private:
+    void reset();
+
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;       // 请求大小
+    size_t mapped_ = 0;     // 实际映射大小
+    Backing backing_ = Backing::NONE;
+};
+
+/**
+ * @brief 进程内存报告（/proc/self/status、smaps_rollup与getrusage）
+ */
+struct MemoryReport {
+    size_t vm_size_kb = 0;
+    size_t rss_kb = 0;
+    size_t rss_peak_kb = 0;
+    size_t locked_kb = 0;          // VmLck
+    size_t anon_huge_kb = 0;       // 透明大页
+    size_t hugetlb_kb = 0;         // hugetlbfs大页
+    size_t huge_buffer_kb = 0;     // HugePageBuffer中实际获得大页的部分
+    uint64_t minor_faults = 0;
+    uint64_t major_faults = 0;
+};
+
+MemoryReport readMemoryReport();
+std::string formatMemoryReport(const MemoryReport& report);
+
+}  // namespace rm_auto_aim
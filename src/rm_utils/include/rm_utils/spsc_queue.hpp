@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 有界无锁单生产者单消费者队列
+ *
+ * 环形缓冲区 + 头尾两个原子下标，仅允许一个线程push、一个线程pop。
+ * 容量向上取整为2的幂；队满时tryPush失败，由调用方决定丢弃策略。
+ * 元素在构造时全部预分配，稳态下push/pop不触发内存分配。
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : capacity_(roundUpPow2(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          buffer_(capacity_)
+    {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief 生产者入队
+     * @return 队满返回false，value保持不变
+     */
+    bool tryPush(T&& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ >= capacity_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ >= capacity_) {
+                return false;
+            }
+        }
+        buffer_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value) {
+        T copy = value;
+        return tryPush(std::move(copy));
+    }
+
+    /**
+     * @brief 消费者出队
+     * @return 队空返回false
+     */
+    bool tryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        out = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者阻塞出队
+     *
+     * 先自旋，再让出CPU，最后以短睡眠退避，兼顾唤醒延迟和空闲时的CPU占用。
+     * @param running 为false时放弃等待
+     * @return 取到元素返回true，因running变为false退出返回false
+     */
+    bool popWait(T& out, const std::atomic<bool>& running) {
+        for (int i = 0; running.load(std::memory_order_relaxed); i++) {
+            if (tryPop(out)) return true;
+            if (i < kSpinCount) continue;
+            if (i < kSpinCount + kYieldCount) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 生产者阻塞入队（需要反压、不允许丢弃时使用），退避策略同popWait
+     * @return 入队返回true，因running变为false退出返回false
+     */
+    bool pushWait(T&& value, const std::atomic<bool>& running) {
+        for (int i = 0; running.load(std::memory_order_relaxed); i++) {
+            if (tryPush(std::move(value))) return true;
+            if (i < kSpinCount) continue;
+            if (i < kSpinCount + kYieldCount) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 当前元素数量（近似值，仅用于统计）
+     */
+    size_t sizeApprox() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    static size_t roundUpPow2(size_t v) {
+        size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    static constexpr size_t kCacheLine = 64;
+    static constexpr int kSpinCount = 256;
+    static constexpr int kYieldCount = 64;
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::vector<T> buffer_;
+
+    // 消费者写head，生产者写tail；分属不同缓存行避免伪共享
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;   // 消费者本地缓存的tail
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;   // 生产者本地缓存的head
+};
+
+}  // namespace rm_auto_aim
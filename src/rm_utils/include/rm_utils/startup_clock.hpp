@@ -0,0 +1,18 @@
+#pragma once
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 系统启动至今的秒数（CLOCK_BOOTTIME，含挂起时间）
+ */
+double secondsSinceBoot();
+
+/**
+ * @brief 本进程启动至今的秒数（/proc/self/stat 的启动时刻，精度为一个时钟节拍）
+ *
+ * 用于统计“进程启动 → 首条云台命令”，不依赖任何节点的构造时刻。
+ * 读取失败时返回负值。
+ */
+double secondsSinceProcessStart();
+
+}  // namespace rm_auto_aim
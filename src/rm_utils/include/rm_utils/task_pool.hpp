@@ -0,0 +1,286 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "rm_utils/thread_placement.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 任务优先级类别（每类有独立的工作线程组，互不抢占）
+ */
+enum class TaskPriority : uint8_t {
+    HOT = 0,          // 关键路径（检测/PnP批量等），线程可绑核+实时优先级
+    BACKGROUND = 1,   // 后台（标定缓存写盘、查表构建、调参等）
+    COUNT
+};
+
+constexpr size_t TASK_PRIORITY_COUNT = static_cast<size_t>(TaskPriority::COUNT);
+
+const char* taskPriorityName(TaskPriority priority);
+
+/**
+ * @brief 单个优先级类别的线程配置
+ */
+struct TaskClassOptions {
+    int threads = 0;              // 工作线程数，0表示不建线程（提交的任务由提交者/等待者执行）
+    ThreadPlacement placement;    // 所有工作线程共用的CPU集合与调度策略
+};
+
+struct TaskPoolOptions {
+    std::array<TaskClassOptions, TASK_PRIORITY_COUNT> classes;
+};
+
+class TaskGroup;
+
+/**
+ * @brief 进程级工作窃取任务池
+ *
+ * 自瞄进程内所有阶段共用一个任务池，替代各模块自建线程，避免CPU超额订阅。
+ * 每个优先级类别有一组工作线程，每个线程一个双端队列：
+ *   - 工作线程内提交的任务压入自己队列尾部，自己从尾部取（LIFO，缓存友好）
+ *   - 外部线程提交的任务进入该类别的注入队列
+ *   - 空闲线程依次从注入队列、同类其他线程队列头部窃取（FIFO）
+ * 不同类别的线程不互相窃取：后台任务再多也不会占用关键路径的核。
+ * 未启动或某类别线程数为0时，submit直接在调用线程执行，行为与串行一致。
+ *
+ * 任务是定长的（函数指针 + 上下文 + 下标区间），队列为只增不缩的环形缓冲区，
+ * 关键路径上的提交与执行稳态不分配内存。
+ */
+class TaskPool {
+public:
+    using RangeFn = void (*)(void* context, size_t begin, size_t end);
+
+    /**
+     * @brief 任务：执行 fn(context, begin, end)
+     */
+    struct Task {
+        RangeFn fn = nullptr;
+        void* context = nullptr;
+        size_t begin = 0;
+        size_t end = 0;
+        TaskGroup* group = nullptr;          // 所属任务组（完成计数与异常收集），独立任务为nullptr
+        void (*release)(void*) = nullptr;    // 任务被丢弃（stop）时释放context，不拥有context时为nullptr
+    };
+
+    struct ClassStats {
+        uint64_t submitted = 0;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;     // 从同类其他线程队列窃取执行的任务数
+        uint64_t helped = 0;     // 由等待中的提交者（fork-join）代为执行的任务数
+        size_t pending = 0;      // 当前排队任务数
+        int threads = 0;
+    };
+
+    static TaskPool& global();
+
+    /**
+     * @brief 按配置创建工作线程（进程内只生效一次，后续调用返回false并保持原配置）
+     * @param message 输出各类别线程的放置结果，可为nullptr
+     */
+    bool start(const TaskPoolOptions& options, std::string* message);
+
+    /**
+     * @brief 停止并回收工作线程（未执行的任务被丢弃）
+     *
+     * 仅在进程退出时调用，此时不应再有等待中的TaskGroup。
+     */
+    void stop();
+
+    bool started() const { return started_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 提交定长任务（不分配内存，context须在任务执行完之前有效）
+     */
+    void submit(TaskPriority priority, const Task& task);
+
+    /**
+     * @brief 提交任意闭包（闭包在堆上保存，仅用于后台等非关键路径的零星任务）
+     */
+    void submit(TaskPriority priority, std::function<void()> fn);
+
+    /**
+     * @brief 在调用线程上执行一个该类别的排队任务（fork-join等待时协助执行）
+     * @return 是否执行了任务
+     */
+    bool runPending(TaskPriority priority);
+
+    int threadCount(TaskPriority priority) const;
+    ClassStats stats(TaskPriority priority) const;
+
+    ~TaskPool();
+
+private:
+    /**
+     * @brief 环形任务队列：容量按2的幂增长后不再收缩
+     */
+    class TaskQueue {
+    public:
+        bool empty() const { return head_ == tail_; }
+        void pushBack(const Task& task);
+        Task popBack();
+        Task popFront();
+        // 丢弃全部任务（释放其拥有的context）
+        void clear();
+        void reserve(size_t capacity);
+
+    private:
+        std::vector<Task> slots_;
+        size_t head_ = 0;
+        size_t tail_ = 0;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        TaskQueue tasks;
+        std::thread thread;
+    };
+
+    struct TaskClass {
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::mutex inject_mutex;
+        TaskQueue injected;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::atomic<size_t> pending{0};
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> helped{0};
+    };
+
+    TaskPool() = default;
+    void workerLoop(TaskPriority priority, size_t index, ThreadPlacement placement);
+    bool takeTask(TaskPriority priority, Worker* self, Task& task);
+    static void execute(const Task& task);
+    TaskClass& taskClass(TaskPriority priority) {
+        return classes_[static_cast<size_t>(priority)];
+    }
+    const TaskClass& taskClass(TaskPriority priority) const {
+        return classes_[static_cast<size_t>(priority)];
+    }
+
+    std::array<TaskClass, TASK_PRIORITY_COUNT> classes_;
+    std::atomic<bool> started_{false};
+    std::atomic<bool> running_{false};
+    std::mutex start_mutex_;
+};
+
+/**
+ * @brief fork-join任务组
+ *
+ * run()提交子任务，wait()先协助执行同类别的排队任务（可能正是本组的子任务），
+ * 因此在工作线程内嵌套fork-join也不会死锁；余下子任务都已被其他线程取走时阻塞等待，
+ * 不自旋：实时优先级的等待者不会饿死与它同核、正在执行子任务的普通线程。
+ * 子任务抛出的第一个异常在wait()中重新抛出。析构时自动wait()（不抛出）。
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPriority priority = TaskPriority::HOT,
+                       TaskPool& pool = TaskPool::global())
+        : pool_(pool), priority_(priority) {}
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief 提交子任务 fn(context, begin, end)（不分配内存，context须在wait()返回前有效）
+     */
+    void run(TaskPool::RangeFn fn, void* context, size_t begin, size_t end);
+    void wait();
+
+private:
+    friend class TaskPool;
+    // 执行一个子任务：收集异常，最后一个完成时唤醒wait()
+    void execute(const TaskPool::Task& task);
+
+    TaskPool& pool_;
+    TaskPriority priority_;
+    std::atomic<size_t> outstanding_{0};
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+};
+
+namespace detail {
+
+template <typename Fn>
+void invokeRange(void* context, size_t begin, size_t end) {
+    auto& fn = *static_cast<Fn*>(context);
+    for (size_t i = begin; i < end; i++) {
+        fn(i);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief 并行执行 fn(i), i ∈ [begin, end)
+ *
+ * 按grain个下标切块，最后一块在调用线程上执行，返回时全部完成。
+ * 各块以函数指针 + fn地址 + 下标区间提交，不为每块分配闭包。
+ */
+template <typename Fn>
+void parallelFor(size_t begin, size_t end, Fn&& fn, size_t grain = 1,
+                 TaskPriority priority = TaskPriority::HOT,
+                 TaskPool& pool = TaskPool::global())
+{
+    if (begin >= end) {
+        return;
+    }
+    grain = grain == 0 ? 1 : grain;
+    if (end - begin <= grain || pool.threadCount(priority) == 0) {
+        for (size_t i = begin; i < end; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    using FnType = std::remove_reference_t<Fn>;
+    void* context = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+    TaskGroup group(priority, pool);
+    size_t chunk_begin = begin;
+    for (; chunk_begin + grain < end; chunk_begin += grain) {
+        group.run(&detail::invokeRange<FnType>, context, chunk_begin, chunk_begin + grain);
+    }
+    for (size_t i = chunk_begin; i < end; i++) {
+        fn(i);
+    }
+    group.wait();
+}
+
+/**
+ * @brief 从节点参数声明并读取任务池配置
+ *
+ * 参数: task_pool.<class>.threads（工作线程数）
+ *       threads.pool_<class>.cpus / threads.pool_<class>.priority（同declareThreadPlacement）
+ * 模板避免本库依赖rclcpp，NodeT为rclcpp::Node或兼容类型。
+ */
+template <typename NodeT>
+TaskPoolOptions declareTaskPoolOptions(NodeT& node) {
+    TaskPoolOptions options;
+    const std::array<int64_t, TASK_PRIORITY_COUNT> default_threads{2, 1};
+    for (size_t i = 0; i < TASK_PRIORITY_COUNT; i++) {
+        const std::string name = taskPriorityName(static_cast<TaskPriority>(i));
+        auto& cls = options.classes[i];
+        cls.threads = static_cast<int>(
+            node.declare_parameter("task_pool." + name + ".threads", default_threads[i]));
+        cls.placement = declareThreadPlacement(node, "pool_" + name);
+    }
+    return options;
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "rm_utils/spsc_queue.hpp"
+#include "rm_utils/thread_placement.hpp"
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 遥测列的数据类型（写入文件，只可追加不可改号）
+ */
+enum class TelemetryType : uint8_t {
+    F64 = 1,
+    F32 = 2,
+    I64 = 3,
+    I32 = 4,
+    U8 = 5,
+};
+
+size_t telemetryTypeSize(TelemetryType type);
+const char* telemetryTypeName(TelemetryType type);
+
+/**
+ * @brief 列定义：名称 + 类型 + 该列在定长记录结构体中的字节偏移
+ */
+struct TelemetryColumn {
+    std::string name;
+    TelemetryType type;
+    uint32_t record_offset;
+};
+
+// 遥测文件（.rmtl）:
+// [TelemetryFileHeader][TelemetryColumnDesc × column_count][填充到data_offset][块 × N]
+// 每块 = [TelemetryBlockHeader][列0 × block_rows][列1 × block_rows]...（各列起点64字节对齐），
+// 即按行组分块的列存储：读取单列时只需跳着访问每块中的一段连续数组。
+// 文件头的row_count在每次刷写后更新，是有效行数的唯一依据（写入中途崩溃也可读出已刷写的行）。
+constexpr char TELEMETRY_MAGIC[8] = {'R', 'M', 'T', 'L', 0, 0, 0, 1};
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr uint32_t TELEMETRY_BLOCK_MAGIC = 0x4B4C4254;  // "TBLK"
+
+struct TelemetryFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t column_count;
+    uint32_t record_bytes;   // 写入端记录结构体大小（仅供参考）
+    uint32_t block_rows;
+    uint64_t block_bytes;    // 含块头
+    uint64_t data_offset;    // 第一块在文件中的偏移
+    uint64_t row_count;
+    int64_t created_ns;      // CLOCK_REALTIME
+    uint8_t reserved[8];
+};
+static_assert(sizeof(TelemetryFileHeader) == 64, "TelemetryFileHeader必须为64字节");
+
+struct TelemetryColumnDesc {
+    char name[32];
+    uint8_t type;            // TelemetryType
+    uint8_t reserved0[3];
+    uint32_t record_offset;
+    uint32_t block_offset;   // 列数组相对块起点的偏移
+    uint32_t reserved1;
+};
+static_assert(sizeof(TelemetryColumnDesc) == 48, "TelemetryColumnDesc必须为48字节");
+
+struct TelemetryBlockHeader {
+    uint32_t magic;
+    uint32_t index;
+    uint32_t rows;           // 本块已写入行数
+    uint8_t reserved[52];
+};
+static_assert(sizeof(TelemetryBlockHeader) == 64, "TelemetryBlockHeader必须为64字节");
+
+/**
+ * @brief 生成遥测文件路径 <output_dir>/<prefix>_<本地时间>.rmtl（目录不存在时创建）
+ */
+std::string makeTelemetryPath(const std::string& output_dir, const std::string& prefix);
+
+/**
+ * @brief 进程内遥测写入器（单生产者）
+ *
+ * append()只把定长记录拷进无锁SPSC队列（队列满时丢弃并计数，绝不阻塞调用方），
+ * 后台刷写线程出队后把各字段转置写入内存映射文件中当前块的列数组，
+ * 文件按grow_blocks块为单位扩展（ftruncate + mremap），定期msync(MS_ASYNC)。
+ * close()排空队列后把文件截断到实际使用的块数，须在生产者停止append后调用。
+ */
+class TelemetryWriter {
+public:
+    static constexpr size_t MAX_RECORD_BYTES = 512;
+
+    struct Options {
+        uint32_t block_rows = 4096;
+        size_t queue_capacity = 1024;
+        size_t grow_blocks = 16;
+        double sync_interval_s = 1.0;
+        ThreadPlacement placement{"telemetry", {}, 0};
+    };
+
+    TelemetryWriter() = default;
+    ~TelemetryWriter();
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    /**
+     * @brief 创建文件并启动刷写线程
+     * @param columns 列定义，record_offset + 类型大小不得超出record_bytes
+     * @param error 失败原因，可为nullptr
+     */
+    bool open(const std::string& path, const std::vector<TelemetryColumn>& columns,
+              size_t record_bytes, const Options& options, std::string* error);
+
+    /**
+     * @brief 停止刷写线程（先写完队列中剩余记录）并关闭文件
+     */
+    void close();
+
+    bool isOpen() const { return running_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 追加一条记录（只能由同一个线程调用）
+     * @return 入队返回true；未打开或队列满返回false
+     */
+    template <typename Record>
+    bool append(const Record& record) noexcept {
+        static_assert(std::is_trivially_copyable<Record>::value, "遥测记录必须可平凡拷贝");
+        static_assert(sizeof(Record) <= MAX_RECORD_BYTES, "遥测记录过大");
+        return appendRaw(&record, sizeof(Record));
+    }
+
+    bool appendRaw(const void* data, size_t bytes) noexcept;
+
+    uint64_t rowsWritten() const { return rows_written_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    const std::string& path() const { return path_; }
+
+private:
+    struct Slot {
+        std::array<uint8_t, MAX_RECORD_BYTES> bytes;
+    };
+
+    struct Column {
+        TelemetryType type;
+        uint32_t size;
+        uint32_t record_offset;
+        uint32_t block_offset;
+    };
+
+    void flusherLoop();
+    bool writeRow(const Slot& slot);
+    bool ensureCapacity(uint64_t block_index);
+    TelemetryFileHeader* header() const { return reinterpret_cast<TelemetryFileHeader*>(base_); }
+
+    std::string path_;
+    Options options_;
+    size_t record_bytes_ = 0;
+    std::vector<Column> columns_;
+    uint64_t data_offset_ = 0;
+    uint64_t block_bytes_ = 0;
+
+    int fd_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    uint64_t rows_ = 0;   // 刷写线程独占
+
+    std::unique_ptr<SpscQueue<Slot>> queue_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> rows_written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::thread flusher_thread_;
+};
+
+/**
+ * @brief 遥测文件只读访问（内存映射，供导出工具和离线分析使用）
+ */
+class TelemetryReader {
+public:
+    struct ColumnInfo {
+        std::string name;
+        TelemetryType type;
+        uint32_t block_offset;
+    };
+
+    TelemetryReader() = default;
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    bool open(const std::string& path, std::string* error);
+
+    const std::vector<ColumnInfo>& columns() const { return columns_; }
+    uint64_t rows() const { return rows_; }
+    uint32_t blockRows() const { return block_rows_; }
+    int64_t createdNs() const { return created_ns_; }
+
+    /**
+     * @brief 按列名查找，不存在返回-1
+     */
+    int findColumn(const std::string& name) const;
+
+    /**
+     * @brief 第block块中column列的连续数组起点
+     */
+    const void* blockData(size_t column, uint64_t block) const {
+        return base_ + data_offset_ + block * block_bytes_ + columns_[column].block_offset;
+    }
+
+    /**
+     * @brief 读取单个值并转换为double
+     */
+    double value(size_t column, uint64_t row) const;
+
+private:
+    const uint8_t* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    std::vector<ColumnInfo> columns_;
+    uint64_t rows_ = 0;
+    uint32_t block_rows_ = 0;
+    uint64_t block_bytes_ = 0;
+    uint64_t data_offset_ = 0;
+    int64_t created_ns_ = 0;
+};
+
+}  // namespace rm_auto_aim
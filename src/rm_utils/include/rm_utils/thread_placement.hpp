@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rm_auto_aim {
+
+/**
+ * @brief 线程放置配置：CPU亲和性 + 调度策略
+ */
+struct ThreadPlacement {
+    std::string name;        // 线程名（最多15字符，超出截断）
+    std::vector<int> cpus;   // 绑定的CPU编号，空表示不绑定（继承创建者）
+    int priority = 0;        // SCHED_FIFO优先级1-99，0表示保持普通调度
+};
+
+/**
+ * @brief 对调用线程应用放置配置
+ *
+ * 失败时优雅降级：不存在的CPU被忽略；没有实时权限（EPERM，
+ * 需CAP_SYS_NICE或 ulimit -r）时保持SCHED_OTHER继续运行。
+ * @param message 输出实际生效情况或降级原因，可为nullptr
+ * @return 全部按配置生效返回true
+ */
+bool applyThreadPlacement(const ThreadPlacement& placement, std::string* message);
+
+/**
+ * @brief 从节点参数声明并读取某个阶段的放置配置
+ *
+ * 参数: threads.<stage>.cpus（整数数组，负数表示不绑定）
+ *       threads.<stage>.priority（0为普通调度）
+ * 模板避免本库依赖rclcpp，NodeT为rclcpp::Node或兼容类型。
+ */
+template <typename NodeT>
+ThreadPlacement declareThreadPlacement(NodeT& node, const std::string& stage) {
+    const std::string prefix = "threads." + stage + ".";
+    ThreadPlacement placement;
+    placement.name = stage;
+    const auto cpus = node.declare_parameter(prefix + "cpus", std::vector<int64_t>{-1});
+    for (const auto cpu : cpus) {
+        if (cpu >= 0) {
+            placement.cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    placement.priority = static_cast<int>(node.declare_parameter(prefix + "priority", int64_t{0}));
+    return placement;
+}
+
+}  // namespace rm_auto_aim
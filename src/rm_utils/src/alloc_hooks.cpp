@@ -0,0 +1,93 @@
+// 可选的堆分配计数钩子（librm_alloc_hooks.so）
+//
+// 替换glibc的malloc系列入口，转调__libc_*实现并通知AllocTracker计数。
+// operator new/delete、cv::fastMalloc、Eigen的对齐分配最终都走这里，不单独替换以免重复计数。
+// 使用: LD_PRELOAD=<prefix>/lib/librm_alloc_hooks.so，或在可执行文件中直接链接本库。
+
+#include <cerrno>
+#include <cstddef>
+
+#include "rm_utils/alloc_tracker.hpp"
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+}  // extern "C"
+
+namespace {
+
+using rm_auto_aim::AllocTracker;
+
+__attribute__((constructor)) void markActive() {
+    AllocTracker::markHooksActive();
+}
+
+}  // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    if (ptr) {
+        AllocTracker::onAlloc(size);
+    }
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    if (ptr) {
+        AllocTracker::onAlloc(count * size);
+    }
+    return ptr;
+}
+
+void* realloc(void* old_ptr, size_t size) {
+    void* ptr = __libc_realloc(old_ptr, size);
+    // 重新分配按一次新分配计；realloc(p, 0) 等同于释放
+    if (ptr) {
+        AllocTracker::onAlloc(size);
+    }
+    if (old_ptr && (ptr || size == 0)) {
+        AllocTracker::onFree();
+    }
+    return ptr;
+}
+
+void* memalign(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    if (ptr) {
+        AllocTracker::onAlloc(size);
+    }
+    return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* ptr = memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        AllocTracker::onFree();
+    }
+    __libc_free(ptr);
+}
+
+}  // extern "C"
@@ -0,0 +1,167 @@
+#include "rm_utils/alloc_tracker.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace rm_auto_aim {
+
+namespace {
+
+// 分配路径上访问的状态全部为常量初始化的POD/原子量，加载期与分配钩子中均可安全使用
+struct AtomicCounters {
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes{0};
+
+    AllocCounters load() const noexcept {
+        return {allocs.load(std::memory_order_relaxed), frees.load(std::memory_order_relaxed),
+                bytes.load(std::memory_order_relaxed)};
+    }
+};
+
+struct FrameCounters {
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> max_allocs{0};
+};
+
+struct ThreadSlot {
+    AtomicCounters counters;
+    char name[16] = {};
+};
+
+// 线程局部状态：initial-exec模型不经过__tls_get_addr，访问时不会触发分配
+struct ThreadState {
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t bytes;
+    int16_t slot;     // 具名计数槽，-1表示未登记
+    uint8_t tag;
+};
+
+__attribute__((tls_model("initial-exec"))) thread_local ThreadState tl_state{0, 0, 0, -1, 0};
+
+std::atomic<bool> g_hooks_active{false};
+AtomicCounters g_tags[ALLOC_TAG_COUNT];
+FrameCounters g_frames[ALLOC_TAG_COUNT];
+ThreadSlot g_slots[AllocTracker::MAX_THREADS];
+std::atomic<size_t> g_slot_count{0};
+std::mutex g_register_mutex;
+
+}  // namespace
+
+const char* allocTagName(AllocTag tag) {
+    switch (tag) {
+        case AllocTag::OTHER: return "other";
+        case AllocTag::CAPTURE: return "capture";
+        case AllocTag::DETECT: return "detect";
+        case AllocTag::SOLVE: return "solve";
+        default: return "unknown";
+    }
+}
+
+bool AllocTracker::hooksActive() noexcept {
+    return g_hooks_active.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::markHooksActive() noexcept {
+    g_hooks_active.store(true, std::memory_order_relaxed);
+}
+
+void AllocTracker::onAlloc(size_t bytes) noexcept {
+    auto& state = tl_state;
+    state.allocs++;
+    state.bytes += bytes;
+    auto& tag = g_tags[state.tag < ALLOC_TAG_COUNT ? state.tag : 0];
+    tag.allocs.fetch_add(1, std::memory_order_relaxed);
+    tag.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (state.slot >= 0) {
+        auto& slot = g_slots[state.slot].counters;
+        slot.allocs.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+void AllocTracker::onFree() noexcept {
+    auto& state = tl_state;
+    state.frees++;
+    g_tags[state.tag < ALLOC_TAG_COUNT ? state.tag : 0].frees.fetch_add(
+        1, std::memory_order_relaxed);
+    if (state.slot >= 0) {
+        g_slots[state.slot].counters.frees.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+AllocCounters AllocTracker::threadCounters() noexcept {
+    const auto& state = tl_state;
+    return {state.allocs, state.frees, state.bytes};
+}
+
+AllocCounters AllocTracker::tagCounters(AllocTag tag) noexcept {
+    return g_tags[static_cast<size_t>(tag)].load();
+}
+
+void AllocTracker::registerThread(const std::string& name) {
+    if (tl_state.slot >= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_register_mutex);
+    const size_t index = g_slot_count.load(std::memory_order_relaxed);
+    if (index >= MAX_THREADS) {
+        return;
+    }
+    std::strncpy(g_slots[index].name, name.c_str(), sizeof(g_slots[index].name) - 1);
+    g_slot_count.store(index + 1, std::memory_order_release);
+    tl_state.slot = static_cast<int16_t>(index);
+}
+
+std::vector<AllocTracker::ThreadEntry> AllocTracker::threads() {
+    std::vector<ThreadEntry> entries;
+    const size_t count = g_slot_count.load(std::memory_order_acquire);
+    entries.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        entries.push_back({g_slots[i].name, g_slots[i].counters.load()});
+    }
+    return entries;
+}
+
+void AllocTracker::recordFrame(AllocTag tag, const AllocCounters& frame) noexcept {
+    auto& stats = g_frames[static_cast<size_t>(tag)];
+    stats.frames.fetch_add(1, std::memory_order_relaxed);
+    stats.allocs.fetch_add(frame.allocs, std::memory_order_relaxed);
+    stats.bytes.fetch_add(frame.bytes, std::memory_order_relaxed);
+    uint64_t prev = stats.max_allocs.load(std::memory_order_relaxed);
+    while (frame.allocs > prev &&
+           !stats.max_allocs.compare_exchange_weak(prev, frame.allocs, std::memory_order_relaxed)) {
+    }
+}
+
+AllocTracker::FrameStats AllocTracker::frameStats(AllocTag tag) noexcept {
+    auto& stats = g_frames[static_cast<size_t>(tag)];
+    FrameStats out;
+    out.frames = stats.frames.load(std::memory_order_relaxed);
+    out.allocs = stats.allocs.load(std::memory_order_relaxed);
+    out.bytes = stats.bytes.load(std::memory_order_relaxed);
+    out.max_allocs = stats.max_allocs.exchange(0, std::memory_order_relaxed);
+    return out;
+}
+
+AllocScope::AllocScope(AllocTag tag, bool record_frame) noexcept
+    : tag_(tag),
+      prev_tag_(static_cast<AllocTag>(tl_state.tag)),
+      record_frame_(record_frame),
+      start_(AllocTracker::threadCounters())
+{
+    tl_state.tag = static_cast<uint8_t>(tag);
+}
+
+AllocScope::~AllocScope() {
+    if (record_frame_ && AllocTracker::hooksActive()) {
+        AllocTracker::recordFrame(tag_, delta());
+    }
+    tl_state.tag = static_cast<uint8_t>(prev_tag_);
+}
+
+}  // namespace rm_auto_aim
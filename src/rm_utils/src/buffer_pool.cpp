@@ -0,0 +1,93 @@
+#include "rm_utils/buffer_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace rm_auto_aim {
+
+BufferPool& BufferPool::global() {
+    static BufferPool pool;
+    return pool;
+}
+
+void BufferPool::reserve(size_t count, size_t bytes, const std::string& owner) {
+    // 在锁外完成分配与页面触碰
+    std::vector<Buffer> buffers(count);
+    for (auto& buffer : buffers) {
+        buffer.resize(bytes);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    reservations_[owner] = count;
+    max_buffers_ = 0;
+    for (const auto& reservation : reservations_) {
+        max_buffers_ += reservation.second;
+    }
+    free_.reserve(max_buffers_);  // 归还时push_back不再扩容
+    in_flight_.reserve(MAX_IN_FLIGHT);
+    for (auto& buffer : buffers) {
+        if (free_.size() >= max_buffers_) {
+            break;
+        }
+        free_.push_back(std::move(buffer));
+    }
+}
+
+BufferPool::Buffer BufferPool::acquire(size_t bytes) {
+    Buffer buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            buffer = std::move(free_.back());
+            free_.pop_back();
+        }
+    }
+
+    if (buffer.capacity() < bytes) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 容量足够时resize不分配；同尺寸复用时为空操作
+    buffer.resize(bytes);
+    acquires_.fetch_add(1, std::memory_order_relaxed);
+
+    // 登记在途地址（扩容后的最终地址）
+    if (buffer.capacity() > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (in_flight_.size() >= MAX_IN_FLIGHT) {
+            in_flight_.erase(in_flight_.begin());
+        }
+        in_flight_.push_back(buffer.data());
+    }
+    return buffer;
+}
+
+void BufferPool::release(Buffer&& buffer) {
+    if (buffer.capacity() == 0) {
+        return;
+    }
+    releases_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 在途登记很短（在途帧数），线性查找即可
+    auto it = std::find(in_flight_.begin(), in_flight_.end(), buffer.data());
+    if (it != in_flight_.end()) {
+        *it = in_flight_.back();
+        in_flight_.pop_back();
+    } else {
+        foreign_releases_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (free_.size() < max_buffers_) {
+        free_.push_back(std::move(buffer));
+    }
+}
+
+size_t BufferPool::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+size_t BufferPool::outstanding() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_.size();
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,202 @@
+#include "rm_utils/flight_recorder.hpp"
+
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace rm_auto_aim {
+
+namespace {
+
+int64_t realtimeNs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+const FlightEventInfo kEventInfo[] = {
+    {"unknown", {"a0", "a1", "a2", "a3"}},
+    {"tracker_state", {"from", "to", "detect_count", "lost_time"}},
+    {"tracker_match", {"best_idx", "min_dist", "armors_num", "best_yaw_diff"}},
+    {"ekf_innovation", {"dx", "dy", "dz", "dyaw"}},
+    {"serial_send", {"yaw", "pitch", "fire", "bytes"}},
+    {"serial_receive", {"cur_yaw", "cur_pitch", "bullet_speed", "color"}},
+    {"frame_dropped", {"dropped_total", nullptr, nullptr, nullptr}},
+    {"dump_request", {"reason", nullptr, nullptr, nullptr}},
+};
+
+}  // namespace
+
+const FlightEventInfo& flightEventInfo(uint16_t id) {
+    if (id < sizeof(kEventInfo) / sizeof(kEventInfo[0])) {
+        return kEventInfo[id];
+    }
+    return kEventInfo[0];
+}
+
+const char* flightDumpReasonName(FlightDumpReason reason) {
+    switch (reason) {
+        case FlightDumpReason::MANUAL: return "manual";
+        case FlightDumpReason::SIGNAL: return "signal";
+        case FlightDumpReason::TRACKER_LOST: return "tracker_lost";
+    }
+    return "unknown";
+}
+
+FlightRecorder& FlightRecorder::global() {
+    static FlightRecorder recorder;
+    return recorder;
+}
+
+FlightRecorder::~FlightRecorder() {
+    stopDumper();
+}
+
+FlightRecorder::Ring* FlightRecorder::threadRing() {
+    thread_local Ring* ring = nullptr;
+    if (!ring) {
+        // 每线程只在第一次记录时加锁分配
+        auto owned = std::make_unique<Ring>();
+        pthread_getname_np(pthread_self(), owned->thread_name, sizeof(owned->thread_name));
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        owned->thread_id = static_cast<uint16_t>(rings_.size());
+        ring = owned.get();
+        rings_.push_back(std::move(owned));
+    }
+    return ring;
+}
+
+void FlightRecorder::record(FlightEvent event, double a0, double a1, double a2, double a3) noexcept {
+    Ring* ring = threadRing();
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    FlightRecord& r = ring->records[head & (kRingRecords - 1)];
+    r.stamp_ns = realtimeNs();
+    r.event = static_cast<uint16_t>(event);
+    r.thread_id = ring->thread_id;
+    r.seq = static_cast<uint32_t>(head);
+    r.args[0] = a0;
+    r.args[1] = a1;
+    r.args[2] = a2;
+    r.args[3] = a3;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+long FlightRecorder::dump(const std::string& path, double window_s, FlightDumpReason reason) const {
+    const int64_t now_ns = realtimeNs();
+    const int64_t since_ns = now_ns - static_cast<int64_t>(window_s * 1e9);
+
+    std::vector<FlightRecord> records;
+    std::vector<FlightThreadInfo> threads;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (const auto& ring : rings_) {
+            FlightThreadInfo info{};
+            info.id = ring->thread_id;
+            std::memcpy(info.name, ring->thread_name, sizeof(info.name));
+            threads.push_back(info);
+
+            // 拷贝[head-N, head)，再以新head剔除拷贝期间可能被覆盖的记录
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            const uint64_t begin = head > kRingRecords ? head - kRingRecords : 0;
+            const size_t first_new = records.size();
+            for (uint64_t i = begin; i < head; i++) {
+                records.push_back(ring->records[i & (kRingRecords - 1)]);
+            }
+            // 写线程可能正在写head_after号记录，它与head_after-N共用一个槽，
+            // 故完好的只有[head_after+1-N, head_after)
+            const uint64_t head_after = ring->head.load(std::memory_order_acquire);
+            const uint64_t valid_from =
+                head_after + 1 > kRingRecords ? head_after + 1 - kRingRecords : 0;
+            const size_t overwritten = static_cast<size_t>(
+                std::min<uint64_t>(valid_from > begin ? valid_from - begin : 0, head - begin));
+            records.erase(records.begin() + first_new, records.begin() + first_new + overwritten);
+        }
+    }
+
+    records.erase(std::remove_if(records.begin(), records.end(),
+                                 [since_ns](const FlightRecord& r) { return r.stamp_ns < since_ns; }),
+                  records.end());
+    std::stable_sort(records.begin(), records.end(),
+                     [](const FlightRecord& a, const FlightRecord& b) { return a.stamp_ns < b.stamp_ns; });
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return -1;
+    }
+    FlightDumpHeader header{};
+    std::memcpy(header.magic, FLIGHT_DUMP_MAGIC, sizeof(FLIGHT_DUMP_MAGIC));
+    header.version = 1;
+    header.record_size = sizeof(FlightRecord);
+    header.thread_count = static_cast<uint32_t>(threads.size());
+    header.reason = static_cast<uint32_t>(reason);
+    header.record_count = records.size();
+    header.dump_time_ns = now_ns;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(threads.data(), sizeof(FlightThreadInfo), threads.size(), file) == threads.size();
+    ok = ok && std::fwrite(records.data(), sizeof(FlightRecord), records.size(), file) == records.size();
+    ok = (std::fclose(file) == 0) && ok;
+    return ok ? static_cast<long>(records.size()) : -1;
+}
+
+std::string FlightRecorder::makeDumpPath(FlightDumpReason reason) const {
+    const auto now = std::chrono::system_clock::now();
+    const std::time_t t = std::chrono::system_clock::to_time_t(now);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count() % 1000;
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    char name[64];
+    std::strftime(name, sizeof(name), "%Y%m%d_%H%M%S", &tm);
+    char full[128];
+    std::snprintf(full, sizeof(full), "flight_%s_%03lld_%s.rmfr", name,
+                  static_cast<long long>(ms), flightDumpReasonName(reason));
+    return config_.output_dir + "/" + full;
+}
+
+void FlightRecorder::startDumper(const DumpConfig& config) {
+    stopDumper();
+    config_ = config;
+    mkdir(config_.output_dir.c_str(), 0755);
+    dumper_running_ = true;
+    dumper_thread_ = std::thread(&FlightRecorder::dumperLoop, this);
+}
+
+void FlightRecorder::stopDumper() {
+    dumper_running_ = false;
+    if (dumper_thread_.joinable()) {
+        dumper_thread_.join();
+    }
+}
+
+void FlightRecorder::dumperLoop() {
+    auto last_lost_dump = std::chrono::steady_clock::time_point{};
+    while (dumper_running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const int pending = pending_reason_.exchange(-1, std::memory_order_relaxed);
+        if (pending < 0) {
+            continue;
+        }
+        const auto reason = static_cast<FlightDumpReason>(pending);
+        if (reason == FlightDumpReason::TRACKER_LOST) {
+            // 反复丢失时限制转储频率
+            const auto now = std::chrono::steady_clock::now();
+            if (!config_.dump_on_tracker_lost ||
+                now - last_lost_dump < std::chrono::duration<double>(config_.min_interval_s)) {
+                continue;
+            }
+            last_lost_dump = now;
+        }
+        const auto path = makeDumpPath(reason);
+        const long count = dump(path, config_.window_s, reason);
+        if (config_.on_dump) {
+            config_.on_dump(path, count);
+        }
+    }
+}
+
+}  // namespace rm_auto_aim
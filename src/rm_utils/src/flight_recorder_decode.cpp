@@ -0,0 +1,83 @@
+// 飞行记录器转储文件离线解码：flight_recorder_decode <file.rmfr> [--csv]
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rm_utils/flight_recorder.hpp"
+
+using rm_auto_aim::FlightDumpHeader;
+using rm_auto_aim::FlightDumpReason;
+using rm_auto_aim::FlightRecord;
+using rm_auto_aim::FlightThreadInfo;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "用法: %s <file.rmfr> [--csv]\n", argv[0]);
+        return 1;
+    }
+    const bool csv = argc > 2 && std::strcmp(argv[2], "--csv") == 0;
+
+    std::FILE* file = std::fopen(argv[1], "rb");
+    if (!file) {
+        std::fprintf(stderr, "无法打开 %s\n", argv[1]);
+        return 1;
+    }
+
+    FlightDumpHeader header{};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, rm_auto_aim::FLIGHT_DUMP_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(FlightRecord)) {
+        std::fprintf(stderr, "%s 不是有效的飞行记录转储\n", argv[1]);
+        std::fclose(file);
+        return 1;
+    }
+
+    std::vector<FlightThreadInfo> threads(header.thread_count);
+    std::vector<FlightRecord> records(header.record_count);
+    const bool ok =
+        std::fread(threads.data(), sizeof(FlightThreadInfo), threads.size(), file) == threads.size() &&
+        std::fread(records.data(), sizeof(FlightRecord), records.size(), file) == records.size();
+    std::fclose(file);
+    if (!ok) {
+        std::fprintf(stderr, "%s 文件被截断\n", argv[1]);
+        return 1;
+    }
+
+    auto threadName = [&threads](uint16_t id) -> std::string {
+        for (const auto& t : threads) {
+            if (t.id == id) {
+                return std::string(t.name, strnlen(t.name, sizeof(t.name)));
+            }
+        }
+        return "?";
+    };
+
+    if (csv) {
+        std::printf("stamp_ns,thread,event,a0,a1,a2,a3\n");
+        for (const auto& r : records) {
+            std::printf("%lld,%s,%s,%.9g,%.9g,%.9g,%.9g\n",
+                        static_cast<long long>(r.stamp_ns), threadName(r.thread_id).c_str(),
+                        rm_auto_aim::flightEventInfo(r.event).name,
+                        r.args[0], r.args[1], r.args[2], r.args[3]);
+        }
+        return 0;
+    }
+
+    std::printf("# 转储原因: %s  线程数: %u  记录数: %llu\n",
+                rm_auto_aim::flightDumpReasonName(static_cast<FlightDumpReason>(header.reason)),
+                header.thread_count, static_cast<unsigned long long>(header.record_count));
+    // 时间以转储时刻为零点，负值表示转储前多久
+    for (const auto& r : records) {
+        const auto& info = rm_auto_aim::flightEventInfo(r.event);
+        std::printf("%+12.6f  %-15s %-16s", (r.stamp_ns - header.dump_time_ns) * 1e-9,
+                    threadName(r.thread_id).c_str(), info.name);
+        for (int i = 0; i < 4; i++) {
+            if (info.args[i]) {
+                std::printf(" %s=%.6g", info.args[i], r.args[i]);
+            }
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "rm_utils/latency_tracer.hpp"
+
+namespace rm_auto_aim {
+
+const char* traceStageName(TraceStage stage) {
+    switch (stage) {
+        case TraceStage::CAPTURE: return "capture";
+        case TraceStage::DETECT_START: return "detect_start";
+        case TraceStage::DETECT_END: return "detect_end";
+        case TraceStage::PNP_DONE: return "pnp_done";
+        case TraceStage::TRACKER_UPDATE: return "tracker_update";
+        case TraceStage::COMPENSATION: return "compensation";
+        case TraceStage::COMMAND_PUBLISH: return "command_publish";
+        case TraceStage::SERIAL_WRITE: return "serial_write";
+        case TraceStage::COUNT: break;
+    }
+    return "unknown";
+}
+
+LatencyTracer& LatencyTracer::global() {
+    static LatencyTracer tracer;
+    return tracer;
+}
+
+void LatencyTracer::mark(TraceStage stage, int64_t frame_stamp_ns, int64_t now_ns) noexcept {
+    const size_t s = static_cast<size_t>(stage);
+    if (sinceCaptureEnabled()) {
+        since_capture_[s].record(now_ns - frame_stamp_ns);
+    }
+
+    // 帧号散列到环形表：时间戳低位多为0，先混合再取模
+    const uint64_t h = static_cast<uint64_t>(frame_stamp_ns) * 0x9E3779B97F4A7C15ULL;
+    FrameSlot& slot = slots_[(h >> 32) % kFrameSlots];
+
+    if (slot.frame.load(std::memory_order_acquire) != frame_stamp_ns) {
+        // 新帧占用该槽，清空旧帧的计时点
+        for (auto& stamp : slot.stamps) {
+            stamp.store(0, std::memory_order_relaxed);
+        }
+        slot.frame.store(frame_stamp_ns, std::memory_order_release);
+    } else {
+        // 最近一个已记录的前序计时点
+        for (size_t prev = s; prev-- > 0;) {
+            const int64_t t = slot.stamps[prev].load(std::memory_order_relaxed);
+            if (t != 0) {
+                // 读取期间槽被新帧抢占则放弃本次差值
+                if (slot.frame.load(std::memory_order_acquire) == frame_stamp_ns) {
+                    stage_delta_[s].record(now_ns - t);
+                }
+                break;
+            }
+        }
+    }
+    slot.stamps[s].store(now_ns, std::memory_order_relaxed);
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,224 @@
+#include "rm_utils/rt_memory.hpp"
+
+#include <alloca.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace rm_auto_aim {
+
+namespace {
+
+constexpr size_t kHugePageBytes = 2u << 20;
+
+std::atomic<bool> g_enabled{false};
+std::atomic<bool> g_huge_pages{false};
+RtMemoryOptions g_options;
+std::atomic<size_t> g_huge_buffer_bytes{0};
+
+size_t pageSize() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+void touchPages(uint8_t* data, size_t bytes) {
+    // 写而不是读：读只会映射共享零页，写才分配实际物理页
+    volatile uint8_t* p = data;
+    for (size_t i = 0; i < bytes; i += pageSize()) {
+        p[i] = 0;
+    }
+}
+
+// 从/proc文件中读取 "key:   123 kB" 形式的字段
+size_t readProcKb(const char* path, const char* key) {
+    std::FILE* file = std::fopen(path, "r");
+    if (!file) {
+        return 0;
+    }
+    const size_t key_len = std::strlen(key);
+    char line[256];
+    size_t value = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::strncmp(line, key, key_len) == 0 && line[key_len] == ':') {
+            value = std::strtoul(line + key_len + 1, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(file);
+    return value;
+}
+
+}  // namespace
+
+bool enableRtMemory(const RtMemoryOptions& options, std::string* message) {
+    bool ok = true;
+    std::string info;
+
+    // 释放的内存不归还系统，大块也从堆中分配：之后的分配复用已触碰的页
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    // 所有线程共用主分配区，预触碰对之后创建的线程同样有效
+    mallopt(M_ARENA_MAX, 1);
+
+    if (options.lock_memory) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            const int err = errno;
+            rlimit limit{};
+            getrlimit(RLIMIT_MEMLOCK, &limit);
+            info += std::string("mlockall失败(") + std::strerror(err) + ", RLIMIT_MEMLOCK=" +
+                    (limit.rlim_cur == RLIM_INFINITY ? std::string("unlimited")
+                                                     : std::to_string(limit.rlim_cur >> 10) + "kB") +
+                    ")，仅预触碰; ";
+            ok = false;
+        } else {
+            info += "mlockall; ";
+        }
+    }
+
+    if (options.prefault_heap_bytes > 0) {
+        auto* heap = static_cast<uint8_t*>(std::malloc(options.prefault_heap_bytes));
+        if (heap) {
+            touchPages(heap, options.prefault_heap_bytes);
+            std::free(heap);  // 堆不收缩，这些页留给之后的分配
+            info += "堆预触碰 " + std::to_string(options.prefault_heap_bytes >> 20) + "MB; ";
+        } else {
+            info += "堆预触碰分配失败; ";
+            ok = false;
+        }
+    }
+
+    g_options = options;
+    g_huge_pages = options.huge_pages;
+    g_enabled = true;
+    prefaultCurrentStack(options.prefault_stack_bytes);
+    info += "栈预触碰 " + std::to_string(options.prefault_stack_bytes >> 10) + "kB";
+    if (options.huge_pages) {
+        info += "; 大页缓冲";
+    }
+
+    if (message) {
+        *message = info;
+    }
+    return ok;
+}
+
+bool rtMemoryEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+bool rtHugePagesEnabled() {
+    return g_huge_pages.load(std::memory_order_relaxed);
+}
+
+const RtMemoryOptions& rtMemoryOptions() {
+    return g_options;
+}
+
+__attribute__((noinline)) void prefaultCurrentStack(size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    touchPages(static_cast<uint8_t*>(alloca(bytes)), bytes);
+}
+
+HugePageBuffer::HugePageBuffer(size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    const size_t mapped = (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+
+    // 1. hugetlbfs大页（需预留 /proc/sys/vm/nr_hugepages）
+    void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    Backing backing = Backing::HUGETLB;
+    if (p == MAP_FAILED) {
+        // 2. 透明大页：先以PROT_NONE映射，避免MCL_FUTURE在madvise之前按小页填充
+        p = mmap(nullptr, mapped, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            return;
+        }
+        backing = madvise(p, mapped, MADV_HUGEPAGE) == 0 ? Backing::TRANSPARENT : Backing::NORMAL;
+        if (mprotect(p, mapped, PROT_READ | PROT_WRITE) != 0) {
+            munmap(p, mapped);
+            return;
+        }
+    }
+
+    data_ = static_cast<uint8_t*>(p);
+    size_ = bytes;
+    mapped_ = mapped;
+    backing_ = backing;
+    touchPages(data_, mapped_);
+    if (backing_ != Backing::NORMAL) {
+        g_huge_buffer_bytes.fetch_add(mapped_, std::memory_order_relaxed);
+    }
+}
+
+HugePageBuffer::~HugePageBuffer() {
+    reset();
+}
+
+HugePageBuffer::HugePageBuffer(HugePageBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+HugePageBuffer& HugePageBuffer::operator=(HugePageBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, 0);
+        backing_ = std::exchange(other.backing_, Backing::NONE);
+    }
+    return *this;
+}
+
+void HugePageBuffer::reset() {
+    if (data_) {
+        if (backing_ != Backing::NORMAL) {
+            g_huge_buffer_bytes.fetch_sub(mapped_, std::memory_order_relaxed);
+        }
+        munmap(data_, mapped_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = 0;
+    backing_ = Backing::NONE;
+}
+
+MemoryReport readMemoryReport() {
+    MemoryReport report;
+    report.vm_size_kb = readProcKb("/proc/self/status", "VmSize");
+    report.rss_kb = readProcKb("/proc/self/status", "VmRSS");
+    report.rss_peak_kb = readProcKb("/proc/self/status", "VmHWM");
+    report.locked_kb = readProcKb("/proc/self/status", "VmLck");
+    report.hugetlb_kb = readProcKb("/proc/self/status", "HugetlbPages");
+    report.anon_huge_kb = readProcKb("/proc/self/smaps_rollup", "AnonHugePages");
+    report.huge_buffer_kb = g_huge_buffer_bytes.load(std::memory_order_relaxed) >> 10;
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        report.minor_faults = static_cast<uint64_t>(usage.ru_minflt);
+        report.major_faults = static_cast<uint64_t>(usage.ru_majflt);
+    }
+    return report;
+}
+
+std::string formatMemoryReport(const MemoryReport& r) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "RSS %zuMB (峰值 %zuMB), 锁定 %zuMB, 透明大页 %zuMB, hugetlb %zuMB, "
+                  "大页缓冲 %zuMB, 缺页 minor %lu / major %lu",
+                  r.rss_kb >> 10, r.rss_peak_kb >> 10, r.locked_kb >> 10, r.anon_huge_kb >> 10,
+                  r.hugetlb_kb >> 10, r.huge_buffer_kb >> 10, r.minor_faults, r.major_faults);
+    return buf;
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,45 @@
+#include "rm_utils/startup_clock.hpp"
+
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace rm_auto_aim {
+
+double secondsSinceBoot() {
+    timespec ts{};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+double secondsSinceProcessStart() {
+    FILE* f = std::fopen("/proc/self/stat", "r");
+    if (!f) {
+        return -1.0;
+    }
+    char buf[1024];
+    const size_t n = std::fread(buf, 1, sizeof(buf) - 1, f);
+    std::fclose(f);
+    buf[n] = '\0';
+
+    // 进程名可能含空格，从最后一个')'之后开始数字段：其后依次为第3..52字段
+    const char* p = std::strrchr(buf, ')');
+    if (!p) {
+        return -1.0;
+    }
+    unsigned long long start_ticks = 0;
+    if (std::sscanf(p + 2,
+                    "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d "
+                    "%*d %*d %llu", &start_ticks) != 1) {
+        return -1.0;
+    }
+    const long hz = sysconf(_SC_CLK_TCK);
+    if (hz <= 0) {
+        return -1.0;
+    }
+    return secondsSinceBoot() - static_cast<double>(start_ticks) / static_cast<double>(hz);
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,379 @@
+#include "rm_utils/task_pool.hpp"
+
+#include <algorithm>
+
+namespace rm_auto_aim {
+
+namespace {
+
+// 当前线程所属的工作线程（非工作线程为nullptr）及其类别
+thread_local void* tl_worker = nullptr;
+thread_local int tl_class = -1;
+
+// 队列初始容量：稳态排队数远小于此，启动后不再扩容
+constexpr size_t INITIAL_QUEUE_CAPACITY = 64;
+
+// submit(std::function)：闭包保存在堆上，执行或丢弃时释放
+void runClosure(void* context, size_t, size_t) {
+    std::unique_ptr<std::function<void()>> fn(static_cast<std::function<void()>*>(context));
+    (*fn)();
+}
+
+void releaseClosure(void* context) {
+    delete static_cast<std::function<void()>*>(context);
+}
+
+}  // namespace
+
+const char* taskPriorityName(TaskPriority priority) {
+    switch (priority) {
+        case TaskPriority::HOT: return "hot";
+        case TaskPriority::BACKGROUND: return "background";
+        default: return "unknown";
+    }
+}
+
+void TaskPool::TaskQueue::reserve(size_t capacity) {
+    if (capacity <= slots_.size()) {
+        return;
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    std::vector<Task> slots(rounded);
+    const size_t count = tail_ - head_;
+    for (size_t i = 0; i < count; i++) {
+        slots[i] = slots_[(head_ + i) & (slots_.size() - 1)];
+    }
+    slots_.swap(slots);
+    head_ = 0;
+    tail_ = count;
+}
+
+void TaskPool::TaskQueue::pushBack(const Task& task) {
+    if (tail_ - head_ == slots_.size()) {
+        reserve(std::max<size_t>(slots_.size() * 2, INITIAL_QUEUE_CAPACITY));
+    }
+    slots_[tail_++ & (slots_.size() - 1)] = task;
+}
+
+TaskPool::Task TaskPool::TaskQueue::popBack() {
+    return slots_[--tail_ & (slots_.size() - 1)];
+}
+
+TaskPool::Task TaskPool::TaskQueue::popFront() {
+    return slots_[head_++ & (slots_.size() - 1)];
+}
+
+void TaskPool::TaskQueue::clear() {
+    while (!empty()) {
+        const Task task = popFront();
+        if (task.release) {
+            task.release(task.context);
+        }
+    }
+}
+
+TaskPool& TaskPool::global() {
+    static TaskPool pool;
+    return pool;
+}
+
+TaskPool::~TaskPool() {
+    stop();
+}
+
+bool TaskPool::start(const TaskPoolOptions& options, std::string* message) {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    if (started()) {
+        if (message) {
+            *message = "任务池已启动，忽略重复配置";
+        }
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    std::string info;
+    for (size_t c = 0; c < TASK_PRIORITY_COUNT; c++) {
+        const auto priority = static_cast<TaskPriority>(c);
+        const auto& cls_options = options.classes[c];
+        auto& cls = classes_[c];
+        const int threads = std::max(cls_options.threads, 0);
+        for (int i = 0; i < threads; i++) {
+            cls.workers.push_back(std::make_unique<Worker>());
+            cls.workers.back()->tasks.reserve(INITIAL_QUEUE_CAPACITY);
+        }
+        {
+            std::lock_guard<std::mutex> inject_lock(cls.inject_mutex);
+            cls.injected.reserve(INITIAL_QUEUE_CAPACITY);
+        }
+        // 线程在所有Worker创建后再启动：窃取时遍历的workers不再变化
+        for (size_t i = 0; i < cls.workers.size(); i++) {
+            cls.workers[i]->thread = std::thread(
+                &TaskPool::workerLoop, this, priority, i, cls_options.placement);
+        }
+        info += std::string(taskPriorityName(priority)) + " " + std::to_string(threads) + " 线程";
+        if (!cls_options.placement.cpus.empty()) {
+            info += " CPU";
+            for (size_t i = 0; i < cls_options.placement.cpus.size(); i++) {
+                info += (i == 0 ? " " : ",") + std::to_string(cls_options.placement.cpus[i]);
+            }
+        }
+        if (cls_options.placement.priority > 0) {
+            info += " FIFO " + std::to_string(cls_options.placement.priority);
+        }
+        info += "; ";
+    }
+    started_.store(true, std::memory_order_release);
+
+    if (message) {
+        info.resize(info.size() - 2);
+        *message = info;
+    }
+    return true;
+}
+
+void TaskPool::stop() {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    if (!started()) {
+        return;
+    }
+    running_.store(false, std::memory_order_release);
+    for (auto& cls : classes_) {
+        {
+            std::lock_guard<std::mutex> sleep_lock(cls.sleep_mutex);
+        }
+        cls.wake.notify_all();
+    }
+    for (auto& cls : classes_) {
+        for (auto& worker : cls.workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+            worker->tasks.clear();
+        }
+        cls.workers.clear();
+        std::lock_guard<std::mutex> inject_lock(cls.inject_mutex);
+        cls.injected.clear();
+        cls.pending.store(0, std::memory_order_relaxed);
+    }
+    started_.store(false, std::memory_order_release);
+}
+
+void TaskPool::execute(const Task& task) {
+    if (task.group) {
+        task.group->execute(task);
+    } else {
+        task.fn(task.context, task.begin, task.end);
+    }
+}
+
+void TaskPool::submit(TaskPriority priority, std::function<void()> fn) {
+    Task task;
+    task.fn = &runClosure;
+    task.context = new std::function<void()>(std::move(fn));
+    task.release = &releaseClosure;
+    submit(priority, task);
+}
+
+void TaskPool::submit(TaskPriority priority, const Task& task) {
+    auto& cls = taskClass(priority);
+    cls.submitted.fetch_add(1, std::memory_order_relaxed);
+
+    if (!started() || cls.workers.empty()) {
+        // 没有工作线程：同步执行，调用方无需区分
+        execute(task);
+        cls.executed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // 先计数再入队：取走任务时的递减不会先于递增
+    cls.pending.fetch_add(1, std::memory_order_release);
+    if (tl_class == static_cast<int>(priority) && tl_worker) {
+        // 同类工作线程内的嵌套提交：压入自己的队列尾部
+        auto* self = static_cast<Worker*>(tl_worker);
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->tasks.pushBack(task);
+    } else {
+        std::lock_guard<std::mutex> lock(cls.inject_mutex);
+        cls.injected.pushBack(task);
+    }
+
+    // 与workerLoop的等待条件配对，避免丢失唤醒
+    {
+        std::lock_guard<std::mutex> sleep_lock(cls.sleep_mutex);
+    }
+    cls.wake.notify_one();
+}
+
+bool TaskPool::takeTask(TaskPriority priority, Worker* self, Task& task) {
+    auto& cls = taskClass(priority);
+    if (cls.pending.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // 1. 自己的队列尾部
+    if (self) {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        if (!self->tasks.empty()) {
+            task = self->tasks.popBack();
+            cls.pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 2. 注入队列
+    {
+        std::lock_guard<std::mutex> lock(cls.inject_mutex);
+        if (!cls.injected.empty()) {
+            task = cls.injected.popFront();
+            cls.pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 3. 从同类其他线程队列头部窃取（从自己的下一个开始轮询，分散竞争）
+    const size_t count = cls.workers.size();
+    size_t start = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (cls.workers[i].get() == self) {
+            start = i + 1;
+            break;
+        }
+    }
+    for (size_t k = 0; k < count; k++) {
+        Worker* victim = cls.workers[(start + k) % count].get();
+        if (victim == self) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->tasks.empty()) {
+            task = victim->tasks.popFront();
+            cls.pending.fetch_sub(1, std::memory_order_relaxed);
+            cls.stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskPool::runPending(TaskPriority priority) {
+    if (!started()) {
+        return false;
+    }
+    // 工作线程在等待时优先取自己的队列；外部线程只取注入队列和窃取
+    Worker* self = tl_class == static_cast<int>(priority) ? static_cast<Worker*>(tl_worker)
+                                                          : nullptr;
+    Task task;
+    if (!takeTask(priority, self, task)) {
+        return false;
+    }
+    auto& cls = taskClass(priority);
+    execute(task);
+    cls.executed.fetch_add(1, std::memory_order_relaxed);
+    cls.helped.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void TaskPool::workerLoop(TaskPriority priority, size_t index, ThreadPlacement placement) {
+    auto& cls = taskClass(priority);
+    Worker* self = cls.workers[index].get();
+    tl_worker = self;
+    tl_class = static_cast<int>(priority);
+
+    placement.name = std::string("pool_") + taskPriorityName(priority) + "_" + std::to_string(index);
+    applyThreadPlacement(placement, nullptr);
+
+    Task task;
+    while (running_.load(std::memory_order_acquire)) {
+        if (takeTask(priority, self, task)) {
+            execute(task);
+            cls.executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(cls.sleep_mutex);
+        cls.wake.wait(lock, [&]() {
+            return !running_.load(std::memory_order_acquire) ||
+                   cls.pending.load(std::memory_order_acquire) > 0;
+        });
+    }
+
+    tl_worker = nullptr;
+    tl_class = -1;
+}
+
+int TaskPool::threadCount(TaskPriority priority) const {
+    return started() ? static_cast<int>(taskClass(priority).workers.size()) : 0;
+}
+
+TaskPool::ClassStats TaskPool::stats(TaskPriority priority) const {
+    const auto& cls = taskClass(priority);
+    ClassStats stats;
+    stats.submitted = cls.submitted.load(std::memory_order_relaxed);
+    stats.executed = cls.executed.load(std::memory_order_relaxed);
+    stats.stolen = cls.stolen.load(std::memory_order_relaxed);
+    stats.helped = cls.helped.load(std::memory_order_relaxed);
+    stats.pending = cls.pending.load(std::memory_order_relaxed);
+    stats.threads = threadCount(priority);
+    return stats;
+}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // 析构中不传播子任务异常
+    }
+}
+
+void TaskGroup::run(TaskPool::RangeFn fn, void* context, size_t begin, size_t end) {
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+    TaskPool::Task task;
+    task.fn = fn;
+    task.context = context;
+    task.begin = begin;
+    task.end = end;
+    task.group = this;
+    pool_.submit(priority_, task);
+}
+
+void TaskGroup::execute(const TaskPool::Task& task) {
+    std::exception_ptr error;
+    try {
+        task.fn(task.context, task.begin, task.end);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // 加锁递减：wait()返回（任务组析构）前必须再取一次锁，此后本线程不再访问任务组
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error && !error_) {
+        error_ = error;
+    }
+    if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        done_.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    while (outstanding_.load(std::memory_order_acquire) > 0) {
+        // 协助执行同类任务（可能正是本组的子任务）
+        if (pool_.runPending(priority_)) {
+            continue;
+        }
+        // 余下子任务都在其他线程上执行：阻塞等待而不是自旋让出
+        // （SCHED_FIFO线程的yield不会让给同核的普通优先级线程）
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return outstanding_.load(std::memory_order_acquire) == 0; });
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(error, error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace rm_auto_aim
@@ -0,0 +1,166 @@
+// 遥测文件导出：telemetry_export <file.rmtl> [--csv | --npy <dir>] [--columns a,b,c]
+//   无选项: 打印列清单和行数
+//   --csv:  以CSV输出到标准输出
+//   --npy:  每列写一个 <dir>/<列名>.npy（numpy.load / pandas直接读取）
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rm_utils/telemetry_log.hpp"
+
+using rm_auto_aim::TelemetryReader;
+using rm_auto_aim::TelemetryType;
+
+namespace {
+
+void printValue(const TelemetryReader& reader, size_t column, uint64_t row) {
+    const auto type = reader.columns()[column].type;
+    // 整数列按原值输出，避免时间戳等64位整数经double丢失精度
+    if (type == TelemetryType::I64) {
+        int64_t v;
+        const auto* data = static_cast<const uint8_t*>(
+            reader.blockData(column, row / reader.blockRows()));
+        std::memcpy(&v, data + (row % reader.blockRows()) * sizeof(v), sizeof(v));
+        std::printf("%" PRId64, v);
+    } else if (type == TelemetryType::I32 || type == TelemetryType::U8) {
+        std::printf("%.0f", reader.value(column, row));
+    } else {
+        std::printf("%.9g", reader.value(column, row));
+    }
+}
+
+const char* npyDescr(TelemetryType type) {
+    switch (type) {
+        case TelemetryType::F64: return "<f8";
+        case TelemetryType::F32: return "<f4";
+        case TelemetryType::I64: return "<i8";
+        case TelemetryType::I32: return "<i4";
+        case TelemetryType::U8: return "|u1";
+        default: return "|V1";
+    }
+}
+
+bool writeNpy(const TelemetryReader& reader, size_t column, const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    // NPY 1.0: 魔数 + 版本 + 头长度(小端u16) + 字典文本，总头长补齐到64字节
+    std::string dict = "{'descr': '" + std::string(npyDescr(reader.columns()[column].type)) +
+                       "', 'fortran_order': False, 'shape': (" + std::to_string(reader.rows()) +
+                       ",), }";
+    const size_t prefix = 10;
+    const size_t total = (prefix + dict.size() + 1 + 63) / 64 * 64;
+    dict.append(total - prefix - dict.size() - 1, ' ');
+    dict.push_back('\n');
+    const uint16_t header_len = static_cast<uint16_t>(dict.size());
+    const unsigned char magic[8] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0};
+    bool ok = std::fwrite(magic, 1, sizeof(magic), file) == sizeof(magic);
+    const unsigned char len[2] = {static_cast<unsigned char>(header_len & 0xff),
+                                  static_cast<unsigned char>(header_len >> 8)};
+    ok = ok && std::fwrite(len, 1, 2, file) == 2;
+    ok = ok && std::fwrite(dict.data(), 1, dict.size(), file) == dict.size();
+
+    // 每块中该列是一段连续数组，直接整段写出
+    const size_t size = rm_auto_aim::telemetryTypeSize(reader.columns()[column].type);
+    for (uint64_t row = 0; ok && row < reader.rows(); row += reader.blockRows()) {
+        const uint64_t count = std::min<uint64_t>(reader.blockRows(), reader.rows() - row);
+        ok = std::fwrite(reader.blockData(column, row / reader.blockRows()), size, count, file) ==
+             count;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "用法: %s <file.rmtl> [--csv | --npy <dir>] [--columns a,b,c]\n",
+                     argv[0]);
+        return 1;
+    }
+    bool csv = false;
+    std::string npy_dir;
+    std::string column_list;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (std::strcmp(argv[i], "--npy") == 0 && i + 1 < argc) {
+            npy_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--columns") == 0 && i + 1 < argc) {
+            column_list = argv[++i];
+        } else {
+            std::fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    TelemetryReader reader;
+    std::string error;
+    if (!reader.open(argv[1], &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<size_t> selected;
+    if (column_list.empty()) {
+        for (size_t i = 0; i < reader.columns().size(); i++) {
+            selected.push_back(i);
+        }
+    } else {
+        size_t start = 0;
+        while (start <= column_list.size()) {
+            const size_t end = std::min(column_list.find(',', start), column_list.size());
+            const std::string name = column_list.substr(start, end - start);
+            const int index = reader.findColumn(name);
+            if (index < 0) {
+                std::fprintf(stderr, "没有列 %s\n", name.c_str());
+                return 1;
+            }
+            selected.push_back(static_cast<size_t>(index));
+            start = end + 1;
+        }
+    }
+
+    if (csv) {
+        for (size_t i = 0; i < selected.size(); i++) {
+            std::printf("%s%s", i ? "," : "", reader.columns()[selected[i]].name.c_str());
+        }
+        std::printf("\n");
+        for (uint64_t row = 0; row < reader.rows(); row++) {
+            for (size_t i = 0; i < selected.size(); i++) {
+                if (i) {
+                    std::printf(",");
+                }
+                printValue(reader, selected[i], row);
+            }
+            std::printf("\n");
+        }
+        return 0;
+    }
+
+    if (!npy_dir.empty()) {
+        for (size_t column : selected) {
+            const std::string path = npy_dir + "/" + reader.columns()[column].name + ".npy";
+            if (!writeNpy(reader, column, path)) {
+                std::fprintf(stderr, "写入 %s 失败\n", path.c_str());
+                return 1;
+            }
+        }
+        std::printf("已导出 %zu 列 × %llu 行到 %s\n", selected.size(),
+                    static_cast<unsigned long long>(reader.rows()), npy_dir.c_str());
+        return 0;
+    }
+
+    std::printf("# 行数: %llu  块行数: %u  列数: %zu\n",
+                static_cast<unsigned long long>(reader.rows()), reader.blockRows(),
+                reader.columns().size());
+    for (size_t column : selected) {
+        std::printf("%-24s %s\n", reader.columns()[column].name.c_str(),
+                    rm_auto_aim::telemetryTypeName(reader.columns()[column].type));
+    }
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include "rm_utils/telemetry_log.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "rm_utils/latency_tracer.hpp"
+
+namespace rm_auto_aim {
+
+namespace {
+
+constexpr size_t kAlign = 64;
+
+size_t alignUp(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+void setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+std::string errnoMessage(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+}  // namespace
+
+size_t telemetryTypeSize(TelemetryType type) {
+    switch (type) {
+        case TelemetryType::F64: return 8;
+        case TelemetryType::F32: return 4;
+        case TelemetryType::I64: return 8;
+        case TelemetryType::I32: return 4;
+        case TelemetryType::U8: return 1;
+        default: return 0;
+    }
+}
+
+const char* telemetryTypeName(TelemetryType type) {
+    switch (type) {
+        case TelemetryType::F64: return "f64";
+        case TelemetryType::F32: return "f32";
+        case TelemetryType::I64: return "i64";
+        case TelemetryType::I32: return "i32";
+        case TelemetryType::U8: return "u8";
+        default: return "unknown";
+    }
+}
+
+std::string makeTelemetryPath(const std::string& output_dir, const std::string& prefix) {
+    mkdir(output_dir.c_str(), 0755);
+    const auto now = std::chrono::system_clock::now();
+    const std::time_t t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+    return output_dir + "/" + prefix + "_" + stamp + ".rmtl";
+}
+
+// ==================== TelemetryWriter ====================
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+bool TelemetryWriter::open(const std::string& path, const std::vector<TelemetryColumn>& columns,
+                           size_t record_bytes, const Options& options, std::string* error) {
+    if (isOpen()) {
+        setError(error, "已打开 " + path_);
+        return false;
+    }
+    if (columns.empty() || record_bytes == 0 || record_bytes > MAX_RECORD_BYTES ||
+        options.block_rows == 0) {
+        setError(error, "无效的遥测列定义");
+        return false;
+    }
+
+    // 计算块内布局：块头之后各列数组依次排列、64字节对齐
+    columns_.clear();
+    size_t offset = sizeof(TelemetryBlockHeader);
+    for (const auto& column : columns) {
+        const size_t size = telemetryTypeSize(column.type);
+        if (size == 0 || column.record_offset + size > record_bytes ||
+            column.name.empty() || column.name.size() >= sizeof(TelemetryColumnDesc::name)) {
+            setError(error, "无效的遥测列: " + column.name);
+            return false;
+        }
+        columns_.push_back({column.type, static_cast<uint32_t>(size), column.record_offset,
+                            static_cast<uint32_t>(offset)});
+        offset = alignUp(offset + size * options.block_rows, kAlign);
+    }
+    options_ = options;
+    record_bytes_ = record_bytes;
+    block_bytes_ = offset;
+    data_offset_ = alignUp(sizeof(TelemetryFileHeader) + columns.size() * sizeof(TelemetryColumnDesc),
+                           static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        setError(error, errnoMessage("无法创建 " + path));
+        return false;
+    }
+    mapped_bytes_ = data_offset_ + options_.grow_blocks * block_bytes_;
+    if (::ftruncate(fd_, static_cast<off_t>(mapped_bytes_)) != 0) {
+        setError(error, errnoMessage("ftruncate失败"));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    void* base = ::mmap(nullptr, mapped_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        setError(error, errnoMessage("mmap失败"));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(base);
+
+    auto* file_header = header();
+    std::memcpy(file_header->magic, TELEMETRY_MAGIC, sizeof(file_header->magic));
+    file_header->version = TELEMETRY_VERSION;
+    file_header->column_count = static_cast<uint32_t>(columns.size());
+    file_header->record_bytes = static_cast<uint32_t>(record_bytes);
+    file_header->block_rows = options_.block_rows;
+    file_header->block_bytes = block_bytes_;
+    file_header->data_offset = data_offset_;
+    file_header->row_count = 0;
+    file_header->created_ns = LatencyTracer::nowNs();
+
+    auto* descs = reinterpret_cast<TelemetryColumnDesc*>(base_ + sizeof(TelemetryFileHeader));
+    for (size_t i = 0; i < columns.size(); i++) {
+        std::strncpy(descs[i].name, columns[i].name.c_str(), sizeof(descs[i].name) - 1);
+        descs[i].type = static_cast<uint8_t>(columns[i].type);
+        descs[i].record_offset = columns_[i].record_offset;
+        descs[i].block_offset = columns_[i].block_offset;
+    }
+
+    path_ = path;
+    rows_ = 0;
+    rows_written_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+    queue_ = std::make_unique<SpscQueue<Slot>>(options_.queue_capacity);
+    running_.store(true, std::memory_order_release);
+    flusher_thread_ = std::thread(&TelemetryWriter::flusherLoop, this);
+    return true;
+}
+
+void TelemetryWriter::close() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (flusher_thread_.joinable()) {
+        flusher_thread_.join();
+    }
+
+    // 截断到实际使用的块数，文件头的row_count已在刷写时更新
+    const uint64_t blocks = (rows_ + options_.block_rows - 1) / options_.block_rows;
+    const size_t used = data_offset_ + blocks * block_bytes_;
+    ::msync(base_, mapped_bytes_, MS_SYNC);
+    ::munmap(base_, mapped_bytes_);
+    // 截断失败不影响读取（读取端以row_count为准），只是文件尾部留有未用空间
+    const bool truncated = ::ftruncate(fd_, static_cast<off_t>(used)) == 0;
+    (void)truncated;
+    ::close(fd_);
+    base_ = nullptr;
+    mapped_bytes_ = 0;
+    fd_ = -1;
+    queue_.reset();
+}
+
+bool TelemetryWriter::appendRaw(const void* data, size_t bytes) noexcept {
+    if (!running_.load(std::memory_order_relaxed) || bytes > record_bytes_) {
+        return false;
+    }
+    Slot slot;
+    std::memcpy(slot.bytes.data(), data, bytes);
+    if (!queue_->tryPush(std::move(slot))) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void TelemetryWriter::flusherLoop() {
+    applyThreadPlacement(options_.placement, nullptr);
+
+    // 刷写线程不在延迟关键路径上：队列空时睡眠1ms，不用popWait的自旋退避
+    const auto sync_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(options_.sync_interval_s));
+    auto last_sync = std::chrono::steady_clock::now();
+    Slot slot;
+    bool ok = true;
+    for (;;) {
+        const bool running = running_.load(std::memory_order_acquire);
+        bool wrote = false;
+        while (ok && queue_->tryPop(slot)) {
+            ok = writeRow(slot);
+            wrote = true;
+        }
+        if (!running) {
+            break;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (wrote && now - last_sync >= sync_interval) {
+            ::msync(base_, mapped_bytes_, MS_ASYNC);
+            last_sync = now;
+        }
+        if (!wrote) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+bool TelemetryWriter::ensureCapacity(uint64_t block_index) {
+    const size_t needed = data_offset_ + (block_index + 1) * block_bytes_;
+    if (needed <= mapped_bytes_) {
+        return true;
+    }
+    const size_t grown = mapped_bytes_ + options_.grow_blocks * block_bytes_;
+    if (::ftruncate(fd_, static_cast<off_t>(grown)) != 0) {
+        return false;
+    }
+    void* base = ::mremap(base_, mapped_bytes_, grown, MREMAP_MAYMOVE);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(base);
+    mapped_bytes_ = grown;
+    return true;
+}
+
+bool TelemetryWriter::writeRow(const Slot& slot) {
+    const uint64_t block_index = rows_ / options_.block_rows;
+    const uint32_t row = static_cast<uint32_t>(rows_ % options_.block_rows);
+    if (row == 0 && !ensureCapacity(block_index)) {
+        // 磁盘满等情况：停止写入，后续记录计为丢弃
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    uint8_t* block = base_ + data_offset_ + block_index * block_bytes_;
+    auto* block_header = reinterpret_cast<TelemetryBlockHeader*>(block);
+    if (row == 0) {
+        block_header->magic = TELEMETRY_BLOCK_MAGIC;
+        block_header->index = static_cast<uint32_t>(block_index);
+    }
+    for (const auto& column : columns_) {
+        std::memcpy(block + column.block_offset + static_cast<size_t>(row) * column.size,
+                    slot.bytes.data() + column.record_offset, column.size);
+    }
+    block_header->rows = row + 1;
+    rows_++;
+    header()->row_count = rows_;
+    rows_written_.store(rows_, std::memory_order_relaxed);
+    return true;
+}
+
+// ==================== TelemetryReader ====================
+
+TelemetryReader::~TelemetryReader() {
+    if (base_) {
+        ::munmap(const_cast<uint8_t*>(base_), mapped_bytes_);
+    }
+}
+
+bool TelemetryReader::open(const std::string& path, std::string* error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        setError(error, errnoMessage("无法打开 " + path));
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TelemetryFileHeader)) {
+        setError(error, path + " 不是有效的遥测文件");
+        ::close(fd);
+        return false;
+    }
+    void* base = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        setError(error, errnoMessage("mmap失败"));
+        return false;
+    }
+    base_ = static_cast<const uint8_t*>(base);
+    mapped_bytes_ = st.st_size;
+
+    const auto* file_header = reinterpret_cast<const TelemetryFileHeader*>(base_);
+    const size_t descs_end =
+        sizeof(TelemetryFileHeader) + file_header->column_count * sizeof(TelemetryColumnDesc);
+    // data_offset越过文件尾或block_bytes为0时，下面计算完整块数会下溢/除零
+    if (std::memcmp(file_header->magic, TELEMETRY_MAGIC, sizeof(file_header->magic)) != 0 ||
+        file_header->version != TELEMETRY_VERSION || file_header->block_rows == 0 ||
+        file_header->block_bytes == 0 || descs_end > mapped_bytes_ ||
+        file_header->data_offset < descs_end || file_header->data_offset > mapped_bytes_) {
+        setError(error, path + " 不是有效的遥测文件");
+        return false;
+    }
+    block_rows_ = file_header->block_rows;
+    block_bytes_ = file_header->block_bytes;
+    data_offset_ = file_header->data_offset;
+    created_ns_ = file_header->created_ns;
+
+    const auto* descs = reinterpret_cast<const TelemetryColumnDesc*>(base_ + sizeof(TelemetryFileHeader));
+    columns_.clear();
+    for (uint32_t i = 0; i < file_header->column_count; i++) {
+        const auto type = static_cast<TelemetryType>(descs[i].type);
+        if (telemetryTypeSize(type) == 0 ||
+            descs[i].block_offset + telemetryTypeSize(type) * block_rows_ > block_bytes_) {
+            setError(error, path + " 列定义损坏");
+            return false;
+        }
+        columns_.push_back({std::string(descs[i].name, strnlen(descs[i].name, sizeof(descs[i].name))),
+                            type, descs[i].block_offset});
+    }
+
+    // 只信任完整落在文件内的行（写入端崩溃时文件尾可能未截断，也可能少于row_count）
+    const uint64_t blocks_in_file = (mapped_bytes_ - data_offset_) / block_bytes_;
+    rows_ = std::min<uint64_t>(file_header->row_count, blocks_in_file * block_rows_);
+    return true;
+}
+
+int TelemetryReader::findColumn(const std::string& name) const {
+    for (size_t i = 0; i < columns_.size(); i++) {
+        if (columns_[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+double TelemetryReader::value(size_t column, uint64_t row) const {
+    const auto* data = static_cast<const uint8_t*>(blockData(column, row / block_rows_));
+    const size_t index = row % block_rows_;
+    switch (columns_[column].type) {
+        case TelemetryType::F64: {
+            double v;
+            std::memcpy(&v, data + index * sizeof(v), sizeof(v));
+            return v;
+        }
+        case TelemetryType::F32: {
+            float v;
+            std::memcpy(&v, data + index * sizeof(v), sizeof(v));
+            return v;
+        }
+        case TelemetryType::I64: {
+            int64_t v;
+            std::memcpy(&v, data + index * sizeof(v), sizeof(v));
+            return static_cast<double>(v);
+        }
+        case TelemetryType::I32: {
+            int32_t v;
+            std::memcpy(&v, data + index * sizeof(v), sizeof(v));
+            return v;
+        }
+        case TelemetryType::U8:
+            return data[index];
+        default:
+            return 0.0;
+    }
+}
+
+}  // namespace rm_auto_aim
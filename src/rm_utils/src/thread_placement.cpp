@@ -0,0 +1,84 @@
+#include "rm_utils/thread_placement.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "rm_utils/alloc_tracker.hpp"
+#include "rm_utils/rt_memory.hpp"
+
+namespace rm_auto_aim {
+
+bool applyThreadPlacement(const ThreadPlacement& placement, std::string* message) {
+    bool ok = true;
+    std::string info;
+
+    if (!placement.name.empty()) {
+        // 线程名上限16字节（含结尾），便于top/perf中识别
+        pthread_setname_np(pthread_self(), placement.name.substr(0, 15).c_str());
+        // 具名线程登记分配计数槽，诊断中按线程名查看
+        AllocTracker::registerThread(placement.name);
+    }
+
+    if (!placement.cpus.empty()) {
+        const long cpu_count = sysconf(_SC_NPROCESSORS_CONF);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        std::string applied;
+        for (const int cpu : placement.cpus) {
+            if (cpu < 0 || cpu >= cpu_count || cpu >= CPU_SETSIZE) {
+                info += "忽略不存在的CPU " + std::to_string(cpu) + "; ";
+                ok = false;
+                continue;
+            }
+            CPU_SET(cpu, &set);
+            applied += (applied.empty() ? "" : ",") + std::to_string(cpu);
+        }
+        if (applied.empty()) {
+            info += "无可用CPU，不绑定; ";
+        } else {
+            const int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (ret != 0) {
+                info += std::string("绑定CPU失败: ") + std::strerror(ret) + "; ";
+                ok = false;
+            } else {
+                info += "CPU " + applied + "; ";
+            }
+        }
+    }
+
+    if (placement.priority > 0) {
+        sched_param param{};
+        param.sched_priority = std::clamp(
+            placement.priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+        const int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (ret != 0) {
+            info += std::string("SCHED_FIFO失败(") + std::strerror(ret) +
+                    (ret == EPERM ? "，需CAP_SYS_NICE或rtprio限额" : "") + ")，保持普通调度; ";
+            ok = false;
+        } else {
+            info += "SCHED_FIFO " + std::to_string(param.sched_priority) + "; ";
+        }
+    }
+
+    if (rtMemoryEnabled()) {
+        // 实时内存模式：关键线程的栈也提前触碰
+        prefaultCurrentStack(rtMemoryOptions().prefault_stack_bytes);
+    }
+
+    if (info.empty()) {
+        info = "默认调度";
+    } else {
+        info.resize(info.size() - 2);
+    }
+    if (message) {
+        *message = info;
+    }
+    return ok;
+}
+
+}  // namespace rm_auto_aim